@@ -100,6 +100,7 @@ static void printHelp(const char *prog)
     std::printf("Options:\n");
     std::printf("  --dump       Dump bytecode after compilation\n");
     std::printf("  --debug <N>  Set breakpoint at line N (repeatable)\n");
+    std::printf("  --no-jit     Disable the baseline JIT (interpreter only)\n");
     std::printf("  -o <file>    Compile to bytecode file (.buc)\n");
     std::printf("  -I <path>    Add module search path\n");
     std::printf("\nExamples:\n");
@@ -118,6 +119,7 @@ int main(int argc, char *argv[])
     const char *evalCode = nullptr;
     const char *outputBytecode = nullptr;
     bool dump = false;
+    bool noJit = false;
     std::vector<std::string> includePaths;
     std::vector<int> debugBreakpoints;
 
@@ -138,6 +140,10 @@ int main(int argc, char *argv[])
         {
             dump = true;
         }
+        else if (std::strcmp(argv[i], "--no-jit") == 0)
+        {
+            noJit = true;
+        }
         else if (std::strcmp(argv[i], "--debug") == 0)
         {
             if (i + 1 < argc)
@@ -228,6 +234,8 @@ int main(int argc, char *argv[])
     Interpreter vm;
     vm.registerAll();
     vm.setArgs(argc, argv);
+    if (noJit)
+        vm.setJitEnabled(false);
 
     // Configure file loader
     LoaderContext loaderCtx;
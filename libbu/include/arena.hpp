@@ -2,6 +2,7 @@
 
 #pragma once
 #include "config.hpp"
+#include <cstdint>
 
 const size_t chunkSize = 16UL * 1024UL; // 16384 bytes
 const size_t maxBlockSize = 640UL;
@@ -29,7 +30,11 @@ struct StackEntry
 	bool usedMalloc;
 };
 
-struct Block;
+struct Block
+{
+	Block *next;
+};
+
 struct Heap;
 
 //  StringObject *str = strings[i];
@@ -64,6 +69,11 @@ public:
 	size_t GetTotalAllocated() const { return m_totalAllocated; }
 	size_t GetTotalReserved() const { return m_totalReserved; }
 
+	// Classes de tamanho (1..maxBlockSize), partilhadas com o PageAllocator
+	static void InitSizeClasses();
+	static FORCE_INLINE size_t SizeClassOf(size_t size) { return s_blockSizeLookup[size]; }
+	static FORCE_INLINE size_t BlockSize(size_t index) { return s_blockSizes[index]; }
+
 private:
 	Heap *m_chunks;
 	size_t m_chunkCount;
@@ -82,6 +92,179 @@ private:
 	static bool s_blockSizeLookupInitialized;
 };
 
+// ============================================
+// Heap dos objetos do GC (Interpreter::arena)
+//
+// Cada pagina (heapPageSize, alinhada ao proprio tamanho) so tem blocos de
+// uma classe de tamanho. Allocate reutiliza a free list da pagina atual ou
+// avanca o bump; Free chega ao cabecalho da pagina pelo endereco. Sweep(),
+// no fim de cada recolha, guarda as paginas sem blocos vivos que cabem na
+// folga do proximo ciclo e devolve as restantes ao SO.
+// Pertence a uma VM e nao tem locks: as threads de setProcessWorkers nunca
+// alocam objetos (passam o passo a thread principal antes).
+// ============================================
+
+const size_t heapPageSize = BU_HEAP_PAGE_SIZE;
+const size_t heapCachedPages = BU_HEAP_CACHED_PAGES;
+const size_t heapKinds = 16; // contadores por tipo (GCObjectType)
+
+static_assert((heapPageSize & (heapPageSize - 1)) == 0, "BU_HEAP_PAGE_SIZE must be a power of two");
+static_assert(heapPageSize >= 16 * maxBlockSize, "BU_HEAP_PAGE_SIZE too small for the size classes");
+
+struct HeapPage
+{
+	HeapPage *next;			 // paginas da classe (ou lista de vazias)
+	HeapPage *nextAvailable; // paginas com espaco, fora a atual
+	Block *freeList;
+	char *bump;
+	char *end; // fim do ultimo bloco inteiro
+	uint32 live;
+	uint32 blockSize;
+	uint8 sizeClass;
+	bool available;
+};
+
+struct PageKindStats
+{
+	size_t allocations; // desde o inicio
+	size_t frees;
+	size_t liveBytes; // blocos em uso (tamanho da classe) + alocacoes grandes
+};
+
+struct PageAllocatorStats
+{
+	size_t pages;		  // paginas com blocos (ou a atual de cada classe)
+	size_t hotPages;	  // vazias, ainda com memoria, para o proximo ciclo
+	size_t cachedPages;	  // vazias, ja devolvidas, guardadas para reutilizar
+	size_t reservedBytes; // (pages + hotPages) * heapPageSize
+	size_t releasedBytes; // devolvido ao SO desde o inicio
+	size_t largeAllocations;
+	size_t largeAllocatedBytes;
+	size_t classPages[blockSizes];
+	PageKindStats kinds[heapKinds];
+};
+
+class PageAllocator
+{
+public:
+	PageAllocator();
+	~PageAllocator();
+
+	PageAllocator(const PageAllocator &) = delete;
+	PageAllocator &operator=(const PageAllocator &) = delete;
+	PageAllocator(PageAllocator &&) = delete;
+	PageAllocator &operator=(PageAllocator &&) = delete;
+
+	FORCE_INLINE void *Allocate(size_t size, uint8 kind);
+	FORCE_INLINE void Free(void *p, size_t size, uint8 kind);
+
+	// Paginas sem blocos vivos: ficam ate keepBytes (a folga ate a proxima
+	// recolha), as outras vao ao SO (madvise ate heapCachedPages, depois unmap).
+	// Devolve os bytes devolvidos ao SO.
+	size_t Sweep(size_t keepBytes);
+	void Clear();
+
+	void GetStats(PageAllocatorStats &stats) const;
+	size_t GetTotalAllocated() const { return m_totalAllocated; }
+
+private:
+	struct SizeClass
+	{
+		HeapPage *current;
+		HeapPage *pages;
+		HeapPage *available;
+	};
+
+	SizeClass m_classes[blockSizes];
+	HeapPage *m_hot;
+	size_t m_hotCount;
+	HeapPage *m_cached;
+	size_t m_cachedCount;
+	size_t m_pageCount;
+	size_t m_totalAllocated;
+	size_t m_releasedBytes;
+	size_t m_largeAllocations;
+	size_t m_largeAllocatedBytes;
+	PageKindStats m_kinds[heapKinds];
+
+	void *AllocateSlow(size_t size, uint8 kind);
+	void FreeLarge(void *p, size_t size, uint8 kind);
+	HeapPage *NewPage(size_t index);
+	void ReleasePage(HeapPage *page);
+
+	static FORCE_INLINE HeapPage *PageOf(void *p)
+	{
+		return reinterpret_cast<HeapPage *>(reinterpret_cast<uintptr_t>(p) & ~(uintptr_t)(heapPageSize - 1));
+	}
+};
+
+FORCE_INLINE void *PageAllocator::Allocate(size_t size, uint8 kind)
+{
+	if (LIKELY(size - 1 < maxBlockSize))
+	{
+		HeapPage *page = m_classes[HeapAllocator::SizeClassOf(size)].current;
+		if (LIKELY(page != nullptr))
+		{
+			void *p;
+			if (page->freeList)
+			{
+				p = page->freeList;
+				page->freeList = page->freeList->next;
+			}
+			else if (page->bump != page->end)
+			{
+				p = page->bump;
+				page->bump += page->blockSize;
+			}
+			else
+			{
+				return AllocateSlow(size, kind);
+			}
+			page->live++;
+			m_totalAllocated += page->blockSize;
+			PageKindStats &k = m_kinds[kind & (heapKinds - 1)];
+			k.allocations++;
+			k.liveBytes += page->blockSize;
+			return p;
+		}
+	}
+	return AllocateSlow(size, kind);
+}
+
+FORCE_INLINE void PageAllocator::Free(void *p, size_t size, uint8 kind)
+{
+	if (p == nullptr || size == 0)
+		return;
+	if (UNLIKELY(size > maxBlockSize))
+	{
+		FreeLarge(p, size, kind);
+		return;
+	}
+
+	HeapPage *page = PageOf(p);
+#ifdef _DEBUG
+	assert(page->blockSize == HeapAllocator::BlockSize(HeapAllocator::SizeClassOf(size)));
+	std::memset(p, 0xfd, page->blockSize);
+#endif
+	Block *block = static_cast<Block *>(p);
+	block->next = page->freeList;
+	page->freeList = block;
+	page->live--;
+	m_totalAllocated -= page->blockSize;
+	PageKindStats &k = m_kinds[kind & (heapKinds - 1)];
+	k.frees++;
+	k.liveBytes -= page->blockSize;
+
+	// Voltou a ter espaco: entra na lista da classe (a atual ja e a primeira a ser usada)
+	SizeClass &c = m_classes[page->sizeClass];
+	if (!page->available && page != c.current)
+	{
+		page->available = true;
+		page->nextAvailable = c.available;
+		c.available = page;
+	}
+}
+
 // This is a stack allocator used for fast per step allocations.
 // You must nest allocate/free pairs. The code will assert
 // if you try to interleave multiple allocate/free pairs.
@@ -8,6 +8,7 @@
 #include "set.hpp"
 #include <cstring>
 #include <set>
+#include <unordered_map>
 #include <string>
 #include <vector>
 #include <memory>
@@ -75,14 +76,48 @@ struct ParseRule
 #define MAX_BREAKS_PER_LOOP 256
 #define MAX_SWITCH_DEPTH 64
 
+// FNV-1a dos nomes: resolveLocal/resolveUpvalue comparam primeiro o hash
+// e só comparam a string quando coincide
+FORCE_INLINE uint32 identHash(const char *str, size_t len)
+{
+  uint32 h = 2166136261u;
+  for (size_t i = 0; i < len; i++)
+  {
+    h ^= (uint8)str[i];
+    h *= 16777619u;
+  }
+  return h;
+}
+
+FORCE_INLINE uint32 identHash(const std::string &str)
+{
+  return identHash(str.data(), str.size());
+}
+
 struct Local
 {
   std::string name;
+  uint32 hash;
   int depth;
   bool usedInitLocal;
   bool isCaptured;
+  bool appendTarget; // reads use OP_GET_LOCAL_SHARED, `s += x` uses OP_APPEND_LOCAL
+  bool assigned;     // has an OP_SET_LOCAL after its declaration
+  int capture;       // index in Compiler::captures_, -1 until a closure captures it
+
+  Local() : hash(0), depth(-1), usedInitLocal(false), isCaptured(false), appendTarget(false),
+            assigned(false), capture(-1) {}
 
-  Local() : depth(-1), usedInitLocal(false), isCaptured(false) {}
+  void setName(const std::string &str)
+  {
+    name = str;
+    hash = identHash(str);
+  }
+
+  bool matches(const std::string &str, uint32 strHash) const
+  {
+    return hash == strHash && name == str;
+  }
 
   bool equals(const std::string &str) const
   {
@@ -99,6 +134,16 @@ struct UpvalueInfo
 {
   uint8 index;
   bool isLocal;
+  int capture; // Compiler::captures_ entry of the variable at the end of the chain
+};
+
+// A captured local. Closures copy it by value (UPVALUE_BY_VALUE) while it is
+// never assigned; the first assignment turns every OP_CLOSURE descriptor
+// already emitted for it back into a shared Upvalue.
+struct CaptureInfo
+{
+  bool boxed;
+  std::vector<std::pair<Code *, int>> sites; // flags bytes still UPVALUE_BY_VALUE
 };
 
 struct LoopContext
@@ -229,14 +274,20 @@ private:
   {
     Function *function;
     std::vector<Local> locals;
+    std::vector<UpvalueInfo> upvalues;
   };
 
   std::vector<EnclosingContext> enclosingStack_;
   int upvalueCount_;
   UpvalueInfo upvalues_[MAX_LOCALS];
+  std::vector<CaptureInfo> captures_;
 
   int resolveUpvalue(Token &name);
-  int addUpvalue(uint8 index, bool isLocal);
+  int resolveUpvalueAt(int depth, const std::string &name, uint32 hash);
+  int addUpvalue(int depth, uint8 index, bool isLocal, int capture);
+  void noteAssignment(uint8 setOp, int arg);
+  void boxCapture(int capture);
+  void emitClosure(Function *func, const std::vector<UpvalueInfo> &upvalues);
 
   std::vector<Label> labels;
   std::vector<GotoJump> pendingGotos;
@@ -249,6 +300,14 @@ private:
   std::vector<std::string> errors;
   std::vector<std::string> warnings;
   std::set<std::string> declaredGlobals_;  // Track declared global variable names
+  std::set<std::string> appendTargets_;    // Names built with `s = s + "..."` / `s += "..."` (pre-filter)
+
+  // Ultimo OP_ADD emitido por binary(): onde comeca e acaba o operando
+  // esquerdo e o offset do proprio OP_ADD (ver handle_assignment)
+  int infixLeftStart_ = -1;
+  int lastAddLeftStart_ = -1;
+  int lastAddLeftEnd_ = -1;
+  int lastAddAt_ = -1;
 
   // Global variable indexing for optimization
   std::unordered_map<std::string, uint16> globalIndices_;  // Map global name -> index
@@ -259,7 +318,7 @@ private:
 
   // Token management
   void advance();
-  Token peek(int offset = 0);
+  const Token &peek(int offset = 0);
 
   bool checkNext(TokenType t);
 
@@ -396,7 +455,7 @@ private:
 
   uint8 argumentList();
 
-  void compileFunction(Function *func, bool isProcess);
+  void compileFunction(Function *func, bool isProcess, std::vector<UpvalueInfo> *upvalues = nullptr);
   void compileProcess(const std::string &name);
 
   bool isProcessFunction(const char *name) const;
@@ -419,6 +478,8 @@ private:
 
   void initRules();
   void predeclareGlobals();
+  void scanAppendTargets();
+  bool appendTargetInScope(const std::string &name);
   bool enterSwitchContext();
   void leaveSwitchContext();
   void recoverToCurrentSwitchEnd();
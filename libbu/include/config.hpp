@@ -43,10 +43,73 @@
 #error "USE_COMPUTED_GOTO must be 0 or 1"
 #endif
 
+// Type-specializing quickening of hot opcodes (OP_ADD -> OP_ADD_INT, ...)
+// 1 = generic opcodes rewrite themselves after observing operand types
+// 0 = bytecode is never rewritten (quickened handlers still deoptimize)
+#ifndef BU_ENABLE_QUICKENING
+#define BU_ENABLE_QUICKENING 1
+#endif
+
+// Baseline JIT for hot functions/loops (jit.cpp)
+// 1 = compile hot functions to x86-64 code (Linux only)
+// 0 = interpreter only; Interpreter::setJitEnabled(false) also disables it at runtime
+#ifndef BU_ENABLE_JIT
+#if defined(__x86_64__) && defined(OS_LINUX)
+#define BU_ENABLE_JIT 1
+#else
+#define BU_ENABLE_JIT 0
+#endif
+#endif
+
+// Calls + loop back-edges a function must accumulate before it is compiled
+#ifndef BU_JIT_HOT_THRESHOLD
+#define BU_JIT_HOT_THRESHOLD 1000
+#endif
+
+// Parallel process stepping in update() (process_workers.cpp)
+// 1 = Interpreter::setProcessWorkers(n) steps processes whose bytecode only
+//     touches their own locals/privates on n threads (off until called)
+// 0 = update() is always sequential
+#ifndef BU_ENABLE_PROCESS_WORKERS
+#define BU_ENABLE_PROCESS_WORKERS 1
+#endif
+
+// Structure-of-arrays storage for the drawing privates (PrivateColumns)
+// 1 = x, y, z, graph, angle, size of every Process live in contiguous columns
+//     (blocks of BU_PRIVATE_BLOCK processes), so passes over all processes
+//     read packed memory; the other privates stay inside the Process
+// 0 = all privates inline in Process::privates
+#ifndef BU_ENABLE_PRIVATE_COLUMNS
+#define BU_ENABLE_PRIVATE_COLUMNS 1
+#endif
+
+// Processes per PrivateColumns block (each column of a block is contiguous)
+#ifndef BU_PRIVATE_BLOCK
+#define BU_PRIVATE_BLOCK 256
+#endif
+
+// Pages of the GC object heap (PageAllocator, arena.cpp). Objects up to
+// maxBlockSize are bump-allocated from pages of one size class; after each
+// collection empty pages beyond the next cycle's headroom go back to the OS
+// (madvise), keeping at most BU_HEAP_CACHED_PAGES of them mapped for reuse
+// and unmapping the rest. The page size must be a power of two.
+#ifndef BU_HEAP_PAGE_SIZE
+#define BU_HEAP_PAGE_SIZE (64 * 1024)
+#endif
+
+#ifndef BU_HEAP_CACHED_PAGES
+#define BU_HEAP_CACHED_PAGES 64
+#endif
+
 #ifndef BU_ENABLE_SOCKETS
 #define BU_ENABLE_SOCKETS 1
 #endif
 
+// Native HTTP/1.1 server (builtins_http.cpp), needs sockets
+#ifndef BU_ENABLE_HTTP
+#define BU_ENABLE_HTTP BU_ENABLE_SOCKETS
+#endif
+
 #ifndef BU_ENABLE_FILE_IO
 #define BU_ENABLE_FILE_IO 1
 #endif
@@ -91,6 +154,17 @@
 #define BU_ENABLE_CRYPTO 1
 #endif
 
+// Bulk numeric kernels over Buffers/typed arrays (builtins_vec.cpp)
+#ifndef BU_ENABLE_VEC
+#define BU_ENABLE_VEC 1
+#endif
+
+// Spatial queries over processes: collide / within / nearest (builtins_space.cpp)
+// The grid (spatial_grid.cpp) is only built once a script calls space.*
+#ifndef BU_ENABLE_SPACE
+#define BU_ENABLE_SPACE 1
+#endif
+
 #ifndef BU_ENABLE_NN
 #define BU_ENABLE_NN 1
 #endif
@@ -212,3 +286,27 @@ static inline void aFree(void *mem)
 {
     std::free(mem);
 }
+
+// Politica de alocacao dos containers (Vector/HashMap/HashSet)
+struct HeapAlloc
+{
+    static void *allocate(size_t size) { return aAlloc(size); }
+};
+
+// Payload de objetos do GC (elementos de arrays, maps, sets): o volume alocado
+// soma ao contador da VM dona (Interpreter::payloadAllocated), passado quando
+// o objeto e criado, e entra no ritmo do collector (Interpreter::checkGC)
+struct GCPayloadAlloc
+{
+    size_t *allocated;
+
+    GCPayloadAlloc() : allocated(nullptr) {}
+    explicit GCPayloadAlloc(size_t *counter) : allocated(counter) {}
+
+    void *allocate(size_t size)
+    {
+        if (allocated)
+            *allocated += size;
+        return aAlloc(size);
+    }
+};
@@ -10,6 +10,7 @@
 #include "string.hpp"
 #include "types.hpp"
 #include "vector.hpp"
+#include <mutex>
 #include <new>
 
 #ifdef NDEBUG
@@ -33,6 +34,10 @@ struct Process;
 class Interpreter;
 class Compiler;
 class RuntimeDebugger;
+struct JitCode;
+class ProcessWorkers;
+class SpatialGrid;
+struct NetState;
 
 enum class FieldType : uint8_t
 {
@@ -179,6 +184,10 @@ struct Function
   String *name{nullptr};
   bool hasReturn{false};
   int upvalueCount{0};
+  // Baseline JIT (jit.cpp)
+  uint32 hotCount{0};
+  bool jitFailed{false};
+  JitCode *jit{nullptr};
   ~Function();
 };
 
@@ -240,6 +249,7 @@ struct NativeClassDef
   NativeConstructor constructor;
   NativeDestructor destructor;
   bool persistent;  // If true, instances are not collected by GC
+  bool typedArray{false}; // userData e TypedArrayData: indexavel com a[i]
 
   List<String *, NativeMethod> methods;
   List<String *, NativeProperty> properties;
@@ -346,10 +356,32 @@ struct GCObject
   GCObject(GCObjectType t) : type(t), marked(0), next(nullptr) {}
 };
 
+// Elementos guardados na mesma alocacao do objeto, logo a seguir ao
+// cabecalho. O numero fica fixo a nascenca (fieldCount, argCount, upvalues).
+template <typename T>
+struct InlineArray
+{
+  T *items = nullptr;
+  uint32 count = 0;
+
+  FORCE_INLINE T &operator[](size_t i) { return items[i]; }
+  FORCE_INLINE const T &operator[](size_t i) const { return items[i]; }
+  FORCE_INLINE size_t size() const { return count; }
+  FORCE_INLINE T *data() { return items; }
+
+  // items aponta para owner + 1: o bloco tem sizeof(Owner) + n * sizeof(T)
+  template <typename Owner>
+  FORCE_INLINE void attach(Owner *owner, uint32 n)
+  {
+    items = reinterpret_cast<T *>(owner + 1);
+    count = n;
+  }
+};
+
 struct StructInstance : GCObject
 {
   StructDef *def;
-  Vector<Value> values;
+  InlineArray<Value> values;
 
   StructInstance() : GCObject(GCObjectType::STRUCT) {}
 };
@@ -357,7 +389,7 @@ struct StructInstance : GCObject
 struct ClassInstance : GCObject
 {
   ClassDef *klass;
-  Vector<Value> fields;
+  InlineArray<Value> fields;
   void *nativeUserData{nullptr};  // Native data when inheriting from NativeClass
 
   ClassInstance() : GCObject(GCObjectType::CLASS) {}
@@ -432,9 +464,9 @@ struct ClassInstance : GCObject
 
 struct ArrayInstance : GCObject
 {
-  Vector<Value> values;
+  Vector<Value, GCPayloadAlloc> values;
 
-  ArrayInstance() : GCObject(GCObjectType::ARRAY) {}
+  explicit ArrayInstance(size_t *payload) : GCObject(GCObjectType::ARRAY), values(GCPayloadAlloc(payload)) {}
 };
 
 enum class BufferType : uint8
@@ -461,18 +493,104 @@ struct BufferInstance : GCObject
   ~BufferInstance();
 };
 
+// Storage dos typed arrays (Uint8Array ... Float64Array), guardado em
+// NativeClassInstance::userData. OP_GET_INDEX/OP_SET_INDEX e o JIT leem
+// direto daqui quando klass->typedArray esta ligado.
+struct TypedArrayData
+{
+  BufferType type;
+  int count;
+  int capacity;
+  int elementSize;
+  uint8 *data;
+};
+
+FORCE_INLINE Value typedArrayLoad(const TypedArrayData *ta, int index)
+{
+  const uint8 *ptr = ta->data + (size_t)index * (size_t)ta->elementSize;
+  Value v;
+  switch (ta->type)
+  {
+  case BufferType::UINT8:
+    v.type = ValueType::INT;
+    v.as.integer = *ptr;
+    break;
+  case BufferType::INT16:
+    v.type = ValueType::INT;
+    v.as.integer = *(const int16 *)ptr;
+    break;
+  case BufferType::UINT16:
+    v.type = ValueType::INT;
+    v.as.integer = *(const uint16 *)ptr;
+    break;
+  case BufferType::INT32:
+    v.type = ValueType::INT;
+    v.as.integer = *(const int32 *)ptr;
+    break;
+  case BufferType::UINT32:
+    v.type = ValueType::UINT;
+    v.as.unsignedInteger = *(const uint32 *)ptr;
+    break;
+  case BufferType::FLOAT:
+    v.type = ValueType::DOUBLE;
+    v.as.number = *(const float *)ptr;
+    break;
+  default:
+    v.type = ValueType::DOUBLE;
+    v.as.number = *(const double *)ptr;
+    break;
+  }
+  return v;
+}
+
+// value tem de ser numero (isNumber); ints nao passam por double
+FORCE_INLINE void typedArrayStore(TypedArrayData *ta, int index, const Value &value)
+{
+  uint8 *ptr = ta->data + (size_t)index * (size_t)ta->elementSize;
+  if (ta->type == BufferType::DOUBLE)
+  {
+    *(double *)ptr = value.asNumber();
+    return;
+  }
+  if (ta->type == BufferType::FLOAT)
+  {
+    *(float *)ptr = (float)value.asNumber();
+    return;
+  }
+
+  int64_t n = value.isInt() ? (int64_t)value.asInt() : (int64_t)value.asNumber();
+  switch (ta->type)
+  {
+  case BufferType::UINT8:
+    *ptr = (uint8)n;
+    break;
+  case BufferType::INT16:
+    *(int16 *)ptr = (int16)n;
+    break;
+  case BufferType::UINT16:
+    *(uint16 *)ptr = (uint16)n;
+    break;
+  case BufferType::INT32:
+    *(int32 *)ptr = (int32)n;
+    break;
+  default:
+    *(uint32 *)ptr = (uint32)n;
+    break;
+  }
+}
+
 struct MapInstance : GCObject
 {
-  HashMap<Value, Value, ValueHasher, ValueEq> table;
+  HashMap<Value, Value, ValueHasher, ValueEq, GCPayloadAlloc> table;
 
-  MapInstance() : GCObject(GCObjectType::MAP) {}
+  explicit MapInstance(size_t *payload) : GCObject(GCObjectType::MAP), table(GCPayloadAlloc(payload)) {}
 };
 
 struct SetInstance : GCObject
 {
-  HashSet<Value, ValueHasher, ValueEq> table;
+  HashSet<Value, ValueHasher, ValueEq, GCPayloadAlloc> table;
 
-  SetInstance() : GCObject(GCObjectType::SET) {}
+  explicit SetInstance(size_t *payload) : GCObject(GCObjectType::SET), table(GCPayloadAlloc(payload)) {}
 };
 
 struct NativeClassInstance : GCObject
@@ -502,15 +620,19 @@ struct Upvalue : GCObject
 
   Upvalue(Value *loc);
 };
+// Upvalue i: upvalues[i] partilhado (variavel reatribuida algures) ou, se
+// nullptr, captured()[i] com a copia feita no OP_CLOSURE (UPVALUE_BY_VALUE).
+// O bloco tem sizeof(Closure) + n * (sizeof(Value) + sizeof(Upvalue *)):
+// primeiro os n Values, depois os n ponteiros de upvalues.
 struct Closure : GCObject
 {
   int functionId;
   int upvalueCount;
-  Vector<Upvalue *> upvalues;
+  InlineArray<Upvalue *> upvalues;
 
-  Closure();
+  FORCE_INLINE Value *captured() { return reinterpret_cast<Value *>(this + 1); }
 
-  ~Closure();
+  Closure();
 };
 
 struct CallFrame
@@ -521,6 +643,20 @@ struct CallFrame
   Closure *closure{nullptr};
 };
 
+// Processos visiveis de um render(), em arrays paralelos (indice i = procs[i]).
+// Os valores vem dos privates (x, y, angle, size, graph) ja convertidos;
+// so sao validos durante a chamada a onRenderBatch.
+struct ProcessRenderBatch
+{
+  size_t count = 0;
+  Process *const *procs = nullptr;
+  const float *x = nullptr;
+  const float *y = nullptr;
+  const float *angle = nullptr;
+  const float *size = nullptr;
+  const int *graph = nullptr;
+};
+
 struct VMHooks
 {
   void (*onCreate)(Interpreter *vm, Process *p) = nullptr;
@@ -528,6 +664,14 @@ struct VMHooks
   void (*onUpdate)(Interpreter *vm,Process *p, float dt) = nullptr;
   void (*onRender)(Interpreter *vm,Process *p) = nullptr;
   void (*onDestroy)(Interpreter *vm,Process *p, int exitCode) = nullptr;
+
+  // Batched variants: one call per update()/render() instead of one per
+  // process. onUpdateBatch gets every process onUpdate would have seen this
+  // update(), in the same order; onRenderBatch gets the drawable processes.
+  // Both can be set together with the per-process hooks. Don't call
+  // update()/render() from inside them.
+  void (*onUpdateBatch)(Interpreter *vm, Process *const *procs, size_t count, float dt) = nullptr;
+  void (*onRenderBatch)(Interpreter *vm, const ProcessRenderBatch &batch) = nullptr;
 };
 
 struct ProcessResult
@@ -535,8 +679,10 @@ struct ProcessResult
   enum Reason : uint8
   {
     PROCESS_FRAME, // frame(N)
+    PROCESS_WAIT,  // native suspended the process (IO/timer), state already set
     CALL_RETURN,   // return to native C++ caller boundary
     PROCESS_DONE,    // return/end
+    PROCESS_HANDOFF, // parallel step stopped before an op that needs the main thread
     ERROR
   };
 
@@ -630,10 +776,49 @@ struct ProcessDef : public ProcessExec
   Vector<uint8> argsNames;
   String *name{nullptr};
   Value privates[MAX_PRIVATES];
+  int8 parallelSafe{-1}; // bytecode only touches locals/privates (-1 = not checked yet)
+  bool freshStart{false}; // only the entry frame, empty stack (set by finalize)
   void finalize();
   void release();
 };
 
+// Privates 0..PRIVATE_COLUMNS-1 (x, y, z, graph, angle, size) em colunas
+static constexpr int PRIVATE_COLUMNS = (int)PrivateIndex::SIZE + 1;
+static constexpr int PRIVATE_BLOCK = BU_PRIVATE_BLOCK;
+
+#if BU_ENABLE_PRIVATE_COLUMNS
+// Colunas dos privates de desenho de todos os Process. Cada bloco guarda
+// PRIVATE_BLOCK processos com cada coluna seguida em memoria; os blocos nunca
+// mudam de sitio, por isso o Process guarda um ponteiro direto para o seu slot
+// (workers e JIT incluidos). Um slot pertence ao Process enquanto o objeto
+// existe: reciclar no ProcessPool nao o devolve.
+//
+// Partilhado por todas as VMs do processo, como o ProcessPool de onde vem o
+// Process (que passa de uma VM para outra ao ser reciclado). acquire() e
+// release() tomam o lock, porque VMs em threads diferentes criam e apagam
+// Process ao mesmo tempo. Ler ou escrever um slot nao toma lock: cada slot so
+// e usado pelo seu Process.
+class PrivateColumns
+{
+public:
+  static PrivateColumns &instance();
+
+  Value *acquire(); // slot na coluna 0; a coluna i esta em slot[i * PRIVATE_BLOCK]
+  void release(Value *slot);
+
+private:
+  struct Block
+  {
+    Value cols[PRIVATE_COLUMNS][PRIVATE_BLOCK];
+  };
+
+  std::mutex mutex;
+  Vector<Block *> blocks;
+  Vector<Value *> freeSlots;
+  int nextInBlock{PRIVATE_BLOCK};
+};
+#endif
+
 struct Process : public ProcessExec
 {
 
@@ -641,17 +826,59 @@ struct Process : public ProcessExec
   uint32 id{0};
   int blueprint{-1}; // Index of the ProcessDef that is this process's blueprint
   void *userData{nullptr}; 
-  Value privates[MAX_PRIVATES];
+  Value privates[MAX_PRIVATES]; // com colunas, 0..PRIVATE_COLUMNS-1 nao sao usados: ler via priv()
+
+#if BU_ENABLE_PRIVATE_COLUMNS
+  Value *columns{nullptr}; // slot deste processo em PrivateColumns
+
+  Process();
+  ~Process();
+#endif
 
   int exitCode = 0;
 
+  int64_t gridCell{0}; // SpatialGrid: celula atual
+  int32_t gridSlot{-1}; // indice dentro da celula (-1 = fora da grelha)
+
   bool initialized = false;
+  bool parallelStep = false;  // being stepped on a worker thread right now
+  bool batchStepped = false;  // already stepped by the parallel batch this update()
+
+  FORCE_INLINE Value &priv(int index)
+  {
+#if BU_ENABLE_PRIVATE_COLUMNS
+    if (index < PRIVATE_COLUMNS)
+      return columns[index * PRIVATE_BLOCK];
+#endif
+    return privates[index];
+  }
 
   void release();
 
   void reset();
 };
 
+// Retrato do heap do GC (gc.stats()): objetos por tipo, com payload
+struct GCKindStats
+{
+  size_t count = 0;
+  size_t bytes = 0; // cabecalho + elementos (capacidade reservada)
+  size_t allocated = 0; // criados desde o inicio (contador do arena)
+};
+
+struct GCStats
+{
+  GCKindStats kinds[(int)GCObjectType::UPVALUE + 1];
+  size_t stringBytes = 0;
+  size_t heapBytes = 0; // objetos + payload + strings
+  size_t nextGC = 0;
+  size_t collections = 0;
+  size_t lastFreed = 0;
+  size_t heapPages = 0;    // paginas do arena em uso
+  size_t heapReserved = 0; // paginas em uso + vazias guardadas para o proximo ciclo
+  size_t heapReleased = 0; // devolvido ao SO pelo arena.Sweep()
+};
+
 class Interpreter
 {
 
@@ -688,6 +915,12 @@ class Interpreter
   size_t totalNativeStructs = 0;
   size_t totalNativeClasses = 0;
   size_t nextGC = 1024 * 1024;
+  size_t payloadAllocated = 0; // payload de containers desta VM (GCPayloadAlloc), acumulado
+  size_t payloadMark = 0;   // payloadAllocated na ultima recolha
+  size_t stringMark = 0;    // bytes do StringPool na ultima recolha
+  size_t livePayload = 0;   // payload dos objetos que sobreviveram ao ultimo sweep
+  size_t gcCollections = 0;
+  size_t gcLastFreed = 0;
   static constexpr size_t MIN_GC_THRESHOLD = 512 * 1024;         
   static constexpr size_t MAX_GC_THRESHOLD = 512 * 1024 * 1024;  
   static constexpr double GC_GROWTH_FACTOR = 2.0;
@@ -706,6 +939,8 @@ class Interpreter
   Vector<Value> globalsArray;                                    // OPTIMIZATION: Direct indexed access
   HashMap<String *, uint16, StringHasher, StringEq> nativeGlobalIndices; // Native name -> globalsArray index
   Vector<String*> globalIndexToName_;                            // For debug: index -> name mapping (VM strings)
+  Vector<String*> scriptArgs_;                                   // setArgs(): ARGV e recriado a cada reset()
+  bool hasScriptArgs_{false};
 
   // Plugin system internals
   static constexpr int MAX_PLUGIN_PATHS = 8;
@@ -725,8 +960,22 @@ class Interpreter
 
   Vector<Process *> aliveProcesses;
   Vector<Process *> cleanProcesses;
+  Vector<Process *> parallelBatch;
+  ProcessWorkers *workers_{nullptr};
+
+  // Modulo space: criada no primeiro space.*, atualizada pelo update()
+  SpatialGrid *spatialGrid_{nullptr};
+
+  // Modulo socket: pool HTTP keep-alive e cache DNS desta VM
+  NetState *netState_{nullptr};
 
-  HeapAllocator arena;
+  // VMHooks::onUpdateBatch / onRenderBatch (reusados entre frames)
+  Vector<Process *> updateBatch;
+  Vector<Process *> renderProcs;
+  Vector<float> renderX, renderY, renderAngle, renderSize;
+  Vector<int> renderGraph;
+
+  PageAllocator arena;
 
   StringPool stringPool;
 
@@ -746,6 +995,8 @@ class Interpreter
   bool hasFatalError_;
   bool debugMode_;
   RuntimeDebugger *debugger_{nullptr};
+  bool jitEnabled_{BU_ENABLE_JIT != 0};
+  bool nativeYield_{false}; // set by suspendCurrentProcess(), consumed after the native returns
 
   Compiler *compiler;
   FileLoaderCallback fileLoaderCallback_ = nullptr;
@@ -790,6 +1041,10 @@ class Interpreter
   void addFunctionsClasses(Function *fun);
   bool findAndJumpToHandler(Value error, uint8 *&ip, ProcessExec *fiber);
 
+  // Baseline JIT (jit.cpp)
+  bool jitCompile(Function *func);
+  uint8 *jitRun(Function *func, ProcessExec *fiber, Process *process, Value *slots, uint8 *ip);
+
   friend class Compiler;
   friend class ModuleBuilder;
   friend class RuntimeDebugger;
@@ -800,13 +1055,23 @@ class Interpreter
   size_t countObjects() const;
   void clearAllGCObjects();
 
-  FORCE_INLINE ClassInstance *creatClass()
+  // Cabecalho + fields numa so alocacao; fields com os defaults da classe
+  FORCE_INLINE ClassInstance *creatClass(ClassDef *klass)
   {
 
     checkGC();
-    size_t size = sizeof(ClassInstance);
-    void *mem = (MapInstance *)arena.Allocate(size); // 40kb
+    uint32 fieldCount = (uint32)klass->fieldCount;
+    size_t size = sizeof(ClassInstance) + fieldCount * sizeof(Value);
+    void *mem = arena.Allocate(size, (uint8)GCObjectType::CLASS);
     ClassInstance *instance = new (mem) ClassInstance();
+    instance->klass = klass;
+    instance->fields.attach(instance, fieldCount);
+
+    uint32 defaults = (uint32)klass->fieldDefaults.size();
+    for (uint32 i = 0; i < fieldCount; i++)
+    {
+      instance->fields[i] = i < defaults ? klass->fieldDefaults[i] : makeNil();
+    }
 
     totalClasses++;
     instance->next = gcObjects;
@@ -821,7 +1086,7 @@ class Interpreter
   {
     checkGC();
     size_t size = sizeof(Upvalue);
-    void *mem = arena.Allocate(size);
+    void *mem = arena.Allocate(size, (uint8)GCObjectType::UPVALUE);
     Upvalue *upvalue = new (mem) Upvalue(loc);
 
     upvalue->next = (Upvalue *)gcObjects;
@@ -837,19 +1102,31 @@ class Interpreter
   {
     size_t size = sizeof(Upvalue);
     upvalue->~Upvalue();
-    arena.Free(upvalue, size);
+    arena.Free(upvalue, size, (uint8)GCObjectType::UPVALUE);
     totalAllocated -= size;
     totalUpvalues--;
   }
 
-  FORCE_INLINE Closure *createClosure()
+  // OP_APPEND_LOCAL: `left + right` quando left e string, guardado de volta
+  // na local slot. Devolve false se nao for concatenacao (segue OP_ADD).
+  bool appendToLocal(Value *slot, Value &left, const Value &right, bool discarded);
+
+  FORCE_INLINE Closure *createClosure(int upvalueCount)
   {
     checkGC();
-    size_t size = sizeof(Closure);
-    void *mem = arena.Allocate(size);
+    size_t size = sizeof(Closure) + upvalueCount * (sizeof(Value) + sizeof(Upvalue *));
+    void *mem = arena.Allocate(size, (uint8)GCObjectType::CLOSURE);
     Closure *closure = new (mem) Closure();
     closure->type = GCObjectType::CLOSURE;
     closure->marked = 0;
+    closure->upvalueCount = upvalueCount;
+    closure->upvalues.items = reinterpret_cast<Upvalue **>(closure->captured() + upvalueCount);
+    closure->upvalues.count = (uint32)upvalueCount;
+    for (int i = 0; i < upvalueCount; i++)
+    {
+      new (&closure->captured()[i]) Value();
+      closure->upvalues[i] = nullptr;
+    }
 
     closure->next = gcObjects;
     gcObjects = closure;
@@ -861,15 +1138,15 @@ class Interpreter
   FORCE_INLINE void freeClosure(Closure *c)
   {
 
-    size_t size = sizeof(Closure);
+    size_t size = sizeof(Closure) + c->upvalues.size() * (sizeof(Value) + sizeof(Upvalue *));
     c->~Closure();
-    arena.Free(c, size);
+    arena.Free(c, size, (uint8)GCObjectType::CLOSURE);
     totalAllocated -= size;
   }
 
   FORCE_INLINE void freeClass(ClassInstance *c)
   {
-    size_t size = sizeof(ClassInstance);
+    size_t size = sizeof(ClassInstance) + c->fields.size() * sizeof(Value);
     
     // If inheriting from NativeClass, call native destructor
     if (c->nativeUserData)
@@ -883,21 +1160,28 @@ class Interpreter
       // The arena cleans up automatically on shutdown
     }
     
-    c->fields.destroy();
     c->klass = nullptr;
     c->~ClassInstance();
-    arena.Free(c, size);
+    arena.Free(c, size, (uint8)GCObjectType::CLASS);
     totalAllocated -= size;
     totalClasses--;
   }
 
-  FORCE_INLINE StructInstance *createStruct()
+  // Cabecalho + valores numa so alocacao, todos a nil
+  FORCE_INLINE StructInstance *createStruct(StructDef *def)
   {
     checkGC();
-    size_t size = sizeof(StructInstance);
-    void *mem = (StructInstance *)arena.Allocate(size); // 40kb
+    uint32 count = (uint32)def->argCount;
+    size_t size = sizeof(StructInstance) + count * sizeof(Value);
+    void *mem = arena.Allocate(size, (uint8)GCObjectType::STRUCT);
     StructInstance *instance = new (mem) StructInstance();
     instance->marked = 0;
+    instance->def = def;
+    instance->values.attach(instance, count);
+    for (uint32 i = 0; i < count; i++)
+    {
+      instance->values[i] = makeNil();
+    }
     totalAllocated += size;
     totalStructs++;
 
@@ -909,19 +1193,18 @@ class Interpreter
 
   FORCE_INLINE void freeStruct(StructInstance *s)
   {
-    size_t size = sizeof(StructInstance);
-    s->values.destroy();
+    size_t size = sizeof(StructInstance) + s->values.size() * sizeof(Value);
     s->~StructInstance();
     totalStructs--;
-    arena.Free(s, size);
+    arena.Free(s, size, (uint8)GCObjectType::STRUCT);
     totalAllocated -= size;
   }
   FORCE_INLINE ArrayInstance *createArray()
   {
     checkGC();
     size_t size = sizeof(ArrayInstance);
-    void *mem = (ArrayInstance *)arena.Allocate(size); // 32kb
-    ArrayInstance *instance = new (mem) ArrayInstance();
+    void *mem = (ArrayInstance *)arena.Allocate(size, (uint8)GCObjectType::ARRAY); // 32kb
+    ArrayInstance *instance = new (mem) ArrayInstance(&payloadAllocated);
 
     instance->next = gcObjects;
     gcObjects = instance;
@@ -941,7 +1224,7 @@ class Interpreter
     // size += a->values.capacity() * sizeof(Value);
     a->values.destroy();
     a->~ArrayInstance();
-    arena.Free(a, size);
+    arena.Free(a, size, (uint8)GCObjectType::ARRAY);
     totalAllocated -= size;
     totalArrays--;
   }
@@ -953,8 +1236,8 @@ class Interpreter
   {
     checkGC();
     size_t size = sizeof(MapInstance);
-    void *mem = (MapInstance *)arena.Allocate(size); // 40kb
-    MapInstance *instance = new (mem) MapInstance();
+    void *mem = (MapInstance *)arena.Allocate(size, (uint8)GCObjectType::MAP); // 40kb
+    MapInstance *instance = new (mem) MapInstance(&payloadAllocated);
     instance->marked = 0;
 
     instance->next = gcObjects;
@@ -974,15 +1257,15 @@ class Interpreter
 
     m->table.destroy();
     m->~MapInstance();
-    arena.Free(m, size);
+    arena.Free(m, size, (uint8)GCObjectType::MAP);
   }
 
   FORCE_INLINE SetInstance *createSet()
   {
     checkGC();
     size_t size = sizeof(SetInstance);
-    void *mem = arena.Allocate(size);
-    SetInstance *instance = new (mem) SetInstance();
+    void *mem = arena.Allocate(size, (uint8)GCObjectType::SET);
+    SetInstance *instance = new (mem) SetInstance(&payloadAllocated);
     instance->marked = 0;
     instance->next = gcObjects;
     gcObjects = instance;
@@ -998,7 +1281,7 @@ class Interpreter
     totalSets--;
     s->table.destroy();
     s->~SetInstance();
-    arena.Free(s, size);
+    arena.Free(s, size, (uint8)GCObjectType::SET);
   }
 
   FORCE_INLINE NativeClassInstance *createNativeClass(bool persistent = false)
@@ -1006,7 +1289,7 @@ class Interpreter
 
     checkGC();
     size_t size = sizeof(NativeClassInstance);
-    void *mem = (NativeClassInstance *)arena.Allocate(size); // 32kb
+    void *mem = (NativeClassInstance *)arena.Allocate(size, (uint8)GCObjectType::NATIVE_CLASS); // 32kb
     NativeClassInstance *instance = new (mem) NativeClassInstance();
     instance->persistent = persistent;
 
@@ -1039,7 +1322,7 @@ class Interpreter
     size_t size = sizeof(NativeClassInstance);
     totalAllocated -= size;
     n->~NativeClassInstance();
-    arena.Free(n, size);
+    arena.Free(n, size, (uint8)GCObjectType::NATIVE_CLASS);
     totalNativeClasses--;
   }
 
@@ -1047,7 +1330,7 @@ class Interpreter
   {
     checkGC();
     size_t size = sizeof(NativeStructInstance);
-    void *mem = (NativeStructInstance *)arena.Allocate(size); // 32kb
+    void *mem = (NativeStructInstance *)arena.Allocate(size, (uint8)GCObjectType::NATIVE_STRUCT); // 32kb
     NativeStructInstance *instance = new (mem) NativeStructInstance();
     instance->persistent = persistent;
     totalAllocated += size;
@@ -1072,11 +1355,11 @@ class Interpreter
   {
     if (n->def && n->def->destructor)
         n->def->destructor(this, n->data);
-    if (n->data) { arena.Free(n->data, n->def->structSize); n->data = nullptr; }
+    if (n->data) { arena.Free(n->data, n->def->structSize, (uint8)GCObjectType::NATIVE_STRUCT); n->data = nullptr; }
     size_t size = sizeof(NativeStructInstance);
     totalAllocated -= size;
     n->~NativeStructInstance();
-    arena.Free(n, size);
+    arena.Free(n, size, (uint8)GCObjectType::NATIVE_STRUCT);
     totalNativeStructs--;
   }
 
@@ -1085,6 +1368,7 @@ class Interpreter
   void markObject(GCObject *obj);
   void sweep();
   void freeObject(GCObject *obj);
+  size_t payloadBytes(GCObject *obj) const;
 
   // Immediately unlink from gcObjects and free completely.
   // Returns true if the object was found and freed.
@@ -1129,6 +1413,17 @@ public:
   void detachDebugger() { debugger_ = nullptr; }
   RuntimeDebugger *getDebugger() const { return debugger_; }
 
+  // Baseline JIT (no-op when built with BU_ENABLE_JIT=0)
+  void setJitEnabled(bool enabled) { jitEnabled_ = enabled && BU_ENABLE_JIT; }
+  bool isJitEnabled() const { return jitEnabled_; }
+
+  // Parallel update(): processes whose blueprint only touches its own
+  // locals/privates are stepped on `threads` threads (caller included).
+  // 0/1 = sequential (default), < 0 = one per hardware thread.
+  // No-op when built with BU_ENABLE_PROCESS_WORKERS=0.
+  void setProcessWorkers(int threads);
+  int getProcessWorkers() const;
+
   void setFileLoader(FileLoaderCallback loader, void *userdata = nullptr);
 
   NativeClassDef *registerNativeClass(const char *name, NativeConstructor ctor,
@@ -1153,6 +1448,10 @@ public:
   ProcessDef *addProcess(const char *name, Function *func);
   void destroyProcess(Process *proc);
   Process *spawnProcess(ProcessDef *proc);
+  void bindProcessArgs(Process *instance, ProcessDef *blueprint, const Value *args, int argCount);
+  // spawn + args + ID/FATHER + onCreate (OP_CALL, callProcess, spawn_many)
+  Process *spawnWithArgs(ProcessDef *blueprint, const Value *args, int argCount, Value father);
+  void reserveProcesses(size_t extra);
 
   StructDef *addStruct(String *nam, int *id);
 
@@ -1178,9 +1477,34 @@ public:
 
   uint32 getTotalProcesses() const;
   uint32 getTotalAliveProcesses() const;
+  // Grelha de colisoes (modulo space); criada e preenchida na primeira chamada
+  SpatialGrid *getSpatialGrid();
+  void setSpatialGrid(float cellSize, float radius);
+
+  ProcessDef *getProcessDef(int index) const
+  {
+    return (index >= 0 && index < (int)processes.size()) ? processes[index] : nullptr;
+  }
   Process *findProcessById(uint32 id);
   const Vector<Process *>& getAliveProcesses() const { return aliveProcesses; }
 
+  // Native-driven suspension (IO, timers).
+  // A native running on a scheduled process can park it: the native returns
+  // normally, its return value lands in the call's result slot and the process
+  // yields right after the call. Not available on the main process or inside
+  // C++ -> script calls, where natives must block instead.
+  bool canSuspendCurrentProcess() const;
+  // seconds < 0: park until wakeProcess(); otherwise resume after `seconds`
+  bool suspendCurrentProcess(float seconds);
+  // Stack index of the result slot of the native call whose args are `args`
+  int nativeResultSlot(const Value *args);
+  // Replaces the parked call's return value and makes the process runnable.
+  // False if the process is gone (killed while waiting).
+  bool wakeProcess(uint32 processId, int resultSlot, const Value &result);
+  // Seconds until some process (other than the current one) can run: 0 if one
+  // is runnable now, -1 if every process is parked or frozen
+  float timeUntilNextWake() const;
+
   void destroyFunction(Function *func);
 
   int registerNative(const char *name, NativeFunction func, int arity);
@@ -1201,8 +1525,16 @@ public:
   void registerRegex();
   void registerZip();
   void registerSocket();
+#ifdef BU_ENABLE_SOCKETS
+  NetState *getNetState();
+  void freeNetState();
+#endif
+  void registerHttp();
   void registerCrypto();
   void registerNN();
+  void registerVec();
+  void registerSpace();
+  void registerGC();
   void registerAll();
 
   Function *addFunction(const char *name, int arity = 0);
@@ -1212,6 +1544,10 @@ public:
 
   void run_process_step(Process *proc);
   ProcessResult run_process(Process *process);
+  bool isParallelSafe(ProcessDef *def);
+  void runParallelBatch(Process *skip);
+  void renderBatch(); // VMHooks::onRenderBatch
+  static void parallelStepTask(void *ctx, size_t index);
 
   float getCurrentTime() const;
 
@@ -1248,12 +1584,16 @@ public:
   void render();
 
   size_t getTotalAlocated() { return totalAllocated; }
+
+  // Payload alocado fora de GCPayloadAlloc (ex.: typed arrays) para o ritmo do GC
+  void notePayload(size_t bytes) { payloadAllocated += bytes; }
   size_t getTotalClasses() { return totalClasses; }
   size_t getTotalStructs() { return totalStructs; }
   size_t getTotalArrays() { return totalArrays; }
   size_t getTotalMaps() { return totalMaps; }
   size_t getTotalSets() { return totalSets; }
   size_t getTotalNativeClasses() { return totalNativeClasses; }
+  void getGCStats(GCStats &out);
   size_t getTotalNativeStructs() { return totalNativeStructs; }
 
   void killAliveProcess();
@@ -1290,6 +1630,7 @@ public:
 
   // Set script arguments (available as global ARGV array)
   void setArgs(int argc, char *argv[]);
+  void buildArgs();
 
   // ===== ARRAY EXTRACTION HELPERS (for native bindings - no allocation) =====
   // Extract values from a BuLang array to a C buffer (stack-allocated by caller)
@@ -1353,19 +1694,19 @@ public:
   bool isNil(int index);
 
   // ====== VALUE ====
-  Value makeClosure()
+  Value makeClosure(int upvalueCount)
   {
     Value v;
     v.type = ValueType::CLOSURE;
-    v.as.closure = createClosure();
+    v.as.closure = createClosure(upvalueCount);
     return v;
   }
 
-  FORCE_INLINE Value makeClassInstance()
+  FORCE_INLINE Value makeClassInstance(ClassDef *klass)
   {
     Value v;
     v.type = ValueType::CLASSINSTANCE;
-    v.as.sClass = creatClass();
+    v.as.sClass = creatClass(klass);
     return v;
   }
 
@@ -1385,11 +1726,11 @@ public:
     return v;
   }
 
-  FORCE_INLINE Value makeStructInstance()
+  FORCE_INLINE Value makeStructInstance(StructDef *def)
   {
     Value v;
     v.type = ValueType::STRUCTINSTANCE;
-    v.as.sInstance = createStruct();
+    v.as.sInstance = createStruct(def);
     return v;
   }
   FORCE_INLINE Value makeBuffer(int count, int typeRaw)
@@ -1454,6 +1795,15 @@ public:
     return v;
   }
 
+  // Chave guardada num map/set: transients (concat) passam a interned, a
+  // chave nao pode ser libertada nem crescer no sitio depois de guardada
+  FORCE_INLINE Value mapKey(const Value &key)
+  {
+    if (key.isString() && key.asString()->isTransient())
+      return makeString(stringPool.intern(key.asString()));
+    return key;
+  }
+
   FORCE_INLINE Value makeNil()
   {
     Value v;
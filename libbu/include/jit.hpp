@@ -0,0 +1,48 @@
+#pragma once
+
+#include "config.hpp"
+#include "value.hpp"
+
+// ============================================
+// JIT baseline (x86-64, System V)
+//
+// Funcoes quentes sao traduzidas uma vez para uma sequencia plana de chamadas
+// nativas/moves inline, um bloco por instrucao de bytecode. O codigo nativo
+// usa a mesma stack do ProcessExec e a mesma CallFrame do interpretador e sai
+// sempre com o offset exato de bytecode onde o interpretador retoma:
+// chamadas, returns, alocacao, excecoes e tudo o que o tradutor nao cobre
+// ficam a cargo do interpretador, como de costume.
+// ============================================
+
+// Estado partilhado entre o interpretador e o codigo nativo.
+// rbx aponta para esta struct durante toda a execucao nativa.
+struct JitState
+{
+  Value *stackTop;        // entrada/saida
+  Value *slots;           // frame->slots
+  Value *globals;         // globalsArray.data()
+  Value *privates;        // process->privates
+  Value *columns;         // process->columns (BU_ENABLE_PRIVATE_COLUMNS)
+  const Value *constants; // func->chunk->constants.data
+  uint32 pc;              // saida: offset de bytecode onde o interpretador retoma
+};
+
+typedef void (*JitEntryFn)(JitState *state, const uint8 *target);
+
+struct JitCode
+{
+  uint8 *mem{nullptr};      // mmap RX (leitura + execucao)
+  size_t size{0};
+  int32 *entries{nullptr};  // offset de bytecode -> offset nativo (-1 = sem entrada)
+  uint32 codeSize{0};       // chunk->count no momento da compilacao
+
+  // Devolve nullptr quando o offset nao tem bloco nativo (opcode nao suportado).
+  FORCE_INLINE const uint8 *entryAt(uint32 offset) const
+  {
+    if (offset >= codeSize || entries[offset] < 0)
+      return nullptr;
+    return mem + entries[offset];
+  }
+};
+
+void jitFreeCode(JitCode *code);
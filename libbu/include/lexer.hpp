@@ -2,7 +2,6 @@
 
 #include "token.hpp"
 #include <vector>
-#include <unordered_map>
 #include <string>
 
 
@@ -36,8 +35,6 @@ private:
     int pendingErrorLine;
     int pendingErrorColumn;
 
-    std::unordered_map<std::string, TokenType> keywords;
-
     // Helper methods
     bool isAtEnd() const;
     char advance();
@@ -49,7 +46,8 @@ private:
     void skipWhitespace();
 
     int readHexDigit();
-    Token makeToken(TokenType type, const std::string &lexeme);
+    Token makeToken(TokenType type, std::string lexeme);
+    Token makeSourceToken(TokenType type);
     Token errorToken(const std::string &message);
 
 
@@ -59,6 +57,4 @@ private:
     Token verbatimString();
     Token fstring();
     Token identifier();
-
-    void initKeywords();
 };
\ No newline at end of file
@@ -43,8 +43,8 @@
 #include <cassert>
 #include <cstring>
 
-template <typename K, typename V, typename Hasher, typename Eq>
-struct HashMap
+template <typename K, typename V, typename Hasher, typename Eq, typename Alloc = HeapAlloc>
+struct HashMap : private Alloc
 {
   enum State : uint8
   {
@@ -69,6 +69,7 @@ struct HashMap
   static constexpr float MAX_LOAD = 0.75f;
 
   HashMap() {}
+  explicit HashMap(const Alloc &alloc) : Alloc(alloc) {}
 
   ~HashMap() { destroy(); }
 
@@ -139,7 +140,7 @@ struct HashMap
     Entry *old = entries;
     size_t oldCap = capacity;
 
-    entries = (Entry *)aAlloc(newCap * sizeof(Entry));
+    entries = (Entry *)Alloc::allocate(newCap * sizeof(Entry));
     std::memset(entries, 0, newCap * sizeof(Entry)); // State = EMPTY = 0
 
     capacity = newCap;
@@ -120,7 +120,7 @@ enum Opcode : uint8
     //new type buffer
     OP_NEW_BUFFER = 82,
     OP_FREE = 83,
-    OP_CLOSURE = 84,
+    OP_CLOSURE = 84, // [const16] + [flags][index] por upvalue (UPVALUE_*)
     OP_GET_UPVALUE = 85,
     OP_SET_UPVALUE = 86,
     OP_CLOSE_UPVALUE = 87,
@@ -144,4 +144,42 @@ enum Opcode : uint8
     // Debug (94) — never emitted by compiler, injected at runtime by debugger
     OP_BREAKPOINT = 94,
 
+    // Quickened variants (95-101) — never emitted by compiler.
+    // Generic opcodes rewrite themselves in place after observing their
+    // operand types, and rewrite back to the generic form when a guard fails.
+    OP_ADD_INT = 95,
+    OP_ADD_DOUBLE = 96,
+    OP_SUBTRACT_INT = 97,
+    OP_SUBTRACT_DOUBLE = 98,
+    OP_LESS_INT = 99,
+    OP_LESS_DOUBLE = 100,
+    OP_GET_INDEX_ARRAY = 101,
+
+    // String append on locals (102-103) — emitted only for locals the compiler
+    // flagged as append targets (`s = s + x` / `s += x` with a string).
+    OP_APPEND_LOCAL = 102,     // OP_ADD that grows an owned string in place; always followed by OP_SET_LOCAL
+    OP_GET_LOCAL_SHARED = 103, // OP_GET_LOCAL that drops exclusive ownership of the string it reads
+
+};
+
+// Bits do byte de flags de cada upvalue no OP_CLOSURE
+enum UpvalueFlags : uint8
+{
+    UPVALUE_LOCAL = 0x01,    // index e slot da frame que cria (senao upvalue da closure dela)
+    UPVALUE_BY_VALUE = 0x02, // variavel nunca reatribuida: copia o valor, sem Upvalue
+};
+
+// OP_GET_LOCAL_SHARED <slot:u8>: descodificacao partilhada pelos interpretadores
+// e pelo JIT, para os dois lerem os mesmos operandos. ip aponta para o opcode.
+static constexpr uint32 GET_LOCAL_SHARED_LENGTH = 2;
+
+struct GetLocalShared
+{
+    uint8 slot;
+    bool share; // false quando segue OP_FUNC_LEN: len(s) nao guarda a string
 };
+
+FORCE_INLINE GetLocalShared decodeGetLocalShared(const uint8 *ip)
+{
+    return {ip[1], ip[GET_LOCAL_SHARED_LENGTH] != OP_FUNC_LEN};
+}
@@ -32,19 +32,52 @@ struct CStringEq
     }
 };
 
+// Chave do pool de strings: span de bytes + hash pre-calculado.
+// Nao precisa de terminador '\0', por isso substrings/spans de um buffer
+// podem ser procurados sem copia e '\0' embutidos nao truncam a chave.
+struct StringKey
+{
+    const char *chars;
+    uint32 length;
+    size_t hash;
+};
+
+struct StringKeyHash
+{
+    size_t operator()(const StringKey &key) const
+    {
+        return key.hash;
+    }
+};
+
+struct StringKeyEq
+{
+    bool operator()(const StringKey &a, const StringKey &b) const
+    {
+        return a.length == b.length && memcmp(a.chars, b.chars, a.length) == 0;
+    }
+};
+
 class StringPool
 {
 private:
     HeapAllocator allocator;
 
-    HashMap<const char *, int, CStringHash, CStringEq> pool;
+    HashMap<StringKey, int, StringKeyHash, StringKeyEq> pool;
     size_t bytesAllocated = 0;
     friend class Interpreter;
     String *dummyString = nullptr;
 
     Vector<String *> map;
+    String *charStrings[256] = {};
+    // Maior buffer de trabalho que fica guardado entre chamadas
+    static constexpr size_t SCRATCH_KEEP = 64 * 1024;
+    char *scratch = nullptr;
+    size_t scratchSize = 0;
     String *allocString();
     void deallocString(String *s);
+    char *scratchBuffer(size_t len);
+    String *createFromScratch(size_t len);
 
 public:
     StringPool();
@@ -52,7 +85,10 @@ public:
 
     size_t getBytesAllocated() { return bytesAllocated; }
 
+    // str nao precisa de terminar em '\0' (len bytes sao copiados)
     String *create(const char *str, uint32 len);
+    // hash ja calculado (hashString(str, len))
+    String *create(const char *str, uint32 len, size_t hash);
     void destroy(String *s);
 
     String *create(const char *str);
@@ -65,9 +101,15 @@ public:
     int indexOf(String *str, const char *substr, int startIndex = 0);
 
     String *concat(String *a, String *b);
+    void append(String *dst, String *src);
     String *upper(String *src);
     String *lower(String *src);
     String *substring(String *src, uint32 start, uint32 end);
+    // [start, start + len) de src, sem copia intermedia (len ja validado)
+    String *slice(String *src, uint32 start, uint32 len);
+    // Versao interned de s (s, se ja for)
+    String *intern(String *s);
+    String *fromChar(unsigned char c);
     String *replace(String *src, const char *oldStr, const char *newStr);
     int find(String *str, String *substr, int startIndex = 0);
     int find(String *str, const char *substr, int startIndex = 0);
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "config.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ============================================
+// Worker threads for the parallel update() (Interpreter::setProcessWorkers)
+//
+// run(count, task, ctx) calls task(ctx, i) for every i in [0, count) and
+// returns once all calls are done; the calling thread works too. Each thread
+// starts on its own contiguous slice of the range and, when it runs dry,
+// steals chunks from the slices of the others, so a few slow processes do
+// not leave the rest of the threads idle.
+// ============================================
+
+typedef void (*WorkerTask)(void *ctx, size_t index);
+
+class ProcessWorkers
+{
+public:
+  explicit ProcessWorkers(int threads);
+  ~ProcessWorkers();
+
+  int threads() const { return threadCount; }
+  void run(size_t count, WorkerTask task, void *ctx);
+
+private:
+  static const size_t CHUNK = 32;
+
+  // Uma fatia por thread; `next` e partilhado com os ladroes
+  struct alignas(64) Slice
+  {
+    std::atomic<size_t> next{0};
+    size_t end{0};
+  };
+
+  int threadCount;
+  Slice *slices;
+  std::vector<std::thread> pool;
+
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+  uint64_t round{0};
+  int busy{0};
+  bool stopping{false};
+
+  WorkerTask task{nullptr};
+  void *taskCtx{nullptr};
+
+  void workerLoop(int self);
+  void drain(int self);
+};
@@ -38,8 +38,8 @@
 #include <cassert>
 #include <cstring>
 
-template <typename K, typename Hasher, typename Eq>
-struct HashSet
+template <typename K, typename Hasher, typename Eq, typename Alloc = HeapAlloc>
+struct HashSet : private Alloc
 {
   enum State : uint8
   {
@@ -63,6 +63,7 @@ struct HashSet
   static constexpr float MAX_LOAD = 0.75f;
 
   HashSet() {}
+  explicit HashSet(const Alloc &alloc) : Alloc(alloc) {}
   
   ~HashSet() { destroy(); }
 
@@ -133,7 +134,7 @@ struct HashSet
     Entry *old = entries;
     size_t oldCap = capacity;
 
-    entries = (Entry *)aAlloc(newCap * sizeof(Entry));
+    entries = (Entry *)Alloc::allocate(newCap * sizeof(Entry));
     std::memset(entries, 0, newCap * sizeof(Entry)); // State = EMPTY = 0
 
     capacity = newCap;
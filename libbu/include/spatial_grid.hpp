@@ -0,0 +1,62 @@
+#pragma once
+
+#include "config.hpp"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// ============================================
+// Broad-phase for the space module (builtins_space.cpp)
+//
+// Uniform grid hashed by cell. Every initialized process sits in the cell of
+// its (x, y) privates; update() moves it after each of its steps, so a query
+// only visits the cells its circle touches instead of every process. Circles
+// have radius `radius * size / 100` (size is the percentage private). Queries
+// read x/y/size live and test exactly; a process moved from outside its own
+// step (another process writing p.x) is found in its old cell until it steps.
+// ============================================
+
+struct Process;
+
+class SpatialGrid
+{
+public:
+  SpatialGrid(float cellSize, float radius);
+
+  float cellSize() const { return cell; }
+  float baseRadius() const { return radiusAt100; }
+
+  void refresh(Process *proc); // insere, muda de celula ou retira (morto)
+  void remove(Process *proc);
+  void clear();
+
+  // blueprint -1 = qualquer tipo; `self` nunca entra no resultado.
+  // within() devolve um vetor interno, valido ate a proxima chamada.
+  Process *collide(Process *self, int blueprint);
+  const std::vector<Process *> &within(float x, float y, float r, int blueprint, Process *self);
+  Process *nearest(float x, float y, int blueprint, Process *self, float maxDist);
+
+  static float radiusOf(Process *proc, float radiusAt100);
+
+private:
+  typedef std::vector<Process *> Cell;
+
+  float cell;
+  float invCell;
+  float radiusAt100;
+  float maxRadius{0.0f}; // maior circulo inserido (so cresce ate clear())
+  // Caixa das celulas ocupadas; boundsDirty = uma celula da borda esvaziou
+  int32_t minCx{0}, maxCx{-1}, minCy{0}, maxCy{-1};
+  bool boundsDirty{false};
+
+  std::unordered_map<int64_t, Cell> cells;
+  std::vector<Process *> found; // within()
+
+  int32_t cellOf(float v) const;
+  static int64_t key(int32_t cx, int32_t cy) { return (int64_t)(((uint64_t)(uint32_t)cx << 32) | (uint32_t)cy); }
+  Cell *find(int32_t cx, int32_t cy);
+  void updateBounds();
+
+  template <class Fn>
+  void visit(float x0, float y0, float x1, float y1, Fn &&fn);
+};
@@ -7,8 +7,15 @@ struct String
   static constexpr size_t SMALL_THRESHOLD = 23;
   static constexpr size_t IS_LONG_FLAG = 0x80000000u;
   static constexpr int TRANSIENT_INDEX = -2;
-  
+  // Transient cujo unico dono e uma local (OP_APPEND_LOCAL): pode crescer no sitio
+  static constexpr uint32 IS_OWNED_FLAG = 0x80000000u;
+  // Ja foi guardada numa local: concat() nao a pode libertar (pode haver copias)
+  static constexpr uint32 IS_HELD_FLAG = 0x40000000u;
+  static constexpr uint32 CAPACITY_MASK = 0x3FFFFFFFu;
+
   int index;
+  // Bytes reservados em ptr (0 = exatamente length() + 1) | IS_OWNED_FLAG | IS_HELD_FLAG
+  uint32 capacity_and_flag;
   size_t hash;
   size_t length_and_flag;
 
@@ -21,17 +28,21 @@ struct String
   FORCE_INLINE bool isLong() const { return length_and_flag & IS_LONG_FLAG; }
   FORCE_INLINE size_t length() const { return length_and_flag & ~IS_LONG_FLAG; };
   FORCE_INLINE bool isTransient() const { return index == TRANSIENT_INDEX; }
+  FORCE_INLINE uint32 capacity() const { return capacity_and_flag & CAPACITY_MASK; }
+  FORCE_INLINE bool isOwned() const { return capacity_and_flag & IS_OWNED_FLAG; }
+  FORCE_INLINE bool isHeld() const { return capacity_and_flag & IS_HELD_FLAG; }
+  FORCE_INLINE void share() { capacity_and_flag &= ~IS_OWNED_FLAG; }
 
   FORCE_INLINE const char *chars() const { return isLong() ? ptr : data; }
   FORCE_INLINE char *chars() { return isLong() ? ptr : data; }
 };
 
-inline size_t hashString(const char *s, uint32 len)
+// FNV-1a e incremental: hash(a + b) == hashStringContinue(hash(a), b)
+inline size_t hashStringContinue(size_t h, const char *s, uint32 len)
 {
-  size_t h = 2166136261u;
   const uint8 *p = (const uint8 *)s;
   const uint8 *end = p + len;
-  
+
   while (p != end)
   {
     h ^= *p++;
@@ -40,6 +51,11 @@ inline size_t hashString(const char *s, uint32 len)
   return h;
 }
 
+inline size_t hashString(const char *s, uint32 len)
+{
+  return hashStringContinue(2166136261u, s, len);
+}
+
 static inline bool compare_strings(String *a, String *b)
 {
   if (a == b)
@@ -173,7 +173,7 @@ struct Token
 
     Token();
 
-    Token(TokenType t, const std::string &lex, int l, int c);
+    Token(TokenType t, std::string lex, int l, int c);
 
     std::string toString() const;
     std::string locationString() const; // "line 5, column 12"
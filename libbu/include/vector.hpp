@@ -7,6 +7,7 @@
  * disables copying to ensure efficient memory management.
  * 
  * @tparam T The POD type stored in the vector. Must be a Plain Old Data type.
+ * @tparam Alloc Allocation policy (HeapAlloc, or GCPayloadAlloc for GC object storage).
  * 
  * @note This class uses custom memory allocation functions (aAlloc/aFree).
  * @note Copy operations are explicitly deleted; only move semantics are supported.
@@ -46,13 +47,15 @@
  * - begin(), end(): Iterator support for range-based loops.
  */
 #pragma once
+#include "config.hpp"
 #include <cstdint>
 #include <cstring>
 #include <utility>  
 
 // Vector optimized for POD types (no constructor/destructor)
-template <typename T>
-class Vector
+// Alloc e base vazia no caso de HeapAlloc: so GCPayloadAlloc ocupa espaco
+template <typename T, typename Alloc = HeapAlloc>
+class Vector : private Alloc
 {
 private:
     T *data_;
@@ -75,6 +78,12 @@ public:
         reserve(initialCapacity);
     }
 
+    explicit Vector(const Alloc &alloc)
+        : Alloc(alloc), data_(nullptr), size_(0), capacity_(0)
+    {
+        reserve(8);
+    }
+
     ~Vector()
     {
         destroy();
@@ -82,7 +91,7 @@ public:
 
     // Move
     Vector(Vector &&other) noexcept
-        : data_(other.data_), size_(other.size_), capacity_(other.capacity_)
+        : Alloc(static_cast<const Alloc &>(other)), data_(other.data_), size_(other.size_), capacity_(other.capacity_)
     {
         other.data_ = nullptr;
         other.size_ = 0;
@@ -127,7 +136,7 @@ public:
             return;
 
         // Allocate new block
-        T *newData = (T *)aAlloc(newCapacity * sizeof(T));
+        T *newData = (T *)Alloc::allocate(newCapacity * sizeof(T));
 
         // Copy old data (POD - uses memcpy)
         if (data_)
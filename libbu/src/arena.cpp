@@ -4,6 +4,14 @@
 #include <cstdlib>
 #include <climits>
 
+#if defined(_WIN32)
+#include <malloc.h>
+#elif defined(__linux__) || defined(__APPLE__) || defined(__ANDROID__) || defined(__unix__)
+#define BU_HEAP_MMAP 1
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 size_t HeapAllocator::s_blockSizes[blockSizes] =
 	{
 		16,	 // 0
@@ -30,11 +38,6 @@ struct Heap
 	Block *blocks;
 };
 
-struct Block
-{
-	Block *next;
-};
-
 HeapAllocator::HeapAllocator()
 {
 	assert(blockSizes < UCHAR_MAX);
@@ -54,26 +57,31 @@ HeapAllocator::HeapAllocator()
 		list = nullptr;
 	}
 
-	if (s_blockSizeLookupInitialized == false)
+	InitSizeClasses();
+	std::memset(m_blockAllocations, 0, sizeof(m_blockAllocations));
+}
+
+void HeapAllocator::InitSizeClasses()
+{
+	if (s_blockSizeLookupInitialized)
+		return;
+
+	size_t j = 0;
+	for (size_t i = 1; i <= maxBlockSize; ++i)
 	{
-		size_t j = 0;
-		for (size_t i = 1; i <= maxBlockSize; ++i)
+		assert(j < blockSizes);
+		if (i <= s_blockSizes[j])
 		{
-			assert(j < blockSizes);
-			if (i <= s_blockSizes[j])
-			{
-				s_blockSizeLookup[i] = (uint8)j;
-			}
-			else
-			{
-				++j;
-				s_blockSizeLookup[i] = (uint8)j;
-			}
+			s_blockSizeLookup[i] = (uint8)j;
+		}
+		else
+		{
+			++j;
+			s_blockSizeLookup[i] = (uint8)j;
 		}
-
-		s_blockSizeLookupInitialized = true;
 	}
-	std::memset(m_blockAllocations, 0, sizeof(m_blockAllocations));
+
+	s_blockSizeLookupInitialized = true;
 }
 
 HeapAllocator::~HeapAllocator()
@@ -299,6 +307,291 @@ void HeapAllocator::Stats()
 
 //********************************************************************** */
 
+// Primeiro bloco da pagina, depois do cabecalho (alinhado a 16)
+static const size_t s_pageHeaderSize = (sizeof(HeapPage) + 15) & ~(size_t)15;
+
+static HeapPage *MapPage()
+{
+#if defined(BU_HEAP_MMAP)
+	// Reserva o dobro e corta as pontas: a pagina fica alinhada ao tamanho
+	size_t span = heapPageSize * 2;
+	void *raw = mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (raw == MAP_FAILED)
+		return nullptr;
+	uintptr_t base = reinterpret_cast<uintptr_t>(raw);
+	uintptr_t aligned = (base + heapPageSize - 1) & ~(uintptr_t)(heapPageSize - 1);
+	if (aligned > base)
+		munmap(raw, aligned - base);
+	if (aligned + heapPageSize < base + span)
+		munmap(reinterpret_cast<void *>(aligned + heapPageSize), base + span - (aligned + heapPageSize));
+	return reinterpret_cast<HeapPage *>(aligned);
+#elif defined(_WIN32)
+	return static_cast<HeapPage *>(_aligned_malloc(heapPageSize, heapPageSize));
+#else
+	void *p = nullptr;
+	if (posix_memalign(&p, heapPageSize, heapPageSize) != 0)
+		return nullptr;
+	return static_cast<HeapPage *>(p);
+#endif
+}
+
+static void UnmapPage(HeapPage *page)
+{
+#if defined(BU_HEAP_MMAP)
+	munmap(page, heapPageSize);
+#elif defined(_WIN32)
+	_aligned_free(page);
+#else
+	free(page);
+#endif
+}
+
+// Devolve ao SO o corpo da pagina; o cabecalho (primeira pagina do SO) fica
+static size_t DropPageBody(HeapPage *page)
+{
+#if defined(BU_HEAP_MMAP)
+	static const size_t osPage = (size_t)sysconf(_SC_PAGESIZE);
+	size_t keep = (s_pageHeaderSize + osPage - 1) & ~(osPage - 1);
+	if (keep >= heapPageSize)
+		return 0;
+	madvise(reinterpret_cast<char *>(page) + keep, heapPageSize - keep, MADV_DONTNEED);
+	return heapPageSize - keep;
+#else
+	(void)page;
+	return 0;
+#endif
+}
+
+PageAllocator::PageAllocator()
+{
+	HeapAllocator::InitSizeClasses();
+	std::memset(m_classes, 0, sizeof(m_classes));
+	std::memset(m_kinds, 0, sizeof(m_kinds));
+	m_hot = nullptr;
+	m_hotCount = 0;
+	m_cached = nullptr;
+	m_cachedCount = 0;
+	m_pageCount = 0;
+	m_totalAllocated = 0;
+	m_releasedBytes = 0;
+	m_largeAllocations = 0;
+	m_largeAllocatedBytes = 0;
+}
+
+PageAllocator::~PageAllocator()
+{
+	Clear();
+}
+
+HeapPage *PageAllocator::NewPage(size_t index)
+{
+	HeapPage *page = m_hot;
+	if (page)
+	{
+		m_hot = page->next;
+		m_hotCount--;
+	}
+	else if ((page = m_cached) != nullptr)
+	{
+		m_cached = page->next;
+		m_cachedCount--;
+	}
+	else
+	{
+		page = MapPage();
+		if (!page)
+			return nullptr;
+	}
+
+	size_t blockSize = HeapAllocator::BlockSize(index);
+	size_t blockCount = (heapPageSize - s_pageHeaderSize) / blockSize;
+	char *first = reinterpret_cast<char *>(page) + s_pageHeaderSize;
+
+	page->nextAvailable = nullptr;
+	page->freeList = nullptr;
+	page->bump = first;
+	page->end = first + blockCount * blockSize;
+	page->live = 0;
+	page->blockSize = (uint32)blockSize;
+	page->sizeClass = (uint8)index;
+	page->available = false;
+
+	SizeClass &c = m_classes[index];
+	page->next = c.pages;
+	c.pages = page;
+	m_pageCount++;
+	return page;
+}
+
+void *PageAllocator::AllocateSlow(size_t size, uint8 kind)
+{
+	if (size == 0)
+		return nullptr;
+
+	if (size > maxBlockSize)
+	{
+		m_totalAllocated += size;
+		m_largeAllocations++;
+		m_largeAllocatedBytes += size;
+		PageKindStats &k = m_kinds[kind & (heapKinds - 1)];
+		k.allocations++;
+		k.liveBytes += size;
+		return aAlloc(size);
+	}
+
+	// A pagina atual encheu: a proxima com blocos livres, senao uma nova
+	size_t index = HeapAllocator::SizeClassOf(size);
+	SizeClass &c = m_classes[index];
+	HeapPage *page = c.available;
+	if (page)
+	{
+		c.available = page->nextAvailable;
+		page->nextAvailable = nullptr;
+		page->available = false;
+	}
+	else
+	{
+		page = NewPage(index);
+		if (!page)
+			return nullptr;
+	}
+	c.current = page;
+	return Allocate(size, kind);
+}
+
+void PageAllocator::FreeLarge(void *p, size_t size, uint8 kind)
+{
+	m_totalAllocated -= size;
+	m_largeAllocations--;
+	m_largeAllocatedBytes -= size;
+	PageKindStats &k = m_kinds[kind & (heapKinds - 1)];
+	k.frees++;
+	k.liveBytes -= size;
+	aFree(p);
+}
+
+void PageAllocator::ReleasePage(HeapPage *page)
+{
+	if (m_cachedCount < heapCachedPages)
+	{
+		m_releasedBytes += DropPageBody(page);
+		page->next = m_cached;
+		m_cached = page;
+		m_cachedCount++;
+	}
+	else
+	{
+		m_releasedBytes += heapPageSize;
+		UnmapPage(page);
+	}
+}
+
+size_t PageAllocator::Sweep(size_t keepBytes)
+{
+	size_t before = m_releasedBytes;
+	for (size_t i = 0; i < blockSizes; ++i)
+	{
+		SizeClass &c = m_classes[i];
+		c.available = nullptr;
+
+		HeapPage **link = &c.pages;
+		while (HeapPage *page = *link)
+		{
+			if (page->live == 0)
+			{
+				// Reinicia o bump (os blocos livres deixam de estar na free list)
+				page->freeList = nullptr;
+				page->bump = reinterpret_cast<char *>(page) + s_pageHeaderSize;
+				if (page != c.current)
+				{
+					*link = page->next;
+					m_pageCount--;
+					page->next = m_hot;
+					m_hot = page;
+					m_hotCount++;
+					continue;
+				}
+			}
+
+			page->available = page != c.current && (page->freeList || page->bump != page->end);
+			if (page->available)
+			{
+				page->nextAvailable = c.available;
+				c.available = page;
+			}
+			link = &page->next;
+		}
+	}
+
+	// O proximo ciclo volta a encher ate keepBytes: essas ficam sem madvise
+	// (evita page faults a cada recolha), o resto do pico vai ao SO
+	size_t keepPages = (keepBytes + heapPageSize - 1) / heapPageSize;
+	while (m_hotCount > keepPages)
+	{
+		HeapPage *page = m_hot;
+		m_hot = page->next;
+		m_hotCount--;
+		ReleasePage(page);
+	}
+	return m_releasedBytes - before;
+}
+
+void PageAllocator::Clear()
+{
+	for (size_t i = 0; i < blockSizes; ++i)
+	{
+		HeapPage *page = m_classes[i].pages;
+		while (page)
+		{
+			HeapPage *next = page->next;
+			UnmapPage(page);
+			page = next;
+		}
+	}
+	while (m_hot)
+	{
+		HeapPage *next = m_hot->next;
+		UnmapPage(m_hot);
+		m_hot = next;
+	}
+	while (m_cached)
+	{
+		HeapPage *next = m_cached->next;
+		UnmapPage(m_cached);
+		m_cached = next;
+	}
+
+	std::memset(m_classes, 0, sizeof(m_classes));
+	std::memset(m_kinds, 0, sizeof(m_kinds));
+	m_hotCount = 0;
+	m_cachedCount = 0;
+	m_pageCount = 0;
+	m_totalAllocated = 0;
+	m_largeAllocations = 0;
+	m_largeAllocatedBytes = 0;
+}
+
+void PageAllocator::GetStats(PageAllocatorStats &stats) const
+{
+	stats.pages = m_pageCount;
+	stats.hotPages = m_hotCount;
+	stats.cachedPages = m_cachedCount;
+	stats.reservedBytes = (m_pageCount + m_hotCount) * heapPageSize;
+	stats.releasedBytes = m_releasedBytes;
+	stats.largeAllocations = m_largeAllocations;
+	stats.largeAllocatedBytes = m_largeAllocatedBytes;
+	for (size_t i = 0; i < blockSizes; ++i)
+	{
+		size_t count = 0;
+		for (HeapPage *page = m_classes[i].pages; page; page = page->next)
+			count++;
+		stats.classPages[i] = count;
+	}
+	std::memcpy(stats.kinds, m_kinds, sizeof(m_kinds));
+}
+
+//********************************************************************** */
+
 StackAllocator::StackAllocator()
 {
 	m_index = 0;
@@ -12,15 +12,6 @@ static constexpr const char *kClassUint32 = "Uint32Array";
 static constexpr const char *kClassFloat32 = "Float32Array";
 static constexpr const char *kClassFloat64 = "Float64Array";
 
-struct BuiltinTypedArrayData
-{
-  BufferType type;
-  int count;
-  int capacity;
-  int elementSize;
-  uint8 *data;
-};
-
 static int element_size(BufferType type)
 {
   switch (type)
@@ -41,36 +32,18 @@ static int element_size(BufferType type)
   }
 }
 
-static bool is_builtin_typedarray_class_name(const char *name)
-{
-  if (!name)
-    return false;
-
-  return (std::strcmp(name, kClassUint8) == 0) ||
-         (std::strcmp(name, kClassInt16) == 0) ||
-         (std::strcmp(name, kClassUint16) == 0) ||
-         (std::strcmp(name, kClassInt32) == 0) ||
-         (std::strcmp(name, kClassUint32) == 0) ||
-         (std::strcmp(name, kClassFloat32) == 0) ||
-         (std::strcmp(name, kClassFloat64) == 0);
-}
-
-static BuiltinTypedArrayData *as_typed_array(void *instance)
+static TypedArrayData *as_typed_array(void *instance)
 {
-  return (BuiltinTypedArrayData *)instance;
+  return (TypedArrayData *)instance;
 }
 
-static bool get_builtin_typedarray(const Value &value, BuiltinTypedArrayData **out)
+static bool get_builtin_typedarray(const Value &value, TypedArrayData **out)
 {
   if (!value.isNativeClassInstance())
     return false;
 
   NativeClassInstance *inst = value.asNativeClassInstance();
-  if (!inst || !inst->klass || !inst->klass->name)
-    return false;
-
-  const char *name = inst->klass->name->chars();
-  if (!is_builtin_typedarray_class_name(name))
+  if (!inst || !inst->klass || !inst->klass->typedArray)
     return false;
 
   if (!inst->userData)
@@ -104,62 +77,20 @@ static double read_buffer_number(const BufferInstance *buf, int index)
   }
 }
 
-static double read_typed_number(const BuiltinTypedArrayData *ta, int index)
+static double read_typed_number(const TypedArrayData *ta, int index)
 {
-  const uint8 *ptr = ta->data + ((size_t)index * (size_t)ta->elementSize);
-  switch (ta->type)
-  {
-  case BufferType::UINT8:
-    return (double)(*ptr);
-  case BufferType::INT16:
-    return (double)(*(const int16 *)ptr);
-  case BufferType::UINT16:
-    return (double)(*(const uint16 *)ptr);
-  case BufferType::INT32:
-    return (double)(*(const int32 *)ptr);
-  case BufferType::UINT32:
-    return (double)(*(const uint32 *)ptr);
-  case BufferType::FLOAT:
-    return (double)(*(const float *)ptr);
-  case BufferType::DOUBLE:
-    return *(const double *)ptr;
-  default:
-    return 0.0;
-  }
+  return typedArrayLoad(ta, index).asNumber();
 }
 
-static void write_typed_number(BuiltinTypedArrayData *ta, int index, double value)
+static void write_typed_number(TypedArrayData *ta, int index, double value)
 {
-  uint8 *ptr = ta->data + ((size_t)index * (size_t)ta->elementSize);
-  switch (ta->type)
-  {
-  case BufferType::UINT8:
-    *ptr = (uint8)value;
-    return;
-  case BufferType::INT16:
-    *(int16 *)ptr = (int16)value;
-    return;
-  case BufferType::UINT16:
-    *(uint16 *)ptr = (uint16)value;
-    return;
-  case BufferType::INT32:
-    *(int32 *)ptr = (int32)value;
-    return;
-  case BufferType::UINT32:
-    *(uint32 *)ptr = (uint32)value;
-    return;
-  case BufferType::FLOAT:
-    *(float *)ptr = (float)value;
-    return;
-  case BufferType::DOUBLE:
-    *(double *)ptr = (double)value;
-    return;
-  default:
-    return;
-  }
+  Value v;
+  v.type = ValueType::DOUBLE;
+  v.as.number = value;
+  typedArrayStore(ta, index, v);
 }
 
-static bool ensure_capacity(BuiltinTypedArrayData *ta, int needed)
+static bool ensure_capacity(Interpreter *vm, TypedArrayData *ta, int needed)
 {
   if (needed <= ta->capacity)
     return true;
@@ -177,28 +108,30 @@ static bool ensure_capacity(BuiltinTypedArrayData *ta, int needed)
   if (!newData)
     return false;
 
+  // Crescimento conta para o ritmo do GC desta VM (a instancia e coletavel)
+  vm->notePayload(bytes - (size_t)ta->capacity * (size_t)ta->elementSize);
   ta->data = (uint8 *)newData;
   ta->capacity = newCap;
   return true;
 }
 
-static bool append_number(BuiltinTypedArrayData *ta, double value)
+static bool append_number(Interpreter *vm, TypedArrayData *ta, double value)
 {
-  if (!ensure_capacity(ta, ta->count + 1))
+  if (!ensure_capacity(vm, ta, ta->count + 1))
     return false;
   write_typed_number(ta, ta->count, value);
   ta->count++;
   return true;
 }
 
-static bool append_value(BuiltinTypedArrayData *ta, const Value &v)
+static bool append_value(Interpreter *vm, TypedArrayData *ta, const Value &v)
 {
   if (!v.isNumber())
     return false;
-  return append_number(ta, v.asNumber());
+  return append_number(vm, ta, v.asNumber());
 }
 
-static bool append_array(BuiltinTypedArrayData *ta, const Value &v)
+static bool append_array(Interpreter *vm, TypedArrayData *ta, const Value &v)
 {
   if (!v.isArray())
     return false;
@@ -212,7 +145,7 @@ static bool append_array(BuiltinTypedArrayData *ta, const Value &v)
       return false;
   }
 
-  if (!ensure_capacity(ta, ta->count + n))
+  if (!ensure_capacity(vm, ta, ta->count + n))
     return false;
 
   for (int i = 0; i < n; i++)
@@ -222,14 +155,14 @@ static bool append_array(BuiltinTypedArrayData *ta, const Value &v)
   return true;
 }
 
-static bool append_buffer(BuiltinTypedArrayData *ta, const Value &v)
+static bool append_buffer(Interpreter *vm, TypedArrayData *ta, const Value &v)
 {
   if (!v.isBuffer())
     return false;
 
   BufferInstance *buf = v.asBuffer();
   const int n = buf->count;
-  if (!ensure_capacity(ta, ta->count + n))
+  if (!ensure_capacity(vm, ta, ta->count + n))
     return false;
 
   for (int i = 0; i < n; i++)
@@ -239,13 +172,13 @@ static bool append_buffer(BuiltinTypedArrayData *ta, const Value &v)
   return true;
 }
 
-static bool append_typed(BuiltinTypedArrayData *ta, const Value &v)
+static bool append_typed(Interpreter *vm, TypedArrayData *ta, const Value &v)
 {
-  BuiltinTypedArrayData *src = nullptr;
+  TypedArrayData *src = nullptr;
   if (!get_builtin_typedarray(v, &src))
     return false;
 
-  if (!ensure_capacity(ta, ta->count + src->count))
+  if (!ensure_capacity(vm, ta, ta->count + src->count))
     return false;
 
   for (int i = 0; i < src->count; i++)
@@ -257,7 +190,7 @@ static bool append_typed(BuiltinTypedArrayData *ta, const Value &v)
 
 static int typed_add(Interpreter *vm, void *instance, int argCount, Value *args)
 {
-  BuiltinTypedArrayData *ta = as_typed_array(instance);
+  TypedArrayData *ta = as_typed_array(instance);
   if (!ta || argCount < 1)
   {
     vm->runtimeError("add() expects at least 1 argument");
@@ -268,23 +201,23 @@ static int typed_add(Interpreter *vm, void *instance, int argCount, Value *args)
   if (argCount == 1)
   {
     if (args[0].isArray())
-      ok = append_array(ta, args[0]);
+      ok = append_array(vm, ta, args[0]);
     else if (args[0].isBuffer())
-      ok = append_buffer(ta, args[0]);
+      ok = append_buffer(vm, ta, args[0]);
     else
     {
-      BuiltinTypedArrayData *tmp = nullptr;
+      TypedArrayData *tmp = nullptr;
       if (get_builtin_typedarray(args[0], &tmp))
-        ok = append_typed(ta, args[0]);
+        ok = append_typed(vm, ta, args[0]);
       else
-        ok = append_value(ta, args[0]);
+        ok = append_value(vm, ta, args[0]);
     }
   }
   else
   {
     for (int i = 0; i < argCount; i++)
     {
-      if (!append_value(ta, args[i]))
+      if (!append_value(vm, ta, args[i]))
       {
         ok = false;
         break;
@@ -305,7 +238,7 @@ static int typed_add(Interpreter *vm, void *instance, int argCount, Value *args)
 static int typed_clear(Interpreter *vm, void *instance, int argCount, Value *args)
 {
   (void)args;
-  BuiltinTypedArrayData *ta = as_typed_array(instance);
+  TypedArrayData *ta = as_typed_array(instance);
   if (!ta || argCount != 0)
   {
     vm->runtimeError("clear() expects 0 arguments");
@@ -318,7 +251,7 @@ static int typed_clear(Interpreter *vm, void *instance, int argCount, Value *arg
 
 static int typed_reserve(Interpreter *vm, void *instance, int argCount, Value *args)
 {
-  BuiltinTypedArrayData *ta = as_typed_array(instance);
+  TypedArrayData *ta = as_typed_array(instance);
   if (!ta || argCount != 1 || !args[0].isNumber())
   {
     vm->runtimeError("reserve() expects 1 numeric argument");
@@ -332,7 +265,7 @@ static int typed_reserve(Interpreter *vm, void *instance, int argCount, Value *a
     return 0;
   }
 
-  if (!ensure_capacity(ta, n))
+  if (!ensure_capacity(vm, ta, n))
   {
     vm->runtimeError("reserve() out of memory");
     return 0;
@@ -345,7 +278,7 @@ static int typed_reserve(Interpreter *vm, void *instance, int argCount, Value *a
 static int typed_pack(Interpreter *vm, void *instance, int argCount, Value *args)
 {
   (void)args;
-  BuiltinTypedArrayData *ta = as_typed_array(instance);
+  TypedArrayData *ta = as_typed_array(instance);
   if (!ta || argCount != 0)
   {
     vm->runtimeError("pack() expects 0 arguments");
@@ -387,7 +320,7 @@ static int typed_pack(Interpreter *vm, void *instance, int argCount, Value *args
 static int typed_length(Interpreter *vm, void *instance, int argCount, Value *args)
 {
   (void)args;
-  BuiltinTypedArrayData *ta = as_typed_array(instance);
+  TypedArrayData *ta = as_typed_array(instance);
   if (!ta || argCount != 0)
     return 0;
   vm->pushInt(ta->count);
@@ -397,7 +330,7 @@ static int typed_length(Interpreter *vm, void *instance, int argCount, Value *ar
 static int typed_capacity(Interpreter *vm, void *instance, int argCount, Value *args)
 {
   (void)args;
-  BuiltinTypedArrayData *ta = as_typed_array(instance);
+  TypedArrayData *ta = as_typed_array(instance);
   if (!ta || argCount != 0)
     return 0;
   vm->pushInt(ta->capacity);
@@ -407,7 +340,7 @@ static int typed_capacity(Interpreter *vm, void *instance, int argCount, Value *
 static int typed_byte_length(Interpreter *vm, void *instance, int argCount, Value *args)
 {
   (void)args;
-  BuiltinTypedArrayData *ta = as_typed_array(instance);
+  TypedArrayData *ta = as_typed_array(instance);
   if (!ta || argCount != 0)
     return 0;
   vm->pushInt(ta->count * ta->elementSize);
@@ -417,7 +350,7 @@ static int typed_byte_length(Interpreter *vm, void *instance, int argCount, Valu
 static int typed_byte_capacity(Interpreter *vm, void *instance, int argCount, Value *args)
 {
   (void)args;
-  BuiltinTypedArrayData *ta = as_typed_array(instance);
+  TypedArrayData *ta = as_typed_array(instance);
   if (!ta || argCount != 0)
     return 0;
   vm->pushInt(ta->capacity * ta->elementSize);
@@ -427,7 +360,7 @@ static int typed_byte_capacity(Interpreter *vm, void *instance, int argCount, Va
 static int typed_ptr(Interpreter *vm, void *instance, int argCount, Value *args)
 {
   (void)args;
-  BuiltinTypedArrayData *ta = as_typed_array(instance);
+  TypedArrayData *ta = as_typed_array(instance);
   if (!ta || argCount != 0)
     return 0;
   vm->pushPointer(ta->data);
@@ -436,7 +369,7 @@ static int typed_ptr(Interpreter *vm, void *instance, int argCount, Value *args)
 
 static int typed_get(Interpreter *vm, void *instance, int argCount, Value *args)
 {
-  BuiltinTypedArrayData *ta = as_typed_array(instance);
+  TypedArrayData *ta = as_typed_array(instance);
   if (!ta || argCount != 1 || !args[0].isNumber())
   {
     vm->runtimeError("get() expects 1 numeric index");
@@ -456,7 +389,7 @@ static int typed_get(Interpreter *vm, void *instance, int argCount, Value *args)
 
 static int typed_set(Interpreter *vm, void *instance, int argCount, Value *args)
 {
-  BuiltinTypedArrayData *ta = as_typed_array(instance);
+  TypedArrayData *ta = as_typed_array(instance);
   if (!ta || argCount != 2 || !args[0].isNumber() || !args[1].isNumber())
   {
     vm->runtimeError("set() expects (index, value)");
@@ -478,7 +411,7 @@ static int typed_set(Interpreter *vm, void *instance, int argCount, Value *args)
 static int typed_to_buffer(Interpreter *vm, void *instance, int argCount, Value *args)
 {
   (void)args;
-  BuiltinTypedArrayData *ta = as_typed_array(instance);
+  TypedArrayData *ta = as_typed_array(instance);
   if (!ta || argCount != 0)
     return 0;
 
@@ -494,32 +427,32 @@ static int typed_to_buffer(Interpreter *vm, void *instance, int argCount, Value
 
 static Value typed_get_length_prop(Interpreter *vm, void *instance)
 {
-  BuiltinTypedArrayData *ta = as_typed_array(instance);
+  TypedArrayData *ta = as_typed_array(instance);
   return vm->makeInt(ta ? ta->count : 0);
 }
 
 static Value typed_get_capacity_prop(Interpreter *vm, void *instance)
 {
-  BuiltinTypedArrayData *ta = as_typed_array(instance);
+  TypedArrayData *ta = as_typed_array(instance);
   return vm->makeInt(ta ? ta->capacity : 0);
 }
 
 static Value typed_get_byte_length_prop(Interpreter *vm, void *instance)
 {
-  BuiltinTypedArrayData *ta = as_typed_array(instance);
+  TypedArrayData *ta = as_typed_array(instance);
   return vm->makeInt(ta ? (ta->count * ta->elementSize) : 0);
 }
 
 static Value typed_get_ptr_prop(Interpreter *vm, void *instance)
 {
-  BuiltinTypedArrayData *ta = as_typed_array(instance);
+  TypedArrayData *ta = as_typed_array(instance);
   return vm->makePointer(ta ? (void *)ta->data : nullptr);
 }
 
 static void typed_destructor(Interpreter *vm, void *instance)
 {
   (void)vm;
-  BuiltinTypedArrayData *ta = as_typed_array(instance);
+  TypedArrayData *ta = as_typed_array(instance);
   if (!ta)
     return;
   if (ta->data)
@@ -535,7 +468,7 @@ static void *typed_constructor(Interpreter *vm, int argCount, Value *args, Buffe
     return nullptr;
   }
 
-  BuiltinTypedArrayData *ta = new BuiltinTypedArrayData();
+  TypedArrayData *ta = new TypedArrayData();
   ta->type = type;
   ta->count = 0;
   ta->capacity = 0;
@@ -561,6 +494,7 @@ static void *typed_constructor(Interpreter *vm, int argCount, Value *args, Buffe
         delete ta;
         return nullptr;
       }
+      vm->notePayload((size_t)cap * (size_t)ta->elementSize);
     }
     ta->capacity = cap;
     ta->count = 0;
@@ -569,7 +503,7 @@ static void *typed_constructor(Interpreter *vm, int argCount, Value *args, Buffe
 
   if (src.isArray())
   {
-    if (!append_array(ta, src))
+    if (!append_array(vm, ta, src))
     {
       vm->runtimeError("%s array constructor expects only numeric elements", className);
       if (ta->data)
@@ -582,7 +516,7 @@ static void *typed_constructor(Interpreter *vm, int argCount, Value *args, Buffe
 
   if (src.isBuffer())
   {
-    if (!append_buffer(ta, src))
+    if (!append_buffer(vm, ta, src))
     {
       vm->runtimeError("%s buffer constructor failed (out of memory)", className);
       if (ta->data)
@@ -593,10 +527,10 @@ static void *typed_constructor(Interpreter *vm, int argCount, Value *args, Buffe
     return ta;
   }
 
-  BuiltinTypedArrayData *tmp = nullptr;
+  TypedArrayData *tmp = nullptr;
   if (get_builtin_typedarray(src, &tmp))
   {
-    if (!append_typed(ta, src))
+    if (!append_typed(vm, ta, src))
     {
       vm->runtimeError("%s typedarray constructor failed (out of memory)", className);
       if (ta->data)
@@ -671,11 +605,11 @@ static void register_typed_class_api(Interpreter &vm, NativeClassDef *klass)
 }
 } // namespace
 
-bool getBuiltinTypedArrayData(const Value &value, const void **outData)
+bool getTypedArrayData(const Value &value, const void **outData)
 {
   if (!outData)
     return false;
-  BuiltinTypedArrayData *ta = nullptr;
+  TypedArrayData *ta = nullptr;
   if (!get_builtin_typedarray(value, &ta) || !ta)
     return false;
   *outData = ta->data;
@@ -700,11 +634,10 @@ void Interpreter::registerArray()
   NativeClassDef *f32 = registerNativeClass(kClassFloat32, ctor_float32, typed_destructor, 1, false);
   NativeClassDef *f64 = registerNativeClass(kClassFloat64, ctor_float64, typed_destructor, 1, false);
 
-  register_typed_class_api(*this, u8);
-  register_typed_class_api(*this, i16);
-  register_typed_class_api(*this, u16);
-  register_typed_class_api(*this, i32);
-  register_typed_class_api(*this, u32);
-  register_typed_class_api(*this, f32);
-  register_typed_class_api(*this, f64);
+  NativeClassDef *classes[] = {u8, i16, u16, i32, u32, f32, f64};
+  for (NativeClassDef *klass : classes)
+  {
+    klass->typedArray = true;
+    register_typed_class_api(*this, klass);
+  }
 }
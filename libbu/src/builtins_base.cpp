@@ -472,6 +472,92 @@ int native_ticks(Interpreter *vm, int argCount, Value *args)
   return 0;
 }
 
+// spawn_many(process, count [, args]): count instancias numa so chamada.
+// args tem uma lista de argumentos por instancia; devolve o array de ids.
+int native_spawn_many(Interpreter *vm, int argCount, Value *args)
+{
+  if (argCount < 2 || argCount > 3)
+  {
+    vm->runtimeError("spawn_many() expects (process, count [, args])");
+    return 0;
+  }
+
+  ProcessDef *blueprint = nullptr;
+  if (args[0].isProcess())
+    blueprint = vm->getProcessDef(args[0].asProcessId());
+  else if (args[0].isInt())
+    blueprint = vm->getProcessDef(args[0].asInt());
+  if (!blueprint || !blueprint->frames[0].func)
+  {
+    vm->runtimeError("spawn_many() expects a process as first argument");
+    return 0;
+  }
+
+  if (!args[1].isInt() || args[1].asInt() < 0)
+  {
+    vm->runtimeError("spawn_many() count must be a non-negative int");
+    return 0;
+  }
+  int count = args[1].asInt();
+  int arity = blueprint->frames[0].func->arity;
+
+  ArrayInstance *argLists = nullptr;
+  if (argCount == 3 && !args[2].isNil())
+  {
+    if (!args[2].isArray())
+    {
+      vm->runtimeError("spawn_many() args must be an array of argument arrays");
+      return 0;
+    }
+    argLists = args[2].asArray();
+    if ((int)argLists->values.size() != count)
+    {
+      vm->runtimeError("spawn_many() args has %d entries, expected %d",
+                       (int)argLists->values.size(), count);
+      return 0;
+    }
+  }
+  else if (arity > 0 && count > 0)
+  {
+    vm->runtimeError("spawn_many() process expects %d arguments per instance", arity);
+    return 0;
+  }
+
+  // Valida tudo antes de criar a primeira instancia
+  if (argLists)
+  {
+    for (int i = 0; i < count; i++)
+    {
+      const Value &list = argLists->values[i];
+      if (!list.isArray() || (int)list.asArray()->values.size() != arity)
+      {
+        vm->runtimeError("spawn_many() args[%d] must be an array of %d arguments", i, arity);
+        return 0;
+      }
+    }
+  }
+
+  // Resultado ja na stack: fica enraizado se o onCreate alocar
+  Value result = vm->makeArray();
+  vm->push(result);
+  ArrayInstance *ids = result.asArray();
+  ids->values.reserve(count);
+  vm->reserveProcesses(count);
+
+  Process *current = vm->getCurrentProcess();
+  Value father = current ? vm->makeProcessInstance(current) : vm->makeNil();
+
+  for (int i = 0; i < count; i++)
+  {
+    const Value *spawnArgs = argLists ? argLists->values[i].asArray()->values.data() : nullptr;
+    Process *instance = vm->spawnWithArgs(blueprint, spawnArgs, argLists ? arity : 0, father);
+    if (!instance)
+      return 1;
+    ids->values.push(vm->makeInt(instance->id));
+  }
+  return 1;
+}
+
 int native_range(Interpreter *vm, int argCount, Value *args)
 {
   if (argCount < 1 || argCount > 3)
@@ -550,6 +636,168 @@ int native_typeof(Interpreter *vm, int argCount, Value *args)
   return 1;
 }
 
+// ============================================
+// StringBuilder - acumula texto num buffer que cresce por duplicacao;
+// toString() copia uma vez para uma string da VM
+// ============================================
+
+static std::string *as_builder(void *instance)
+{
+  return (std::string *)instance;
+}
+
+// Mesmas conversoes que `string + valor` (OP_ADD)
+static bool builder_append_value(std::string *sb, const Value &v)
+{
+  char buffer[32];
+
+  switch (v.type)
+  {
+  case ValueType::STRING:
+  {
+    String *str = v.asString();
+    sb->append(str->chars(), str->length());
+    return true;
+  }
+  case ValueType::INT:
+    snprintf(buffer, sizeof(buffer), "%d", v.as.integer);
+    break;
+  case ValueType::UINT:
+    snprintf(buffer, sizeof(buffer), "%u", v.as.unsignedInteger);
+    break;
+  case ValueType::DOUBLE:
+    snprintf(buffer, sizeof(buffer), "%.6f", v.as.number);
+    break;
+  case ValueType::BOOL:
+    snprintf(buffer, sizeof(buffer), "%d", v.as.boolean ? 1 : 0);
+    break;
+  case ValueType::BYTE:
+    snprintf(buffer, sizeof(buffer), "%d", (int)v.as.byte);
+    break;
+  case ValueType::NIL:
+    sb->append("nil", 3);
+    return true;
+  default:
+    return false;
+  }
+
+  sb->append(buffer);
+  return true;
+}
+
+static void *sb_constructor(Interpreter *vm, int argCount, Value *args)
+{
+  if (argCount > 1 || (argCount == 1 && !args[0].isNumber()))
+  {
+    vm->runtimeError("StringBuilder expects 0 or 1 argument: capacity");
+    return nullptr;
+  }
+
+  std::string *sb = new std::string();
+  if (argCount == 1 && args[0].asNumber() > 0)
+    sb->reserve((size_t)args[0].asNumber());
+  return sb;
+}
+
+static void sb_destructor(Interpreter *vm, void *instance)
+{
+  (void)vm;
+  delete as_builder(instance);
+}
+
+static int sb_append(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+  std::string *sb = as_builder(instance);
+  for (int i = 0; i < argCount; i++)
+  {
+    if (!builder_append_value(sb, args[i]))
+    {
+      vm->runtimeError("append() expects string, number, bool or nil (argument %d)", i + 1);
+      return 0;
+    }
+  }
+  return 0;
+}
+
+static int sb_appendf(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+  if (argCount < 1 || !args[0].isString())
+  {
+    vm->runtimeError("appendf() expects format string as first argument");
+    return 0;
+  }
+
+  // Placeholders '{}' como format()
+  std::string *sb = as_builder(instance);
+  String *fmtStr = args[0].asString();
+  const char *fmt = fmtStr->chars();
+  size_t len = fmtStr->length();
+  int argIndex = 1;
+
+  for (size_t i = 0; i < len; i++)
+  {
+    if (fmt[i] == '{' && i + 1 < len && fmt[i + 1] == '}')
+    {
+      if (argIndex < argCount)
+        valueToString(args[argIndex++], *sb);
+      i++;
+    }
+    else
+    {
+      sb->push_back(fmt[i]);
+    }
+  }
+  return 0;
+}
+
+static int sb_to_string(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+  (void)argCount;
+  (void)args;
+  std::string *sb = as_builder(instance);
+  vm->push(vm->makeString(vm->createString(sb->data(), (uint32)sb->size())));
+  return 1;
+}
+
+static int sb_clear(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+  (void)vm;
+  (void)argCount;
+  (void)args;
+  as_builder(instance)->clear();
+  return 0;
+}
+
+static int sb_reserve(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+  if (argCount != 1 || !args[0].isNumber())
+  {
+    vm->runtimeError("reserve() expects 1 number argument");
+    return 0;
+  }
+  if (args[0].asNumber() > 0)
+    as_builder(instance)->reserve((size_t)args[0].asNumber());
+  return 0;
+}
+
+static int sb_length(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+  (void)argCount;
+  (void)args;
+  vm->pushInt((int)as_builder(instance)->size());
+  return 1;
+}
+
+static Value sb_get_length_prop(Interpreter *vm, void *instance)
+{
+  return vm->makeInt((int)as_builder(instance)->size());
+}
+
+static Value sb_get_capacity_prop(Interpreter *vm, void *instance)
+{
+  return vm->makeInt((int)as_builder(instance)->capacity());
+}
+
 void Interpreter::registerBase()
 {
   registerNative("format", native_format, -1);
@@ -557,6 +805,7 @@ void Interpreter::registerBase()
   registerNative("input", native_input, -1);
   registerNative("print_stack", native_print_stack, -1);
   registerNative("ticks", native_ticks, 1);
+  registerNative("spawn_many", native_spawn_many, -1);
   registerNative("_gc", native_gc, 0);
   registerNative("str", native_string, 1);
   registerNative("int", native_int, 1);
@@ -566,12 +815,23 @@ void Interpreter::registerBase()
   registerNative("typeid", native_typeid, 1);
   registerNative("range", native_range, -1);
   registerNative("typeof", native_typeof, 1);
+
+  NativeClassDef *sb = registerNativeClass("StringBuilder", sb_constructor, sb_destructor, -1, false);
+  addNativeMethod(sb, "append", sb_append);
+  addNativeMethod(sb, "appendf", sb_appendf);
+  addNativeMethod(sb, "toString", sb_to_string);
+  addNativeMethod(sb, "clear", sb_clear);
+  addNativeMethod(sb, "reserve", sb_reserve);
+  addNativeMethod(sb, "length", sb_length);
+  addNativeProperty(sb, "length", sb_get_length_prop, nullptr);
+  addNativeProperty(sb, "capacity", sb_get_capacity_prop, nullptr);
 }
 
 void Interpreter::registerAll()
 {
   registerBase();
   registerArray();
+  registerGC();
 
 #ifdef BU_ENABLE_MATH
   registerMath();
@@ -616,6 +876,10 @@ void Interpreter::registerAll()
   registerSocket();
 #endif
 
+#ifdef BU_ENABLE_HTTP
+  registerHttp();
+#endif
+
 #ifdef BU_ENABLE_CRYPTO
   registerCrypto();
 #endif
@@ -623,4 +887,12 @@ void Interpreter::registerAll()
 #ifdef BU_ENABLE_NN
   registerNN();
 #endif
+
+#ifdef BU_ENABLE_VEC
+  registerVec();
+#endif
+
+#ifdef BU_ENABLE_SPACE
+  registerSpace();
+#endif
 }
@@ -0,0 +1,77 @@
+#include "interpreter.hpp"
+
+// ============================================
+// GC MODULE - recolha manual e contabilidade do heap
+// ============================================
+
+static Value sizeValue(Interpreter *vm, size_t bytes)
+{
+    if (bytes <= 0x7FFFFFFF)
+        return vm->makeInt((int)bytes);
+    return vm->makeDouble((double)bytes);
+}
+
+static void setKind(Interpreter *vm, MapInstance *m, const char *name, const GCKindStats &kind)
+{
+    Value entry = vm->makeMap();
+    MapInstance *e = entry.asMap();
+    e->table.set(vm->makeString("count"), sizeValue(vm, kind.count));
+    e->table.set(vm->makeString("bytes"), sizeValue(vm, kind.bytes));
+    e->table.set(vm->makeString("allocated"), sizeValue(vm, kind.allocated));
+    m->table.set(vm->makeString(name), entry);
+}
+
+// gc.collect() -> bytes libertados
+int native_gc_collect(Interpreter *vm, int argCount, Value *args)
+{
+    (void)argCount;
+    (void)args;
+    vm->runGC();
+
+    GCStats stats;
+    vm->getGCStats(stats);
+    vm->push(sizeValue(vm, stats.lastFreed));
+    return 1;
+}
+
+// gc.stats() -> map com bytes vivos por tipo de objeto
+int native_gc_stats(Interpreter *vm, int argCount, Value *args)
+{
+    (void)argCount;
+    (void)args;
+
+    GCStats stats;
+    vm->getGCStats(stats);
+
+    Value result = vm->makeMap();
+    vm->push(result); // enraizado: os setKind() alocam maps e podem correr o GC
+    MapInstance *m = result.asMap();
+    m->table.set(vm->makeString("heap"), sizeValue(vm, stats.heapBytes));
+    m->table.set(vm->makeString("strings"), sizeValue(vm, stats.stringBytes));
+    m->table.set(vm->makeString("nextGC"), sizeValue(vm, stats.nextGC));
+    m->table.set(vm->makeString("collections"), sizeValue(vm, stats.collections));
+    m->table.set(vm->makeString("lastFreed"), sizeValue(vm, stats.lastFreed));
+    m->table.set(vm->makeString("pages"), sizeValue(vm, stats.heapPages));
+    m->table.set(vm->makeString("reserved"), sizeValue(vm, stats.heapReserved));
+    m->table.set(vm->makeString("released"), sizeValue(vm, stats.heapReleased));
+
+    setKind(vm, m, "structs", stats.kinds[(int)GCObjectType::STRUCT]);
+    setKind(vm, m, "classes", stats.kinds[(int)GCObjectType::CLASS]);
+    setKind(vm, m, "arrays", stats.kinds[(int)GCObjectType::ARRAY]);
+    setKind(vm, m, "maps", stats.kinds[(int)GCObjectType::MAP]);
+    setKind(vm, m, "sets", stats.kinds[(int)GCObjectType::SET]);
+    setKind(vm, m, "buffers", stats.kinds[(int)GCObjectType::BUFFER]);
+    setKind(vm, m, "nativeClasses", stats.kinds[(int)GCObjectType::NATIVE_CLASS]);
+    setKind(vm, m, "nativeStructs", stats.kinds[(int)GCObjectType::NATIVE_STRUCT]);
+    setKind(vm, m, "closures", stats.kinds[(int)GCObjectType::CLOSURE]);
+    setKind(vm, m, "upvalues", stats.kinds[(int)GCObjectType::UPVALUE]);
+
+    return 1;
+}
+
+void Interpreter::registerGC()
+{
+    addModule("gc")
+        .addFunction("collect", native_gc_collect, 0)
+        .addFunction("stats", native_gc_stats, 0);
+}
@@ -0,0 +1,1250 @@
+#include "interpreter.hpp"
+
+#ifdef BU_ENABLE_HTTP
+
+// ============================================
+// HTTP SERVER
+// Non-blocking HTTP/1.1 server driven by the process scheduler.
+//
+// One poll() loop owns the listening socket and every connection; requests
+// are parsed incrementally (keep-alive, pipelining, Content-Length and
+// chunked bodies) and only handed out once complete. accept() called from a
+// process parks it until a request arrives, so a pool of handler processes
+// is served by a single thread. Responses go out with one vectored send
+// straight from the string/Buffer; only the unsent tail of a partial write
+// (or a response that overtook an earlier pipelined one) is copied.
+// ============================================
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <chrono>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+typedef WSAPOLLFD HttpPollFd;
+#define httpPoll WSAPoll
+#define HTTP_WOULD_BLOCK() (WSAGetLastError() == WSAEWOULDBLOCK)
+#else
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#define INVALID_SOCKET -1
+#define SOCKET_ERROR -1
+#define closesocket close
+typedef int SOCKET;
+typedef struct pollfd HttpPollFd;
+#define httpPoll poll
+#define HTTP_WOULD_BLOCK() (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+static const size_t kHttpMaxHead = 64 * 1024;
+static const size_t kHttpReadChunk = 64 * 1024;
+static const uint32 kHttpMaxPipeline = 64; // requests in flight per connection before reads pause
+
+enum class HttpParseState : uint8
+{
+    HEAD,
+    BODY,        // Content-Length
+    CHUNK_SIZE,
+    CHUNK_DATA,
+    CHUNK_CRLF,
+    TRAILER,
+    CLOSED // no further requests on this connection
+};
+
+// A complete request waiting for accept()
+struct HttpServerRequest
+{
+    uint32 id;
+    uint32 connId;
+    uint32 seq;
+    std::string method;
+    std::string path;
+    std::string query;
+    std::string version;
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::string body;
+    bool keepAlive;
+};
+
+// Route of an accepted request back to its connection
+struct HttpInFlight
+{
+    uint32 connId;
+    uint32 seq;
+    bool keepAlive;
+};
+
+struct HttpServerConn
+{
+    uint32 id;
+    SOCKET sock;
+    double lastActive;
+
+    std::string in;
+    size_t pos{0};
+    HttpParseState state{HttpParseState::HEAD};
+    HttpServerRequest *current{nullptr};
+    size_t remaining{0}; // body bytes (BODY) or chunk bytes (CHUNK_DATA)
+
+    uint32 nextSeq{0};  // next parsed request
+    uint32 writeSeq{0}; // next response allowed on the wire
+    std::map<uint32, std::pair<bool, std::string>> deferred; // (keepAlive, bytes) that overtook an earlier one
+    std::string out; // unsent bytes
+    size_t outPos{0};
+
+    bool readClosed{false};
+    bool closeAfterWrite{false}; // a response said "Connection: close"
+    bool broken{false};
+};
+
+struct HttpWaiter
+{
+    uint32 processId;
+    int slot;
+};
+
+struct HttpServerData
+{
+    Interpreter *vm;
+    SOCKET listenSock{INVALID_SOCKET};
+    int port{0};
+    bool closed{false};
+
+    std::unordered_map<uint32, HttpServerConn *> conns;
+    std::deque<HttpServerRequest *> ready;
+    std::deque<HttpWaiter> waiters;
+    std::unordered_map<uint32, HttpInFlight> inflight;
+    std::vector<HttpPollFd> pfds;
+    std::vector<HttpServerConn *> pconns; // pfds[i + 1] -> connection
+
+    uint32 nextConnId{1};
+    uint32 nextRequestId{1};
+    size_t maxBody{8 * 1024 * 1024};
+    double idleTimeout{60.0};
+    double lastUpdate{0.0};
+
+    int64_t served{0};
+    int64_t accepted{0};
+    std::string head; // response head scratch
+};
+
+static double httpNow()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool httpSetNonBlocking(SOCKET sock)
+{
+#ifdef _WIN32
+    u_long mode = 1;
+    return ioctlsocket(sock, FIONBIO, &mode) == 0;
+#else
+    int flags = fcntl(sock, F_GETFL, 0);
+    return flags >= 0 && fcntl(sock, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+}
+
+// Vectored send; returns bytes written, 0 if the socket would block, -1 on error
+static long httpSendv(SOCKET sock, const char *a, size_t aLen, const char *b, size_t bLen)
+{
+#ifdef _WIN32
+    WSABUF bufs[2];
+    bufs[0].buf = (char *)a;
+    bufs[0].len = (ULONG)aLen;
+    bufs[1].buf = (char *)b;
+    bufs[1].len = (ULONG)bLen;
+    DWORD sent = 0;
+    if (WSASend(sock, bufs, bLen > 0 ? 2 : 1, &sent, 0, NULL, NULL) == SOCKET_ERROR)
+    {
+        return HTTP_WOULD_BLOCK() ? 0 : -1;
+    }
+    return (long)sent;
+#else
+    struct iovec iov[2];
+    iov[0].iov_base = (void *)a;
+    iov[0].iov_len = aLen;
+    iov[1].iov_base = (void *)b;
+    iov[1].iov_len = bLen;
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = bLen > 0 ? 2 : 1;
+    ssize_t n = sendmsg(sock, &msg, MSG_NOSIGNAL);
+    if (n < 0)
+    {
+        return HTTP_WOULD_BLOCK() ? 0 : -1;
+    }
+    return (long)n;
+#endif
+}
+
+static bool httpIEquals(const char *a, size_t aLen, const char *b)
+{
+    size_t bLen = strlen(b);
+    if (aLen != bLen)
+        return false;
+    for (size_t i = 0; i < aLen; i++)
+    {
+        if (tolower((unsigned char)a[i]) != b[i])
+            return false;
+    }
+    return true;
+}
+
+static bool httpIContains(const std::string &value, const char *token)
+{
+    size_t n = strlen(token);
+    if (value.size() < n)
+        return false;
+    for (size_t i = 0; i + n <= value.size(); i++)
+    {
+        size_t j = 0;
+        while (j < n && tolower((unsigned char)value[i + j]) == token[j])
+            j++;
+        if (j == n)
+            return true;
+    }
+    return false;
+}
+
+static const char *httpStatusText(int code)
+{
+    switch (code)
+    {
+    case 100: return "Continue";
+    case 101: return "Switching Protocols";
+    case 200: return "OK";
+    case 201: return "Created";
+    case 202: return "Accepted";
+    case 204: return "No Content";
+    case 206: return "Partial Content";
+    case 301: return "Moved Permanently";
+    case 302: return "Found";
+    case 303: return "See Other";
+    case 304: return "Not Modified";
+    case 307: return "Temporary Redirect";
+    case 308: return "Permanent Redirect";
+    case 400: return "Bad Request";
+    case 401: return "Unauthorized";
+    case 403: return "Forbidden";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 408: return "Request Timeout";
+    case 409: return "Conflict";
+    case 413: return "Payload Too Large";
+    case 414: return "URI Too Long";
+    case 415: return "Unsupported Media Type";
+    case 429: return "Too Many Requests";
+    case 431: return "Request Header Fields Too Large";
+    case 500: return "Internal Server Error";
+    case 501: return "Not Implemented";
+    case 502: return "Bad Gateway";
+    case 503: return "Service Unavailable";
+    default: return code < 300 ? "OK" : (code < 400 ? "Redirect" : (code < 500 ? "Client Error" : "Server Error"));
+    }
+}
+
+// ============================================
+// CONNECTION OUTPUT
+// ============================================
+
+static void httpConnFlush(HttpServerConn *conn)
+{
+    while (conn->outPos < conn->out.size())
+    {
+        long n = httpSendv(conn->sock, conn->out.data() + conn->outPos, conn->out.size() - conn->outPos, nullptr, 0);
+        if (n < 0)
+        {
+            conn->broken = true;
+            return;
+        }
+        if (n == 0)
+        {
+            return;
+        }
+        conn->outPos += (size_t)n;
+    }
+    conn->out.clear();
+    conn->outPos = 0;
+}
+
+// Sends head+body for the response at conn->writeSeq; no copy unless the
+// socket can't take it all.
+static void httpConnWrite(HttpServerConn *conn, const char *head, size_t headLen, const char *body, size_t bodyLen)
+{
+    if (conn->broken)
+        return;
+
+    if (conn->outPos < conn->out.size())
+    {
+        conn->out.append(head, headLen);
+        conn->out.append(body, bodyLen);
+        httpConnFlush(conn);
+        return;
+    }
+
+    long n = httpSendv(conn->sock, head, headLen, body, bodyLen);
+    if (n < 0)
+    {
+        conn->broken = true;
+        return;
+    }
+
+    size_t sent = (size_t)n;
+    if (sent < headLen)
+    {
+        conn->out.append(head + sent, headLen - sent);
+        conn->out.append(body, bodyLen);
+    }
+    else if (sent < headLen + bodyLen)
+    {
+        conn->out.append(body + (sent - headLen), bodyLen - (sent - headLen));
+    }
+}
+
+// Emits a response in pipeline order. Out-of-order responses are parked
+// (copied) until every earlier one has been written.
+static void httpConnRespond(HttpServerConn *conn, uint32 seq, bool keepAlive,
+                            const std::string &head, const char *body, size_t bodyLen)
+{
+    if (seq != conn->writeSeq)
+    {
+        std::pair<bool, std::string> &slot = conn->deferred[seq];
+        slot.first = keepAlive;
+        slot.second.reserve(head.size() + bodyLen);
+        slot.second.assign(head);
+        slot.second.append(body, bodyLen);
+        return;
+    }
+
+    httpConnWrite(conn, head.data(), head.size(), body, bodyLen);
+    conn->writeSeq++;
+    if (!keepAlive)
+        conn->closeAfterWrite = true;
+
+    while (!conn->deferred.empty() && conn->deferred.begin()->first == conn->writeSeq)
+    {
+        std::pair<bool, std::string> &next = conn->deferred.begin()->second;
+        httpConnWrite(conn, next.second.data(), next.second.size(), nullptr, 0);
+        if (!next.first)
+            conn->closeAfterWrite = true;
+        conn->deferred.erase(conn->deferred.begin());
+        conn->writeSeq++;
+    }
+}
+
+static void httpBuildHead(std::string &head, int status, bool keepAlive, size_t bodyLen,
+                          const std::string &extraHeaders, bool hasContentType)
+{
+    char line[64];
+    head.clear();
+    head.append("HTTP/1.1 ");
+    snprintf(line, sizeof(line), "%d ", status);
+    head.append(line);
+    head.append(httpStatusText(status));
+    head.append("\r\n");
+    head.append(extraHeaders);
+    if (!hasContentType && bodyLen > 0)
+    {
+        head.append("Content-Type: text/plain; charset=utf-8\r\n");
+    }
+    snprintf(line, sizeof(line), "Content-Length: %zu\r\n", bodyLen);
+    head.append(line);
+    if (!keepAlive)
+    {
+        head.append("Connection: close\r\n");
+    }
+    head.append("\r\n");
+}
+
+// Error answered by the server itself (parse failure, limits): closes afterwards
+static void httpConnFail(HttpServerData *srv, HttpServerConn *conn, int status)
+{
+    conn->state = HttpParseState::CLOSED;
+    conn->readClosed = true;
+    const char *text = httpStatusText(status);
+    httpBuildHead(srv->head, status, false, strlen(text), std::string(), false);
+    httpConnRespond(conn, conn->nextSeq++, false, srv->head, text, strlen(text));
+}
+
+// ============================================
+// REQUEST PARSER
+// ============================================
+
+static void httpServerEnqueue(HttpServerData *srv, HttpServerConn *conn)
+{
+    HttpServerRequest *req = conn->current;
+    conn->current = nullptr;
+    conn->state = HttpParseState::HEAD;
+    req->seq = conn->nextSeq++;
+    srv->ready.push_back(req);
+    if (!req->keepAlive)
+    {
+        // Anything pipelined after "Connection: close" is ignored
+        conn->state = HttpParseState::CLOSED;
+        conn->readClosed = true;
+    }
+}
+
+static bool httpParseHead(HttpServerData *srv, HttpServerConn *conn, size_t headEnd)
+{
+    const char *p = conn->in.data() + conn->pos;
+    const char *end = conn->in.data() + headEnd;
+
+    // Tolerate stray CRLFs between pipelined requests
+    while (p + 1 < end && p[0] == '\r' && p[1] == '\n')
+        p += 2;
+
+    const char *lineEnd = std::search(p, end, "\r\n", "\r\n" + 2);
+    const char *sp1 = std::find(p, lineEnd, ' ');
+    const char *sp2 = sp1 < lineEnd ? std::find(sp1 + 1, lineEnd, ' ') : lineEnd;
+    if (sp1 == lineEnd || sp2 == lineEnd || sp1 == p || sp2 == sp1 + 1)
+    {
+        return false;
+    }
+
+    HttpServerRequest *req = new HttpServerRequest();
+    req->id = srv->nextRequestId++;
+    req->connId = conn->id;
+    req->method.assign(p, sp1);
+    const char *target = sp1 + 1;
+    const char *question = std::find(target, sp2, '?');
+    req->path.assign(target, question);
+    if (question < sp2)
+        req->query.assign(question + 1, sp2);
+    req->version.assign(sp2 + 1, lineEnd);
+
+    bool http10 = req->version == "HTTP/1.0";
+    if (req->version.compare(0, 5, "HTTP/") != 0)
+    {
+        delete req;
+        return false;
+    }
+
+    bool chunked = false;
+    bool hasLength = false;
+    bool expectContinue = false;
+    size_t length = 0;
+    int connection = 0; // 1 keep-alive, -1 close
+
+    const char *line = lineEnd + 2;
+    while (line < end)
+    {
+        const char *eol = std::search(line, end, "\r\n", "\r\n" + 2);
+        const char *colon = std::find(line, eol, ':');
+        if (colon == eol || colon == line)
+        {
+            delete req;
+            return false;
+        }
+        const char *value = colon + 1;
+        while (value < eol && (*value == ' ' || *value == '\t'))
+            value++;
+        const char *valueEnd = eol;
+        while (valueEnd > value && (valueEnd[-1] == ' ' || valueEnd[-1] == '\t'))
+            valueEnd--;
+
+        size_t nameLen = (size_t)(colon - line);
+        req->headers.emplace_back(std::string(line, nameLen), std::string(value, valueEnd));
+        const std::string &v = req->headers.back().second;
+
+        if (httpIEquals(line, nameLen, "content-length"))
+        {
+            char *numEnd = nullptr;
+            unsigned long long n = strtoull(v.c_str(), &numEnd, 10);
+            if (numEnd == v.c_str() || *numEnd != '\0')
+            {
+                delete req;
+                return false;
+            }
+            hasLength = true;
+            length = (size_t)n;
+        }
+        else if (httpIEquals(line, nameLen, "transfer-encoding"))
+        {
+            chunked = httpIContains(v, "chunked");
+        }
+        else if (httpIEquals(line, nameLen, "connection"))
+        {
+            if (httpIContains(v, "close"))
+                connection = -1;
+            else if (httpIContains(v, "keep-alive"))
+                connection = 1;
+        }
+        else if (httpIEquals(line, nameLen, "expect"))
+        {
+            expectContinue = httpIContains(v, "100-continue");
+        }
+        line = eol + 2;
+    }
+
+    req->keepAlive = http10 ? connection == 1 : connection != -1;
+    conn->current = req;
+    conn->pos = headEnd + 4;
+
+    if ((hasLength && length > srv->maxBody))
+    {
+        httpConnFail(srv, conn, 413);
+        return true;
+    }
+
+    if ((chunked || length > 0) && expectContinue)
+    {
+        static const char kContinue[] = "HTTP/1.1 100 Continue\r\n\r\n";
+        if (conn->writeSeq == conn->nextSeq && conn->out.empty())
+            httpConnWrite(conn, kContinue, sizeof(kContinue) - 1, nullptr, 0);
+    }
+
+    if (chunked)
+    {
+        conn->state = HttpParseState::CHUNK_SIZE;
+    }
+    else if (length > 0)
+    {
+        conn->state = HttpParseState::BODY;
+        conn->remaining = length;
+        req->body.reserve(length);
+    }
+    else
+    {
+        httpServerEnqueue(srv, conn);
+    }
+    return true;
+}
+
+// Consumes as much of conn->in as possible; complete requests go to srv->ready
+static void httpConnParse(HttpServerData *srv, HttpServerConn *conn)
+{
+    while (conn->state != HttpParseState::CLOSED &&
+           conn->nextSeq - conn->writeSeq < kHttpMaxPipeline)
+    {
+        std::string &in = conn->in;
+        size_t avail = in.size() - conn->pos;
+
+        if (conn->state == HttpParseState::HEAD)
+        {
+            if (avail == 0)
+                break;
+            size_t headEnd = in.find("\r\n\r\n", conn->pos);
+            if (headEnd == std::string::npos)
+            {
+                if (avail > kHttpMaxHead)
+                    httpConnFail(srv, conn, 431);
+                break;
+            }
+            if (headEnd - conn->pos > kHttpMaxHead)
+            {
+                httpConnFail(srv, conn, 431);
+                break;
+            }
+            if (!httpParseHead(srv, conn, headEnd))
+            {
+                httpConnFail(srv, conn, 400);
+                break;
+            }
+            continue;
+        }
+
+        HttpServerRequest *req = conn->current;
+        if (conn->state == HttpParseState::BODY || conn->state == HttpParseState::CHUNK_DATA)
+        {
+            size_t take = std::min(avail, conn->remaining);
+            req->body.append(in, conn->pos, take);
+            conn->pos += take;
+            conn->remaining -= take;
+            if (conn->remaining > 0)
+                break;
+            if (conn->state == HttpParseState::BODY)
+                httpServerEnqueue(srv, conn);
+            else
+                conn->state = HttpParseState::CHUNK_CRLF;
+            continue;
+        }
+
+        // Chunk framing is line based
+        size_t eol = in.find("\r\n", conn->pos);
+        if (eol == std::string::npos)
+        {
+            if (avail > 1024)
+                httpConnFail(srv, conn, 400);
+            break;
+        }
+
+        if (conn->state == HttpParseState::CHUNK_SIZE)
+        {
+            char *numEnd = nullptr;
+            unsigned long long size = strtoull(in.c_str() + conn->pos, &numEnd, 16);
+            if (numEnd == in.c_str() + conn->pos)
+            {
+                httpConnFail(srv, conn, 400);
+                break;
+            }
+            conn->pos = eol + 2;
+            if (size == 0)
+            {
+                conn->state = HttpParseState::TRAILER;
+            }
+            else if (req->body.size() + size > srv->maxBody)
+            {
+                httpConnFail(srv, conn, 413);
+                break;
+            }
+            else
+            {
+                conn->remaining = (size_t)size;
+                conn->state = HttpParseState::CHUNK_DATA;
+            }
+        }
+        else if (conn->state == HttpParseState::CHUNK_CRLF)
+        {
+            if (eol != conn->pos)
+            {
+                httpConnFail(srv, conn, 400);
+                break;
+            }
+            conn->pos = eol + 2;
+            conn->state = HttpParseState::CHUNK_SIZE;
+        }
+        else // TRAILER: skip trailer fields up to the empty line
+        {
+            bool last = eol == conn->pos;
+            conn->pos = eol + 2;
+            if (last)
+                httpServerEnqueue(srv, conn);
+        }
+    }
+
+    // Compact the read buffer
+    if (conn->pos == conn->in.size())
+    {
+        conn->in.clear();
+        conn->pos = 0;
+    }
+    else if (conn->pos > kHttpReadChunk)
+    {
+        conn->in.erase(0, conn->pos);
+        conn->pos = 0;
+    }
+}
+
+// ============================================
+// EVENT LOOP
+// ============================================
+
+static void httpConnClose(HttpServerData *srv, HttpServerConn *conn)
+{
+    closesocket(conn->sock);
+    delete conn->current;
+    srv->conns.erase(conn->id);
+    delete conn;
+}
+
+static void httpServerAcceptAll(HttpServerData *srv, double now)
+{
+    for (;;)
+    {
+        sockaddr_in addr;
+        socklen_t len = sizeof(addr);
+        SOCKET sock = accept(srv->listenSock, (sockaddr *)&addr, &len);
+        if (sock == INVALID_SOCKET)
+            return;
+
+        httpSetNonBlocking(sock);
+        int flag = 1;
+        setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (char *)&flag, sizeof(flag));
+
+        HttpServerConn *conn = new HttpServerConn();
+        conn->id = srv->nextConnId++;
+        conn->sock = sock;
+        conn->lastActive = now;
+        srv->conns[conn->id] = conn;
+        srv->accepted++;
+    }
+}
+
+static void httpConnRead(HttpServerData *srv, HttpServerConn *conn)
+{
+    char chunk[16 * 1024];
+    size_t total = 0;
+    while (total < kHttpReadChunk)
+    {
+        int n = (int)recv(conn->sock, chunk, sizeof(chunk), 0);
+        if (n > 0)
+        {
+            conn->in.append(chunk, (size_t)n);
+            total += (size_t)n;
+            continue;
+        }
+        if (n == 0)
+            conn->readClosed = true;
+        else if (!HTTP_WOULD_BLOCK())
+            conn->broken = true;
+        break;
+    }
+    httpConnParse(srv, conn);
+}
+
+// Builds the script-side request map. Caller keeps it rooted.
+static Value httpRequestToMap(Interpreter *vm, const HttpServerRequest *req)
+{
+    Value result = vm->makeMap();
+    vm->push(result);
+    MapInstance *map = result.asMap();
+
+    map->table.set(vm->makeString("id"), vm->makeInt((int)req->id));
+    map->table.set(vm->makeString("method"), vm->makeString(vm->createString(req->method.data(), (uint32)req->method.size())));
+    map->table.set(vm->makeString("path"), vm->makeString(vm->createString(req->path.data(), (uint32)req->path.size())));
+    map->table.set(vm->makeString("query"), vm->makeString(vm->createString(req->query.data(), (uint32)req->query.size())));
+    map->table.set(vm->makeString("version"), vm->makeString(vm->createString(req->version.data(), (uint32)req->version.size())));
+    map->table.set(vm->makeString("body"), vm->makeString(vm->createString(req->body.data(), (uint32)req->body.size())));
+    map->table.set(vm->makeString("keep_alive"), vm->makeBool(req->keepAlive));
+
+    Value headersMap = vm->makeMap();
+    map->table.set(vm->makeString("headers"), headersMap);
+    MapInstance *headers = headersMap.asMap();
+    for (const auto &h : req->headers)
+    {
+        headers->table.set(vm->makeString(vm->createString(h.first.data(), (uint32)h.first.size())),
+                           vm->makeString(vm->createString(h.second.data(), (uint32)h.second.size())));
+    }
+
+    vm->pop();
+    return result;
+}
+
+static Value httpServerTake(HttpServerData *srv)
+{
+    HttpServerRequest *req = srv->ready.front();
+    srv->ready.pop_front();
+
+    HttpInFlight route = {req->connId, req->seq, req->keepAlive};
+    srv->inflight[req->id] = route;
+    Value map = httpRequestToMap(srv->vm, req);
+    delete req;
+    return map;
+}
+
+// Hands ready requests to parked accept() callers
+static void httpServerDispatch(HttpServerData *srv)
+{
+    Interpreter *vm = srv->vm;
+    while (!srv->ready.empty() && !srv->waiters.empty())
+    {
+        // Skip handlers killed while parked
+        HttpWaiter waiter = srv->waiters.front();
+        srv->waiters.pop_front();
+        Process *proc = vm->findProcessById(waiter.processId);
+        if (!proc || proc->state != ProcessState::SUSPENDED)
+            continue;
+
+        Value map = httpServerTake(srv);
+        vm->wakeProcess(waiter.processId, waiter.slot, map);
+    }
+}
+
+// One round of IO: waits up to timeoutMs, accepts, reads, parses and writes.
+static void httpServerPoll(HttpServerData *srv, int timeoutMs)
+{
+    if (srv->closed)
+        return;
+
+    // A request already parsed must not wait for IO
+    if (!srv->ready.empty() && !srv->waiters.empty())
+        timeoutMs = 0;
+
+    srv->pfds.clear();
+    srv->pconns.clear();
+    HttpPollFd lfd;
+    lfd.fd = srv->listenSock;
+    lfd.events = POLLIN;
+    lfd.revents = 0;
+    srv->pfds.push_back(lfd);
+
+    for (auto &entry : srv->conns)
+    {
+        HttpServerConn *conn = entry.second;
+        HttpPollFd pfd;
+        pfd.fd = conn->sock;
+        pfd.events = 0;
+        pfd.revents = 0;
+        if (!conn->readClosed && conn->nextSeq - conn->writeSeq < kHttpMaxPipeline)
+            pfd.events |= POLLIN;
+        if (conn->outPos < conn->out.size())
+            pfd.events |= POLLOUT;
+        srv->pfds.push_back(pfd);
+        srv->pconns.push_back(conn);
+    }
+
+    int n = httpPoll(srv->pfds.data(), (unsigned long)srv->pfds.size(), timeoutMs);
+    double now = httpNow();
+
+    if (n > 0)
+    {
+        if (srv->pfds[0].revents & POLLIN)
+            httpServerAcceptAll(srv, now);
+
+        for (size_t i = 0; i < srv->pconns.size(); i++)
+        {
+            HttpServerConn *conn = srv->pconns[i];
+            short revents = srv->pfds[i + 1].revents;
+            if (revents == 0)
+                continue;
+            conn->lastActive = now;
+            if (revents & POLLOUT)
+                httpConnFlush(conn);
+            if (revents & (POLLIN | POLLHUP | POLLERR))
+                httpConnRead(srv, conn);
+        }
+    }
+
+    // Retire finished, broken and idle connections
+    for (size_t i = 0; i < srv->pconns.size(); i++)
+    {
+        HttpServerConn *conn = srv->pconns[i];
+        bool drained = conn->outPos >= conn->out.size() && conn->deferred.empty() &&
+                       conn->writeSeq == conn->nextSeq;
+        bool idle = drained && conn->in.size() == conn->pos && now - conn->lastActive > srv->idleTimeout;
+        if (conn->broken || (drained && (conn->closeAfterWrite || conn->readClosed)) || idle)
+        {
+            httpConnClose(srv, conn);
+        }
+    }
+
+    httpServerDispatch(srv);
+}
+
+// Runs scheduled processes between IO rounds (main process event loop)
+static void httpServerTick(HttpServerData *srv)
+{
+    double now = httpNow();
+    float dt = (float)(now - srv->lastUpdate);
+    srv->lastUpdate = now;
+    srv->vm->update(dt);
+}
+
+static int httpServerWaitMs(HttpServerData *srv, int capMs)
+{
+    float wake = srv->vm->timeUntilNextWake();
+    if (wake < 0.0f)
+        return capMs;
+    int ms = (int)(wake * 1000.0f);
+    return std::min(ms, capMs);
+}
+
+static void httpServerShutdown(HttpServerData *srv)
+{
+    if (srv->closed)
+        return;
+    srv->closed = true;
+
+    std::vector<HttpServerConn *> all;
+    for (auto &entry : srv->conns)
+        all.push_back(entry.second);
+    for (HttpServerConn *conn : all)
+    {
+        httpConnFlush(conn);
+        httpConnClose(srv, conn);
+    }
+    for (HttpServerRequest *req : srv->ready)
+        delete req;
+    srv->ready.clear();
+    srv->inflight.clear();
+
+    if (srv->listenSock != INVALID_SOCKET)
+    {
+        closesocket(srv->listenSock);
+        srv->listenSock = INVALID_SOCKET;
+    }
+
+    // Parked handlers resume with nil
+    while (!srv->waiters.empty())
+    {
+        HttpWaiter waiter = srv->waiters.front();
+        srv->waiters.pop_front();
+        srv->vm->wakeProcess(waiter.processId, waiter.slot, srv->vm->makeNil());
+    }
+}
+
+// ============================================
+// HttpServer CLASS
+// ============================================
+
+static HttpServerData *asHttpServer(void *instance)
+{
+    return static_cast<HttpServerData *>(instance);
+}
+
+// HttpServer(port, [host], [backlog])
+static void *http_server_ctor(Interpreter *vm, int argCount, Value *args)
+{
+    if (argCount < 1 || !args[0].isInt())
+    {
+        vm->runtimeError("HttpServer expects (port, [host], [backlog])");
+        return nullptr;
+    }
+
+    HttpServerData *srv = new HttpServerData();
+    srv->vm = vm;
+    srv->lastUpdate = httpNow();
+
+    const char *host = (argCount >= 2 && args[1].isString()) ? args[1].asStringChars() : "0.0.0.0";
+    int backlog = (argCount >= 3 && args[2].isInt()) ? args[2].asInt() : 1024;
+
+    SOCKET sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (sock == INVALID_SOCKET)
+    {
+        vm->runtimeError("HttpServer: socket creation failed");
+        srv->closed = true;
+        return srv;
+    }
+
+    int opt = 1;
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, (char *)&opt, sizeof(opt));
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)args[0].asInt());
+    if (inet_pton(AF_INET, host, &addr.sin_addr) != 1)
+        addr.sin_addr.s_addr = INADDR_ANY;
+
+    if (bind(sock, (sockaddr *)&addr, sizeof(addr)) == SOCKET_ERROR || listen(sock, backlog) == SOCKET_ERROR)
+    {
+        vm->runtimeError("HttpServer: cannot listen on %s:%d", host, args[0].asInt());
+        closesocket(sock);
+        srv->closed = true;
+        return srv;
+    }
+
+    socklen_t len = sizeof(addr);
+    getsockname(sock, (sockaddr *)&addr, &len);
+    srv->port = ntohs(addr.sin_port);
+
+    httpSetNonBlocking(sock);
+    srv->listenSock = sock;
+    return srv;
+}
+
+static void http_server_dtor(Interpreter *vm, void *instance)
+{
+    (void)vm;
+    HttpServerData *srv = asHttpServer(instance);
+    httpServerShutdown(srv);
+    delete srv;
+}
+
+// accept() -> request map, nil once the server is closed
+static int http_server_accept(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    HttpServerData *srv = asHttpServer(instance);
+
+    if (srv->closed)
+    {
+        vm->pushNil();
+        return 1;
+    }
+
+    if (srv->ready.empty() && srv->waiters.empty())
+        httpServerPoll(srv, 0);
+
+    if (!srv->ready.empty())
+    {
+        vm->push(httpServerTake(srv));
+        return 1;
+    }
+
+    // Scheduled process: park until the event loop has a request for it
+    if (vm->suspendCurrentProcess(-1.0f))
+    {
+        HttpWaiter waiter = {vm->getCurrentProcess()->id, vm->nativeResultSlot(args)};
+        srv->waiters.push_back(waiter);
+        vm->pushNil();
+        return 1;
+    }
+
+    // Main process: drive IO and the other processes until a request is ready
+    while (!srv->closed && srv->ready.empty())
+    {
+        httpServerPoll(srv, httpServerWaitMs(srv, 100));
+        httpServerTick(srv);
+    }
+
+    if (srv->ready.empty())
+    {
+        vm->pushNil();
+        return 1;
+    }
+    vm->push(httpServerTake(srv));
+    return 1;
+}
+
+static bool httpHeadersFromMap(Interpreter *vm, Value value, std::string &out, bool *hasContentType)
+{
+    if (!value.isMap())
+        return false;
+
+    MapInstance *map = value.asMap();
+    map->table.forEach([&](Value key, Value val)
+                       {
+        if (!key.isString())
+            return;
+        String *name = key.asString();
+        if (httpIEquals(name->chars(), name->length(), "content-length") ||
+            httpIEquals(name->chars(), name->length(), "connection"))
+            return;
+        if (httpIEquals(name->chars(), name->length(), "content-type"))
+            *hasContentType = true;
+        out.append(name->chars(), name->length());
+        out.append(": ");
+        if (val.isString())
+        {
+            out.append(val.asStringChars(), val.asString()->length());
+        }
+        else
+        {
+            char tmp[64];
+            if (val.isInt())
+                snprintf(tmp, sizeof(tmp), "%d", val.asInt());
+            else if (val.isNumber())
+                snprintf(tmp, sizeof(tmp), "%g", val.asNumber());
+            else
+                snprintf(tmp, sizeof(tmp), "%s", val.isBool() && val.asBool() ? "true" : "false");
+            out.append(tmp);
+        }
+        out.append("\r\n"); });
+    return true;
+}
+
+// respond(request, status, [body], [headers]) -> bool
+// body: string or Buffer (sent as-is, no copy), headers: map
+static int http_server_respond(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    HttpServerData *srv = asHttpServer(instance);
+
+    if (argCount < 2 || !args[1].isInt())
+    {
+        vm->runtimeError("HttpServer.respond expects (request, status, [body], [headers])");
+        vm->pushBool(false);
+        return 1;
+    }
+
+    uint32 requestId = 0;
+    if (args[0].isInt())
+    {
+        requestId = (uint32)args[0].asInt();
+    }
+    else if (args[0].isMap())
+    {
+        Value id;
+        if (args[0].asMap()->table.get(vm->makeString("id"), &id) && id.isInt())
+            requestId = (uint32)id.asInt();
+    }
+
+    auto it = srv->inflight.find(requestId);
+    if (it == srv->inflight.end())
+    {
+        vm->pushBool(false);
+        return 1;
+    }
+    HttpInFlight route = it->second;
+    srv->inflight.erase(it);
+
+    auto connIt = srv->conns.find(route.connId);
+    if (connIt == srv->conns.end())
+    {
+        vm->pushBool(false); // client went away
+        return 1;
+    }
+    HttpServerConn *conn = connIt->second;
+
+    const char *body = "";
+    size_t bodyLen = 0;
+    if (argCount >= 3)
+    {
+        if (args[2].isString())
+        {
+            body = args[2].asStringChars();
+            bodyLen = args[2].asString()->length();
+        }
+        else if (args[2].isBuffer())
+        {
+            BufferInstance *buf = args[2].asBuffer();
+            body = (const char *)buf->data;
+            bodyLen = (size_t)buf->count * (size_t)buf->elementSize;
+        }
+        else if (!args[2].isNil())
+        {
+            vm->runtimeError("HttpServer.respond body must be a string or Buffer");
+        }
+    }
+
+    std::string extra;
+    bool hasContentType = false;
+    if (argCount >= 4)
+        httpHeadersFromMap(vm, args[3], extra, &hasContentType);
+
+    int status = args[1].asInt();
+    httpBuildHead(srv->head, status, route.keepAlive, bodyLen, extra, hasContentType);
+    httpConnRespond(conn, route.seq, route.keepAlive, srv->head, body, bodyLen);
+    srv->served++;
+
+    vm->pushBool(!conn->broken);
+    return 1;
+}
+
+// poll([timeoutMs]) -> number of requests ready for accept()
+static int http_server_poll(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    HttpServerData *srv = asHttpServer(instance);
+    int timeoutMs = (argCount >= 1 && args[0].isInt()) ? args[0].asInt() : 0;
+    httpServerPoll(srv, timeoutMs);
+    vm->pushInt((int)srv->ready.size());
+    return 1;
+}
+
+// run([seconds]) -> responses sent. Event loop for the main process: IO rounds
+// interleaved with the process scheduler until close() or the time is up.
+static int http_server_run(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    HttpServerData *srv = asHttpServer(instance);
+    double limit = (argCount >= 1 && args[0].isNumber()) ? args[0].asNumber() : -1.0;
+    double start = httpNow();
+    int64_t servedBefore = srv->served;
+
+    srv->lastUpdate = start;
+    while (!srv->closed)
+    {
+        int capMs = 100;
+        if (limit >= 0)
+        {
+            double left = limit - (httpNow() - start);
+            if (left <= 0)
+                break;
+            capMs = std::min(capMs, (int)(left * 1000.0) + 1);
+        }
+        httpServerPoll(srv, httpServerWaitMs(srv, capMs));
+        httpServerTick(srv);
+    }
+
+    vm->pushInt((int)(srv->served - servedBefore));
+    return 1;
+}
+
+static int http_server_close(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    httpServerShutdown(asHttpServer(instance));
+    return 0;
+}
+
+// setMaxBody(bytes): larger request bodies are answered with 413
+static int http_server_set_max_body(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    if (argCount < 1 || !args[0].isInt() || args[0].asInt() < 0)
+    {
+        vm->runtimeError("HttpServer.setMaxBody expects (bytes)");
+        return 0;
+    }
+    asHttpServer(instance)->maxBody = (size_t)args[0].asInt();
+    return 0;
+}
+
+// setIdleTimeout(seconds): keep-alive connections idle longer are closed
+static int http_server_set_idle_timeout(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    if (argCount < 1 || !args[0].isNumber())
+    {
+        vm->runtimeError("HttpServer.setIdleTimeout expects (seconds)");
+        return 0;
+    }
+    asHttpServer(instance)->idleTimeout = args[0].asNumber();
+    return 0;
+}
+
+static Value http_server_get_port(Interpreter *vm, void *instance)
+{
+    return vm->makeInt(asHttpServer(instance)->port);
+}
+
+static Value http_server_get_served(Interpreter *vm, void *instance)
+{
+    return vm->makeInt((int)asHttpServer(instance)->served);
+}
+
+static Value http_server_get_accepted(Interpreter *vm, void *instance)
+{
+    return vm->makeInt((int)asHttpServer(instance)->accepted);
+}
+
+static Value http_server_get_connections(Interpreter *vm, void *instance)
+{
+    return vm->makeInt((int)asHttpServer(instance)->conns.size());
+}
+
+static Value http_server_get_pending(Interpreter *vm, void *instance)
+{
+    return vm->makeInt((int)asHttpServer(instance)->ready.size());
+}
+
+static Value http_server_get_waiting(Interpreter *vm, void *instance)
+{
+    return vm->makeInt((int)asHttpServer(instance)->waiters.size());
+}
+
+static Value http_server_get_closed(Interpreter *vm, void *instance)
+{
+    return vm->makeBool(asHttpServer(instance)->closed);
+}
+
+// status_text(code) -> reason phrase
+static int native_http_status_text(Interpreter *vm, int argCount, Value *args)
+{
+    if (argCount < 1 || !args[0].isInt())
+    {
+        vm->runtimeError("http.status_text expects (code)");
+        return 0;
+    }
+    vm->push(vm->makeString(httpStatusText(args[0].asInt())));
+    return 1;
+}
+
+void Interpreter::registerHttp()
+{
+    NativeClassDef *klass = registerNativeClass("HttpServer", http_server_ctor, http_server_dtor, -1, false);
+
+    addNativeMethod(klass, "accept", http_server_accept);
+    addNativeMethod(klass, "respond", http_server_respond);
+    addNativeMethod(klass, "poll", http_server_poll);
+    addNativeMethod(klass, "run", http_server_run);
+    addNativeMethod(klass, "close", http_server_close);
+    addNativeMethod(klass, "setMaxBody", http_server_set_max_body);
+    addNativeMethod(klass, "setIdleTimeout", http_server_set_idle_timeout);
+
+    addNativeProperty(klass, "port", http_server_get_port, nullptr);
+    addNativeProperty(klass, "served", http_server_get_served, nullptr);
+    addNativeProperty(klass, "accepted", http_server_get_accepted, nullptr);
+    addNativeProperty(klass, "connections", http_server_get_connections, nullptr);
+    addNativeProperty(klass, "pending", http_server_get_pending, nullptr);
+    addNativeProperty(klass, "waiting", http_server_get_waiting, nullptr);
+    addNativeProperty(klass, "closed", http_server_get_closed, nullptr);
+
+    addModule("http")
+        .addFunction("status_text", native_http_status_text, 1);
+}
+
+#endif
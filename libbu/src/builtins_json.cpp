@@ -13,14 +13,47 @@
 #include <string>
 #include <vector>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Streaming output drains `out` once it grows past this size
+static const size_t kJsonFlushBytes = 64 * 1024;
+
+typedef bool (*JsonFlushFn)(void *user, std::string &out);
+
 struct JsonStringifyContext
 {
     bool pretty = false;
     int indentWidth = 0;
     std::vector<const void *> stack;
     std::string error;
+
+    // Optional sink (JsonWriter, json.save): called between container
+    // elements so large values are never held in memory whole
+    JsonFlushFn flush = nullptr;
+    void *flushUser = nullptr;
 };
 
+static bool jsonMaybeFlush(JsonStringifyContext &ctx, std::string &out)
+{
+    if (!ctx.flush || out.size() < kJsonFlushBytes)
+    {
+        return true;
+    }
+    if (!ctx.flush(ctx.flushUser, out))
+    {
+        if (ctx.error.empty())
+        {
+            ctx.error = "write failed";
+        }
+        return false;
+    }
+    return true;
+}
+
 static void jsonWriteIndent(std::string &out, int depth, int indentWidth)
 {
     if (indentWidth <= 0 || depth <= 0)
@@ -153,7 +186,8 @@ static bool jsonStringifyValue(const Value &value, int depth,
                     jsonWriteIndent(out, depth + 1, ctx.indentWidth);
                 }
 
-                if (!jsonStringifyValue(arr->values[i], depth + 1, ctx, out))
+                if (!jsonStringifyValue(arr->values[i], depth + 1, ctx, out) ||
+                    !jsonMaybeFlush(ctx, out))
                 {
                     ctx.stack.pop_back();
                     return false;
@@ -233,7 +267,8 @@ static bool jsonStringifyValue(const Value &value, int depth,
                 out += '"';
                 out += ctx.pretty ? ": " : ":";
 
-                if (!jsonStringifyValue(ent[idx].value, depth + 1, ctx, out))
+                if (!jsonStringifyValue(ent[idx].value, depth + 1, ctx, out) ||
+                    !jsonMaybeFlush(ctx, out))
                 {
                     ok = false;
                 }
@@ -282,11 +317,109 @@ static bool jsonStringifyValue(const Value &value, int depth,
     }
 }
 
+// ============================================
+// Decoder helpers
+// ============================================
+
+// First index >= i holding '"', '\\' or a control character (< 0x20), or len.
+// Plain string content is skipped 16 bytes at a time.
+static FORCE_INLINE size_t jsonScanStringRun(const char *s, size_t i, size_t len)
+{
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1F);
+    while (i + 16 <= len)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(s + i));
+        __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash));
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi8(_mm_min_epu8(v, control), v)); // v <= 0x1F
+        int mask = _mm_movemask_epi8(hit);
+        if (mask != 0)
+        {
+            return i + (size_t)__builtin_ctz((unsigned)mask);
+        }
+        i += 16;
+    }
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+    const uint8x16_t quote = vdupq_n_u8('"');
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+    const uint8x16_t control = vdupq_n_u8(0x1F);
+    while (i + 16 <= len)
+    {
+        uint8x16_t v = vld1q_u8((const uint8_t *)(s + i));
+        uint8x16_t hit = vorrq_u8(vorrq_u8(vceqq_u8(v, quote), vceqq_u8(v, backslash)), vcleq_u8(v, control));
+        if (vmaxvq_u8(hit) != 0)
+        {
+            break; // the scalar loop finds the exact byte
+        }
+        i += 16;
+    }
+#endif
+    while (i < len)
+    {
+        unsigned char c = (unsigned char)s[i];
+        if (c == '"' || c == '\\' || c < 0x20)
+        {
+            return i;
+        }
+        i++;
+    }
+    return len;
+}
+
+// Recently decoded keys (and short strings). Records in a JSON array or
+// JSON Lines stream repeat the same keys; a hit skips hashing and the
+// string pool probe. Interned strings live as long as the VM, so the
+// cache can outlive a single parse (JsonReader keeps one per reader).
+struct JsonKeyCache
+{
+    static const size_t kSlots = 256;
+    static const size_t kMaxLength = 32;
+    String *slots[kSlots];
+
+    JsonKeyCache()
+    {
+        memset(slots, 0, sizeof(slots));
+    }
+
+    static FORCE_INLINE size_t slotFor(const char *chars, size_t len)
+    {
+        size_t h = len * 31u + (unsigned char)chars[0] * 7u + (unsigned char)chars[len - 1];
+        h += (unsigned char)chars[len >> 1] * 131u;
+        return h & (kSlots - 1);
+    }
+
+    FORCE_INLINE String *intern(Interpreter *vm, const char *chars, size_t len)
+    {
+        if (len == 0 || len > kMaxLength)
+        {
+            return vm->createString(chars, (uint32)len);
+        }
+        size_t slot = slotFor(chars, len);
+        String *cached = slots[slot];
+        if (cached && cached->length() == len && memcmp(cached->chars(), chars, len) == 0)
+        {
+            return cached;
+        }
+        String *str = vm->createString(chars, (uint32)len);
+        slots[slot] = str;
+        return str;
+    }
+};
+
+// Exact powers of ten for the fast double path (Clinger): a mantissa below
+// 2^53 scaled by 10^e with |e| <= 22 is correctly rounded by one IEEE op.
+static const double kJsonPow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
 class JsonParser
 {
 public:
-    JsonParser(Interpreter *vm, const char *src)
-        : vm_(vm), src_(src), len_(strlen(src)), pos_(0)
+    // keys: optional cache shared across parses (e.g. JsonReader records)
+    JsonParser(Interpreter *vm, const char *src, size_t len, JsonKeyCache *keys = nullptr)
+        : vm_(vm), src_(src), len_(len), pos_(0), keys_(keys ? keys : &localKeys_)
     {
     }
 
@@ -316,6 +449,9 @@ private:
     const char *src_;
     size_t len_;
     size_t pos_;
+    JsonKeyCache *keys_;
+    JsonKeyCache localKeys_;
+    std::string scratch_; // decoded text of strings with escapes
     std::string error_;
 
     bool parseValue(Value *out)
@@ -330,12 +466,12 @@ private:
         char c = src_[pos_];
         if (c == '"')
         {
-            std::string text;
-            if (!parseString(&text))
+            String *str = parseStringValue();
+            if (!str)
             {
                 return false;
             }
-            *out = vm_->makeString(text.c_str());
+            *out = vm_->makeString(str);
             return true;
         }
         if (c == '{')
@@ -459,8 +595,8 @@ private:
 
         while (true)
         {
-            std::string key;
-            if (!parseString(&key))
+            String *key = parseStringValue();
+            if (!key)
             {
                 vm_->pop();
                 return false;
@@ -486,7 +622,7 @@ private:
             {
                 vm_->push(val);
             }
-            map->table.set(vm_->makeString(key.c_str()), val);
+            map->table.set(vm_->makeString(key), val);
             if (keepValue)
             {
                 vm_->pop();
@@ -509,18 +645,48 @@ private:
         }
     }
 
-    bool parseString(std::string *out)
+    // Interned string for the literal at pos_. Without escapes the string is
+    // created straight from the source span; otherwise it is decoded into
+    // scratch_ (reused across calls).
+    String *parseStringValue()
     {
-        if (!consume('"'))
+        if (pos_ >= len_ || src_[pos_] != '"')
         {
             setError("expected string");
-            return false;
+            return nullptr;
+        }
+
+        size_t start = pos_ + 1;
+        size_t end = jsonScanStringRun(src_, start, len_);
+        if (end < len_ && src_[end] == '"')
+        {
+            pos_ = end + 1;
+            return keys_->intern(vm_, src_ + start, end - start);
         }
 
-        out->clear();
+        // Escapes or an error: keep the plain prefix and decode the rest
+        scratch_.assign(src_ + start, end - start);
+        pos_ = end;
+        if (!parseStringTail(&scratch_))
+        {
+            return nullptr;
+        }
+        return keys_->intern(vm_, scratch_.data(), scratch_.size());
+    }
 
+    // Continues decoding a string body at pos_, appending to out.
+    bool parseStringTail(std::string *out)
+    {
         while (pos_ < len_)
         {
+            size_t run = jsonScanStringRun(src_, pos_, len_);
+            out->append(src_ + pos_, run - pos_);
+            pos_ = run;
+            if (pos_ >= len_)
+            {
+                break;
+            }
+
             char c = src_[pos_++];
             if (c == '"')
             {
@@ -675,15 +841,12 @@ private:
         return true;
     }
 
+    // Digits are accumulated while validating; strtod is only used when the
+    // value cannot be computed exactly (long mantissas, large exponents).
     bool parseNumber(Value *out)
     {
         size_t start = pos_;
-
-        if (consume('-') && pos_ >= len_)
-        {
-            setError("invalid number");
-            return false;
-        }
+        bool negative = consume('-');
 
         if (pos_ >= len_)
         {
@@ -691,10 +854,15 @@ private:
             return false;
         }
 
+        uint64_t mantissa = 0;
+        int digits = 0;     // significant digits in mantissa
+        int dropped = 0;    // integer digits that did not fit in mantissa
+        bool truncated = false;
+
         if (src_[pos_] == '0')
         {
             pos_++;
-            if (pos_ < len_ && std::isdigit((unsigned char)src_[pos_]))
+            if (pos_ < len_ && isDigit(src_[pos_]))
             {
                 setError("leading zeroes are not allowed");
                 return false;
@@ -702,33 +870,57 @@ private:
         }
         else
         {
-            if (!std::isdigit((unsigned char)src_[pos_]))
+            if (!isDigit(src_[pos_]))
             {
                 setError("invalid number");
                 return false;
             }
-            while (pos_ < len_ && std::isdigit((unsigned char)src_[pos_]))
+            while (pos_ < len_ && isDigit(src_[pos_]))
             {
+                if (digits < 19)
+                {
+                    mantissa = mantissa * 10 + (uint64_t)(src_[pos_] - '0');
+                    digits++;
+                }
+                else
+                {
+                    dropped++;
+                    truncated = true;
+                }
                 pos_++;
             }
         }
 
         bool hasFraction = false;
         bool hasExponent = false;
+        int exponent = dropped;
 
         if (pos_ < len_ && src_[pos_] == '.')
         {
             hasFraction = true;
             pos_++;
 
-            if (pos_ >= len_ || !std::isdigit((unsigned char)src_[pos_]))
+            if (pos_ >= len_ || !isDigit(src_[pos_]))
             {
                 setError("invalid fraction");
                 return false;
             }
 
-            while (pos_ < len_ && std::isdigit((unsigned char)src_[pos_]))
+            while (pos_ < len_ && isDigit(src_[pos_]))
             {
+                if (digits < 19)
+                {
+                    if (mantissa != 0 || src_[pos_] != '0')
+                    {
+                        digits++;
+                    }
+                    mantissa = mantissa * 10 + (uint64_t)(src_[pos_] - '0');
+                    exponent--;
+                }
+                else
+                {
+                    truncated = true;
+                }
                 pos_++;
             }
         }
@@ -738,49 +930,82 @@ private:
             hasExponent = true;
             pos_++;
 
+            bool expNegative = false;
             if (pos_ < len_ && (src_[pos_] == '+' || src_[pos_] == '-'))
             {
+                expNegative = src_[pos_] == '-';
                 pos_++;
             }
 
-            if (pos_ >= len_ || !std::isdigit((unsigned char)src_[pos_]))
+            if (pos_ >= len_ || !isDigit(src_[pos_]))
             {
                 setError("invalid exponent");
                 return false;
             }
 
-            while (pos_ < len_ && std::isdigit((unsigned char)src_[pos_]))
+            int value = 0;
+            while (pos_ < len_ && isDigit(src_[pos_]))
             {
+                if (value < 100000)
+                {
+                    value = value * 10 + (src_[pos_] - '0');
+                }
                 pos_++;
             }
+            exponent += expNegative ? -value : value;
         }
 
-        std::string text(src_ + start, pos_ - start);
-
-        if (!hasFraction && !hasExponent)
+        if (!hasFraction && !hasExponent && !truncated)
         {
-            errno = 0;
-            char *endInt = nullptr;
-            long long integer = strtoll(text.c_str(), &endInt, 10);
-
-            if (errno != ERANGE && endInt && *endInt == '\0')
+            if (!negative && mantissa <= (uint64_t)INT_MAX)
             {
-                if (integer >= INT_MIN && integer <= INT_MAX)
-                {
-                    *out = vm_->makeInt((int)integer);
-                    return true;
-                }
-                if (integer >= 0 && integer <= (long long)UINT_MAX)
-                {
-                    *out = vm_->makeUInt((uint32)integer);
-                    return true;
-                }
+                *out = vm_->makeInt((int)mantissa);
+                return true;
+            }
+            if (negative && mantissa <= (uint64_t)INT_MAX + 1)
+            {
+                *out = vm_->makeInt((int)(-(int64_t)mantissa));
+                return true;
+            }
+            if (!negative && mantissa <= (uint64_t)UINT_MAX)
+            {
+                *out = vm_->makeUInt((uint32)mantissa);
+                return true;
             }
         }
 
+        if (!truncated && mantissa <= (1ull << 53) && exponent >= -22 && exponent <= 22)
+        {
+            double number = (double)mantissa;
+            number = exponent < 0 ? number / kJsonPow10[-exponent] : number * kJsonPow10[exponent];
+            *out = vm_->makeDouble(negative ? -number : number);
+            return true;
+        }
+
+        return parseNumberSlow(start, out);
+    }
+
+    // strtod needs a terminated copy: the source may be a buffer or a span
+    bool parseNumberSlow(size_t start, Value *out)
+    {
+        size_t n = pos_ - start;
+        char small[64];
+        std::string large;
+        const char *text = small;
+        if (n < sizeof(small))
+        {
+            memcpy(small, src_ + start, n);
+            small[n] = '\0';
+        }
+        else
+        {
+            large.assign(src_ + start, n);
+            text = large.c_str();
+        }
+
         errno = 0;
         char *end = nullptr;
-        double number = strtod(text.c_str(), &end);
+        double number = strtod(text, &end);
 
         if (!end || *end != '\0')
         {
@@ -798,6 +1023,11 @@ private:
         return true;
     }
 
+    static FORCE_INLINE bool isDigit(char c)
+    {
+        return (unsigned)(c - '0') < 10u;
+    }
+
     void skipWhitespace()
     {
         while (pos_ < len_)
@@ -850,79 +1080,1206 @@ private:
     }
 };
 
-int native_json_parse(Interpreter *vm, int argCount, Value *args)
+// ============================================
+// JsonReader — incremental pull parser
+//
+// Input comes from a file (read in 64 KB chunks) or from feed() calls
+// (sockets, pipes). Only the unread tail of the input is kept in memory.
+//
+//   next()/ready(): one complete top-level value at a time. Works for JSON
+//                   Lines, concatenated values and, with unwrapArray, for the
+//                   elements of one huge top-level array.
+//   read():         SAX-style events ("start_object", "key", "value", ...)
+//                   with the key/scalar in the `value` property.
+//
+// nil from next()/read() means "no complete token buffered yet"; `done` tells
+// whether the input is exhausted.
+// ============================================
+
+static const size_t kJsonReadChunk = 64 * 1024;
+
+enum JsonReaderStatus
 {
-    if (argCount < 1 || !args[0].isString())
+    JSON_READER_READY,
+    JSON_READER_WAIT, // needs more input (feed mode)
+    JSON_READER_DONE,
+    JSON_READER_ERROR,
+};
+
+// Event-mode parser states
+enum JsonReaderState
+{
+    JSON_EXPECT_VALUE,
+    JSON_EXPECT_VALUE_OR_END, // just after '['
+    JSON_EXPECT_KEY,
+    JSON_EXPECT_KEY_OR_END, // just after '{'
+    JSON_EXPECT_COLON,
+    JSON_EXPECT_COMMA_OR_END,
+};
+
+struct JsonReaderData
+{
+    FILE *file;
+    bool inputEnded; // file at EOF or end() called
+    std::string path;
+    std::string error;
+
+    std::string buf; // unread input starts at buf[pos]
+    size_t pos;
+    size_t consumed; // bytes dropped from the front of buf
+
+    // Record mode
+    bool unwrap;
+    bool arrayOpened;
+    bool arrayClosed;
+    bool needComma;
+    int records;
+
+    // Resumable scan of the current record (offsets relative to pos)
+    int scanKind; // 0 = not started, 1 = container, 2 = string, 3 = scalar
+    bool scanComplete;
+    size_t scanOff;
+    int scanDepth;
+    bool scanInString;
+    bool scanEscape;
+
+    JsonKeyCache keys; // shared by every record/event of this reader
+
+    // Event mode
+    std::vector<char> stack;
+    JsonReaderState state;
+    Value value; // scalar or key of the last event (strings are interned)
+
+    JsonReaderData()
+        : file(nullptr), inputEnded(false), pos(0), consumed(0),
+          unwrap(false), arrayOpened(false), arrayClosed(false), needComma(false), records(0),
+          scanKind(0), scanComplete(false), scanOff(0), scanDepth(0), scanInString(false), scanEscape(false),
+          state(JSON_EXPECT_VALUE)
     {
-        vm->runtimeError("json.parse expects a JSON string");
-        return 0;
+        value.type = ValueType::NIL;
     }
+};
 
-    JsonParser parser(vm, args[0].asStringChars());
-    Value result;
-    if (!parser.parse(&result))
+static JsonReaderData *asJsonReader(void *instance)
+{
+    return static_cast<JsonReaderData *>(instance);
+}
+
+static void jsonReaderCompact(JsonReaderData *r)
+{
+    if (r->pos == 0)
     {
-        vm->runtimeError("json.parse: %s", parser.error().c_str());
-        return 0;
+        return;
     }
+    r->buf.erase(0, r->pos);
+    r->consumed += r->pos;
+    r->pos = 0;
+}
 
-    vm->push(result);
-    return 1;
+// Pull the next chunk from the file. False when nothing more can be read now.
+static bool jsonReaderFill(JsonReaderData *r)
+{
+    if (!r->file || r->inputEnded)
+    {
+        return false;
+    }
+    jsonReaderCompact(r);
+
+    size_t old = r->buf.size();
+    r->buf.resize(old + kJsonReadChunk);
+    size_t n = fread(&r->buf[old], 1, kJsonReadChunk, r->file);
+    r->buf.resize(old + n);
+    if (n == 0)
+    {
+        r->inputEnded = true;
+        fclose(r->file);
+        r->file = nullptr;
+        return false;
+    }
+    return true;
 }
 
-int native_json_stringify(Interpreter *vm, int argCount, Value *args)
+static void jsonReaderFail(JsonReaderData *r, const std::string &message)
 {
-    if (argCount < 1)
+    if (r->error.empty())
     {
-        vm->runtimeError("json.stringify expects value");
+        r->error = message + " at byte " + std::to_string(r->consumed + r->pos);
+    }
+}
+
+static bool jsonIsSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static bool jsonIsDelimiter(char c)
+{
+    return jsonIsSpace(c) || c == ',' || c == ']' || c == '}' || c == ':';
+}
+
+static void jsonReaderSkipSpace(JsonReaderData *r)
+{
+    while (r->pos < r->buf.size() && jsonIsSpace(r->buf[r->pos]))
+    {
+        r->pos++;
+    }
+}
+
+// Length of the complete token at pos (string, number or literal), or 0 when
+// it is cut by the end of the buffered input.
+static size_t jsonReaderTokenLength(JsonReaderData *r)
+{
+    const char *p = r->buf.data() + r->pos;
+    size_t n = r->buf.size() - r->pos;
+    size_t i = 1;
+    if (p[0] == '"')
+    {
+        bool escape = false;
+        for (; i < n; i++)
+        {
+            if (escape)
+            {
+                escape = false;
+            }
+            else if (p[i] == '\\')
+            {
+                escape = true;
+            }
+            else if (p[i] == '"')
+            {
+                return i + 1;
+            }
+        }
         return 0;
     }
+    while (i < n && !jsonIsDelimiter(p[i]))
+    {
+        i++;
+    }
+    return (i < n || r->inputEnded) ? i : 0;
+}
 
-    JsonStringifyContext ctx;
-    if (argCount >= 2)
+// Advance the record scan; true once scanOff is one past the record's end.
+static bool jsonReaderScanRecord(JsonReaderData *r)
+{
+    const char *p = r->buf.data() + r->pos;
+    size_t n = r->buf.size() - r->pos;
+    size_t i = r->scanOff;
+
+    if (r->scanKind == 0)
     {
-        if (args[1].isBool())
+        char c = p[0];
+        r->scanKind = (c == '{' || c == '[') ? 1 : (c == '"' ? 2 : 3);
+        r->scanDepth = r->scanKind == 1 ? 1 : 0;
+        r->scanInString = r->scanKind == 2;
+        r->scanEscape = false;
+        i = 1;
+    }
+
+    if (r->scanKind == 3)
+    {
+        while (i < n && !jsonIsDelimiter(p[i]))
         {
-            ctx.pretty = args[1].asBool();
-            ctx.indentWidth = ctx.pretty ? 2 : 0;
+            i++;
         }
-        else if (args[1].isInt())
+        r->scanOff = i;
+        return i < n || r->inputEnded;
+    }
+
+    for (; i < n; i++)
+    {
+        char c = p[i];
+        if (r->scanInString)
         {
-            int width = args[1].asInt();
-            if (width < 0)
+            if (r->scanEscape)
             {
-                width = 0;
+                r->scanEscape = false;
             }
-            if (width > 16)
+            else if (c == '\\')
             {
-                width = 16;
+                r->scanEscape = true;
             }
-            ctx.indentWidth = width;
-            ctx.pretty = width > 0;
+            else if (c == '"')
+            {
+                r->scanInString = false;
+                if (r->scanKind == 2)
+                {
+                    r->scanOff = i + 1;
+                    return true;
+                }
+            }
+            continue;
         }
-        else
+        if (c == '"')
         {
-            vm->runtimeError("json.stringify second argument must be bool or int");
-            return 0;
+            r->scanInString = true;
+        }
+        else if (c == '{' || c == '[')
+        {
+            r->scanDepth++;
+        }
+        else if ((c == '}' || c == ']') && --r->scanDepth == 0)
+        {
+            r->scanOff = i + 1;
+            return true;
         }
     }
+    r->scanOff = i;
+    return false;
+}
 
-    std::string output;
-    if (!jsonStringifyValue(args[0], 0, ctx, output))
+// Position the reader on the next complete record: on READY, the record is
+// buf[pos, pos + scanOff).
+static JsonReaderStatus jsonReaderPrepare(JsonReaderData *r)
+{
+    if (!r->error.empty())
     {
-        vm->runtimeError("json.stringify: %s", ctx.error.c_str());
-        return 0;
+        return JSON_READER_ERROR;
+    }
+    if (r->scanComplete)
+    {
+        return JSON_READER_READY;
     }
 
-    vm->push(vm->makeString(output.c_str()));
-    return 1;
+    for (;;)
+    {
+        if (r->scanKind == 0)
+        {
+            jsonReaderSkipSpace(r);
+            if (r->pos >= r->buf.size())
+            {
+                if (jsonReaderFill(r))
+                {
+                    continue;
+                }
+                if (!r->inputEnded)
+                {
+                    return JSON_READER_WAIT;
+                }
+                if (r->unwrap && !r->arrayClosed)
+                {
+                    jsonReaderFail(r, r->arrayOpened ? "expected ']'" : "expected '['");
+                    return JSON_READER_ERROR;
+                }
+                return JSON_READER_DONE;
+            }
+
+            char c = r->buf[r->pos];
+            if (r->unwrap)
+            {
+                if (r->arrayClosed)
+                {
+                    jsonReaderFail(r, "unexpected data after array");
+                    return JSON_READER_ERROR;
+                }
+                if (!r->arrayOpened)
+                {
+                    if (c != '[')
+                    {
+                        jsonReaderFail(r, "expected '['");
+                        return JSON_READER_ERROR;
+                    }
+                    r->arrayOpened = true;
+                    r->pos++;
+                    continue;
+                }
+                if (c == ']')
+                {
+                    r->arrayClosed = true;
+                    r->pos++;
+                    continue;
+                }
+                if (r->needComma)
+                {
+                    if (c != ',')
+                    {
+                        jsonReaderFail(r, "expected ',' or ']'");
+                        return JSON_READER_ERROR;
+                    }
+                    r->needComma = false;
+                    r->pos++;
+                    continue;
+                }
+            }
+        }
+
+        if (jsonReaderScanRecord(r))
+        {
+            r->scanComplete = true;
+            return JSON_READER_READY;
+        }
+        if (!jsonReaderFill(r))
+        {
+            if (!r->inputEnded)
+            {
+                return JSON_READER_WAIT;
+            }
+            jsonReaderFail(r, "unexpected end of input");
+            return JSON_READER_ERROR;
+        }
+    }
 }
 
-void Interpreter::registerJSON()
+static void *json_reader_ctor(Interpreter *vm, int argCount, Value *args)
 {
-    addModule("json")
+    JsonReaderData *r = new JsonReaderData();
+    if (argCount >= 2)
+    {
+        r->unwrap = args[1].isBool() && args[1].asBool();
+    }
+    if (argCount >= 1 && args[0].isString())
+    {
+        r->path = args[0].asStringChars();
+        r->file = fopen(r->path.c_str(), "rb");
+        if (!r->file)
+        {
+            r->error = "cannot open '" + r->path + "'";
+            r->inputEnded = true;
+        }
+    }
+    else if (argCount >= 1 && !args[0].isNil())
+    {
+        delete r;
+        vm->runtimeError("JsonReader expects ([path], [unwrapArray])");
+        return nullptr;
+    }
+    return r;
+}
+
+static void json_reader_dtor(Interpreter *vm, void *instance)
+{
+    (void)vm;
+    JsonReaderData *r = asJsonReader(instance);
+    if (r->file)
+    {
+        fclose(r->file);
+    }
+    delete r;
+}
+
+// feed(string|buffer): append input (feed mode)
+static int json_reader_feed(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    JsonReaderData *r = asJsonReader(instance);
+    if (argCount < 1 || (!args[0].isString() && !args[0].isBuffer()))
+    {
+        vm->runtimeError("JsonReader.feed expects (string|buffer)");
+        return 0;
+    }
+    if (r->file || r->inputEnded)
+    {
+        vm->runtimeError("JsonReader.feed: input already ended");
+        return 0;
+    }
+    jsonReaderCompact(r);
+    if (args[0].isString())
+    {
+        r->buf.append(args[0].asStringChars(), args[0].asString()->length());
+    }
+    else
+    {
+        BufferInstance *b = args[0].asBuffer();
+        r->buf.append((const char *)b->data, (size_t)b->count * (size_t)b->elementSize);
+    }
+    return 0;
+}
+
+static int json_reader_end(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    (void)vm;
+    (void)argCount;
+    (void)args;
+    asJsonReader(instance)->inputEnded = true;
+    return 0;
+}
+
+static int json_reader_ready(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    (void)argCount;
+    (void)args;
+    vm->pushBool(jsonReaderPrepare(asJsonReader(instance)) == JSON_READER_READY);
+    return 1;
+}
+
+// next() -> next top-level record, or nil when none is complete yet
+static int json_reader_next(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    (void)argCount;
+    (void)args;
+    JsonReaderData *r = asJsonReader(instance);
+    JsonReaderStatus status = jsonReaderPrepare(r);
+    if (status == JSON_READER_ERROR)
+    {
+        vm->runtimeError("JsonReader: %s", r->error.c_str());
+        return 0;
+    }
+    if (status != JSON_READER_READY)
+    {
+        vm->pushNil();
+        return 1;
+    }
+
+    JsonParser parser(vm, r->buf.data() + r->pos, r->scanOff, &r->keys);
+    Value result;
+    if (!parser.parse(&result))
+    {
+        jsonReaderFail(r, parser.error());
+        vm->runtimeError("JsonReader: %s", r->error.c_str());
+        return 0;
+    }
+
+    r->pos += r->scanOff;
+    r->scanKind = 0;
+    r->scanComplete = false;
+    r->scanOff = 0;
+    r->needComma = r->unwrap;
+    r->records++;
+    vm->push(result);
+    return 1;
+}
+
+static void jsonReaderAfterValue(JsonReaderData *r)
+{
+    r->state = r->stack.empty() ? JSON_EXPECT_VALUE : JSON_EXPECT_COMMA_OR_END;
+}
+
+static const char *jsonReaderEvent(Interpreter *vm, JsonReaderData *r)
+{
+    for (;;)
+    {
+        jsonReaderSkipSpace(r);
+        if (r->pos >= r->buf.size())
+        {
+            if (jsonReaderFill(r))
+            {
+                continue;
+            }
+            if (!r->inputEnded)
+            {
+                return nullptr;
+            }
+            if (!r->stack.empty() || r->state != JSON_EXPECT_VALUE)
+            {
+                jsonReaderFail(r, "unexpected end of input");
+                return nullptr;
+            }
+            return "end";
+        }
+
+        char c = r->buf[r->pos];
+        switch (r->state)
+        {
+        case JSON_EXPECT_COMMA_OR_END:
+            if (c == ',')
+            {
+                r->pos++;
+                r->state = r->stack.back() == '{' ? JSON_EXPECT_KEY : JSON_EXPECT_VALUE;
+                continue;
+            }
+            break;
+        case JSON_EXPECT_COLON:
+            if (c != ':')
+            {
+                jsonReaderFail(r, "expected ':' after object key");
+                return nullptr;
+            }
+            r->pos++;
+            r->state = JSON_EXPECT_VALUE;
+            continue;
+        case JSON_EXPECT_KEY:
+        case JSON_EXPECT_KEY_OR_END:
+            if (c != '"' && !(c == '}' && r->state == JSON_EXPECT_KEY_OR_END))
+            {
+                jsonReaderFail(r, "expected object key");
+                return nullptr;
+            }
+            break;
+        default:
+            break;
+        }
+
+        // Closing brackets
+        if (c == '}' || c == ']')
+        {
+            bool allowed = (r->state == JSON_EXPECT_COMMA_OR_END || r->state == JSON_EXPECT_KEY_OR_END ||
+                            r->state == JSON_EXPECT_VALUE_OR_END) &&
+                           r->stack.back() == (c == '}' ? '{' : '[');
+            if (!allowed)
+            {
+                jsonReaderFail(r, std::string("unexpected '") + c + "'");
+                return nullptr;
+            }
+            r->pos++;
+            r->stack.pop_back();
+            jsonReaderAfterValue(r);
+            r->value = vm->makeNil();
+            return c == '}' ? "end_object" : "end_array";
+        }
+
+        if (r->state == JSON_EXPECT_COMMA_OR_END)
+        {
+            jsonReaderFail(r, "expected ',' or closing bracket");
+            return nullptr;
+        }
+
+        if (c == '{' || c == '[')
+        {
+            r->pos++;
+            r->stack.push_back(c);
+            r->state = c == '{' ? JSON_EXPECT_KEY_OR_END : JSON_EXPECT_VALUE_OR_END;
+            r->value = vm->makeNil();
+            return c == '{' ? "start_object" : "start_array";
+        }
+
+        // Scalar or key: needs the whole token in the buffer
+        size_t len = jsonReaderTokenLength(r);
+        if (len == 0)
+        {
+            if (jsonReaderFill(r))
+            {
+                continue;
+            }
+            if (!r->inputEnded)
+            {
+                return nullptr;
+            }
+            jsonReaderFail(r, "unexpected end of input");
+            return nullptr;
+        }
+
+        JsonParser parser(vm, r->buf.data() + r->pos, len, &r->keys);
+        Value scalar;
+        if (!parser.parse(&scalar))
+        {
+            jsonReaderFail(r, parser.error());
+            return nullptr;
+        }
+        r->pos += len;
+        r->value = scalar;
+
+        if (r->state == JSON_EXPECT_KEY || r->state == JSON_EXPECT_KEY_OR_END)
+        {
+            r->state = JSON_EXPECT_COLON;
+            return "key";
+        }
+        jsonReaderAfterValue(r);
+        return "value";
+    }
+}
+
+// read() -> event name, or nil when more input is needed
+static int json_reader_read(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    (void)argCount;
+    (void)args;
+    JsonReaderData *r = asJsonReader(instance);
+    const char *event = r->error.empty() ? jsonReaderEvent(vm, r) : nullptr;
+    if (!r->error.empty())
+    {
+        vm->runtimeError("JsonReader: %s", r->error.c_str());
+        return 0;
+    }
+    if (!event)
+    {
+        vm->pushNil();
+        return 1;
+    }
+    vm->push(vm->makeString(event));
+    return 1;
+}
+
+static int json_reader_close(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    (void)vm;
+    (void)argCount;
+    (void)args;
+    JsonReaderData *r = asJsonReader(instance);
+    if (r->file)
+    {
+        fclose(r->file);
+        r->file = nullptr;
+    }
+    r->inputEnded = true;
+    r->buf.clear();
+    r->buf.shrink_to_fit();
+    r->pos = 0;
+    return 0;
+}
+
+// Byte counts: int while they fit, double past 2 GB
+static Value jsonSizeValue(Interpreter *vm, double size)
+{
+    if (size <= (double)INT_MAX)
+    {
+        return vm->makeInt((int)size);
+    }
+    return vm->makeDouble(size);
+}
+
+static Value json_reader_get_value(Interpreter *vm, void *instance)
+{
+    (void)vm;
+    return asJsonReader(instance)->value;
+}
+
+static Value json_reader_get_depth(Interpreter *vm, void *instance)
+{
+    return vm->makeInt((int)asJsonReader(instance)->stack.size());
+}
+
+static Value json_reader_get_records(Interpreter *vm, void *instance)
+{
+    return vm->makeInt(asJsonReader(instance)->records);
+}
+
+static Value json_reader_get_offset(Interpreter *vm, void *instance)
+{
+    JsonReaderData *r = asJsonReader(instance);
+    return jsonSizeValue(vm, (double)(r->consumed + r->pos));
+}
+
+static Value json_reader_get_done(Interpreter *vm, void *instance)
+{
+    JsonReaderData *r = asJsonReader(instance);
+    if (!r->inputEnded)
+    {
+        return vm->makeBool(false);
+    }
+    size_t i = r->pos;
+    while (i < r->buf.size() && jsonIsSpace(r->buf[i]))
+    {
+        i++;
+    }
+    return vm->makeBool(i >= r->buf.size());
+}
+
+static Value json_reader_get_error(Interpreter *vm, void *instance)
+{
+    const std::string &error = asJsonReader(instance)->error;
+    if (error.empty())
+    {
+        return vm->makeNil();
+    }
+    return vm->makeString(vm->createString(error.c_str(), (uint32)error.size()));
+}
+
+// ============================================
+// JsonWriter — streaming encoder
+//
+//   JsonWriter(path)  write to a file (64 KB staging, flushed as it fills)
+//   JsonWriter()      keep output in memory; drain(buffer) moves it out in
+//                     buffer-sized pieces (sockets), toString()/toBuffer()
+//                     return what is left
+//
+// write(value) emits a whole value; beginArray/beginObject/key/end* build
+// large documents piecewise. Top-level values are separated by '\n', so a
+// sequence of write() calls produces JSON Lines.
+// ============================================
+
+enum JsonWriterTarget
+{
+    JSON_WRITER_MEMORY,
+    JSON_WRITER_FILE,
+};
+
+struct JsonWriterFrame
+{
+    bool isObject;
+    int count;
+    bool hasKey;
+};
+
+struct JsonWriterData
+{
+    JsonWriterTarget target;
+    FILE *file;
+    std::string path;
+    std::string out; // staged output
+    double written;  // bytes already handed to the target
+    int topLevel;    // values written at depth 0
+    std::vector<JsonWriterFrame> frames;
+    std::string error;
+    bool closed;
+
+    JsonWriterData()
+        : target(JSON_WRITER_MEMORY), file(nullptr), written(0), topLevel(0), closed(false) {}
+};
+
+static JsonWriterData *asJsonWriter(void *instance)
+{
+    return static_cast<JsonWriterData *>(instance);
+}
+
+static bool jsonWriterDrain(void *user, std::string &out)
+{
+    JsonWriterData *w = static_cast<JsonWriterData *>(user);
+    if (out.empty() || w->target == JSON_WRITER_MEMORY)
+    {
+        return true;
+    }
+
+    if (!w->file || fwrite(out.data(), 1, out.size(), w->file) != out.size())
+    {
+        w->error = "cannot write '" + w->path + "'";
+        return false;
+    }
+
+    w->written += (double)out.size();
+    out.clear();
+    return true;
+}
+
+// Separator/key bookkeeping before a value; false on misuse.
+static bool jsonWriterBeforeValue(Interpreter *vm, JsonWriterData *w, const char *what)
+{
+    if (w->closed || !w->error.empty())
+    {
+        return false;
+    }
+    if (w->frames.empty())
+    {
+        if (w->topLevel++ > 0)
+        {
+            w->out += '\n';
+        }
+        return true;
+    }
+
+    JsonWriterFrame &top = w->frames.back();
+    if (top.isObject)
+    {
+        if (!top.hasKey)
+        {
+            vm->runtimeError("JsonWriter.%s: object value needs key() first", what);
+            return false;
+        }
+        top.hasKey = false;
+        return true;
+    }
+    if (top.count++ > 0)
+    {
+        w->out += ',';
+    }
+    return true;
+}
+
+static bool jsonWriterAfterValue(JsonWriterData *w)
+{
+    if (w->out.size() >= kJsonFlushBytes && !jsonWriterDrain(w, w->out))
+    {
+        return false;
+    }
+    return w->error.empty();
+}
+
+static void *json_writer_ctor(Interpreter *vm, int argCount, Value *args)
+{
+    JsonWriterData *w = new JsonWriterData();
+    if (argCount >= 1 && args[0].isString())
+    {
+        w->target = JSON_WRITER_FILE;
+        w->path = args[0].asStringChars();
+        w->file = fopen(w->path.c_str(), "wb");
+        if (!w->file)
+        {
+            w->error = "cannot create '" + w->path + "'";
+        }
+    }
+    else if (argCount >= 1 && !args[0].isNil())
+    {
+        delete w;
+        vm->runtimeError("JsonWriter expects ([path])");
+        return nullptr;
+    }
+    return w;
+}
+
+static bool jsonWriterFinish(JsonWriterData *w)
+{
+    if (w->closed)
+    {
+        return w->error.empty();
+    }
+    w->closed = true;
+    if (w->target != JSON_WRITER_MEMORY)
+    {
+        jsonWriterDrain(w, w->out);
+    }
+    if (w->file)
+    {
+        if (fclose(w->file) != 0 && w->error.empty())
+        {
+            w->error = "cannot write '" + w->path + "'";
+        }
+        w->file = nullptr;
+    }
+    return w->error.empty();
+}
+
+static void json_writer_dtor(Interpreter *vm, void *instance)
+{
+    (void)vm;
+    JsonWriterData *w = asJsonWriter(instance);
+    jsonWriterFinish(w);
+    delete w;
+}
+
+// write(value) -> bool
+static int json_writer_write(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    if (argCount < 1)
+    {
+        vm->runtimeError("JsonWriter.write expects (value)");
+        return 0;
+    }
+    JsonWriterData *w = asJsonWriter(instance);
+    if (!jsonWriterBeforeValue(vm, w, "write"))
+    {
+        vm->pushBool(false);
+        return 1;
+    }
+
+    JsonStringifyContext ctx;
+    if (w->target != JSON_WRITER_MEMORY)
+    {
+        ctx.flush = jsonWriterDrain;
+        ctx.flushUser = w;
+    }
+    if (!jsonStringifyValue(args[0], (int)w->frames.size(), ctx, w->out))
+    {
+        if (w->error.empty())
+        {
+            w->error = ctx.error;
+        }
+        vm->pushBool(false);
+        return 1;
+    }
+    vm->pushBool(jsonWriterAfterValue(w));
+    return 1;
+}
+
+static int jsonWriterBegin(Interpreter *vm, JsonWriterData *w, bool isObject)
+{
+    if (!jsonWriterBeforeValue(vm, w, isObject ? "beginObject" : "beginArray"))
+    {
+        vm->pushBool(false);
+        return 1;
+    }
+    w->out += isObject ? '{' : '[';
+    JsonWriterFrame frame = {isObject, 0, false};
+    w->frames.push_back(frame);
+    vm->pushBool(true);
+    return 1;
+}
+
+static int jsonWriterEnd(Interpreter *vm, JsonWriterData *w, bool isObject)
+{
+    if (w->frames.empty() || w->frames.back().isObject != isObject || w->frames.back().hasKey)
+    {
+        vm->runtimeError("JsonWriter.%s: no open %s", isObject ? "endObject" : "endArray",
+                         isObject ? "object" : "array");
+        return 0;
+    }
+    w->frames.pop_back();
+    w->out += isObject ? '}' : ']';
+    vm->pushBool(jsonWriterAfterValue(w));
+    return 1;
+}
+
+static int json_writer_begin_array(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    (void)argCount;
+    (void)args;
+    return jsonWriterBegin(vm, asJsonWriter(instance), false);
+}
+
+static int json_writer_begin_object(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    (void)argCount;
+    (void)args;
+    return jsonWriterBegin(vm, asJsonWriter(instance), true);
+}
+
+static int json_writer_end_array(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    (void)argCount;
+    (void)args;
+    return jsonWriterEnd(vm, asJsonWriter(instance), false);
+}
+
+static int json_writer_end_object(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    (void)argCount;
+    (void)args;
+    return jsonWriterEnd(vm, asJsonWriter(instance), true);
+}
+
+// key(name): next value goes into the open object under `name`
+static int json_writer_key(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    JsonWriterData *w = asJsonWriter(instance);
+    if (argCount < 1 || !args[0].isString())
+    {
+        vm->runtimeError("JsonWriter.key expects (name)");
+        return 0;
+    }
+    if (w->frames.empty() || !w->frames.back().isObject || w->frames.back().hasKey)
+    {
+        vm->runtimeError("JsonWriter.key: no open object awaiting a key");
+        return 0;
+    }
+    JsonWriterFrame &top = w->frames.back();
+    if (top.count++ > 0)
+    {
+        w->out += ',';
+    }
+    top.hasKey = true;
+    w->out += '"';
+    jsonAppendEscapedString(args[0].asStringChars(), w->out);
+    w->out += "\":";
+    return 0;
+}
+
+static int json_writer_flush(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    (void)argCount;
+    (void)args;
+    JsonWriterData *w = asJsonWriter(instance);
+    bool ok = w->error.empty() && jsonWriterDrain(w, w->out);
+    if (ok && w->file)
+    {
+        fflush(w->file);
+    }
+    vm->pushBool(ok);
+    return 1;
+}
+
+static int json_writer_close(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    (void)argCount;
+    (void)args;
+    JsonWriterData *w = asJsonWriter(instance);
+    if (!w->frames.empty() && w->error.empty())
+    {
+        w->error = "unclosed array or object";
+    }
+    vm->pushBool(jsonWriterFinish(w));
+    return 1;
+}
+
+static int json_writer_to_string(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    (void)argCount;
+    (void)args;
+    JsonWriterData *w = asJsonWriter(instance);
+    if (w->target != JSON_WRITER_MEMORY)
+    {
+        vm->runtimeError("JsonWriter.toString: only for in-memory writers");
+        return 0;
+    }
+    vm->push(vm->makeString(vm->createString(w->out.c_str(), (uint32)w->out.size())));
+    return 1;
+}
+
+static int json_writer_to_buffer(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    (void)argCount;
+    (void)args;
+    JsonWriterData *w = asJsonWriter(instance);
+    if (w->target != JSON_WRITER_MEMORY)
+    {
+        vm->runtimeError("JsonWriter.toBuffer: only for in-memory writers");
+        return 0;
+    }
+    Value out = vm->makeBuffer((int)w->out.size(), (int)BufferType::UINT8);
+    if (!w->out.empty())
+    {
+        memcpy(out.asBuffer()->data, w->out.data(), w->out.size());
+    }
+    vm->push(out);
+    return 1;
+}
+
+// drain(buffer, [byteOffset]) -> bytes moved out of an in-memory writer
+static int json_writer_drain(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    JsonWriterData *w = asJsonWriter(instance);
+    if (argCount < 1 || !args[0].isBuffer())
+    {
+        vm->runtimeError("JsonWriter.drain expects (buffer, [byteOffset])");
+        return 0;
+    }
+    if (w->target != JSON_WRITER_MEMORY)
+    {
+        vm->runtimeError("JsonWriter.drain: only for in-memory writers");
+        return 0;
+    }
+    BufferInstance *buf = args[0].asBuffer();
+    size_t capacity = (size_t)buf->count * (size_t)buf->elementSize;
+    size_t offset = (argCount >= 2 && args[1].isInt() && args[1].asInt() > 0) ? (size_t)args[1].asInt() : 0;
+    if (offset > capacity)
+    {
+        offset = capacity;
+    }
+
+    size_t n = w->out.size();
+    if (n > capacity - offset)
+    {
+        n = capacity - offset;
+    }
+    if (n > 0)
+    {
+        memcpy(buf->data + offset, w->out.data(), n);
+        w->out.erase(0, n);
+        w->written += (double)n;
+    }
+    vm->pushInt((int)n);
+    return 1;
+}
+
+static Value json_writer_get_bytes(Interpreter *vm, void *instance)
+{
+    JsonWriterData *w = asJsonWriter(instance);
+    return jsonSizeValue(vm, w->written + (double)w->out.size());
+}
+
+static Value json_writer_get_depth(Interpreter *vm, void *instance)
+{
+    return vm->makeInt((int)asJsonWriter(instance)->frames.size());
+}
+
+static Value json_writer_get_error(Interpreter *vm, void *instance)
+{
+    const std::string &error = asJsonWriter(instance)->error;
+    if (error.empty())
+    {
+        return vm->makeNil();
+    }
+    return vm->makeString(vm->createString(error.c_str(), (uint32)error.size()));
+}
+
+static void registerJsonStreamClasses(Interpreter &vm)
+{
+    NativeClassDef *reader = vm.registerNativeClass("JsonReader", json_reader_ctor, json_reader_dtor, -1, false);
+    vm.addNativeMethod(reader, "feed", json_reader_feed);
+    vm.addNativeMethod(reader, "end", json_reader_end);
+    vm.addNativeMethod(reader, "ready", json_reader_ready);
+    vm.addNativeMethod(reader, "next", json_reader_next);
+    vm.addNativeMethod(reader, "read", json_reader_read);
+    vm.addNativeMethod(reader, "close", json_reader_close);
+    vm.addNativeProperty(reader, "value", json_reader_get_value, nullptr);
+    vm.addNativeProperty(reader, "depth", json_reader_get_depth, nullptr);
+    vm.addNativeProperty(reader, "records", json_reader_get_records, nullptr);
+    vm.addNativeProperty(reader, "offset", json_reader_get_offset, nullptr);
+    vm.addNativeProperty(reader, "done", json_reader_get_done, nullptr);
+    vm.addNativeProperty(reader, "error", json_reader_get_error, nullptr);
+
+    NativeClassDef *writer = vm.registerNativeClass("JsonWriter", json_writer_ctor, json_writer_dtor, -1, false);
+    vm.addNativeMethod(writer, "write", json_writer_write);
+    vm.addNativeMethod(writer, "beginArray", json_writer_begin_array);
+    vm.addNativeMethod(writer, "endArray", json_writer_end_array);
+    vm.addNativeMethod(writer, "beginObject", json_writer_begin_object);
+    vm.addNativeMethod(writer, "endObject", json_writer_end_object);
+    vm.addNativeMethod(writer, "key", json_writer_key);
+    vm.addNativeMethod(writer, "flush", json_writer_flush);
+    vm.addNativeMethod(writer, "close", json_writer_close);
+    vm.addNativeMethod(writer, "toString", json_writer_to_string);
+    vm.addNativeMethod(writer, "toBuffer", json_writer_to_buffer);
+    vm.addNativeMethod(writer, "drain", json_writer_drain);
+    vm.addNativeProperty(writer, "bytes", json_writer_get_bytes, nullptr);
+    vm.addNativeProperty(writer, "depth", json_writer_get_depth, nullptr);
+    vm.addNativeProperty(writer, "error", json_writer_get_error, nullptr);
+}
+
+int native_json_parse(Interpreter *vm, int argCount, Value *args)
+{
+    const char *src;
+    size_t len;
+    if (argCount >= 1 && args[0].isString())
+    {
+        src = args[0].asStringChars();
+        len = args[0].asString()->length();
+    }
+    else if (argCount >= 1 && args[0].isBuffer())
+    {
+        // Raw bytes (e.g. file.read_all / zip read_buffer): no string is interned
+        BufferInstance *buf = args[0].asBuffer();
+        src = (const char *)buf->data;
+        len = (size_t)buf->count * (size_t)buf->elementSize;
+    }
+    else
+    {
+        vm->runtimeError("json.parse expects a JSON string or buffer");
+        return 0;
+    }
+
+    JsonParser parser(vm, src, len);
+    Value result;
+    if (!parser.parse(&result))
+    {
+        vm->runtimeError("json.parse: %s", parser.error().c_str());
+        return 0;
+    }
+
+    vm->push(result);
+    return 1;
+}
+
+int native_json_stringify(Interpreter *vm, int argCount, Value *args)
+{
+    if (argCount < 1)
+    {
+        vm->runtimeError("json.stringify expects value");
+        return 0;
+    }
+
+    JsonStringifyContext ctx;
+    if (argCount >= 2)
+    {
+        if (args[1].isBool())
+        {
+            ctx.pretty = args[1].asBool();
+            ctx.indentWidth = ctx.pretty ? 2 : 0;
+        }
+        else if (args[1].isInt())
+        {
+            int width = args[1].asInt();
+            if (width < 0)
+            {
+                width = 0;
+            }
+            if (width > 16)
+            {
+                width = 16;
+            }
+            ctx.indentWidth = width;
+            ctx.pretty = width > 0;
+        }
+        else
+        {
+            vm->runtimeError("json.stringify second argument must be bool or int");
+            return 0;
+        }
+    }
+
+    std::string output;
+    if (!jsonStringifyValue(args[0], 0, ctx, output))
+    {
+        vm->runtimeError("json.stringify: %s", ctx.error.c_str());
+        return 0;
+    }
+
+    vm->push(vm->makeString(output.c_str()));
+    return 1;
+}
+
+void Interpreter::registerJSON()
+{
+    addModule("json")
         .addFunction("parse", native_json_parse, 1)
         .addFunction("stringify", native_json_stringify, -1);
+
+    registerJsonStreamClasses(*this);
 }
 
 #endif
@@ -15,6 +15,7 @@
 #include <algorithm>
 #include <sstream>
 #include <iomanip>
+#include <chrono>
 
 #ifdef _WIN32
 #include <winsock2.h>
@@ -27,6 +28,7 @@
 #include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <unistd.h>
 #include <errno.h>
 #include <netdb.h>
@@ -36,6 +38,10 @@
 typedef int SOCKET;
 #endif
 
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
 enum class SocketType
 {
     TCP_SERVER,
@@ -183,299 +189,843 @@ struct HttpResponse
     bool success;
 };
 
-static HttpResponse parseHttpResponse(const std::string &rawResponse)
+static std::vector<SocketHandle *> openSockets;
+static int nextSocketId = 1;
+static bool wsaInitialized = false;
+
+// ============================================
+// DNS CACHE
+// getaddrinfo does not report record TTLs, so entries live for a fixed,
+// configurable time (socket.dns_ttl). Literal IPs never hit the resolver.
+// ============================================
+
+struct DnsCacheEntry
 {
-    HttpResponse response;
-    response.success = false;
-    response.statusCode = 0;
+    in_addr addr;
+    double expires;
+};
 
-    size_t headerEnd = rawResponse.find("\r\n\r\n");
-    if (headerEnd == std::string::npos)
+// ============================================
+// HTTP CONNECTION POOL
+// Idle keep-alive connections keyed by "host:port". A pooled socket is
+// checked with a zero-timeout poll() before reuse: an idle HTTP
+// connection that became readable was closed (or poisoned) by the server.
+// ============================================
+
+struct HttpPooledConnection
+{
+    SOCKET sock;
+    double idleSince;
+};
+
+// Pool e cache DNS de uma VM (Interpreter::getNetState): duas VMs nunca
+// partilham sockets. Os natives so correm na thread da VM (as threads de
+// setProcessWorkers nao chamam natives), por isso nao ha locks.
+struct NetState
+{
+    std::map<std::string, std::vector<HttpPooledConnection>> httpPool;
+    int httpMaxIdlePerHost = 8;
+    double httpIdleTimeout = 30.0;
+    int httpOpened = 0;
+    int httpReused = 0;
+
+    std::map<std::string, DnsCacheEntry> dnsCache;
+    double dnsTtlSeconds = 60.0;
+    int dnsHits = 0;
+    int dnsMisses = 0;
+};
+
+static double netNowSeconds()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool netResolveHost(NetState *net, const std::string &host, in_addr *out)
+{
+    if (inet_pton(AF_INET, host.c_str(), out) == 1)
     {
-        return response;
+        return true;
     }
 
-    std::string headerSection = rawResponse.substr(0, headerEnd);
-    response.body = rawResponse.substr(headerEnd + 4);
+    double now = netNowSeconds();
+    auto it = net->dnsCache.find(host);
+    if (it != net->dnsCache.end() && it->second.expires > now)
+    {
+        net->dnsHits++;
+        *out = it->second.addr;
+        return true;
+    }
+    net->dnsMisses++;
 
-    size_t lineEnd = headerSection.find("\r\n");
-    std::string statusLine = headerSection.substr(0, lineEnd);
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *res = nullptr;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &res) != 0 || !res)
+    {
+        if (it != net->dnsCache.end())
+        {
+            net->dnsCache.erase(it);
+        }
+        return false;
+    }
+    *out = ((sockaddr_in *)res->ai_addr)->sin_addr;
+    freeaddrinfo(res);
 
-    // Parse status line: "HTTP/1.1 200 OK"
-    size_t firstSpace = statusLine.find(' ');
-    size_t secondSpace = statusLine.find(' ', firstSpace + 1);
-    if (firstSpace != std::string::npos && secondSpace != std::string::npos)
+    if (net->dnsTtlSeconds > 0)
     {
-        response.statusCode = std::stoi(statusLine.substr(firstSpace + 1, secondSpace - firstSpace - 1));
-        response.statusText = statusLine.substr(secondSpace + 1);
+        DnsCacheEntry entry = {*out, now + net->dnsTtlSeconds};
+        net->dnsCache[host] = entry;
     }
+    return true;
+}
+
+// poll() em vez de select(): FD_SET e indefinido para fd >= FD_SETSIZE
+static bool httpConnectionIdle(SOCKET sock)
+{
+#ifdef _WIN32
+    WSAPOLLFD pfd;
+    pfd.fd = sock;
+    pfd.events = POLLRDNORM;
+    pfd.revents = 0;
+    return WSAPoll(&pfd, 1, 0) == 0;
+#else
+    struct pollfd pfd;
+    pfd.fd = sock;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    return poll(&pfd, 1, 0) == 0;
+#endif
+}
 
-    // Parse headers
-    size_t pos = lineEnd + 2;
-    while (pos < headerSection.length())
+static SOCKET httpPoolAcquire(NetState *net, const std::string &key)
+{
+    auto it = net->httpPool.find(key);
+    if (it == net->httpPool.end())
     {
-        size_t nextLine = headerSection.find("\r\n", pos);
-        if (nextLine == std::string::npos)
-            break;
+        return INVALID_SOCKET;
+    }
 
-        std::string line = headerSection.substr(pos, nextLine - pos);
-        size_t colon = line.find(':');
-        if (colon != std::string::npos)
+    double now = netNowSeconds();
+    std::vector<HttpPooledConnection> &idle = it->second;
+    while (!idle.empty())
+    {
+        HttpPooledConnection conn = idle.back();
+        idle.pop_back();
+        if (now - conn.idleSince <= net->httpIdleTimeout && httpConnectionIdle(conn.sock))
         {
-            std::string key = line.substr(0, colon);
-            std::string value = line.substr(colon + 2); // Skip ": "
-            response.headers[key] = value;
+            return conn.sock;
         }
-        pos = nextLine + 2;
+        closesocket(conn.sock);
     }
+    return INVALID_SOCKET;
+}
 
-    response.success = (response.statusCode >= 200 && response.statusCode < 300);
-    return response;
+static void httpPoolRelease(NetState *net, const std::string &key, SOCKET sock)
+{
+    std::vector<HttpPooledConnection> &idle = net->httpPool[key];
+    if ((int)idle.size() >= net->httpMaxIdlePerHost)
+    {
+        closesocket(sock);
+        return;
+    }
+    HttpPooledConnection conn = {sock, netNowSeconds()};
+    idle.push_back(conn);
 }
 
-static std::vector<SocketHandle *> openSockets;
-static int nextSocketId = 1;
-static bool wsaInitialized = false;
+static int httpPoolIdleCount(NetState *net)
+{
+    int count = 0;
+    for (const auto &entry : net->httpPool)
+    {
+        count += (int)entry.second.size();
+    }
+    return count;
+}
 
-static void SocketModuleCleanup()
+static void httpPoolClear(NetState *net)
 {
-    for (auto handle : openSockets)
+    for (auto &entry : net->httpPool)
     {
-        if (handle && handle->socket != INVALID_SOCKET)
+        for (const HttpPooledConnection &conn : entry.second)
         {
-            shutdown(handle->socket, SHUT_RDWR);
-            closesocket(handle->socket);
-            delete handle;
+            closesocket(conn.sock);
         }
     }
-    openSockets.clear();
+    net->httpPool.clear();
+}
 
-#ifdef _WIN32
-    if (wsaInitialized)
+NetState *Interpreter::getNetState()
+{
+    if (!netState_)
+        netState_ = new NetState();
+    return netState_;
+}
+
+void Interpreter::freeNetState()
+{
+    if (!netState_)
+        return;
+    httpPoolClear(netState_);
+    delete netState_;
+    netState_ = nullptr;
+}
+
+// ============================================
+// HTTP/1.1 EXCHANGE
+// ============================================
+
+struct HttpUrl
+{
+    std::string host;
+    int port;
+    std::string path;
+    std::string key; // pool key "host:port"
+};
+
+static bool httpParseUrl(const std::string &url, HttpUrl *out, std::string *error)
+{
+    size_t protoEnd = url.find("://");
+    if (protoEnd == std::string::npos)
     {
-        WSACleanup();
-        wsaInitialized = false;
+        *error = "Invalid URL";
+        return false;
     }
-#endif
+    if (url.compare(0, protoEnd, "https") == 0)
+    {
+        *error = "HTTPS not supported";
+        return false;
+    }
+
+    size_t hostStart = protoEnd + 3;
+    size_t pathStart = url.find('/', hostStart);
+    out->host = url.substr(hostStart, pathStart - hostStart);
+    out->path = (pathStart != std::string::npos) ? url.substr(pathStart) : "/";
+    out->port = 80;
+
+    size_t portPos = out->host.find(':');
+    if (portPos != std::string::npos)
+    {
+        out->port = atoi(out->host.c_str() + portPos + 1);
+        out->host = out->host.substr(0, portPos);
+    }
+    if (out->host.empty() || out->port <= 0 || out->port > 65535)
+    {
+        *error = "Invalid URL";
+        return false;
+    }
+    out->key = out->host + ":" + std::to_string(out->port);
+    return true;
 }
 
-int native_socket_init(Interpreter *vm, int argCount, Value *args)
+static SOCKET httpOpenConnection(NetState *net, const HttpUrl &url, std::string *error)
+{
+    in_addr ip;
+    if (!netResolveHost(net, url.host, &ip))
+    {
+        *error = "Host resolution failed";
+        return INVALID_SOCKET;
+    }
+
+    SOCKET sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (sock == INVALID_SOCKET)
+    {
+        *error = "Socket creation failed";
+        return INVALID_SOCKET;
+    }
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)url.port);
+    addr.sin_addr = ip;
+
+    if (connect(sock, (sockaddr *)&addr, sizeof(addr)) == SOCKET_ERROR)
+    {
+        closesocket(sock);
+        *error = "Connection failed";
+        return INVALID_SOCKET;
+    }
+
+    // Requests are written in one send; don't let Nagle hold the next one
+    int flag = 1;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (char *)&flag, sizeof(flag));
+    net->httpOpened++;
+    return sock;
+}
+
+static void httpSetTimeout(SOCKET sock, int seconds)
 {
-    bool result = false;
 #ifdef _WIN32
-    if (!wsaInitialized)
+    DWORD ms = (DWORD)seconds * 1000;
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (char *)&ms, sizeof(ms));
+    setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, (char *)&ms, sizeof(ms));
+#else
+    struct timeval tv;
+    tv.tv_sec = seconds;
+    tv.tv_usec = 0;
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (char *)&tv, sizeof(tv));
+    setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, (char *)&tv, sizeof(tv));
+#endif
+}
+
+static bool httpSendAll(SOCKET sock, const std::string &data)
+{
+    size_t sent = 0;
+    while (sent < data.size())
     {
-        WSADATA wsaData;
-        int result = WSAStartup(MAKEWORD(2, 2), &wsaData);
-        if (result != 0)
+        int n = send(sock, data.data() + sent, (int)(data.size() - sent), MSG_NOSIGNAL);
+        if (n <= 0)
         {
-            vm->runtimeError("WSAStartup failed: %d", result);
-            vm->push(vm->makeBool(false));
+            return false;
         }
-        wsaInitialized = true;
+        sent += (size_t)n;
     }
-#endif
-    vm->push(vm->makeBool(result));
-    return 1;
+    return true;
 }
 
-int native_socket_quit(Interpreter *vm, int argCount, Value *args)
+// Buffered reads from one connection; the body goes to `body` or `sink`.
+struct HttpConnReader
 {
-    SocketModuleCleanup();
-    return 0;
+    SOCKET sock;
+    std::string buf;
+    size_t pos;
+    size_t received;
+
+    explicit HttpConnReader(SOCKET s) : sock(s), pos(0), received(0) {}
+
+    bool fill()
+    {
+        if (pos > 0 && pos == buf.size())
+        {
+            buf.clear();
+            pos = 0;
+        }
+        else if (pos > 64 * 1024)
+        {
+            buf.erase(0, pos);
+            pos = 0;
+        }
+        char chunk[16 * 1024];
+        int n = recv(sock, chunk, sizeof(chunk), 0);
+        if (n <= 0)
+        {
+            return false;
+        }
+        buf.append(chunk, (size_t)n);
+        received += (size_t)n;
+        return true;
+    }
+
+    bool readLine(std::string *line)
+    {
+        for (;;)
+        {
+            size_t end = buf.find("\r\n", pos);
+            if (end != std::string::npos)
+            {
+                line->assign(buf, pos, end - pos);
+                pos = end + 2;
+                return true;
+            }
+            if (!fill())
+            {
+                return false;
+            }
+        }
+    }
+
+    static void emit(const char *data, size_t n, std::string *body, FILE *sink)
+    {
+        if (sink)
+        {
+            fwrite(data, 1, n, sink);
+        }
+        else
+        {
+            body->append(data, n);
+        }
+    }
+
+    bool readExact(size_t n, std::string *body, FILE *sink)
+    {
+        while (n > 0)
+        {
+            if (pos == buf.size() && !fill())
+            {
+                return false;
+            }
+            size_t take = std::min(n, buf.size() - pos);
+            emit(buf.data() + pos, take, body, sink);
+            pos += take;
+            n -= take;
+        }
+        return true;
+    }
+
+    void readToEnd(std::string *body, FILE *sink)
+    {
+        do
+        {
+            emit(buf.data() + pos, buf.size() - pos, body, sink);
+            pos = buf.size();
+        } while (fill());
+    }
+
+    bool readChunked(std::string *body, FILE *sink)
+    {
+        std::string line;
+        for (;;)
+        {
+            if (!readLine(&line))
+            {
+                return false;
+            }
+            char *end = nullptr;
+            unsigned long long size = strtoull(line.c_str(), &end, 16);
+            if (end == line.c_str())
+            {
+                return false;
+            }
+            if (size == 0)
+            {
+                // Trailer headers end with an empty line
+                while (readLine(&line) && !line.empty())
+                {
+                }
+                return true;
+            }
+            if (!readExact((size_t)size, body, sink) || !readLine(&line))
+            {
+                return false;
+            }
+        }
+    }
+};
+
+static bool httpHeaderEquals(const std::string &a, const char *b)
+{
+    size_t n = strlen(b);
+    if (a.size() != n)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < n; i++)
+    {
+        if (tolower((unsigned char)a[i]) != tolower((unsigned char)b[i]))
+        {
+            return false;
+        }
+    }
+    return true;
 }
 
-//
-// REQUESTS
-//
+static bool httpHeaderContains(const std::string &value, const char *token)
+{
+    std::string lower(value);
+    for (size_t i = 0; i < lower.size(); i++)
+    {
+        lower[i] = (char)tolower((unsigned char)lower[i]);
+    }
+    return lower.find(token) != std::string::npos;
+}
 
-// =============================================================
-// FUNCTION: HTTP GET Completo
-// =============================================================
-int native_socket_http_get(Interpreter *vm, int argCount, Value *args)
+static const std::string *httpFindHeader(const HttpResponse &response, const char *name)
 {
-    if (argCount < 1 || !args[0].isString())
+    for (const auto &h : response.headers)
     {
-        vm->runtimeError("http_get expects (url, [options_map])");
-        return 0;
+        if (httpHeaderEquals(h.first, name))
+        {
+            return &h.second;
+        }
     }
+    return nullptr;
+}
 
-    std::string url = args[0].asStringChars();
+struct HttpExchange
+{
+    const HttpUrl *url;
+    std::string request; // head + body
+    bool headOnly;       // no body expected (HEAD)
+    bool idempotent;     // GET/HEAD: safe to resend after the server saw it
+    bool keepAlive;
+    int timeout;
+    FILE *sink; // stream the body to a file instead of response.body
+
+    // Results
+    size_t received;
+    bool reused;
+    std::string error;
+};
 
-    // --- DEFAULTS ---
-    std::map<std::string, std::string> customHeaders;
-    std::string queryParams;
-    std::string userAgent = "SocketModule/1.0";
-    int timeout = 30;
+// Reads status line + headers; false if the connection yielded nothing.
+// Interim 1xx responses (100 Continue, 103 Early Hints) are skipped; 101 is
+// final (we never ask for an upgrade, but it ends the HTTP exchange).
+static bool httpReadHead(HttpConnReader &reader, HttpResponse &response, bool *keepAlive)
+{
+    std::string line;
+    for (;;)
+    {
+        if (!reader.readLine(&line))
+        {
+            return false;
+        }
+        size_t space = line.find(' ');
+        int code = space != std::string::npos ? atoi(line.c_str() + space + 1) : 0;
+        if (line.compare(0, 5, "HTTP/") != 0 || code < 100 || code >= 200 || code == 101)
+        {
+            break;
+        }
+        while (reader.readLine(&line) && !line.empty())
+        {
+        }
+    }
 
-    // --- PARSE OPTIONS ---
-    if (argCount >= 2 && args[1].isMap())
+    // "HTTP/1.1 200 OK"
+    size_t firstSpace = line.find(' ');
+    if (line.compare(0, 5, "HTTP/") != 0 || firstSpace == std::string::npos)
     {
-        MapInstance *options = args[1].asMap();
-        Value val;
+        return false;
+    }
+    bool http10 = line.compare(0, 8, "HTTP/1.0") == 0;
+    response.statusCode = atoi(line.c_str() + firstSpace + 1);
+    size_t secondSpace = line.find(' ', firstSpace + 1);
+    response.statusText = secondSpace != std::string::npos ? line.substr(secondSpace + 1) : "";
 
-        // 1. Headers
-        if (options->table.get(vm->makeString("headers"), &val))
+    while (reader.readLine(&line) && !line.empty())
+    {
+        size_t colon = line.find(':');
+        if (colon == std::string::npos)
         {
-            if (val.isMap())
-                customHeaders = extractHeaders(vm, val);
+            continue;
         }
+        size_t valueStart = colon + 1;
+        while (valueStart < line.size() && (line[valueStart] == ' ' || line[valueStart] == '\t'))
+        {
+            valueStart++;
+        }
+        response.headers[line.substr(0, colon)] = line.substr(valueStart);
+    }
 
-        // 2. Params
-        if (options->table.get(vm->makeString("params"), &val))
+    const std::string *connection = httpFindHeader(response, "Connection");
+    if (connection && httpHeaderContains(*connection, "close"))
+    {
+        *keepAlive = false;
+    }
+    else if (http10 && !(connection && httpHeaderContains(*connection, "keep-alive")))
+    {
+        *keepAlive = false;
+    }
+    return true;
+}
+
+// One request/response on a pooled or new connection. A reused connection
+// that fails before any response byte arrives (closed by the server while
+// idle) is retried once on a fresh connection: always when the request could
+// not be written, otherwise only for idempotent methods (a POST that reached
+// the server must not run twice).
+static bool httpPerform(NetState *net, HttpExchange &ex, HttpResponse &response)
+{
+    response.success = false;
+    response.statusCode = 0;
+    ex.received = 0;
+    ex.reused = false;
+
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        SOCKET sock = ex.keepAlive ? httpPoolAcquire(net, ex.url->key) : INVALID_SOCKET;
+        bool reused = sock != INVALID_SOCKET;
+        if (!reused)
         {
-            if (val.isMap())
-                queryParams = buildQueryString(vm, val);
+            sock = httpOpenConnection(net, *ex.url, &ex.error);
+            if (sock == INVALID_SOCKET)
+            {
+                return false;
+            }
+        }
+        else
+        {
+            net->httpReused++;
         }
+        httpSetTimeout(sock, ex.timeout);
 
-        // 3. Timeout
-        if (options->table.get(vm->makeString("timeout"), &val))
+        HttpConnReader reader(sock);
+        bool keepAlive = ex.keepAlive;
+        bool sent = httpSendAll(sock, ex.request);
+        if (!sent || !httpReadHead(reader, response, &keepAlive))
         {
-            if (val.isInt())
-                timeout = val.asInt();
+            closesocket(sock);
+            if (reused && reader.received == 0 && (!sent || ex.idempotent))
+            {
+                response.headers.clear();
+                continue;
+            }
+            ex.error = reader.received == 0 ? "No response" : "Malformed response";
+            return false;
         }
 
-        // 4. User Agent Explícito
-        if (options->table.get(vm->makeString("user_agent"), &val))
+        bool complete = true;
+        int code = response.statusCode;
+        const std::string *transfer = httpFindHeader(response, "Transfer-Encoding");
+        const std::string *length = httpFindHeader(response, "Content-Length");
+        if (ex.headOnly || code == 101 || code == 204 || code == 304)
         {
-            if (val.isString())
-                userAgent = val.asStringChars();
+            // No body
+        }
+        else if (transfer && httpHeaderContains(*transfer, "chunked"))
+        {
+            complete = reader.readChunked(&response.body, ex.sink);
         }
+        else if (length)
+        {
+            complete = reader.readExact((size_t)strtoull(length->c_str(), nullptr, 10), &response.body, ex.sink);
+        }
+        else
+        {
+            // Body delimited by connection close
+            reader.readToEnd(&response.body, ex.sink);
+            keepAlive = false;
+        }
+
+        ex.received = reader.received;
+        ex.reused = reused;
+        if (complete && keepAlive && reader.pos == reader.buf.size())
+        {
+            httpPoolRelease(net, ex.url->key, sock);
+        }
+        else
+        {
+            closesocket(sock);
+        }
+        response.success = complete && code >= 200 && code < 300;
+        if (!complete)
+        {
+            ex.error = "Connection closed mid-body";
+        }
+        return true;
     }
 
-    // --- LÓGICA USER-AGENT (Evita Duplicados) ---
-    // Procura se o user agent já está nos headers customizados
-    auto itUA = customHeaders.find("User-Agent");
-    if (itUA == customHeaders.end())
-        itUA = customHeaders.find("user-agent");
+    ex.error = "Connection failed";
+    return false;
+}
+
+// Shared request head: request line, Host, User-Agent, Connection, custom headers
+static std::string httpBuildHead(const char *method, const HttpUrl &url, const std::string &userAgent,
+                                 bool keepAlive, const std::map<std::string, std::string> &headers)
+{
+    std::string head;
+    head.reserve(256);
+    head += method;
+    head += ' ';
+    head += url.path;
+    head += " HTTP/1.1\r\nHost: ";
+    head += url.host;
+    if (url.port != 80)
+    {
+        head += ':';
+        head += std::to_string(url.port);
+    }
+    head += "\r\nUser-Agent: ";
+    head += userAgent;
+    head += keepAlive ? "\r\nConnection: keep-alive\r\n" : "\r\nConnection: close\r\n";
+    for (const auto &header : headers)
+    {
+        head += header.first + ": " + header.second + "\r\n";
+    }
+    return head;
+}
+
+static Value httpResponseToMap(Interpreter *vm, const HttpResponse &httpResp, const std::string &url,
+                               const HttpExchange &ex)
+{
+    Value result = vm->makeMap();
+    vm->push(result); // GC root while the map is filled
+    MapInstance *map = result.asMap();
+
+    map->table.set(vm->makeString("status_code"), vm->makeInt(httpResp.statusCode));
+    map->table.set(vm->makeString("status_text"), vm->makeString(httpResp.statusText.c_str()));
+    map->table.set(vm->makeString("body"),
+                   vm->makeString(vm->createString(httpResp.body.c_str(), (uint32)httpResp.body.size())));
+    map->table.set(vm->makeString("success"), vm->makeBool(httpResp.success));
+    map->table.set(vm->makeString("url"), vm->makeString(url.c_str()));
+    map->table.set(vm->makeString("received"), vm->makeInt((int)ex.received));
+    map->table.set(vm->makeString("reused"), vm->makeBool(ex.reused));
 
-    if (itUA != customHeaders.end())
+    Value headersMap = vm->makeMap();
+    MapInstance *headers = headersMap.asMap();
+    for (const auto &h : httpResp.headers)
     {
-        userAgent = itUA->second;  // Usa o do header
-        customHeaders.erase(itUA); // Remove do mapa para não enviar 2x
+        headers->table.set(vm->makeString(h.first.c_str()), vm->makeString(h.second.c_str()));
     }
+    map->table.set(vm->makeString("headers"), headersMap);
+
+    vm->pop();
+    return result;
+}
 
-    // --- CONSTRUÇÃO URL ---
-    if (!queryParams.empty())
+// Common options: headers, timeout, user_agent, keep_alive
+static void httpReadCommonOptions(Interpreter *vm, Value options, std::map<std::string, std::string> *customHeaders,
+                                  int *timeout, std::string *userAgent, bool *keepAlive)
+{
+    if (!options.isMap())
     {
-        url += (url.find('?') != std::string::npos) ? "&" : "?";
-        url += queryParams;
+        return;
     }
+    MapInstance *map = options.asMap();
+    Value val;
 
-    // --- PARSE URL ---
-    size_t protoEnd = url.find("://");
-    if (protoEnd == std::string::npos)
+    if (map->table.get(vm->makeString("headers"), &val) && val.isMap())
     {
-        vm->runtimeError("Invalid URL");
-        return 0;
+        *customHeaders = extractHeaders(vm, val);
+    }
+    if (map->table.get(vm->makeString("timeout"), &val) && val.isInt())
+    {
+        *timeout = val.asInt();
+    }
+    if (map->table.get(vm->makeString("user_agent"), &val) && val.isString())
+    {
+        *userAgent = val.asStringChars();
+    }
+    if (map->table.get(vm->makeString("keep_alive"), &val) && val.isBool())
+    {
+        *keepAlive = val.asBool();
     }
 
-    std::string protocol = url.substr(0, protoEnd);
-    if (protocol == "https")
+    // User-Agent / Connection given as headers win over the defaults
+    for (auto it = customHeaders->begin(); it != customHeaders->end();)
     {
-        vm->runtimeError("HTTPS not supported");
-        return 0;
+        if (httpHeaderEquals(it->first, "User-Agent"))
+        {
+            *userAgent = it->second;
+            it = customHeaders->erase(it);
+        }
+        else if (httpHeaderEquals(it->first, "Connection"))
+        {
+            *keepAlive = !httpHeaderContains(it->second, "close");
+            it = customHeaders->erase(it);
+        }
+        else
+        {
+            ++it;
+        }
     }
+}
 
-    size_t hostStart = protoEnd + 3;
-    size_t pathStart = url.find('/', hostStart);
+static void SocketModuleCleanup()
+{
+    for (auto handle : openSockets)
+    {
+        if (handle && handle->socket != INVALID_SOCKET)
+        {
+            shutdown(handle->socket, SHUT_RDWR);
+            closesocket(handle->socket);
+            delete handle;
+        }
+    }
+    openSockets.clear();
 
-    std::string host = url.substr(hostStart, pathStart - hostStart);
-    std::string path = (pathStart != std::string::npos) ? url.substr(pathStart) : "/";
+#ifdef _WIN32
+    if (wsaInitialized)
+    {
+        WSACleanup();
+        wsaInitialized = false;
+    }
+#endif
+}
 
-    int port = 80;
-    size_t portPos = host.find(':');
-    if (portPos != std::string::npos)
+int native_socket_init(Interpreter *vm, int argCount, Value *args)
+{
+    bool result = false;
+#ifdef _WIN32
+    if (!wsaInitialized)
     {
-        port = std::stoi(host.substr(portPos + 1));
-        host = host.substr(0, portPos);
+        WSADATA wsaData;
+        int result = WSAStartup(MAKEWORD(2, 2), &wsaData);
+        if (result != 0)
+        {
+            vm->runtimeError("WSAStartup failed: %d", result);
+            vm->push(vm->makeBool(false));
+        }
+        wsaInitialized = true;
     }
+#endif
+    vm->push(vm->makeBool(result));
+    return 1;
+}
 
-    // --- SOCKET CONNECT ---
-    SOCKET sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
-    if (sock == INVALID_SOCKET)
-    {
-        vm->runtimeError("Socket creation failed");
-        return 0;
-    }
+int native_socket_quit(Interpreter *vm, int argCount, Value *args)
+{
+    SocketModuleCleanup();
+    return 0;
+}
 
-    struct timeval tv;
-    tv.tv_sec = timeout;
-    tv.tv_usec = 0;
-    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (char *)&tv, sizeof(tv));
-    setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, (char *)&tv, sizeof(tv));
+//
+// REQUESTS
+//
 
-    struct hostent *he = gethostbyname(host.c_str());
-    if (!he)
+// =============================================================
+// FUNCTION: HTTP GET Completo
+// =============================================================
+int native_socket_http_get(Interpreter *vm, int argCount, Value *args)
+{
+    if (argCount < 1 || !args[0].isString())
     {
-        closesocket(sock);
-        vm->runtimeError("Host resolution failed");
+        vm->runtimeError("http_get expects (url, [options_map])");
         return 0;
     }
 
-    sockaddr_in addr = {0};
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(port);
-    memcpy(&addr.sin_addr, he->h_addr_list[0], he->h_length);
-
-    if (connect(sock, (sockaddr *)&addr, sizeof(addr)) == SOCKET_ERROR)
-    {
-        closesocket(sock);
-        vm->runtimeError("Connection failed");
-        return 0;
-    }
+    std::string url = args[0].asStringChars();
 
-    // --- SEND REQUEST ---
-    std::string request = "GET " + path + " HTTP/1.1\r\n";
-    request += "Host: " + host + "\r\n";
-    request += "User-Agent: " + userAgent + "\r\n";
-    request += "Connection: close\r\n";
+    // --- DEFAULTS ---
+    std::map<std::string, std::string> customHeaders;
+    std::string userAgent = "SocketModule/1.0";
+    int timeout = 30;
+    bool keepAlive = true;
 
-    for (const auto &header : customHeaders)
+    // --- PARSE OPTIONS ---
+    if (argCount >= 2 && args[1].isMap())
     {
-        request += header.first + ": " + header.second + "\r\n";
-    }
-    request += "\r\n";
+        httpReadCommonOptions(vm, args[1], &customHeaders, &timeout, &userAgent, &keepAlive);
 
-    if (send(sock, request.c_str(), request.length(), 0) == SOCKET_ERROR)
-    {
-        closesocket(sock);
-        return 0;
+        Value val;
+        if (args[1].asMap()->table.get(vm->makeString("params"), &val) && val.isMap())
+        {
+            std::string queryParams = buildQueryString(vm, val);
+            if (!queryParams.empty())
+            {
+                url += (url.find('?') != std::string::npos) ? "&" : "?";
+                url += queryParams;
+            }
+        }
     }
 
-    // --- RECEIVE RESPONSE ---
-    std::string response;
-    char buffer[4096];
-    int received;
-
-    while ((received = recv(sock, buffer, sizeof(buffer), 0)) > 0)
+    HttpUrl target;
+    std::string error;
+    if (!httpParseUrl(url, &target, &error))
     {
-        response.append(buffer, received);
+        vm->runtimeError("%s", error.c_str());
+        return 0;
     }
-    closesocket(sock);
-
-    // --- PARSE & RETURN ---
-    HttpResponse httpResp = parseHttpResponse(response);
 
-    Value result = vm->makeMap();
-    MapInstance *map = result.asMap();
-
-    map->table.set(vm->makeString("status_code"), vm->makeInt(httpResp.statusCode));
-    map->table.set(vm->makeString("status_text"), vm->makeString(httpResp.statusText.c_str()));
-    map->table.set(vm->makeString("body"), vm->makeString(httpResp.body.c_str()));
-    map->table.set(vm->makeString("success"), vm->makeBool(httpResp.success));
-    map->table.set(vm->makeString("url"), vm->makeString(url.c_str()));
-    map->table.set(vm->makeString("received"), vm->makeInt(response.length()));
+    HttpExchange ex;
+    ex.url = &target;
+    ex.request = httpBuildHead("GET", target, userAgent, keepAlive, customHeaders);
+    ex.request += "\r\n";
+    ex.headOnly = false;
+    ex.idempotent = true;
+    ex.keepAlive = keepAlive;
+    ex.timeout = timeout;
+    ex.sink = nullptr;
 
-    Value headersMap = vm->makeMap();
-    MapInstance *headers = headersMap.asMap();
-    for (const auto &h : httpResp.headers)
+    HttpResponse httpResp;
+    if (!httpPerform(vm->getNetState(), ex, httpResp))
     {
-        headers->table.set(vm->makeString(h.first.c_str()), vm->makeString(h.second.c_str()));
+        vm->runtimeError("%s", ex.error.c_str());
+        return 0;
     }
-    map->table.set(vm->makeString("headers"), headersMap);
 
-    vm->push(result);
+    vm->push(httpResponseToMap(vm, httpResp, url, ex));
     return 1;
 }
 
@@ -568,26 +1118,22 @@ int native_socket_http_post(Interpreter *vm, int argCount, Value *args)
     std::string contentType = "application/x-www-form-urlencoded"; // Default
     std::string userAgent = "SocketModule/1.0";
     int timeout = 30;
+    bool keepAlive = true;
 
     // --- PARSE OPTIONS ---
     if (argCount >= 2 && args[1].isMap())
     {
+        httpReadCommonOptions(vm, args[1], &customHeaders, &timeout, &userAgent, &keepAlive);
+
         MapInstance *options = args[1].asMap();
         Value val;
 
-        // 1. Headers
-        if (options->table.get(vm->makeString("headers"), &val))
-        {
-            if (val.isMap())
-                customHeaders = extractHeaders(vm, val);
-        }
-
-        // 2. Data (Raw String ou Form Map)
+        // Data (Raw String ou Form Map)
         if (options->table.get(vm->makeString("data"), &val))
         {
             if (val.isString())
             {
-                postData = val.asStringChars();
+                postData.assign(val.asStringChars(), val.asString()->length());
             }
             else if (val.isMap())
             {
@@ -595,165 +1141,53 @@ int native_socket_http_post(Interpreter *vm, int argCount, Value *args)
             }
         }
 
-        // 3. JSON (Auto-serialize) - TEM PRIORIDADE SOBRE 'data'
+        // JSON (Auto-serialize) - TEM PRIORIDADE SOBRE 'data'
         if (options->table.get(vm->makeString("json"), &val))
         {
-            //   serializa   JSON
             postData = serializeJson(vm, val);
             contentType = "application/json";
         }
-
-        // 4. Timeout
-        if (options->table.get(vm->makeString("timeout"), &val))
-        {
-            if (val.isInt())
-                timeout = val.asInt();
-        }
-
-        // 5. User Agent Explícito
-        if (options->table.get(vm->makeString("user_agent"), &val))
-        {
-            if (val.isString())
-                userAgent = val.asStringChars();
-        }
-    }
-
-    // --- SMART HEADERS MANAGEMENT ---
-    // User-Agent: Se existir nos headers,
-    auto itUA = customHeaders.find("User-Agent");
-    if (itUA == customHeaders.end())
-        itUA = customHeaders.find("user-agent");
-    if (itUA != customHeaders.end())
-    {
-        userAgent = itUA->second;
-        customHeaders.erase(itUA);
-    }
-
-    // Content-Type: Se existir nos headers,
-    auto itCT = customHeaders.find("Content-Type");
-    if (itCT == customHeaders.end())
-        itCT = customHeaders.find("content-type");
-    if (itCT != customHeaders.end())
-    {
-        contentType = itCT->second;
-        customHeaders.erase(itCT);
-    }
-
-    // --- URL PARSING ---
-    size_t protoEnd = url.find("://");
-    if (protoEnd == std::string::npos)
-    {
-        vm->runtimeError("Invalid URL");
-        return 0;
-    }
-
-    std::string protocol = url.substr(0, protoEnd);
-    if (protocol == "https")
-    {
-        vm->runtimeError("HTTPS not supported");
-        return 0;
-    }
-
-    size_t hostStart = protoEnd + 3;
-    size_t pathStart = url.find('/', hostStart);
-    std::string host = url.substr(hostStart, pathStart - hostStart);
-    std::string path = (pathStart != std::string::npos) ? url.substr(pathStart) : "/";
-    int port = 80;
-    size_t portPos = host.find(':');
-    if (portPos != std::string::npos)
-    {
-        port = std::stoi(host.substr(portPos + 1));
-        host = host.substr(0, portPos);
-    }
-
-    // --- SOCKET CONNECT ---
-    SOCKET sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
-    if (sock == INVALID_SOCKET)
-    {
-        vm->runtimeError("Socket error");
-        return 0;
     }
 
-    struct timeval tv;
-    tv.tv_sec = timeout;
-    tv.tv_usec = 0;
-    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (char *)&tv, sizeof(tv));
-    setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, (char *)&tv, sizeof(tv));
-
-    struct hostent *he = gethostbyname(host.c_str());
-    if (!he)
+    // Content-Type: Se existir nos headers, substitui o default
+    for (auto it = customHeaders.begin(); it != customHeaders.end(); ++it)
     {
-        closesocket(sock);
-        vm->runtimeError("DNS error");
-        return 0;
+        if (httpHeaderEquals(it->first, "Content-Type"))
+        {
+            contentType = it->second;
+            customHeaders.erase(it);
+            break;
+        }
     }
 
-    sockaddr_in addr = {0};
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(port);
-    memcpy(&addr.sin_addr, he->h_addr_list[0], he->h_length);
-
-    if (connect(sock, (sockaddr *)&addr, sizeof(addr)) == SOCKET_ERROR)
+    HttpUrl target;
+    std::string error;
+    if (!httpParseUrl(url, &target, &error))
     {
-        closesocket(sock);
-        vm->runtimeError("Connection failed");
+        vm->runtimeError("%s", error.c_str());
         return 0;
     }
 
-    // --- BUILD REQUEST ---
-    std::string request = "POST " + path + " HTTP/1.1\r\n";
-    request += "Host: " + host + "\r\n";
-    request += "User-Agent: " + userAgent + "\r\n";
-    request += "Content-Type: " + contentType + "\r\n";
-    request += "Content-Length: " + std::to_string(postData.length()) + "\r\n";
-    request += "Connection: close\r\n";
-
-    for (const auto &header : customHeaders)
-    {
-        request += header.first + ": " + header.second + "\r\n";
-    }
-
-    request += "\r\n";
-    request += postData;
+    HttpExchange ex;
+    ex.url = &target;
+    ex.request = httpBuildHead("POST", target, userAgent, keepAlive, customHeaders);
+    ex.request += "Content-Type: " + contentType + "\r\n";
+    ex.request += "Content-Length: " + std::to_string(postData.length()) + "\r\n\r\n";
+    ex.request += postData;
+    ex.headOnly = false;
+    ex.idempotent = false;
+    ex.keepAlive = keepAlive;
+    ex.timeout = timeout;
+    ex.sink = nullptr;
 
-    // --- SEND & RECEIVE ---
-    if (send(sock, request.c_str(), request.length(), 0) == SOCKET_ERROR)
+    HttpResponse httpResp;
+    if (!httpPerform(vm->getNetState(), ex, httpResp))
     {
-        closesocket(sock);
+        vm->runtimeError("%s", ex.error.c_str());
         return 0;
     }
 
-    std::string response;
-    char buffer[4096];
-    int received;
-    while ((received = recv(sock, buffer, sizeof(buffer), 0)) > 0)
-    {
-        response.append(buffer, received);
-    }
-    closesocket(sock);
-
-    // --- RESPONSE ---
-    HttpResponse httpResp = parseHttpResponse(response);
-
-    Value result = vm->makeMap();
-    MapInstance *map = result.asMap();
-
-    map->table.set(vm->makeString("status_code"), vm->makeInt(httpResp.statusCode));
-    map->table.set(vm->makeString("status_text"), vm->makeString(httpResp.statusText.c_str()));
-    map->table.set(vm->makeString("body"), vm->makeString(httpResp.body.c_str()));
-    map->table.set(vm->makeString("success"), vm->makeBool(httpResp.success));
-    map->table.set(vm->makeString("url"), vm->makeString(url.c_str()));
-
-    Value headersMap = vm->makeMap();
-    MapInstance *headers = headersMap.asMap();
-    for (const auto &h : httpResp.headers)
-    {
-        headers->table.set(vm->makeString(h.first.c_str()), vm->makeString(h.second.c_str()));
-    }
-    map->table.set(vm->makeString("headers"), headersMap);
-
-    vm->push(result);
-
+    vm->push(httpResponseToMap(vm, httpResp, url, ex));
     return 1;
 }
 
@@ -786,17 +1220,18 @@ int native_socket_ping(Interpreter *vm, int argCount, Value *args)
     setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (char *)&tv, sizeof(tv));
     setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, (char *)&tv, sizeof(tv));
 
-    struct hostent *he = gethostbyname(host);
-    if (!he)
+    in_addr ip;
+    if (!netResolveHost(vm->getNetState(), host, &ip))
     {
         closesocket(sock);
+        vm->push(vm->makeBool(false));
         return 1;
     }
 
     sockaddr_in addr = {0};
     addr.sin_family = AF_INET;
     addr.sin_port = htons(port);
-    memcpy(&addr.sin_addr, he->h_addr_list[0], he->h_length);
+    addr.sin_addr = ip;
 
     bool success = (connect(sock, (sockaddr *)&addr, sizeof(addr)) != SOCKET_ERROR);
     closesocket(sock);
@@ -805,104 +1240,59 @@ int native_socket_ping(Interpreter *vm, int argCount, Value *args)
     return 1;
 }
 
+
 // Download de file (Streamed to disk para não encher a RAM)
 int native_socket_download_file(Interpreter *vm, int argCount, Value *args)
 {
     if (argCount < 2 || !args[0].isString() || !args[1].isString())
     {
-        vm->runtimeError("download_file expects (url, filepath)");
+        vm->runtimeError("download_file expects (url, filepath, [options_map])");
+        vm->push(vm->makeBool(false));
         return 1;
     }
 
     std::string url = args[0].asStringChars();
     std::string filepath = args[1].asStringChars();
 
-    // 1. Parse URL (Host/Path/Port) - Reutiliza lógica do http_get
-    size_t protoEnd = url.find("://");
-    if (protoEnd == std::string::npos)
-        return 1;
-    size_t hostStart = protoEnd + 3;
-    size_t pathStart = url.find('/', hostStart);
-    std::string host = url.substr(hostStart, pathStart - hostStart);
-    std::string path = (pathStart != std::string::npos) ? url.substr(pathStart) : "/";
-    int port = 80;
-    size_t portPos = host.find(':');
-    if (portPos != std::string::npos)
-    {
-        port = std::stoi(host.substr(portPos + 1));
-        host = host.substr(0, portPos);
-    }
-
-    // 2. Connect
-    SOCKET sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
-    if (sock == INVALID_SOCKET)
-        return 1;
-
-    struct hostent *he = gethostbyname(host.c_str());
-    if (!he)
+    std::map<std::string, std::string> customHeaders;
+    std::string userAgent = "SocketModule/1.0";
+    int timeout = 30;
+    bool keepAlive = true;
+    if (argCount >= 3 && args[2].isMap())
     {
-        closesocket(sock);
-        return 1;
+        httpReadCommonOptions(vm, args[2], &customHeaders, &timeout, &userAgent, &keepAlive);
     }
 
-    sockaddr_in addr = {0};
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(port);
-    memcpy(&addr.sin_addr, he->h_addr_list[0], he->h_length);
-
-    if (connect(sock, (sockaddr *)&addr, sizeof(addr)) == SOCKET_ERROR)
+    HttpUrl target;
+    std::string error;
+    if (!httpParseUrl(url, &target, &error))
     {
-        closesocket(sock);
+        vm->push(vm->makeBool(false));
         return 1;
     }
 
-    // 3. Send Request
-    std::string request = "GET " + path + " HTTP/1.1\r\nHost: " + host + "\r\nConnection: close\r\n\r\n";
-    send(sock, request.c_str(), request.length(), 0);
-
-    // 4. Open File
     FILE *file = fopen(filepath.c_str(), "wb");
     if (!file)
     {
-        closesocket(sock);
+        vm->push(vm->makeBool(false));
         return 1;
     }
 
-    // 5. Receive & Skip Headers
-    char buffer[4096];
-    int received;
-    bool headerFinished = false;
-    std::string headerBuffer;
-
-    while ((received = recv(sock, buffer, sizeof(buffer), 0)) > 0)
-    {
-        if (!headerFinished)
-        {
-            headerBuffer.append(buffer, received);
-            size_t headerEnd = headerBuffer.find("\r\n\r\n");
-
-            if (headerEnd != std::string::npos)
-            {
-                // Header found! Write the rest to file
-                headerFinished = true;
-                size_t bodyStart = headerEnd + 4;
-                if (bodyStart < headerBuffer.length())
-                {
-                    fwrite(headerBuffer.data() + bodyStart, 1, headerBuffer.length() - bodyStart, file);
-                }
-            }
-        }
-        else
-        {
-            // Write body directly to disk
-            fwrite(buffer, 1, received, file);
-        }
-    }
+    HttpExchange ex;
+    ex.url = &target;
+    ex.request = httpBuildHead("GET", target, userAgent, keepAlive, customHeaders);
+    ex.request += "\r\n";
+    ex.headOnly = false;
+    ex.idempotent = true;
+    ex.keepAlive = keepAlive;
+    ex.timeout = timeout;
+    ex.sink = file;
 
+    HttpResponse httpResp;
+    bool ok = httpPerform(vm->getNetState(), ex, httpResp) && httpResp.success;
     fclose(file);
-    closesocket(sock);
 
-    vm->push(vm->makeBool(true));
+    vm->push(vm->makeBool(ok));
     return 1;
 }
 
@@ -922,25 +1312,14 @@ int native_socket_resolve(Interpreter *vm, int argCount, Value *args)
 
     const char *hostname = args[0].asStringChars();
 
-    struct hostent *he = gethostbyname(hostname);
-
-    if (he == nullptr)
+    struct in_addr addr;
+    if (!netResolveHost(vm->getNetState(), hostname, &addr))
     {
-
         return 0;
     }
 
-    if (he->h_addr_list && he->h_addr_list[0])
-    {
-        struct in_addr addr;
-
-        memcpy(&addr, he->h_addr_list[0], sizeof(struct in_addr));
-
-        vm->push(vm->makeString(inet_ntoa(addr)));
-        return 1;
-    }
-
-    return 0;
+    vm->push(vm->makeString(inet_ntoa(addr)));
+    return 1;
 }
 
 int native_socket_get_local_ip(Interpreter *vm, int argCount, Value *args)
@@ -1084,8 +1463,8 @@ int native_socket_tcp_connect(Interpreter *vm, int argCount, Value *args)
     const char *host = args[0].asStringChars();
     int port = args[1].asInt();
 
-    struct hostent *he = gethostbyname(host);
-    if (!he)
+    in_addr ip;
+    if (!netResolveHost(vm->getNetState(), host, &ip))
     {
         vm->runtimeError("Failed to resolve hostname '%s'", host);
         return 0;
@@ -1101,7 +1480,7 @@ int native_socket_tcp_connect(Interpreter *vm, int argCount, Value *args)
     sockaddr_in addr = {0};
     addr.sin_family = AF_INET;
     addr.sin_port = htons(port);
-    memcpy(&addr.sin_addr, he->h_addr_list[0], he->h_length);
+    addr.sin_addr = ip;
 
     if (connect(sock, (sockaddr *)&addr, sizeof(addr)) == SOCKET_ERROR)
     {
@@ -1414,8 +1793,8 @@ int native_socket_sendto(Interpreter *vm, int argCount, Value *args)
         return 1;
     }
 
-    struct hostent *he = gethostbyname(host);
-    if (!he)
+    in_addr ip;
+    if (!netResolveHost(vm->getNetState(), host, &ip))
     {
         vm->push(vm->makeInt(-1));
         return 1;
@@ -1424,7 +1803,7 @@ int native_socket_sendto(Interpreter *vm, int argCount, Value *args)
     sockaddr_in addr = {0};
     addr.sin_family = AF_INET;
     addr.sin_port = htons(port);
-    memcpy(&addr.sin_addr, he->h_addr_list[0], he->h_length);
+    addr.sin_addr = ip;
 
     int len = args[1].asString()->length();
     int sent = sendto(handle->socket, data, len, 0, (sockaddr *)&addr, sizeof(addr));
@@ -1587,6 +1966,72 @@ int native_socket_is_connected(Interpreter *vm, int argCount, Value *args)
     return 1;
 }
 
+//
+// HTTP POOL / DNS CACHE
+//
+
+int native_socket_http_pool_stats(Interpreter *vm, int argCount, Value *args)
+{
+    NetState *net = vm->getNetState();
+    Value result = vm->makeMap();
+    MapInstance *map = result.asMap();
+    map->table.set(vm->makeString("idle"), vm->makeInt(httpPoolIdleCount(net)));
+    map->table.set(vm->makeString("opened"), vm->makeInt(net->httpOpened));
+    map->table.set(vm->makeString("reused"), vm->makeInt(net->httpReused));
+    map->table.set(vm->makeString("dns_hits"), vm->makeInt(net->dnsHits));
+    map->table.set(vm->makeString("dns_misses"), vm->makeInt(net->dnsMisses));
+    map->table.set(vm->makeString("dns_entries"), vm->makeInt((int)net->dnsCache.size()));
+    vm->push(result);
+    return 1;
+}
+
+int native_socket_http_pool_clear(Interpreter *vm, int argCount, Value *args)
+{
+    httpPoolClear(vm->getNetState());
+    return 0;
+}
+
+int native_socket_http_pool_config(Interpreter *vm, int argCount, Value *args)
+{
+    if (argCount < 1 || !args[0].isInt())
+    {
+        vm->runtimeError("http_pool_config expects (max_idle_per_host, [idle_timeout])");
+        return 0;
+    }
+    NetState *net = vm->getNetState();
+    net->httpMaxIdlePerHost = std::max(0, args[0].asInt());
+    if (argCount >= 2 && args[1].isNumber())
+    {
+        net->httpIdleTimeout = args[1].asNumber();
+    }
+    if (net->httpMaxIdlePerHost == 0)
+    {
+        httpPoolClear(net);
+    }
+    return 0;
+}
+
+int native_socket_dns_ttl(Interpreter *vm, int argCount, Value *args)
+{
+    NetState *net = vm->getNetState();
+    if (argCount >= 1 && args[0].isNumber())
+    {
+        net->dnsTtlSeconds = args[0].asNumber();
+        if (net->dnsTtlSeconds <= 0)
+        {
+            net->dnsCache.clear();
+        }
+    }
+    vm->push(vm->makeDouble(net->dnsTtlSeconds));
+    return 1;
+}
+
+int native_socket_dns_clear(Interpreter *vm, int argCount, Value *args)
+{
+    vm->getNetState()->dnsCache.clear();
+    return 0;
+}
+
 // No registerSocket():
 
 void Interpreter::registerSocket()
@@ -1627,6 +2072,13 @@ void Interpreter::registerSocket()
         .addFunction("ping", native_socket_ping, -1)
         .addFunction("get_local_ip", native_socket_get_local_ip, 0)
         .addFunction("resolve", native_socket_resolve, 1)
+        .addFunction("dns_ttl", native_socket_dns_ttl, -1)
+        .addFunction("dns_clear", native_socket_dns_clear, 0)
+
+        // Keep-alive pool
+        .addFunction("http_pool_stats", native_socket_http_pool_stats, 0)
+        .addFunction("http_pool_clear", native_socket_http_pool_clear, 0)
+        .addFunction("http_pool_config", native_socket_http_pool_config, -1)
 
         .addFunction("info", native_socket_info, 1)
         .addFunction("close", native_socket_close, 1);
@@ -15,6 +15,17 @@
 #include <csignal>
 #include <unistd.h>
 #include <sys/wait.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <thread>
+#include <unordered_map>
+
+extern char **environ;
 #endif
 
 int native_os_execute(Interpreter *vm, int argCount, Value *args)
@@ -609,6 +620,849 @@ int native_os_is_alive(Interpreter *vm, int argCount, Value *args)
 #endif
 }
 
+#if BU_ENABLE_OS_PROCESS && !defined(_WIN32)
+
+// ============================================
+// CHILDPOOL - Processos filhos assíncronos
+// posix_spawn com pipes não bloqueantes: o output chega aos bocados
+// (read/readInto) em vez de ficar todo em memória, e wait()/read()/next()
+// estacionam só o process que chama. No máximo maxParallel filhos a
+// correr; os restantes ficam em fila. Quem faz o IO é run()/poll() no
+// main process (ou as próprias chamadas bloqueantes do main).
+// ============================================
+
+enum OsStreamMode
+{
+    OS_STREAM_PIPE,
+    OS_STREAM_INHERIT,
+    OS_STREAM_NULL
+};
+
+enum OsChildState
+{
+    OS_CHILD_QUEUED,
+    OS_CHILD_RUNNING,
+    OS_CHILD_EXITED
+};
+
+enum OsWaitKind
+{
+    OS_WAIT_EXIT,
+    OS_WAIT_READ,
+    OS_WAIT_READ_INTO,
+    OS_WAIT_NEXT
+};
+
+struct OsWaiter
+{
+    uint32 processId;
+    int slot;
+    int kind;
+    int childId;
+    int stream;
+};
+
+struct OsChild
+{
+    int id = 0;
+    pid_t pid = -1;
+    std::vector<std::string> argv;
+    int mode[2] = {OS_STREAM_PIPE, OS_STREAM_PIPE};
+    int fd[2] = {-1, -1};
+    std::string pending[2]; // output ainda não lido
+    size_t head[2] = {0, 0};
+    int state = OS_CHILD_QUEUED;
+    bool reaped = false;
+    int exitCode = -1;
+};
+
+struct OsChildPool
+{
+    Interpreter *vm = nullptr;
+    int maxParallel = 1;
+    int nextId = 1;
+    int running = 0;
+    int64_t finishedTotal = 0;
+    std::unordered_map<int, OsChild *> children;
+    std::deque<int> queue;
+    std::deque<int> finished; // terminados ainda não devolvidos por next()
+    std::vector<OsWaiter> waiters;
+    double lastUpdate = 0;
+};
+
+static const char *osStreamNames[2] = {"stdout", "stderr"};
+
+static double osNow()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static OsChild *osPoolFind(OsChildPool *pool, int id)
+{
+    auto it = pool->children.find(id);
+    return it == pool->children.end() ? nullptr : it->second;
+}
+
+static size_t osChildAvailable(const OsChild *c, int s)
+{
+    return c->pending[s].size() - c->head[s];
+}
+
+// Sem pipe aberto e sem nada pendente: não vem mais nada deste stream
+static bool osChildStreamDone(const OsChild *c, int s)
+{
+    return c->state != OS_CHILD_QUEUED && c->fd[s] < 0 && osChildAvailable(c, s) == 0;
+}
+
+static void osChildConsume(OsChild *c, int s, size_t n)
+{
+    c->head[s] += n;
+    if (c->head[s] == c->pending[s].size())
+    {
+        c->pending[s].clear();
+        c->head[s] = 0;
+    }
+    else if (c->head[s] > 65536 && c->head[s] * 2 > c->pending[s].size())
+    {
+        c->pending[s].erase(0, c->head[s]);
+        c->head[s] = 0;
+    }
+}
+
+// Devolve tudo o que está pendente como string
+static Value osChildTake(Interpreter *vm, OsChild *c, int s)
+{
+    size_t n = osChildAvailable(c, s);
+    Value v = vm->makeString(vm->createString(c->pending[s].data() + c->head[s], (uint32)n));
+    osChildConsume(c, s, n);
+    return v;
+}
+
+static size_t osChildCopy(OsChild *c, int s, BufferInstance *buf, size_t offset)
+{
+    size_t capacity = (size_t)buf->count * (size_t)buf->elementSize;
+    if (offset >= capacity)
+        return 0;
+    size_t n = std::min(osChildAvailable(c, s), capacity - offset);
+    memcpy(buf->data + offset, c->pending[s].data() + c->head[s], n);
+    osChildConsume(c, s, n);
+    return n;
+}
+
+static void osCloseFd(int &fd)
+{
+    if (fd >= 0)
+    {
+        close(fd);
+        fd = -1;
+    }
+}
+
+// Lê o que houver sem bloquear; fecha o pipe no EOF
+static void osChildDrain(OsChild *c, int s)
+{
+    char chunk[65536];
+    while (c->fd[s] >= 0)
+    {
+        ssize_t n = read(c->fd[s], chunk, sizeof(chunk));
+        if (n > 0)
+        {
+            c->pending[s].append(chunk, (size_t)n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return;
+        osCloseFd(c->fd[s]);
+    }
+}
+
+static void osChildFinish(OsChildPool *pool, OsChild *c, int exitCode)
+{
+    if (c->state == OS_CHILD_RUNNING)
+        pool->running--;
+    c->state = OS_CHILD_EXITED;
+    c->exitCode = exitCode;
+    pool->finished.push_back(c->id);
+    pool->finishedTotal++;
+}
+
+static bool osChildStart(OsChildPool *pool, OsChild *c)
+{
+    int pipes[2][2] = {{-1, -1}, {-1, -1}};
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, 0, "/dev/null", O_RDONLY, 0);
+
+    bool ok = true;
+    for (int s = 0; s < 2 && ok; s++)
+    {
+        int target = s + 1;
+        if (c->mode[s] == OS_STREAM_PIPE)
+        {
+            // CLOEXEC nas duas pontas: os outros filhos não podem herdar o
+            // pipe, senão o EOF nunca chega
+            if (pipe(pipes[s]) != 0)
+            {
+                ok = false;
+                break;
+            }
+            fcntl(pipes[s][0], F_SETFD, FD_CLOEXEC);
+            fcntl(pipes[s][1], F_SETFD, FD_CLOEXEC);
+            fcntl(pipes[s][0], F_SETFL, fcntl(pipes[s][0], F_GETFL, 0) | O_NONBLOCK);
+            posix_spawn_file_actions_adddup2(&actions, pipes[s][1], target);
+        }
+        else if (c->mode[s] == OS_STREAM_NULL)
+        {
+            posix_spawn_file_actions_addopen(&actions, target, "/dev/null", O_WRONLY, 0);
+        }
+    }
+
+    std::vector<char *> argv;
+    argv.reserve(c->argv.size() + 1);
+    for (std::string &arg : c->argv)
+        argv.push_back(&arg[0]);
+    argv.push_back(nullptr);
+
+    pid_t pid = -1;
+    if (ok && posix_spawnp(&pid, argv[0], &actions, nullptr, argv.data(), environ) != 0)
+        ok = false;
+    posix_spawn_file_actions_destroy(&actions);
+
+    for (int s = 0; s < 2; s++)
+    {
+        osCloseFd(pipes[s][1]);
+        if (ok)
+            c->fd[s] = pipes[s][0];
+        else
+            osCloseFd(pipes[s][0]);
+    }
+
+    if (!ok)
+    {
+        c->state = OS_CHILD_EXITED;
+        c->reaped = true;
+        c->exitCode = 127;
+        pool->finished.push_back(c->id);
+        pool->finishedTotal++;
+        return false;
+    }
+
+    c->pid = pid;
+    c->state = OS_CHILD_RUNNING;
+    pool->running++;
+    return true;
+}
+
+static void osPoolFill(OsChildPool *pool)
+{
+    while (pool->running < pool->maxParallel && !pool->queue.empty())
+    {
+        OsChild *c = osPoolFind(pool, pool->queue.front());
+        pool->queue.pop_front();
+        if (c && c->state == OS_CHILD_QUEUED)
+            osChildStart(pool, c);
+    }
+}
+
+// Tenta satisfazer um waiter; devolve o valor de retorno do call estacionado
+static bool osWaiterReady(OsChildPool *pool, const OsWaiter &w, Value *result)
+{
+    Interpreter *vm = pool->vm;
+
+    if (w.kind == OS_WAIT_NEXT)
+    {
+        if (!pool->finished.empty())
+        {
+            *result = vm->makeInt(pool->finished.front());
+            return true;
+        }
+        if (pool->running == 0 && pool->queue.empty())
+        {
+            *result = vm->makeNil();
+            return true;
+        }
+        return false;
+    }
+
+    OsChild *c = osPoolFind(pool, w.childId);
+    if (!c)
+    {
+        *result = w.kind == OS_WAIT_READ ? vm->makeNil() : vm->makeInt(-1);
+        return true;
+    }
+
+    switch (w.kind)
+    {
+    case OS_WAIT_EXIT:
+        if (c->state != OS_CHILD_EXITED)
+            return false;
+        *result = vm->makeInt(c->exitCode);
+        return true;
+    case OS_WAIT_READ:
+        if (osChildAvailable(c, w.stream) > 0)
+        {
+            *result = osChildTake(vm, c, w.stream);
+            return true;
+        }
+        if (osChildStreamDone(c, w.stream))
+        {
+            *result = vm->makeNil();
+            return true;
+        }
+        return false;
+    default: // OS_WAIT_READ_INTO: acorda com 0, o script volta a chamar readInto
+        if (osChildAvailable(c, w.stream) == 0 && !osChildStreamDone(c, w.stream))
+            return false;
+        *result = vm->makeInt(0);
+        return true;
+    }
+}
+
+static void osPoolWake(OsChildPool *pool)
+{
+    size_t keep = 0;
+    for (size_t i = 0; i < pool->waiters.size(); i++)
+    {
+        OsWaiter w = pool->waiters[i];
+        Value result;
+        if (!osWaiterReady(pool, w, &result))
+        {
+            pool->waiters[keep++] = w;
+            continue;
+        }
+        // Process morto entretanto: o id terminado fica para o próximo next()
+        if (pool->vm->wakeProcess(w.processId, w.slot, result) &&
+            w.kind == OS_WAIT_NEXT && result.isInt())
+            pool->finished.pop_front();
+    }
+    pool->waiters.resize(keep);
+}
+
+// Uma ronda de IO: lê os pipes, recolhe filhos terminados, arranca a fila
+static void osPoolPoll(OsChildPool *pool, int timeoutMs)
+{
+    std::vector<pollfd> fds;
+    std::vector<std::pair<OsChild *, int>> owners;
+    bool reapPending = false;
+
+    for (auto &entry : pool->children)
+    {
+        OsChild *c = entry.second;
+        if (c->state != OS_CHILD_RUNNING)
+            continue;
+        bool open = false;
+        for (int s = 0; s < 2; s++)
+        {
+            if (c->fd[s] < 0)
+                continue;
+            pollfd p;
+            p.fd = c->fd[s];
+            p.events = POLLIN;
+            p.revents = 0;
+            fds.push_back(p);
+            owners.push_back(std::make_pair(c, s));
+            open = true;
+        }
+        if (!open)
+            reapPending = true;
+    }
+
+    // Filhos sem pipes abertos só se descobrem com waitpid
+    if (reapPending && (timeoutMs < 0 || timeoutMs > 5))
+        timeoutMs = 5;
+    if (pool->running == 0)
+        timeoutMs = 0;
+
+    if (!fds.empty() || timeoutMs > 0)
+    {
+        int n = poll(fds.empty() ? nullptr : fds.data(), (nfds_t)fds.size(), timeoutMs);
+        if (n > 0)
+        {
+            for (size_t i = 0; i < fds.size(); i++)
+            {
+                if (fds[i].revents)
+                    osChildDrain(owners[i].first, owners[i].second);
+            }
+        }
+    }
+
+    std::vector<OsChild *> done;
+    for (auto &entry : pool->children)
+    {
+        OsChild *c = entry.second;
+        if (c->state != OS_CHILD_RUNNING)
+            continue;
+        if (!c->reaped)
+        {
+            int status = 0;
+            pid_t ret = waitpid(c->pid, &status, WNOHANG);
+            if (ret == c->pid || (ret == -1 && errno == ECHILD))
+            {
+                c->reaped = true;
+                c->exitCode = ret == c->pid ? os_status_to_exit_code(status) : -1;
+            }
+        }
+        // Só termina depois do EOF nos dois pipes
+        if (c->reaped && c->fd[0] < 0 && c->fd[1] < 0)
+            done.push_back(c);
+    }
+    for (OsChild *c : done)
+        osChildFinish(pool, c, c->exitCode);
+
+    osPoolFill(pool);
+    osPoolWake(pool);
+}
+
+static void osPoolTick(OsChildPool *pool)
+{
+    double now = osNow();
+    float dt = (float)(now - pool->lastUpdate);
+    pool->lastUpdate = now;
+    pool->vm->update(dt);
+}
+
+static int osPoolWaitMs(OsChildPool *pool, int capMs)
+{
+    float wake = pool->vm->timeUntilNextWake();
+    if (wake < 0.0f)
+        return capMs;
+    return std::min((int)(wake * 1000.0f), capMs);
+}
+
+static bool osPoolIdle(OsChildPool *pool)
+{
+    return pool->running == 0 && pool->queue.empty() && pool->waiters.empty();
+}
+
+// Main process: corre IO e os outros processes até o waiter ficar pronto
+static Value osPoolBlock(OsChildPool *pool, const OsWaiter &w)
+{
+    Value result;
+    pool->lastUpdate = osNow();
+    while (!osWaiterReady(pool, w, &result))
+    {
+        osPoolPoll(pool, osPoolWaitMs(pool, 100));
+        osPoolTick(pool);
+    }
+    return result;
+}
+
+// Estaciona o process atual (ou bloqueia no main) até o waiter ficar pronto
+static int osPoolAwait(Interpreter *vm, OsChildPool *pool, Value *args, int kind, int childId, int stream)
+{
+    OsWaiter w = {0, 0, kind, childId, stream};
+
+    osPoolPoll(pool, 0);
+    Value result;
+    if (osWaiterReady(pool, w, &result))
+    {
+        if (kind == OS_WAIT_NEXT && result.isInt())
+            pool->finished.pop_front();
+        vm->push(result);
+        return 1;
+    }
+
+    if (vm->suspendCurrentProcess(-1.0f))
+    {
+        w.processId = vm->getCurrentProcess()->id;
+        w.slot = vm->nativeResultSlot(args);
+        pool->waiters.push_back(w);
+        vm->pushNil();
+        return 1;
+    }
+
+    result = osPoolBlock(pool, w);
+    if (kind == OS_WAIT_NEXT && result.isInt())
+        pool->finished.pop_front();
+    vm->push(result);
+    return 1;
+}
+
+static int osStreamArg(Value value)
+{
+    if (value.isString() && strcmp(value.asStringChars(), "stderr") == 0)
+        return 1;
+    return 0;
+}
+
+static int osStreamModeArg(Interpreter *vm, MapInstance *map, int s)
+{
+    Value val;
+    if (!map->table.get(vm->makeString(osStreamNames[s]), &val) || !val.isString())
+        return OS_STREAM_PIPE;
+    const char *mode = val.asStringChars();
+    if (strcmp(mode, "inherit") == 0)
+        return OS_STREAM_INHERIT;
+    if (strcmp(mode, "null") == 0)
+        return OS_STREAM_NULL;
+    return OS_STREAM_PIPE;
+}
+
+static int osPoolQueue(Interpreter *vm, OsChildPool *pool, std::vector<std::string> &argv, Value options)
+{
+    OsChild *c = new OsChild();
+    c->id = pool->nextId++;
+    c->argv.swap(argv);
+    if (options.isMap())
+    {
+        for (int s = 0; s < 2; s++)
+            c->mode[s] = osStreamModeArg(vm, options.asMap(), s);
+    }
+    pool->children[c->id] = c;
+    pool->queue.push_back(c->id);
+    osPoolFill(pool);
+    return c->id;
+}
+
+static void *child_pool_ctor(Interpreter *vm, int argCount, Value *args)
+{
+    int maxParallel = (int)std::thread::hardware_concurrency();
+    if (argCount >= 1)
+    {
+        if (!args[0].isInt() || args[0].asInt() < 1)
+        {
+            vm->runtimeError("ChildPool expects ([maxParallel])");
+            return nullptr;
+        }
+        maxParallel = args[0].asInt();
+    }
+
+    OsChildPool *pool = new OsChildPool();
+    pool->vm = vm;
+    pool->maxParallel = maxParallel > 0 ? maxParallel : 1;
+    pool->lastUpdate = osNow();
+    return pool;
+}
+
+static void child_pool_dtor(Interpreter *vm, void *instance)
+{
+    (void)vm;
+    OsChildPool *pool = (OsChildPool *)instance;
+    for (auto &entry : pool->children)
+    {
+        OsChild *c = entry.second;
+        osCloseFd(c->fd[0]);
+        osCloseFd(c->fd[1]);
+        if (c->state == OS_CHILD_RUNNING && !c->reaped)
+        {
+            kill(c->pid, SIGKILL);
+            waitpid(c->pid, nullptr, 0);
+        }
+        delete c;
+    }
+    delete pool;
+}
+
+// spawn(cmd, [args], [options]) -> id; cmd procurado no PATH, sem shell
+static int child_pool_spawn(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    OsChildPool *pool = (OsChildPool *)instance;
+    if (argCount < 1 || !args[0].isString() || args[0].asString()->length() == 0)
+    {
+        vm->runtimeError("ChildPool.spawn expects (cmd, [args], [options])");
+        vm->pushInt(-1);
+        return 1;
+    }
+
+    std::vector<std::string> argv;
+    argv.push_back(args[0].asStringChars());
+    Value options = vm->makeNil();
+    for (int i = 1; i < argCount && i < 3; i++)
+    {
+        if (args[i].isArray())
+        {
+            ArrayInstance *arr = args[i].asArray();
+            for (size_t j = 0; j < arr->values.size(); j++)
+            {
+                if (arr->values[j].isString())
+                    argv.push_back(arr->values[j].asStringChars());
+            }
+        }
+        else if (args[i].isMap())
+        {
+            options = args[i];
+        }
+    }
+
+    vm->pushInt(osPoolQueue(vm, pool, argv, options));
+    return 1;
+}
+
+// shell(command, [options]) -> id; corre via /bin/sh -c
+static int child_pool_shell(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    OsChildPool *pool = (OsChildPool *)instance;
+    if (argCount < 1 || !args[0].isString())
+    {
+        vm->runtimeError("ChildPool.shell expects (command, [options])");
+        vm->pushInt(-1);
+        return 1;
+    }
+
+    std::vector<std::string> argv;
+    argv.push_back("/bin/sh");
+    argv.push_back("-c");
+    argv.push_back(args[0].asStringChars());
+    vm->pushInt(osPoolQueue(vm, pool, argv, argCount >= 2 ? args[1] : vm->makeNil()));
+    return 1;
+}
+
+static OsChild *osChildArg(Interpreter *vm, OsChildPool *pool, int argCount, Value *args, const char *method)
+{
+    if (argCount < 1 || !args[0].isInt())
+    {
+        vm->runtimeError("ChildPool.%s expects (id, ...)", method);
+        return nullptr;
+    }
+    return osPoolFind(pool, args[0].asInt());
+}
+
+// read(id, [stream]) -> próximo bocado de output; nil no fim
+static int child_pool_read(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    OsChildPool *pool = (OsChildPool *)instance;
+    if (argCount < 1 || !args[0].isInt())
+    {
+        vm->runtimeError("ChildPool.read expects (id, [stream])");
+        vm->pushNil();
+        return 1;
+    }
+    int stream = argCount >= 2 ? osStreamArg(args[1]) : 0;
+    return osPoolAwait(vm, pool, args, OS_WAIT_READ, args[0].asInt(), stream);
+}
+
+// readInto(id, buffer, [stream], [offset]) -> bytes copiados, -1 no fim.
+// Sem dados estaciona o process e devolve 0 quando chegarem (chamar de novo)
+static int child_pool_read_into(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    OsChildPool *pool = (OsChildPool *)instance;
+    if (argCount < 2 || !args[0].isInt() || !args[1].isBuffer())
+    {
+        vm->runtimeError("ChildPool.readInto expects (id, buffer, [stream], [offset])");
+        vm->pushInt(-1);
+        return 1;
+    }
+    int stream = argCount >= 3 ? osStreamArg(args[2]) : 0;
+    int offset = (argCount >= 4 && args[3].isInt()) ? args[3].asInt() : 0;
+
+    OsChild *c = osPoolFind(pool, args[0].asInt());
+    if (!c || offset < 0)
+    {
+        vm->pushInt(-1);
+        return 1;
+    }
+
+    osPoolPoll(pool, 0);
+    if (osChildAvailable(c, stream) == 0 && !osChildStreamDone(c, stream))
+    {
+        if (vm->canSuspendCurrentProcess())
+            return osPoolAwait(vm, pool, args, OS_WAIT_READ_INTO, c->id, stream);
+        OsWaiter w = {0, 0, OS_WAIT_READ_INTO, c->id, stream};
+        osPoolBlock(pool, w);
+    }
+
+    if (osChildStreamDone(c, stream))
+    {
+        vm->pushInt(-1);
+        return 1;
+    }
+    vm->pushInt((int)osChildCopy(c, stream, args[1].asBuffer(), (size_t)offset));
+    return 1;
+}
+
+// output(id, [stream]) -> o que já chegou (sem esperar)
+static int child_pool_output(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    OsChildPool *pool = (OsChildPool *)instance;
+    OsChild *c = osChildArg(vm, pool, argCount, args, "output");
+    if (!c)
+    {
+        vm->pushNil();
+        return 1;
+    }
+    osPoolPoll(pool, 0);
+    vm->push(osChildTake(vm, c, argCount >= 2 ? osStreamArg(args[1]) : 0));
+    return 1;
+}
+
+// wait(id) -> exit code (negativo = sinal); -1 se o id não existe
+static int child_pool_wait(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    OsChildPool *pool = (OsChildPool *)instance;
+    if (argCount < 1 || !args[0].isInt())
+    {
+        vm->runtimeError("ChildPool.wait expects (id)");
+        vm->pushInt(-1);
+        return 1;
+    }
+    return osPoolAwait(vm, pool, args, OS_WAIT_EXIT, args[0].asInt(), 0);
+}
+
+// next() -> id do próximo filho a terminar; nil quando não há mais
+static int child_pool_next(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    return osPoolAwait(vm, (OsChildPool *)instance, args, OS_WAIT_NEXT, 0, 0);
+}
+
+// status(id) -> "queued" | "running" | "exited" | nil
+static int child_pool_status(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    OsChildPool *pool = (OsChildPool *)instance;
+    OsChild *c = osChildArg(vm, pool, argCount, args, "status");
+    if (!c)
+    {
+        vm->pushNil();
+        return 1;
+    }
+    static const char *names[] = {"queued", "running", "exited"};
+    vm->push(vm->makeString(names[c->state]));
+    return 1;
+}
+
+// kill(id, [signal]) -> bool; filhos ainda na fila são cancelados
+static int child_pool_kill(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    OsChildPool *pool = (OsChildPool *)instance;
+    OsChild *c = osChildArg(vm, pool, argCount, args, "kill");
+    int sig = (argCount >= 2 && args[1].isInt()) ? args[1].asInt() : SIGTERM;
+    bool ok = false;
+    if (c && c->state == OS_CHILD_QUEUED)
+    {
+        pool->queue.erase(std::remove(pool->queue.begin(), pool->queue.end(), c->id), pool->queue.end());
+        c->reaped = true;
+        osChildFinish(pool, c, -sig);
+        osPoolWake(pool);
+        ok = true;
+    }
+    else if (c && c->state == OS_CHILD_RUNNING && !c->reaped)
+    {
+        ok = kill(c->pid, sig) == 0;
+    }
+    vm->pushBool(ok);
+    return 1;
+}
+
+// release(id) -> bool; esquece um filho terminado e o output por ler
+static int child_pool_release(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    OsChildPool *pool = (OsChildPool *)instance;
+    OsChild *c = osChildArg(vm, pool, argCount, args, "release");
+    if (!c || c->state != OS_CHILD_EXITED)
+    {
+        vm->pushBool(false);
+        return 1;
+    }
+    pool->finished.erase(std::remove(pool->finished.begin(), pool->finished.end(), c->id), pool->finished.end());
+    pool->children.erase(c->id);
+    delete c;
+    vm->pushBool(true);
+    return 1;
+}
+
+// poll([timeoutMs]) -> filhos a correr; uma ronda de IO sem correr processes
+static int child_pool_poll(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    OsChildPool *pool = (OsChildPool *)instance;
+    int timeoutMs = (argCount >= 1 && args[0].isInt()) ? args[0].asInt() : 0;
+    osPoolPoll(pool, timeoutMs);
+    vm->pushInt(pool->running);
+    return 1;
+}
+
+// run([seconds]) -> filhos terminados; IO + scheduler até não haver nada
+// a correr, na fila ou à espera
+static int child_pool_run(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    OsChildPool *pool = (OsChildPool *)instance;
+    double limit = (argCount >= 1 && args[0].isNumber()) ? args[0].asNumber() : -1.0;
+    double start = osNow();
+    int64_t before = pool->finishedTotal;
+
+    pool->lastUpdate = start;
+    osPoolPoll(pool, 0);
+    while (!osPoolIdle(pool))
+    {
+        int capMs = 100;
+        if (limit >= 0)
+        {
+            double left = limit - (osNow() - start);
+            if (left <= 0)
+                break;
+            capMs = std::min(capMs, (int)(left * 1000.0) + 1);
+        }
+        osPoolPoll(pool, osPoolWaitMs(pool, capMs));
+        osPoolTick(pool);
+    }
+
+    vm->pushInt((int)(pool->finishedTotal - before));
+    return 1;
+}
+
+static Value child_pool_get_running(Interpreter *vm, void *instance)
+{
+    return vm->makeInt(((OsChildPool *)instance)->running);
+}
+
+static Value child_pool_get_queued(Interpreter *vm, void *instance)
+{
+    return vm->makeInt((int)((OsChildPool *)instance)->queue.size());
+}
+
+static Value child_pool_get_waiting(Interpreter *vm, void *instance)
+{
+    return vm->makeInt((int)((OsChildPool *)instance)->waiters.size());
+}
+
+static Value child_pool_get_finished(Interpreter *vm, void *instance)
+{
+    return vm->makeInt((int)((OsChildPool *)instance)->finishedTotal);
+}
+
+static Value child_pool_get_max(Interpreter *vm, void *instance)
+{
+    return vm->makeInt(((OsChildPool *)instance)->maxParallel);
+}
+
+static void child_pool_set_max(Interpreter *vm, void *instance, Value value)
+{
+    OsChildPool *pool = (OsChildPool *)instance;
+    if (!value.isInt() || value.asInt() < 1)
+    {
+        vm->runtimeError("ChildPool.max expects a positive int");
+        return;
+    }
+    pool->maxParallel = value.asInt();
+    osPoolFill(pool);
+}
+
+static void registerChildPool(Interpreter *vm)
+{
+    NativeClassDef *klass = vm->registerNativeClass("ChildPool", child_pool_ctor, child_pool_dtor, -1, false);
+
+    vm->addNativeMethod(klass, "spawn", child_pool_spawn);
+    vm->addNativeMethod(klass, "shell", child_pool_shell);
+    vm->addNativeMethod(klass, "read", child_pool_read);
+    vm->addNativeMethod(klass, "readInto", child_pool_read_into);
+    vm->addNativeMethod(klass, "output", child_pool_output);
+    vm->addNativeMethod(klass, "wait", child_pool_wait);
+    vm->addNativeMethod(klass, "next", child_pool_next);
+    vm->addNativeMethod(klass, "status", child_pool_status);
+    vm->addNativeMethod(klass, "kill", child_pool_kill);
+    vm->addNativeMethod(klass, "release", child_pool_release);
+    vm->addNativeMethod(klass, "poll", child_pool_poll);
+    vm->addNativeMethod(klass, "run", child_pool_run);
+
+    vm->addNativeProperty(klass, "running", child_pool_get_running);
+    vm->addNativeProperty(klass, "queued", child_pool_get_queued);
+    vm->addNativeProperty(klass, "waiting", child_pool_get_waiting);
+    vm->addNativeProperty(klass, "finished", child_pool_get_finished);
+    vm->addNativeProperty(klass, "max", child_pool_get_max, child_pool_set_max);
+}
+
+#endif
+
 void Interpreter::registerOS()
 {
 #ifdef _WIN32
@@ -642,6 +1496,10 @@ void Interpreter::registerOS()
         .addFunction("getcwd", native_os_getcwd, 0)
         .addFunction("chdir", native_os_chdir, 1)
         .addFunction("quit", native_os_exit, 1);
+
+#if BU_ENABLE_OS_PROCESS && !defined(_WIN32)
+    registerChildPool(this);
+#endif
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "interpreter.hpp"
+
+#ifdef BU_ENABLE_SPACE
+
+#include "spatial_grid.hpp"
+
+// ============================================
+// SPACE MODULE - colisoes e buscas por proximidade entre processos
+// A grelha (spatial_grid.cpp) nasce na primeira chamada e o update() mantem-na;
+// nenhuma busca aloca: within() reescreve o array que o script passa.
+// ============================================
+
+// `type X`, o proprio processo (X) ou nil (qualquer tipo)
+static bool blueprintArg(Interpreter *vm, const Value &v, const char *fn, int *out)
+{
+    if (v.isNil())
+    {
+        *out = -1;
+        return true;
+    }
+    int index = v.isProcess() ? v.asProcessId() : (v.isInt() ? v.asInt() : -1);
+    if (!vm->getProcessDef(index))
+    {
+        vm->runtimeError("%s() expects a process type (type X) or nil", fn);
+        return false;
+    }
+    *out = index;
+    return true;
+}
+
+static void pushProcess(Interpreter *vm, Process *proc)
+{
+    if (proc)
+        vm->push(vm->makeProcessInstance(proc));
+    else
+        vm->pushNil();
+}
+
+// space.setup(cellSize [, radius]) - radius e o raio de um processo com size 100
+int native_space_setup(Interpreter *vm, int argCount, Value *args)
+{
+    if (argCount < 1 || argCount > 2 || !args[0].isNumber() || (argCount == 2 && !args[1].isNumber()))
+    {
+        vm->runtimeError("space.setup() expects (cellSize [, radius])");
+        return 0;
+    }
+    double cellSize = args[0].asNumber();
+    double radius = argCount == 2 ? args[1].asNumber() : 16.0;
+    if (!(cellSize > 0.0) || !(radius >= 0.0))
+    {
+        vm->runtimeError("space.setup() needs cellSize > 0 and radius >= 0");
+        return 0;
+    }
+    vm->setSpatialGrid((float)cellSize, (float)radius);
+    return 0;
+}
+
+// space.collide(type X) -> primeiro X que toca no processo atual, ou nil
+int native_space_collide(Interpreter *vm, int argCount, Value *args)
+{
+    if (argCount > 1)
+    {
+        vm->runtimeError("space.collide() expects ([type])");
+        return 0;
+    }
+    int blueprint = -1;
+    if (argCount == 1 && !blueprintArg(vm, args[0], "space.collide", &blueprint))
+        return 0;
+
+    Process *self = vm->getCurrentProcess();
+    if (!self)
+    {
+        vm->pushNil();
+        return 1;
+    }
+    pushProcess(vm, vm->getSpatialGrid()->collide(self, blueprint));
+    return 1;
+}
+
+// space.within(x, y, radius, out [, type X]) -> quantos; `out` fica com eles
+int native_space_within(Interpreter *vm, int argCount, Value *args)
+{
+    if (argCount < 4 || argCount > 5 || !args[0].isNumber() || !args[1].isNumber() ||
+        !args[2].isNumber() || !args[3].isArray())
+    {
+        vm->runtimeError("space.within() expects (x, y, radius, out: array [, type])");
+        return 0;
+    }
+    int blueprint = -1;
+    if (argCount == 5 && !blueprintArg(vm, args[4], "space.within", &blueprint))
+        return 0;
+
+    const std::vector<Process *> &found = vm->getSpatialGrid()->within(
+        (float)args[0].asNumber(), (float)args[1].asNumber(), (float)args[2].asNumber(),
+        blueprint, vm->getCurrentProcess());
+
+    ArrayInstance *out = args[3].asArray();
+    out->values.clear();
+    out->values.reserve(found.size());
+    for (Process *proc : found)
+        out->values.push(vm->makeProcessInstance(proc));
+
+    vm->pushInt((int)found.size());
+    return 1;
+}
+
+// space.nearest(x, y [, type X [, maxDist]]) -> processo mais perto, ou nil
+int native_space_nearest(Interpreter *vm, int argCount, Value *args)
+{
+    if (argCount < 2 || argCount > 4 || !args[0].isNumber() || !args[1].isNumber() ||
+        (argCount == 4 && !args[3].isNumber()))
+    {
+        vm->runtimeError("space.nearest() expects (x, y [, type [, maxDist]])");
+        return 0;
+    }
+    int blueprint = -1;
+    if (argCount >= 3 && !blueprintArg(vm, args[2], "space.nearest", &blueprint))
+        return 0;
+    float maxDist = argCount == 4 ? (float)args[3].asNumber() : -1.0f;
+
+    pushProcess(vm, vm->getSpatialGrid()->nearest((float)args[0].asNumber(), (float)args[1].asNumber(),
+                                                  blueprint, vm->getCurrentProcess(), maxDist));
+    return 1;
+}
+
+void Interpreter::registerSpace()
+{
+    addModule("space")
+        .addFunction("setup", native_space_setup, -1)
+        .addFunction("collide", native_space_collide, -1)
+        .addFunction("within", native_space_within, -1)
+        .addFunction("nearest", native_space_nearest, -1);
+}
+
+#endif
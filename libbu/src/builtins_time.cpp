@@ -43,11 +43,22 @@ int native_time_now_ms(Interpreter *vm, int argCount, Value *args)
 
 // ============================================
 // TIME.SLEEP - Pausa execução (segundos)
+// Dentro de um process só esse process fica parado (SUSPENDED até
+// currentTime + seconds); os outros continuam a correr. No main process
+// não há scheduler por baixo, por isso bloqueia como antes.
 // ============================================
 
+static void timeSleepFor(Interpreter *vm, double seconds)
+{
+    if (vm->suspendCurrentProcess((float)seconds))
+        return;
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+}
+
 int native_time_sleep(Interpreter *vm, int argCount, Value *args)
 {
-    if (argCount < 1)
+    if (argCount < 1 || !args[0].isNumber())
     {
         vm->runtimeError("time.sleep expects at least 1 argument");
         return 0;
@@ -62,8 +73,7 @@ int native_time_sleep(Interpreter *vm, int argCount, Value *args)
             return 0;
         }
     
-    auto duration = std::chrono::duration<double>(seconds);
-    std::this_thread::sleep_for(duration);
+    timeSleepFor(vm, seconds);
     
     return 0;
 }
@@ -84,11 +94,221 @@ int native_time_sleep_ms(Interpreter *vm, int argCount, Value *args)
     if (ms < 0)
         return 0;
     
-    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    timeSleepFor(vm, ms / 1000.0);
     
     return 0;
 }
 
+// ============================================
+// TIMER - Temporizador no tempo do scheduler
+// O deadline é medido em getCurrentTime() (a soma dos dt passados a
+// update()/ticks()), o mesmo relógio que acorda processes SUSPENDED.
+// wait() estaciona só o process que chama; timers repetidos avançam o
+// deadline pelo período, sem acumular atraso.
+// ============================================
+
+struct TimerData
+{
+    double period;
+    double deadline;
+    bool repeat;
+    bool cancelled;
+    bool done;      // one-shot já consumido por ready()/wait()
+    int fires;
+};
+
+static TimerData *timerStart(Interpreter *vm, double seconds, bool repeat)
+{
+    TimerData *t = new TimerData();
+    t->period = seconds < 0 ? 0 : seconds;
+    t->deadline = vm->getCurrentTime() + t->period;
+    t->repeat = repeat;
+    t->cancelled = false;
+    t->done = false;
+    t->fires = 0;
+    return t;
+}
+
+// Consome um disparo: repetidos passam ao período seguinte
+static void timerFire(TimerData *t)
+{
+    t->fires++;
+    if (t->repeat)
+        t->deadline += t->period;
+    else
+        t->done = true;
+}
+
+static void *timer_ctor(Interpreter *vm, int argCount, Value *args)
+{
+    if (argCount < 1 || !args[0].isNumber())
+    {
+        vm->runtimeError("Timer expects (seconds, [repeat])");
+        return nullptr;
+    }
+
+    bool repeat = argCount >= 2 && args[1].isBool() && args[1].asBool();
+    return timerStart(vm, args[0].asNumber(), repeat);
+}
+
+static void timer_dtor(Interpreter *vm, void *instance)
+{
+    (void)vm;
+    delete (TimerData *)instance;
+}
+
+// wait() -> true quando o deadline passa, false se foi cancelado
+static int timer_wait(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    TimerData *t = (TimerData *)instance;
+
+    if (t->cancelled)
+    {
+        vm->push(vm->makeBool(false));
+        return 1;
+    }
+    if (t->done)
+    {
+        vm->push(vm->makeBool(true));
+        return 1;
+    }
+
+    double now = vm->getCurrentTime();
+    double remaining = t->deadline - now;
+
+    if (vm->canSuspendCurrentProcess())
+    {
+        // Já vencido: dispara sem ceder o frame
+        if (remaining > 0)
+            vm->suspendCurrentProcess((float)remaining);
+        timerFire(t);
+    }
+    else
+    {
+        // Main process: o tempo do scheduler não anda enquanto bloqueamos,
+        // por isso o próximo período conta a partir de agora
+        if (remaining > 0)
+            std::this_thread::sleep_for(std::chrono::duration<double>(remaining));
+        t->fires++;
+        if (t->repeat)
+            t->deadline = now + t->period;
+        else
+        {
+            t->deadline = now;
+            t->done = true;
+        }
+    }
+
+    vm->push(vm->makeBool(true));
+    return 1;
+}
+
+// ready() -> true uma vez por disparo, sem bloquear (para loops com ticks())
+static int timer_ready(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    TimerData *t = (TimerData *)instance;
+
+    bool due = !t->cancelled && !t->done && vm->getCurrentTime() >= t->deadline;
+    if (due)
+        timerFire(t);
+
+    vm->push(vm->makeBool(due));
+    return 1;
+}
+
+// reset([seconds]) -> rearma a partir de agora (e muda o período)
+static int timer_reset(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    TimerData *t = (TimerData *)instance;
+
+    if (argCount >= 1)
+    {
+        if (!args[0].isNumber())
+        {
+            vm->runtimeError("Timer.reset expects ([seconds])");
+            return 0;
+        }
+        double seconds = args[0].asNumber();
+        t->period = seconds < 0 ? 0 : seconds;
+    }
+
+    t->deadline = vm->getCurrentTime() + t->period;
+    t->cancelled = false;
+    t->done = false;
+    return 0;
+}
+
+static int timer_cancel(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    ((TimerData *)instance)->cancelled = true;
+    return 0;
+}
+
+static Value timer_get_remaining(Interpreter *vm, void *instance)
+{
+    TimerData *t = (TimerData *)instance;
+    double left = t->deadline - vm->getCurrentTime();
+    if (t->cancelled || t->done || left < 0)
+        left = 0;
+    return vm->makeDouble(left);
+}
+
+static Value timer_get_expired(Interpreter *vm, void *instance)
+{
+    TimerData *t = (TimerData *)instance;
+    return vm->makeBool(!t->cancelled && (t->done || vm->getCurrentTime() >= t->deadline));
+}
+
+static Value timer_get_period(Interpreter *vm, void *instance)
+{
+    return vm->makeDouble(((TimerData *)instance)->period);
+}
+
+static Value timer_get_fires(Interpreter *vm, void *instance)
+{
+    return vm->makeInt(((TimerData *)instance)->fires);
+}
+
+static Value timer_get_repeat(Interpreter *vm, void *instance)
+{
+    return vm->makeBool(((TimerData *)instance)->repeat);
+}
+
+static Value timer_get_cancelled(Interpreter *vm, void *instance)
+{
+    return vm->makeBool(((TimerData *)instance)->cancelled);
+}
+
+static int timeNewTimer(Interpreter *vm, int argCount, Value *args, bool repeat, const char *name)
+{
+    NativeClassDef *klass = nullptr;
+    if (argCount < 1 || !args[0].isNumber() || !vm->tryGetNativeClassDef("Timer", &klass))
+    {
+        vm->runtimeError("time.%s expects (seconds)", name);
+        return 0;
+    }
+
+    Value v = vm->makeNativeClassInstance(klass->persistent);
+    NativeClassInstance *instance = v.as.sClassInstance;
+    instance->klass = klass;
+    instance->userData = timerStart(vm, args[0].asNumber(), repeat);
+
+    vm->push(v);
+    return 1;
+}
+
+// TIME.AFTER(seconds) -> Timer de um disparo
+int native_time_after(Interpreter *vm, int argCount, Value *args)
+{
+    return timeNewTimer(vm, argCount, args, false, "after");
+}
+
+// TIME.EVERY(seconds) -> Timer periódico
+int native_time_every(Interpreter *vm, int argCount, Value *args)
+{
+    return timeNewTimer(vm, argCount, args, true, "every");
+}
+
 // ============================================
 // TIME.CLOCK - Tempo de CPU (high precision)
 // ============================================
@@ -267,6 +487,20 @@ int native_time_diff(Interpreter *vm, int argCount, Value *args)
 
 void Interpreter::registerTime()
 {
+    NativeClassDef *timer = registerNativeClass("Timer", timer_ctor, timer_dtor, -1, false);
+
+    addNativeMethod(timer, "wait", timer_wait);
+    addNativeMethod(timer, "ready", timer_ready);
+    addNativeMethod(timer, "reset", timer_reset);
+    addNativeMethod(timer, "cancel", timer_cancel);
+
+    addNativeProperty(timer, "remaining", timer_get_remaining);
+    addNativeProperty(timer, "expired", timer_get_expired);
+    addNativeProperty(timer, "period", timer_get_period);
+    addNativeProperty(timer, "fires", timer_get_fires);
+    addNativeProperty(timer, "repeat", timer_get_repeat);
+    addNativeProperty(timer, "cancelled", timer_get_cancelled);
+
     addModule("time")
         // Timestamps
         .addFunction("now", native_time_now, 0)           // Segundos
@@ -276,6 +510,10 @@ void Interpreter::registerTime()
         // Sleep
         .addFunction("sleep", native_time_sleep, 1)       // Segundos
         .addFunction("sleep_ms", native_time_sleep_ms, 1) // Milissegundos
+
+        // Timers (tempo do scheduler)
+        .addFunction("after", native_time_after, 1)       // Timer de um disparo
+        .addFunction("every", native_time_every, 1)       // Timer periódico
         
         // Date/Time manipulation
         .addFunction("date", native_time_date, -1)        // Decompõe timestamp
@@ -0,0 +1,747 @@
+#include "interpreter.hpp"
+
+#ifdef BU_ENABLE_VEC
+
+#include "vec_kernels.hpp"
+#include <cstring>
+#include <cstdlib>
+#include <limits>
+#include <type_traits>
+
+// ============================================
+// VEC MODULE - operacoes em bloco sobre Buffers e typed arrays
+// float32/float64 usam os kernels SIMD (vec_kernels*.cpp); os tipos
+// inteiros calculam em double e guardam truncado + saturado.
+// ============================================
+
+static const VecKernels *gVecKernels = nullptr;
+
+static const VecKernels *vecKernels()
+{
+    if (!gVecKernels)
+        gVecKernels = vecKernelsBest();
+    return gVecKernels;
+}
+
+struct VecView
+{
+    BufferType type;
+    int count;
+    int elementSize;
+    uint8 *data;
+};
+
+static bool vecView(const Value &v, VecView *out)
+{
+    if (v.isBuffer())
+    {
+        BufferInstance *buf = v.asBuffer();
+        out->type = buf->type;
+        out->count = buf->count;
+        out->elementSize = buf->elementSize;
+        out->data = buf->data;
+        return true;
+    }
+    if (v.isNativeClassInstance())
+    {
+        NativeClassInstance *inst = v.asNativeClassInstance();
+        if (!inst->klass->typedArray || !inst->userData)
+            return false;
+        TypedArrayData *ta = (TypedArrayData *)inst->userData;
+        out->type = ta->type;
+        out->count = ta->count;
+        out->elementSize = ta->elementSize;
+        out->data = ta->data;
+        return true;
+    }
+    return false;
+}
+
+template <class Fn>
+static void vecWithType(BufferType type, Fn &&fn)
+{
+    switch (type)
+    {
+    case BufferType::UINT8:
+        fn((uint8 *)nullptr);
+        break;
+    case BufferType::INT16:
+        fn((int16 *)nullptr);
+        break;
+    case BufferType::UINT16:
+        fn((uint16 *)nullptr);
+        break;
+    case BufferType::INT32:
+        fn((int32 *)nullptr);
+        break;
+    case BufferType::UINT32:
+        fn((uint32 *)nullptr);
+        break;
+    case BufferType::FLOAT:
+        fn((float *)nullptr);
+        break;
+    default:
+        fn((double *)nullptr);
+        break;
+    }
+}
+
+template <class T>
+static inline T vecSaturate(double x, std::true_type /*floating*/)
+{
+    return (T)x;
+}
+
+template <class T>
+static inline T vecSaturate(double x, std::false_type)
+{
+    if (x != x)
+        return 0;
+    if (x <= (double)std::numeric_limits<T>::min())
+        return std::numeric_limits<T>::min();
+    if (x >= (double)std::numeric_limits<T>::max())
+        return std::numeric_limits<T>::max();
+    return (T)x;
+}
+
+template <class T>
+static inline T vecSaturate(double x)
+{
+    return vecSaturate<T>(x, std::is_floating_point<T>());
+}
+
+static bool vecIsFloat(BufferType type)
+{
+    return type == BufferType::FLOAT || type == BufferType::DOUBLE;
+}
+
+// Empurra um elemento com o tipo do script que a[i] daria
+static void vecPushElement(Interpreter *vm, BufferType type, double x)
+{
+    if (vecIsFloat(type))
+        vm->pushDouble(x);
+    else if (type == BufferType::UINT32)
+        vm->push(vm->makeUInt((uint32)x));
+    else
+        vm->pushInt((int)x);
+}
+
+// dst e a (e b quando nao e numero) com o mesmo tipo e tamanho
+static bool vecSameShape(Interpreter *vm, const char *fn, const VecView &x, const VecView &y)
+{
+    if (x.type != y.type)
+    {
+        vm->runtimeError("vec.%s: element types differ (use vec.convert)", fn);
+        return false;
+    }
+    if (x.count != y.count)
+    {
+        vm->runtimeError("vec.%s: lengths differ (%d vs %d)", fn, x.count, y.count);
+        return false;
+    }
+    return true;
+}
+
+// Operando que pode ser Buffer/typed array ou numero (broadcast)
+static bool vecOperand(Interpreter *vm, const char *fn, const VecView &shape, const Value &v,
+                       VecView *view, bool *scalar, double *k)
+{
+    if (v.isNumber())
+    {
+        *scalar = true;
+        *k = v.asNumber();
+        return true;
+    }
+    *scalar = false;
+    if (!vecView(v, view))
+    {
+        vm->runtimeError("vec.%s expects a Buffer, typed array or number", fn);
+        return false;
+    }
+    return vecSameShape(vm, fn, shape, *view);
+}
+
+// ============================================
+// VEC.ADD / SUB / MUL / DIV (dst, a, b|number) -> dst
+// ============================================
+
+static int vecBinaryOp(Interpreter *vm, int argCount, Value *args, VecOp op, const char *fn)
+{
+    VecView d, a, b;
+    bool bScalar = false;
+    double k = 0.0;
+    if (argCount != 3 || !vecView(args[0], &d) || !vecView(args[1], &a))
+    {
+        vm->runtimeError("vec.%s expects (dst, a, b)", fn);
+        return 0;
+    }
+    if (!vecSameShape(vm, fn, d, a) || !vecOperand(vm, fn, d, args[2], &b, &bScalar, &k))
+        return 0;
+
+    const size_t n = (size_t)d.count;
+    const VecKernels *kern = vecKernels();
+    if (d.type == BufferType::FLOAT)
+    {
+        float kf = (float)k;
+        kern->binaryF32(op, (float *)d.data, (const float *)a.data,
+                        bScalar ? &kf : (const float *)b.data, bScalar, n);
+    }
+    else if (d.type == BufferType::DOUBLE)
+    {
+        kern->binaryF64(op, (double *)d.data, (const double *)a.data,
+                        bScalar ? &k : (const double *)b.data, bScalar, n);
+    }
+    else
+    {
+        vecWithType(d.type, [&](auto *tag)
+        {
+            typedef typename std::remove_pointer<decltype(tag)>::type T;
+            T *dp = (T *)d.data;
+            const T *ap = (const T *)a.data;
+            const T *bp = (const T *)b.data;
+            for (size_t i = 0; i < n; i++)
+            {
+                double x = (double)ap[i];
+                double y = bScalar ? k : (double)bp[i];
+                double r;
+                switch (op)
+                {
+                case VecOp::ADD: r = x + y; break;
+                case VecOp::SUB: r = x - y; break;
+                case VecOp::MUL: r = x * y; break;
+                default: r = x / y; break;
+                }
+                dp[i] = vecSaturate<T>(r);
+            }
+        });
+    }
+
+    vm->push(args[0]);
+    return 1;
+}
+
+int native_vec_add(Interpreter *vm, int argCount, Value *args)
+{
+    return vecBinaryOp(vm, argCount, args, VecOp::ADD, "add");
+}
+
+int native_vec_sub(Interpreter *vm, int argCount, Value *args)
+{
+    return vecBinaryOp(vm, argCount, args, VecOp::SUB, "sub");
+}
+
+int native_vec_mul(Interpreter *vm, int argCount, Value *args)
+{
+    return vecBinaryOp(vm, argCount, args, VecOp::MUL, "mul");
+}
+
+int native_vec_div(Interpreter *vm, int argCount, Value *args)
+{
+    return vecBinaryOp(vm, argCount, args, VecOp::DIV, "div");
+}
+
+// ============================================
+// VEC.FMA(dst, a, b|number, c|number) -> dst = a * b + c
+// ============================================
+
+int native_vec_fma(Interpreter *vm, int argCount, Value *args)
+{
+    VecView d, a, b, c;
+    bool bScalar = false, cScalar = false;
+    double kb = 0.0, kc = 0.0;
+    if (argCount != 4 || !vecView(args[0], &d) || !vecView(args[1], &a))
+    {
+        vm->runtimeError("vec.fma expects (dst, a, b, c)");
+        return 0;
+    }
+    if (!vecSameShape(vm, "fma", d, a) ||
+        !vecOperand(vm, "fma", d, args[2], &b, &bScalar, &kb) ||
+        !vecOperand(vm, "fma", d, args[3], &c, &cScalar, &kc))
+        return 0;
+
+    const size_t n = (size_t)d.count;
+    const VecKernels *kern = vecKernels();
+    if (d.type == BufferType::FLOAT)
+    {
+        float fb = (float)kb, fc = (float)kc;
+        kern->fmaF32((float *)d.data, (const float *)a.data,
+                     bScalar ? &fb : (const float *)b.data, bScalar,
+                     cScalar ? &fc : (const float *)c.data, cScalar, n);
+    }
+    else if (d.type == BufferType::DOUBLE)
+    {
+        kern->fmaF64((double *)d.data, (const double *)a.data,
+                     bScalar ? &kb : (const double *)b.data, bScalar,
+                     cScalar ? &kc : (const double *)c.data, cScalar, n);
+    }
+    else
+    {
+        vecWithType(d.type, [&](auto *tag)
+        {
+            typedef typename std::remove_pointer<decltype(tag)>::type T;
+            T *dp = (T *)d.data;
+            const T *ap = (const T *)a.data;
+            const T *bp = (const T *)b.data;
+            const T *cp = (const T *)c.data;
+            for (size_t i = 0; i < n; i++)
+            {
+                double y = bScalar ? kb : (double)bp[i];
+                double z = cScalar ? kc : (double)cp[i];
+                dp[i] = vecSaturate<T>((double)ap[i] * y + z);
+            }
+        });
+    }
+
+    vm->push(args[0]);
+    return 1;
+}
+
+// ============================================
+// VEC.CLAMP(dst, a, lo, hi) -> dst
+// ============================================
+
+int native_vec_clamp(Interpreter *vm, int argCount, Value *args)
+{
+    VecView d, a;
+    if (argCount != 4 || !vecView(args[0], &d) || !vecView(args[1], &a) ||
+        !args[2].isNumber() || !args[3].isNumber())
+    {
+        vm->runtimeError("vec.clamp expects (dst, a, lo, hi)");
+        return 0;
+    }
+    if (!vecSameShape(vm, "clamp", d, a))
+        return 0;
+
+    double lo = args[2].asNumber();
+    double hi = args[3].asNumber();
+    if (lo > hi)
+    {
+        vm->runtimeError("vec.clamp: lo (%g) > hi (%g)", lo, hi);
+        return 0;
+    }
+
+    const size_t n = (size_t)d.count;
+    if (d.type == BufferType::FLOAT)
+        vecKernels()->clampF32((float *)d.data, (const float *)a.data, (float)lo, (float)hi, n);
+    else if (d.type == BufferType::DOUBLE)
+        vecKernels()->clampF64((double *)d.data, (const double *)a.data, lo, hi, n);
+    else
+    {
+        vecWithType(d.type, [&](auto *tag)
+        {
+            typedef typename std::remove_pointer<decltype(tag)>::type T;
+            const T tlo = vecSaturate<T>(lo);
+            const T thi = vecSaturate<T>(hi);
+            T *dp = (T *)d.data;
+            const T *ap = (const T *)a.data;
+            for (size_t i = 0; i < n; i++)
+            {
+                T x = ap[i];
+                x = x < thi ? x : thi;
+                dp[i] = x > tlo ? x : tlo;
+            }
+        });
+    }
+
+    vm->push(args[0]);
+    return 1;
+}
+
+// ============================================
+// VEC.SUM / DOT / MIN / MAX
+// ============================================
+
+int native_vec_sum(Interpreter *vm, int argCount, Value *args)
+{
+    VecView a;
+    if (argCount != 1 || !vecView(args[0], &a))
+    {
+        vm->runtimeError("vec.sum expects (a)");
+        return 0;
+    }
+
+    const size_t n = (size_t)a.count;
+    double s = 0.0;
+    if (a.type == BufferType::FLOAT)
+        s = vecKernels()->sumF32((const float *)a.data, n);
+    else if (a.type == BufferType::DOUBLE)
+        s = vecKernels()->sumF64((const double *)a.data, n);
+    else
+    {
+        vecWithType(a.type, [&](auto *tag)
+        {
+            typedef typename std::remove_pointer<decltype(tag)>::type T;
+            const T *ap = (const T *)a.data;
+            for (size_t i = 0; i < n; i++)
+                s += (double)ap[i];
+        });
+    }
+
+    vm->pushDouble(s);
+    return 1;
+}
+
+int native_vec_dot(Interpreter *vm, int argCount, Value *args)
+{
+    VecView a, b;
+    if (argCount != 2 || !vecView(args[0], &a) || !vecView(args[1], &b))
+    {
+        vm->runtimeError("vec.dot expects (a, b)");
+        return 0;
+    }
+    if (!vecSameShape(vm, "dot", a, b))
+        return 0;
+
+    const size_t n = (size_t)a.count;
+    double s = 0.0;
+    if (a.type == BufferType::FLOAT)
+        s = vecKernels()->dotF32((const float *)a.data, (const float *)b.data, n);
+    else if (a.type == BufferType::DOUBLE)
+        s = vecKernels()->dotF64((const double *)a.data, (const double *)b.data, n);
+    else
+    {
+        vecWithType(a.type, [&](auto *tag)
+        {
+            typedef typename std::remove_pointer<decltype(tag)>::type T;
+            const T *ap = (const T *)a.data;
+            const T *bp = (const T *)b.data;
+            for (size_t i = 0; i < n; i++)
+                s += (double)ap[i] * (double)bp[i];
+        });
+    }
+
+    vm->pushDouble(s);
+    return 1;
+}
+
+static int vecMinMax(Interpreter *vm, int argCount, Value *args, bool wantMax)
+{
+    VecView a;
+    if (argCount != 1 || !vecView(args[0], &a))
+    {
+        vm->runtimeError("vec.%s expects (a)", wantMax ? "max" : "min");
+        return 0;
+    }
+    if (a.count == 0)
+    {
+        vm->pushNil();
+        return 1;
+    }
+
+    const size_t n = (size_t)a.count;
+    double mn = 0.0, mx = 0.0;
+    if (a.type == BufferType::FLOAT)
+    {
+        float fmn, fmx;
+        vecKernels()->minMaxF32((const float *)a.data, n, &fmn, &fmx);
+        mn = fmn;
+        mx = fmx;
+    }
+    else if (a.type == BufferType::DOUBLE)
+        vecKernels()->minMaxF64((const double *)a.data, n, &mn, &mx);
+    else
+    {
+        vecWithType(a.type, [&](auto *tag)
+        {
+            typedef typename std::remove_pointer<decltype(tag)>::type T;
+            const T *ap = (const T *)a.data;
+            T tmn = ap[0], tmx = ap[0];
+            for (size_t i = 1; i < n; i++)
+            {
+                tmn = ap[i] < tmn ? ap[i] : tmn;
+                tmx = ap[i] > tmx ? ap[i] : tmx;
+            }
+            mn = (double)tmn;
+            mx = (double)tmx;
+        });
+    }
+
+    vecPushElement(vm, a.type, wantMax ? mx : mn);
+    return 1;
+}
+
+int native_vec_min(Interpreter *vm, int argCount, Value *args)
+{
+    return vecMinMax(vm, argCount, args, false);
+}
+
+int native_vec_max(Interpreter *vm, int argCount, Value *args)
+{
+    return vecMinMax(vm, argCount, args, true);
+}
+
+// ============================================
+// VEC.CONVERT(dst, src) -> dst (qualquer par de tipos)
+// ============================================
+
+int native_vec_convert(Interpreter *vm, int argCount, Value *args)
+{
+    VecView d, s;
+    if (argCount != 2 || !vecView(args[0], &d) || !vecView(args[1], &s))
+    {
+        vm->runtimeError("vec.convert expects (dst, src)");
+        return 0;
+    }
+    if (d.count != s.count)
+    {
+        vm->runtimeError("vec.convert: lengths differ (%d vs %d)", d.count, s.count);
+        return 0;
+    }
+
+    const size_t n = (size_t)d.count;
+    if (d.type == s.type)
+    {
+        if (n > 0 && d.data != s.data)
+            std::memmove(d.data, s.data, n * (size_t)d.elementSize);
+    }
+    else if (d.type == BufferType::DOUBLE && s.type == BufferType::FLOAT)
+        vecKernels()->f32ToF64((double *)d.data, (const float *)s.data, n);
+    else if (d.type == BufferType::FLOAT && s.type == BufferType::DOUBLE)
+        vecKernels()->f64ToF32((float *)d.data, (const double *)s.data, n);
+    else
+    {
+        vecWithType(d.type, [&](auto *dtag)
+        {
+            typedef typename std::remove_pointer<decltype(dtag)>::type D;
+            vecWithType(s.type, [&](auto *stag)
+            {
+                typedef typename std::remove_pointer<decltype(stag)>::type S;
+                D *dp = (D *)d.data;
+                const S *sp = (const S *)s.data;
+                for (size_t i = 0; i < n; i++)
+                    dp[i] = vecSaturate<D>((double)sp[i]);
+            });
+        });
+    }
+
+    vm->push(args[0]);
+    return 1;
+}
+
+// ============================================
+// VEC.FILL(dst, value, [start], [count]) -> dst
+// ============================================
+
+static bool vecRange(Interpreter *vm, const char *fn, int total, int start, int count)
+{
+    if (start < 0 || count < 0 || start > total || count > total - start)
+    {
+        vm->runtimeError("vec.%s: range [%d, %d) out of bounds (size=%d)", fn, start, start + count, total);
+        return false;
+    }
+    return true;
+}
+
+int native_vec_fill(Interpreter *vm, int argCount, Value *args)
+{
+    VecView d;
+    if (argCount < 2 || argCount > 4 || !vecView(args[0], &d) || !args[1].isNumber() ||
+        (argCount > 2 && !args[2].isInt()) || (argCount > 3 && !args[3].isInt()))
+    {
+        vm->runtimeError("vec.fill expects (dst, value, [start], [count])");
+        return 0;
+    }
+
+    int start = argCount > 2 ? args[2].asInt() : 0;
+    int count = argCount > 3 ? args[3].asInt() : d.count - start;
+    if (!vecRange(vm, "fill", d.count, start, count))
+        return 0;
+
+    if (count > 0)
+    {
+        const size_t es = (size_t)d.elementSize;
+        uint8 *p = d.data + (size_t)start * es;
+        double v = args[1].asNumber();
+        vecWithType(d.type, [&](auto *tag)
+        {
+            typedef typename std::remove_pointer<decltype(tag)>::type T;
+            T x = vecSaturate<T>(v);
+            std::memcpy(p, &x, sizeof(T));
+        });
+
+        // Um elemento escrito; o resto e memcpy a dobrar (ou memset se os bytes sao iguais)
+        bool uniform = true;
+        for (size_t b = 1; b < es; b++)
+            uniform = uniform && p[b] == p[0];
+        const size_t total = (size_t)count * es;
+        if (uniform)
+            std::memset(p, p[0], total);
+        else
+        {
+            size_t filled = es;
+            while (filled < total)
+            {
+                size_t chunk = filled <= total - filled ? filled : total - filled;
+                std::memcpy(p + filled, p, chunk);
+                filled += chunk;
+            }
+        }
+    }
+
+    vm->push(args[0]);
+    return 1;
+}
+
+// ============================================
+// VEC.COPY(dst, dstOffset, src, srcOffset, count) -> dst
+// ============================================
+
+int native_vec_copy(Interpreter *vm, int argCount, Value *args)
+{
+    VecView d, s;
+    if (argCount != 5 || !vecView(args[0], &d) || !args[1].isInt() || !vecView(args[2], &s) ||
+        !args[3].isInt() || !args[4].isInt())
+    {
+        vm->runtimeError("vec.copy expects (dst, dstOffset, src, srcOffset, count)");
+        return 0;
+    }
+    if (d.type != s.type)
+    {
+        vm->runtimeError("vec.copy: element types differ (use vec.convert)");
+        return 0;
+    }
+
+    int dstOffset = args[1].asInt();
+    int srcOffset = args[3].asInt();
+    int count = args[4].asInt();
+    if (!vecRange(vm, "copy", d.count, dstOffset, count) || !vecRange(vm, "copy", s.count, srcOffset, count))
+        return 0;
+
+    if (count > 0)
+    {
+        const size_t es = (size_t)d.elementSize;
+        std::memmove(d.data + (size_t)dstOffset * es, s.data + (size_t)srcOffset * es, (size_t)count * es);
+    }
+
+    vm->push(args[0]);
+    return 1;
+}
+
+// ============================================
+// VEC.SLICE(src, start, [end]) -> novo Buffer / typed array da mesma classe
+// ============================================
+
+int native_vec_slice(Interpreter *vm, int argCount, Value *args)
+{
+    VecView s;
+    if (argCount < 2 || argCount > 3 || !vecView(args[0], &s) || !args[1].isInt() ||
+        (argCount > 2 && !args[2].isInt()))
+    {
+        vm->runtimeError("vec.slice expects (src, start, [end])");
+        return 0;
+    }
+
+    // Indices negativos contam do fim; o resultado e cortado a [0, count]
+    int start = args[1].asInt();
+    int end = argCount > 2 ? args[2].asInt() : s.count;
+    if (start < 0)
+        start += s.count;
+    if (end < 0)
+        end += s.count;
+    start = start < 0 ? 0 : (start > s.count ? s.count : start);
+    end = end < start ? start : (end > s.count ? s.count : end);
+
+    const int count = end - start;
+    const size_t bytes = (size_t)count * (size_t)s.elementSize;
+    const uint8 *from = s.data + (size_t)start * (size_t)s.elementSize;
+
+    if (args[0].isBuffer())
+    {
+        Value out = vm->makeBuffer(count, (int)s.type);
+        if (bytes > 0)
+            std::memcpy(out.asBuffer()->data, from, bytes);
+        vm->push(out);
+        return 1;
+    }
+
+    NativeClassDef *klass = args[0].asNativeClassInstance()->klass;
+    TypedArrayData *ta = new TypedArrayData();
+    ta->type = s.type;
+    ta->count = count;
+    ta->capacity = count;
+    ta->elementSize = s.elementSize;
+    ta->data = nullptr;
+    if (bytes > 0)
+    {
+        ta->data = (uint8 *)std::malloc(bytes);
+        if (!ta->data)
+        {
+            delete ta;
+            vm->runtimeError("vec.slice: out of memory");
+            return 0;
+        }
+        std::memcpy(ta->data, from, bytes);
+    }
+
+    Value v = vm->makeNativeClassInstance(klass->persistent);
+    NativeClassInstance *instance = v.as.sClassInstance;
+    instance->klass = klass;
+    instance->userData = ta;
+    vm->push(v);
+    return 1;
+}
+
+// ============================================
+// VEC.ISA([name]) -> kernels em uso ("avx2", "sse2", "scalar")
+// Com argumento forca outro conjunto (testes/benchmarks); "best" volta ao
+// automatico; nil se esse conjunto nao existe nesta CPU
+// ============================================
+
+int native_vec_isa(Interpreter *vm, int argCount, Value *args)
+{
+    if (argCount > 1 || (argCount == 1 && !args[0].isString()))
+    {
+        vm->runtimeError("vec.isa expects ([name])");
+        return 0;
+    }
+
+    if (argCount == 1)
+    {
+        const char *name = args[0].asStringChars();
+        const VecKernels *want = nullptr;
+        if (std::strcmp(name, "best") == 0)
+            want = vecKernelsBest();
+        else if (std::strcmp(name, "scalar") == 0)
+            want = vecKernelsScalar();
+        else if (std::strcmp(name, "sse2") == 0)
+            want = vecKernelsSse2();
+        else if (std::strcmp(name, "avx2") == 0 && std::strcmp(vecKernelsBest()->name, "avx2") == 0)
+            want = vecKernelsBest();
+
+        if (!want)
+        {
+            vm->pushNil();
+            return 1;
+        }
+        gVecKernels = want;
+    }
+
+    vm->push(vm->makeString(vecKernels()->name));
+    return 1;
+}
+
+// ============================================
+// REGISTRATION
+// ============================================
+
+void Interpreter::registerVec()
+{
+    addModule("vec")
+        .addFunction("add", native_vec_add, 3)
+        .addFunction("sub", native_vec_sub, 3)
+        .addFunction("mul", native_vec_mul, 3)
+        .addFunction("div", native_vec_div, 3)
+        .addFunction("fma", native_vec_fma, 4)
+        .addFunction("clamp", native_vec_clamp, 4)
+        .addFunction("sum", native_vec_sum, 1)
+        .addFunction("dot", native_vec_dot, 2)
+        .addFunction("min", native_vec_min, 1)
+        .addFunction("max", native_vec_max, 1)
+        .addFunction("convert", native_vec_convert, 2)
+        .addFunction("fill", native_vec_fill, -1)
+        .addFunction("copy", native_vec_copy, 5)
+        .addFunction("slice", native_vec_slice, -1)
+        .addFunction("isa", native_vec_isa, -1);
+}
+
+#endif
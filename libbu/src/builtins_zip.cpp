@@ -9,7 +9,16 @@
 #include <cctype>
 #include <climits>
 #include <cstring>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 #ifdef _WIN32
 #include <direct.h>
@@ -184,6 +193,31 @@ static std::string zipNormalizeEntryName(const char *entryName)
     return result;
 }
 
+// Inflate an entry into a NUL-terminated heap block (free with free()).
+// The string pool looks strings up by C string, so text must end in '\0'.
+static char *zipExtractText(mz_zip_archive *zip, mz_uint index, size_t *outSize)
+{
+    mz_zip_archive_file_stat st;
+    if (!mz_zip_reader_file_stat(zip, index, &st) || st.m_uncomp_size >= (mz_uint64)UINT32_MAX)
+    {
+        return nullptr;
+    }
+    size_t size = (size_t)st.m_uncomp_size;
+    char *text = (char *)malloc(size + 1);
+    if (!text)
+    {
+        return nullptr;
+    }
+    if (size > 0 && !mz_zip_reader_extract_to_mem(zip, index, text, size, 0))
+    {
+        free(text);
+        return nullptr;
+    }
+    text[size] = '\0';
+    *outSize = size;
+    return text;
+}
+
 int native_zip_list(Interpreter *vm, int argCount, Value *args)
 {
     if (argCount < 1 || !args[0].isString())
@@ -238,8 +272,12 @@ int native_zip_read(Interpreter *vm, int argCount, Value *args)
     }
 
     size_t size = 0;
-    void *data = mz_zip_reader_extract_file_to_heap(
-        &zip, args[1].asStringChars(), &size, 0);
+    char *data = nullptr;
+    int index = mz_zip_reader_locate_file(&zip, args[1].asStringChars(), NULL, 0);
+    if (index >= 0)
+    {
+        data = zipExtractText(&zip, (mz_uint)index, &size);
+    }
 
     if (!data)
     {
@@ -248,11 +286,11 @@ int native_zip_read(Interpreter *vm, int argCount, Value *args)
         return 1;
     }
 
-    std::string text((const char *)data, size);
-    mz_free(data);
+    String *text = vm->createString(data, (uint32)size);
+    free(data);
     mz_zip_reader_end(&zip);
 
-    vm->push(vm->makeString(text.c_str()));
+    vm->push(vm->makeString(text));
     return 1;
 }
 
@@ -273,42 +311,41 @@ int native_zip_read_buffer(Interpreter *vm, int argCount, Value *args)
         return 1;
     }
 
-    size_t size = 0;
-    void *data = mz_zip_reader_extract_file_to_heap(
-        &zip, args[1].asStringChars(), &size, 0);
-
-    if (!data)
+    int index = mz_zip_reader_locate_file(&zip, args[1].asStringChars(), NULL, 0);
+    mz_zip_archive_file_stat st;
+    if (index < 0 || !mz_zip_reader_file_stat(&zip, (mz_uint)index, &st))
     {
         mz_zip_reader_end(&zip);
         vm->pushNil();
         return 1;
     }
 
-    if (size > (size_t)INT_MAX)
+    if (st.m_uncomp_size > (mz_uint64)INT_MAX)
     {
-        mz_free(data);
         mz_zip_reader_end(&zip);
         vm->runtimeError("zip.read_buffer: entry too large");
         return 0;
     }
 
+    // Inflate directly into the buffer memory (no intermediate heap copy)
+    size_t size = (size_t)st.m_uncomp_size;
     Value bufferValue = vm->makeBuffer((int)size, 0); // UINT8
     BufferInstance *buf = bufferValue.asBuffer();
-    if (!buf || !buf->data)
+    if (!buf || (size > 0 && !buf->data))
     {
-        mz_free(data);
         mz_zip_reader_end(&zip);
         vm->pushNil();
         return 1;
     }
 
-    if (size > 0)
+    if (size > 0 && !mz_zip_reader_extract_to_mem(&zip, (mz_uint)index, buf->data, size, 0))
     {
-        memcpy(buf->data, data, size);
+        mz_zip_reader_end(&zip);
+        vm->pushNil();
+        return 1;
     }
     buf->cursor = 0;
 
-    mz_free(data);
     mz_zip_reader_end(&zip);
 
     vm->push(bufferValue);
@@ -465,6 +502,1059 @@ int native_zip_create(Interpreter *vm, int argCount, Value *args)
     return 1;
 }
 
+// ============================================
+// ZipArchive — archive kept open between calls
+//
+//   var z = ZipArchive("assets.zip");
+//   var img = z.readBuffer("gfx/player.png");
+//
+// The central directory is parsed once and every entry is indexed by name,
+// so lookups and extraction don't pay mz_zip_reader_init_file again.
+// Binary reads inflate straight into BufferInstance memory; large entries
+// can be streamed in chunks with open()/readChunk()/closeEntry().
+// ============================================
+
+struct ZipEntryInfo
+{
+    std::string name;
+    mz_uint64 size;
+    mz_uint64 compressedSize;
+    bool isDirectory;
+};
+
+struct ZipArchiveData
+{
+    mz_zip_archive zip;
+    bool isOpen;
+    std::string path;
+    std::vector<ZipEntryInfo> entries;
+    std::unordered_map<std::string, mz_uint> index;
+
+    // Streaming state (one entry at a time)
+    mz_zip_reader_extract_iter_state *iter;
+    int iterEntry;
+
+    ZipArchiveData() : isOpen(false), iter(nullptr), iterEntry(-1)
+    {
+        memset(&zip, 0, sizeof(zip));
+    }
+};
+
+static ZipArchiveData *asZipArchive(void *instance)
+{
+    return static_cast<ZipArchiveData *>(instance);
+}
+
+static void zipArchiveCloseEntry(ZipArchiveData *za)
+{
+    if (za->iter)
+    {
+        mz_zip_reader_extract_iter_free(za->iter);
+        za->iter = nullptr;
+    }
+    za->iterEntry = -1;
+}
+
+static void zipArchiveClose(ZipArchiveData *za)
+{
+    zipArchiveCloseEntry(za);
+    if (za->isOpen)
+    {
+        mz_zip_reader_end(&za->zip);
+        za->isOpen = false;
+    }
+    za->entries.clear();
+    za->index.clear();
+}
+
+static bool zipArchiveOpen(ZipArchiveData *za, const char *path)
+{
+    za->path = path;
+    if (!mz_zip_reader_init_file(&za->zip, path, 0))
+    {
+        return false;
+    }
+    za->isOpen = true;
+
+    mz_uint numFiles = mz_zip_reader_get_num_files(&za->zip);
+    za->entries.reserve(numFiles);
+    za->index.reserve(numFiles);
+
+    for (mz_uint i = 0; i < numFiles; i++)
+    {
+        mz_zip_archive_file_stat st;
+        ZipEntryInfo info;
+        if (mz_zip_reader_file_stat(&za->zip, i, &st))
+        {
+            info.name = st.m_filename;
+            info.size = st.m_uncomp_size;
+            info.compressedSize = st.m_comp_size;
+            info.isDirectory = st.m_is_directory != 0;
+        }
+        else
+        {
+            info.size = 0;
+            info.compressedSize = 0;
+            info.isDirectory = false;
+        }
+        // First entry wins on duplicated names (same as mz_zip_reader_locate_file)
+        za->index.emplace(info.name, i);
+        za->entries.push_back(info);
+    }
+    return true;
+}
+
+// Resolve an entry argument (name or index). Returns -1 if not found.
+static int zipArchiveResolve(ZipArchiveData *za, const Value &entry)
+{
+    if (!za->isOpen)
+    {
+        return -1;
+    }
+    if (entry.isInt())
+    {
+        int i = entry.asInt();
+        return (i >= 0 && (size_t)i < za->entries.size()) ? i : -1;
+    }
+    if (entry.isString())
+    {
+        auto it = za->index.find(std::string(entry.asStringChars(), entry.asString()->length()));
+        return it == za->index.end() ? -1 : (int)it->second;
+    }
+    return -1;
+}
+
+static Value zipSizeValue(Interpreter *vm, mz_uint64 size)
+{
+    if (size <= (mz_uint64)INT_MAX)
+    {
+        return vm->makeInt((int)size);
+    }
+    return vm->makeDouble((double)size);
+}
+
+static size_t zipBufferBytes(const BufferInstance *buf)
+{
+    return (size_t)buf->count * (size_t)buf->elementSize;
+}
+
+static void *zip_archive_ctor(Interpreter *vm, int argCount, Value *args)
+{
+    if (argCount < 1 || !args[0].isString())
+    {
+        vm->runtimeError("ZipArchive expects (archivePath)");
+        return nullptr;
+    }
+
+    ZipArchiveData *za = new ZipArchiveData();
+    // A missing/corrupt archive still yields an instance: isOpen() reports it
+    zipArchiveOpen(za, args[0].asStringChars());
+    return za;
+}
+
+static void zip_archive_dtor(Interpreter *vm, void *instance)
+{
+    (void)vm;
+    ZipArchiveData *za = asZipArchive(instance);
+    zipArchiveClose(za);
+    delete za;
+}
+
+static int zip_archive_is_open(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    (void)argCount;
+    (void)args;
+    vm->pushBool(asZipArchive(instance)->isOpen);
+    return 1;
+}
+
+static int zip_archive_close(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    (void)vm;
+    (void)argCount;
+    (void)args;
+    zipArchiveClose(asZipArchive(instance));
+    return 0;
+}
+
+static int zip_archive_count(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    (void)argCount;
+    (void)args;
+    vm->pushInt((int)asZipArchive(instance)->entries.size());
+    return 1;
+}
+
+static int zip_archive_list(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    (void)argCount;
+    (void)args;
+    ZipArchiveData *za = asZipArchive(instance);
+
+    Value out = vm->makeArray();
+    ArrayInstance *arr = out.asArray();
+    arr->values.reserve(za->entries.size());
+    for (size_t i = 0; i < za->entries.size(); i++)
+    {
+        const std::string &name = za->entries[i].name;
+        arr->values.push(vm->makeString(vm->createString(name.c_str(), (uint32)name.size())));
+    }
+    vm->push(out);
+    return 1;
+}
+
+static int zip_archive_has(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    if (argCount < 1)
+    {
+        vm->runtimeError("ZipArchive.has expects (entry)");
+        return 0;
+    }
+    vm->pushBool(zipArchiveResolve(asZipArchive(instance), args[0]) >= 0);
+    return 1;
+}
+
+static int zip_archive_index_of(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    if (argCount < 1 || !args[0].isString())
+    {
+        vm->runtimeError("ZipArchive.indexOf expects (entryName)");
+        return 0;
+    }
+    vm->pushInt(zipArchiveResolve(asZipArchive(instance), args[0]));
+    return 1;
+}
+
+static int zip_archive_name(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    if (argCount < 1 || !args[0].isInt())
+    {
+        vm->runtimeError("ZipArchive.name expects (index)");
+        return 0;
+    }
+    ZipArchiveData *za = asZipArchive(instance);
+    int idx = zipArchiveResolve(za, args[0]);
+    if (idx < 0)
+    {
+        vm->pushNil();
+        return 1;
+    }
+    const std::string &name = za->entries[idx].name;
+    vm->push(vm->makeString(vm->createString(name.c_str(), (uint32)name.size())));
+    return 1;
+}
+
+static int zip_archive_size(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    if (argCount < 1)
+    {
+        vm->runtimeError("ZipArchive.size expects (entry)");
+        return 0;
+    }
+    ZipArchiveData *za = asZipArchive(instance);
+    int idx = zipArchiveResolve(za, args[0]);
+    if (idx < 0)
+    {
+        vm->pushInt(-1);
+        return 1;
+    }
+    vm->push(zipSizeValue(vm, za->entries[idx].size));
+    return 1;
+}
+
+static int zip_archive_compressed_size(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    if (argCount < 1)
+    {
+        vm->runtimeError("ZipArchive.compressedSize expects (entry)");
+        return 0;
+    }
+    ZipArchiveData *za = asZipArchive(instance);
+    int idx = zipArchiveResolve(za, args[0]);
+    if (idx < 0)
+    {
+        vm->pushInt(-1);
+        return 1;
+    }
+    vm->push(zipSizeValue(vm, za->entries[idx].compressedSize));
+    return 1;
+}
+
+static int zip_archive_is_directory(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    if (argCount < 1)
+    {
+        vm->runtimeError("ZipArchive.isDirectory expects (entry)");
+        return 0;
+    }
+    ZipArchiveData *za = asZipArchive(instance);
+    int idx = zipArchiveResolve(za, args[0]);
+    vm->pushBool(idx >= 0 && za->entries[idx].isDirectory);
+    return 1;
+}
+
+static int zip_archive_read(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    if (argCount < 1)
+    {
+        vm->runtimeError("ZipArchive.read expects (entry)");
+        return 0;
+    }
+    ZipArchiveData *za = asZipArchive(instance);
+    int idx = zipArchiveResolve(za, args[0]);
+    if (idx < 0)
+    {
+        vm->pushNil();
+        return 1;
+    }
+    if (za->entries[idx].size > (mz_uint64)UINT32_MAX)
+    {
+        vm->runtimeError("ZipArchive.read: entry too large");
+        return 0;
+    }
+
+    size_t size = 0;
+    char *data = zipExtractText(&za->zip, (mz_uint)idx, &size);
+    if (!data)
+    {
+        vm->pushNil();
+        return 1;
+    }
+    String *text = vm->createString(data, (uint32)size);
+    free(data);
+    vm->push(vm->makeString(text));
+    return 1;
+}
+
+static int zip_archive_read_buffer(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    if (argCount < 1)
+    {
+        vm->runtimeError("ZipArchive.readBuffer expects (entry)");
+        return 0;
+    }
+    ZipArchiveData *za = asZipArchive(instance);
+    int idx = zipArchiveResolve(za, args[0]);
+    if (idx < 0)
+    {
+        vm->pushNil();
+        return 1;
+    }
+    if (za->entries[idx].size > (mz_uint64)INT_MAX)
+    {
+        vm->runtimeError("ZipArchive.readBuffer: entry too large");
+        return 0;
+    }
+
+    size_t size = (size_t)za->entries[idx].size;
+    Value bufferValue = vm->makeBuffer((int)size, 0); // UINT8
+    BufferInstance *buf = bufferValue.asBuffer();
+    if (!buf || (size > 0 && !buf->data))
+    {
+        vm->pushNil();
+        return 1;
+    }
+    if (size > 0 && !mz_zip_reader_extract_to_mem(&za->zip, (mz_uint)idx, buf->data, size, 0))
+    {
+        vm->pushNil();
+        return 1;
+    }
+    buf->cursor = 0;
+    vm->push(bufferValue);
+    return 1;
+}
+
+// readInto(entry, buffer, [byteOffset]) -> bytes written, -1 on failure
+// Reuses caller-owned memory: no allocation per entry.
+static int zip_archive_read_into(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    if (argCount < 2 || !args[1].isBuffer())
+    {
+        vm->runtimeError("ZipArchive.readInto expects (entry, buffer, [byteOffset])");
+        return 0;
+    }
+    ZipArchiveData *za = asZipArchive(instance);
+    BufferInstance *buf = args[1].asBuffer();
+    int offset = (argCount >= 3 && args[2].isInt()) ? args[2].asInt() : 0;
+
+    int idx = zipArchiveResolve(za, args[0]);
+    size_t capacity = zipBufferBytes(buf);
+    if (idx < 0 || offset < 0 || (size_t)offset > capacity)
+    {
+        vm->pushInt(-1);
+        return 1;
+    }
+
+    mz_uint64 size = za->entries[idx].size;
+    if (size > (mz_uint64)(capacity - (size_t)offset))
+    {
+        vm->pushInt(-1);
+        return 1;
+    }
+    if (size > 0 && !mz_zip_reader_extract_to_mem(&za->zip, (mz_uint)idx, buf->data + offset, (size_t)size, 0))
+    {
+        vm->pushInt(-1);
+        return 1;
+    }
+    vm->pushInt((int)size);
+    return 1;
+}
+
+// open(entry) -> bool. Starts chunked extraction of one entry.
+static int zip_archive_open_entry(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    if (argCount < 1)
+    {
+        vm->runtimeError("ZipArchive.open expects (entry)");
+        return 0;
+    }
+    ZipArchiveData *za = asZipArchive(instance);
+    zipArchiveCloseEntry(za);
+
+    int idx = zipArchiveResolve(za, args[0]);
+    if (idx < 0)
+    {
+        vm->pushBool(false);
+        return 1;
+    }
+    za->iter = mz_zip_reader_extract_iter_new(&za->zip, (mz_uint)idx, 0);
+    za->iterEntry = za->iter ? idx : -1;
+    vm->pushBool(za->iter != nullptr);
+    return 1;
+}
+
+// readChunk(buffer, [byteOffset], [maxBytes]) -> bytes read (0 at end of entry)
+static int zip_archive_read_chunk(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    if (argCount < 1 || !args[0].isBuffer())
+    {
+        vm->runtimeError("ZipArchive.readChunk expects (buffer, [byteOffset], [maxBytes])");
+        return 0;
+    }
+    ZipArchiveData *za = asZipArchive(instance);
+    if (!za->iter)
+    {
+        vm->pushInt(0);
+        return 1;
+    }
+
+    BufferInstance *buf = args[0].asBuffer();
+    size_t capacity = zipBufferBytes(buf);
+    int offset = (argCount >= 2 && args[1].isInt()) ? args[1].asInt() : 0;
+    if (offset < 0 || (size_t)offset > capacity)
+    {
+        vm->pushInt(0);
+        return 1;
+    }
+
+    size_t want = capacity - (size_t)offset;
+    if (argCount >= 3 && args[2].isInt() && args[2].asInt() >= 0 && (size_t)args[2].asInt() < want)
+    {
+        want = (size_t)args[2].asInt();
+    }
+
+    size_t got = want > 0 ? mz_zip_reader_extract_iter_read(za->iter, buf->data + offset, want) : 0;
+    vm->pushInt((int)got);
+    return 1;
+}
+
+static int zip_archive_close_entry(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    (void)vm;
+    (void)argCount;
+    (void)args;
+    zipArchiveCloseEntry(asZipArchive(instance));
+    return 0;
+}
+
+static Value zip_archive_get_path(Interpreter *vm, void *instance)
+{
+    const std::string &path = asZipArchive(instance)->path;
+    return vm->makeString(vm->createString(path.c_str(), (uint32)path.size()));
+}
+
+static Value zip_archive_get_count(Interpreter *vm, void *instance)
+{
+    return vm->makeInt((int)asZipArchive(instance)->entries.size());
+}
+
+static void registerZipArchiveClass(Interpreter &vm)
+{
+    NativeClassDef *klass = vm.registerNativeClass("ZipArchive", zip_archive_ctor, zip_archive_dtor, 1, false);
+
+    vm.addNativeMethod(klass, "isOpen", zip_archive_is_open);
+    vm.addNativeMethod(klass, "close", zip_archive_close);
+
+    // Entry index
+    vm.addNativeMethod(klass, "count", zip_archive_count);
+    vm.addNativeMethod(klass, "list", zip_archive_list);
+    vm.addNativeMethod(klass, "has", zip_archive_has);
+    vm.addNativeMethod(klass, "indexOf", zip_archive_index_of);
+    vm.addNativeMethod(klass, "name", zip_archive_name);
+    vm.addNativeMethod(klass, "size", zip_archive_size);
+    vm.addNativeMethod(klass, "compressedSize", zip_archive_compressed_size);
+    vm.addNativeMethod(klass, "isDirectory", zip_archive_is_directory);
+
+    // Whole-entry extraction
+    vm.addNativeMethod(klass, "read", zip_archive_read);
+    vm.addNativeMethod(klass, "readBuffer", zip_archive_read_buffer);
+    vm.addNativeMethod(klass, "readInto", zip_archive_read_into);
+
+    // Chunked extraction
+    vm.addNativeMethod(klass, "open", zip_archive_open_entry);
+    vm.addNativeMethod(klass, "readChunk", zip_archive_read_chunk);
+    vm.addNativeMethod(klass, "closeEntry", zip_archive_close_entry);
+
+    vm.addNativeProperty(klass, "path", zip_archive_get_path, nullptr);
+    vm.addNativeProperty(klass, "count", zip_archive_get_count, nullptr);
+}
+
+// ============================================
+// ZipWriter — incremental archive creation
+//
+//   var w = ZipWriter("logs.zip", 6, 4);   // path, level, worker threads
+//   w.addFile("app.log");
+//   w.addBuffer("meta.json", text);
+//   w.finalize();
+//
+// Entries are written to disk as they are added. With threads > 0 each entry
+// is deflated on a worker thread into memory (raw deflate + CRC) and then
+// appended in submission order as pre-compressed data, so independent files
+// use all cores. At most 2 * threads entries are in flight, which bounds
+// memory; files larger than kZipParallelMaxBytes bypass the workers and are
+// streamed from disk by miniz.
+// ============================================
+
+static const size_t kZipParallelMaxBytes = 64u * 1024u * 1024u;
+
+struct ZipWriteJob
+{
+    std::string archiveName;
+    std::string sourcePath; // empty = data already in `input`
+    std::vector<unsigned char> input;
+    int level;
+    bool hasTime;
+    MZ_TIME_T mtime;
+
+    // Filled by the worker
+    bool done;
+    bool ok;
+    void *compressed; // tdefl heap block (malloc), null = store
+    size_t compressedSize;
+    mz_uint64 uncompressedSize;
+    mz_uint32 crc;
+    std::string error;
+
+    ZipWriteJob()
+        : level(6), hasTime(false), mtime(0), done(false), ok(false),
+          compressed(nullptr), compressedSize(0), uncompressedSize(0), crc(0) {}
+
+    ~ZipWriteJob()
+    {
+        if (compressed)
+        {
+            mz_free(compressed);
+        }
+    }
+};
+
+static bool zipReadWholeFile(const std::string &path, std::vector<unsigned char> &out)
+{
+    FILE *f = fopen(path.c_str(), "rb");
+    if (!f)
+    {
+        return false;
+    }
+    out.clear();
+    unsigned char chunk[64 * 1024];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0)
+    {
+        out.insert(out.end(), chunk, chunk + n);
+    }
+    bool ok = !ferror(f);
+    fclose(f);
+    return ok;
+}
+
+// Runs on a worker thread: touches nothing but the job.
+static void zipCompressJob(ZipWriteJob *job)
+{
+    if (!job->sourcePath.empty() && !zipReadWholeFile(job->sourcePath, job->input))
+    {
+        job->error = "cannot read '" + job->sourcePath + "'";
+        job->ok = false;
+        return;
+    }
+
+    const unsigned char *data = job->input.empty() ? nullptr : job->input.data();
+    job->uncompressedSize = job->input.size();
+    job->crc = (mz_uint32)mz_crc32(MZ_CRC32_INIT, data, job->input.size());
+
+    // Tiny or level-0 entries are stored; the writer handles them directly
+    if (job->level > 0 && job->input.size() > 3)
+    {
+        mz_uint flags = tdefl_create_comp_flags_from_zip_params(job->level, -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY);
+        size_t outLen = 0;
+        void *out = tdefl_compress_mem_to_heap(data, job->input.size(), &outLen, (int)flags);
+        if (out && outLen < job->input.size())
+        {
+            job->compressed = out;
+            job->compressedSize = outLen;
+        }
+        else if (out)
+        {
+            mz_free(out);
+        }
+    }
+    job->ok = true;
+}
+
+struct ZipWriterData
+{
+    mz_zip_archive zip;
+    bool isOpen;
+    bool failed;
+    std::string path;
+    std::string error;
+    int level;
+    int entries;
+
+    // Worker pool
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable workCv; // jobs available / stop
+    std::condition_variable doneCv; // a job finished
+    std::deque<ZipWriteJob *> queue;                   // waiting for a worker
+    std::deque<std::unique_ptr<ZipWriteJob>> pending; // submission order
+    bool stopping;
+
+    ZipWriterData() : isOpen(false), failed(false), level(6), entries(0), stopping(false)
+    {
+        memset(&zip, 0, sizeof(zip));
+    }
+};
+
+static ZipWriterData *asZipWriter(void *instance)
+{
+    return static_cast<ZipWriterData *>(instance);
+}
+
+static int zipClampLevel(int level)
+{
+    if (level < 0)
+    {
+        return 0;
+    }
+    if (level > 10)
+    {
+        return 10;
+    }
+    return level;
+}
+
+static void zipWriterFail(ZipWriterData *zw, const std::string &message)
+{
+    if (!zw->failed)
+    {
+        zw->failed = true;
+        zw->error = message;
+    }
+}
+
+static void zipWorkerLoop(ZipWriterData *zw)
+{
+    for (;;)
+    {
+        ZipWriteJob *job;
+        {
+            std::unique_lock<std::mutex> lock(zw->mutex);
+            zw->workCv.wait(lock, [zw] { return zw->stopping || !zw->queue.empty(); });
+            if (zw->queue.empty())
+            {
+                return;
+            }
+            job = zw->queue.front();
+            zw->queue.pop_front();
+        }
+
+        zipCompressJob(job);
+
+        {
+            std::lock_guard<std::mutex> lock(zw->mutex);
+            job->done = true;
+        }
+        zw->doneCv.notify_all();
+    }
+}
+
+static void zipWriterStopWorkers(ZipWriterData *zw)
+{
+    {
+        std::lock_guard<std::mutex> lock(zw->mutex);
+        zw->stopping = true;
+    }
+    zw->workCv.notify_all();
+    for (size_t i = 0; i < zw->workers.size(); i++)
+    {
+        zw->workers[i].join();
+    }
+    zw->workers.clear();
+    zw->stopping = false;
+}
+
+static void zipWriterStartWorkers(ZipWriterData *zw, int threads)
+{
+    if (threads > 64)
+    {
+        threads = 64;
+    }
+    for (int i = 0; i < threads; i++)
+    {
+        zw->workers.emplace_back(zipWorkerLoop, zw);
+    }
+}
+
+// Append a finished job to the archive (VM thread only).
+static void zipWriterCommit(ZipWriterData *zw, ZipWriteJob *job)
+{
+    if (zw->failed)
+    {
+        return;
+    }
+    if (!job->ok)
+    {
+        zipWriterFail(zw, job->error);
+        return;
+    }
+
+    MZ_TIME_T *mtime = job->hasTime ? &job->mtime : NULL;
+    mz_bool ok;
+    if (job->compressed)
+    {
+        ok = mz_zip_writer_add_mem_ex_v2(&zw->zip, job->archiveName.c_str(),
+                                         job->compressed, job->compressedSize, NULL, 0,
+                                         (mz_uint)job->level | MZ_ZIP_FLAG_COMPRESSED_DATA,
+                                         job->uncompressedSize, job->crc, mtime, NULL, 0, NULL, 0);
+    }
+    else
+    {
+        ok = mz_zip_writer_add_mem_ex_v2(&zw->zip, job->archiveName.c_str(),
+                                         job->input.empty() ? NULL : job->input.data(), job->input.size(),
+                                         NULL, 0, 0, 0, 0, mtime, NULL, 0, NULL, 0);
+    }
+
+    if (!ok)
+    {
+        zipWriterFail(zw, "cannot add '" + job->archiveName + "': " +
+                              mz_zip_get_error_string(mz_zip_get_last_error(&zw->zip)));
+        return;
+    }
+    zw->entries++;
+}
+
+// Write finished jobs at the head of the queue. With `all`, wait for every
+// pending job; otherwise wait only while more than `maxPending` are in flight.
+static void zipWriterDrain(ZipWriterData *zw, bool all)
+{
+    const size_t maxPending = all ? 0 : zw->workers.size() * 2;
+    while (!zw->pending.empty())
+    {
+        ZipWriteJob *head = zw->pending.front().get();
+        {
+            std::unique_lock<std::mutex> lock(zw->mutex);
+            if (!head->done)
+            {
+                if (zw->pending.size() <= maxPending)
+                {
+                    return;
+                }
+                zw->doneCv.wait(lock, [head] { return head->done; });
+            }
+        }
+        zipWriterCommit(zw, head);
+        zw->pending.pop_front();
+    }
+}
+
+static void zipWriterSubmit(ZipWriterData *zw, std::unique_ptr<ZipWriteJob> job)
+{
+    if (zw->workers.empty())
+    {
+        zipCompressJob(job.get());
+        zipWriterCommit(zw, job.get());
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(zw->mutex);
+        zw->queue.push_back(job.get());
+    }
+    zw->pending.push_back(std::move(job));
+    zw->workCv.notify_one();
+    zipWriterDrain(zw, false);
+}
+
+static bool zipWriterFinish(ZipWriterData *zw)
+{
+    if (!zw->isOpen)
+    {
+        return !zw->failed;
+    }
+    zipWriterDrain(zw, true);
+    zipWriterStopWorkers(zw);
+
+    if (!zw->failed && !mz_zip_writer_finalize_archive(&zw->zip))
+    {
+        zipWriterFail(zw, "cannot finalize archive");
+    }
+    mz_zip_writer_end(&zw->zip);
+    zw->isOpen = false;
+    return !zw->failed;
+}
+
+static void *zip_writer_ctor(Interpreter *vm, int argCount, Value *args)
+{
+    if (argCount < 1 || !args[0].isString())
+    {
+        vm->runtimeError("ZipWriter expects (archivePath, [level], [threads])");
+        return nullptr;
+    }
+
+    ZipWriterData *zw = new ZipWriterData();
+    zw->path = args[0].asStringChars();
+    if (argCount >= 2 && args[1].isInt())
+    {
+        zw->level = zipClampLevel(args[1].asInt());
+    }
+
+    if (mz_zip_writer_init_file(&zw->zip, zw->path.c_str(), 0))
+    {
+        zw->isOpen = true;
+        if (argCount >= 3 && args[2].isInt() && args[2].asInt() > 0)
+        {
+            zipWriterStartWorkers(zw, args[2].asInt());
+        }
+    }
+    else
+    {
+        zipWriterFail(zw, "cannot create '" + zw->path + "'");
+    }
+    return zw;
+}
+
+static void zip_writer_dtor(Interpreter *vm, void *instance)
+{
+    (void)vm;
+    ZipWriterData *zw = asZipWriter(instance);
+    // Unfinished archives are finalized so the file on disk is always valid
+    zipWriterFinish(zw);
+    delete zw;
+}
+
+// addFile(sourcePath, [archiveName], [level]) -> bool
+static int zip_writer_add_file(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    if (argCount < 1 || !args[0].isString())
+    {
+        vm->runtimeError("ZipWriter.addFile expects (sourcePath, [archiveName], [level])");
+        return 0;
+    }
+    ZipWriterData *zw = asZipWriter(instance);
+    std::string sourcePath = args[0].asStringChars();
+    std::string archiveName = (argCount >= 2 && args[1].isString())
+                                  ? zipNormalizeEntryName(args[1].asStringChars())
+                                  : zipBaseName(sourcePath);
+    int level = (argCount >= 3 && args[2].isInt()) ? zipClampLevel(args[2].asInt()) : zw->level;
+
+    if (!zw->isOpen || zw->failed)
+    {
+        vm->pushBool(false);
+        return 1;
+    }
+
+    struct stat st;
+    if (archiveName.empty() || stat(sourcePath.c_str(), &st) != 0 || S_ISDIR(st.st_mode))
+    {
+        zipWriterFail(zw, "cannot read '" + sourcePath + "'");
+        vm->pushBool(false);
+        return 1;
+    }
+
+    if (zw->workers.empty() || level == 0 || (size_t)st.st_size > kZipParallelMaxBytes)
+    {
+        // Streamed from disk by miniz; keep archive order
+        zipWriterDrain(zw, true);
+        if (!zw->failed)
+        {
+            if (mz_zip_writer_add_file(&zw->zip, archiveName.c_str(), sourcePath.c_str(), NULL, 0, (mz_uint)level))
+            {
+                zw->entries++;
+            }
+            else
+            {
+                zipWriterFail(zw, "cannot add '" + sourcePath + "': " +
+                                      mz_zip_get_error_string(mz_zip_get_last_error(&zw->zip)));
+            }
+        }
+        vm->pushBool(!zw->failed);
+        return 1;
+    }
+
+    std::unique_ptr<ZipWriteJob> job(new ZipWriteJob());
+    job->archiveName = archiveName;
+    job->sourcePath = sourcePath;
+    job->level = level;
+    job->hasTime = true;
+    job->mtime = st.st_mtime;
+    zipWriterSubmit(zw, std::move(job));
+
+    vm->pushBool(!zw->failed);
+    return 1;
+}
+
+// addBuffer(archiveName, bufferOrString, [level]) -> bool
+static int zip_writer_add_buffer(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    if (argCount < 2 || !args[0].isString() || (!args[1].isBuffer() && !args[1].isString()))
+    {
+        vm->runtimeError("ZipWriter.addBuffer expects (archiveName, buffer|string, [level])");
+        return 0;
+    }
+    ZipWriterData *zw = asZipWriter(instance);
+    if (!zw->isOpen || zw->failed)
+    {
+        vm->pushBool(false);
+        return 1;
+    }
+
+    const unsigned char *data;
+    size_t size;
+    if (args[1].isBuffer())
+    {
+        BufferInstance *buf = args[1].asBuffer();
+        data = buf->data;
+        size = zipBufferBytes(buf);
+    }
+    else
+    {
+        data = (const unsigned char *)args[1].asStringChars();
+        size = args[1].asString()->length();
+    }
+
+    std::unique_ptr<ZipWriteJob> job(new ZipWriteJob());
+    job->archiveName = zipNormalizeEntryName(args[0].asStringChars());
+    job->level = (argCount >= 3 && args[2].isInt()) ? zipClampLevel(args[2].asInt()) : zw->level;
+    job->hasTime = true;
+    job->mtime = time(NULL);
+    if (job->archiveName.empty())
+    {
+        vm->pushBool(false);
+        return 1;
+    }
+    // Always copied: the VM value may change or be collected before a worker runs
+    job->input.assign(data, data + size);
+    zipWriterSubmit(zw, std::move(job));
+
+    vm->pushBool(!zw->failed);
+    return 1;
+}
+
+static int zip_writer_set_level(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    if (argCount < 1 || !args[0].isInt())
+    {
+        vm->runtimeError("ZipWriter.setLevel expects (level)");
+        return 0;
+    }
+    asZipWriter(instance)->level = zipClampLevel(args[0].asInt());
+    return 0;
+}
+
+static int zip_writer_set_threads(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    if (argCount < 1 || !args[0].isInt())
+    {
+        vm->runtimeError("ZipWriter.setThreads expects (count)");
+        return 0;
+    }
+    ZipWriterData *zw = asZipWriter(instance);
+    zipWriterDrain(zw, true);
+    zipWriterStopWorkers(zw);
+    if (zw->isOpen && args[0].asInt() > 0)
+    {
+        zipWriterStartWorkers(zw, args[0].asInt());
+    }
+    return 0;
+}
+
+static int zip_writer_flush(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    (void)argCount;
+    (void)args;
+    ZipWriterData *zw = asZipWriter(instance);
+    zipWriterDrain(zw, true);
+    vm->pushBool(!zw->failed);
+    return 1;
+}
+
+static int zip_writer_finalize(Interpreter *vm, void *instance, int argCount, Value *args)
+{
+    (void)argCount;
+    (void)args;
+    vm->pushBool(zipWriterFinish(asZipWriter(instance)));
+    return 1;
+}
+
+static Value zip_writer_get_path(Interpreter *vm, void *instance)
+{
+    const std::string &path = asZipWriter(instance)->path;
+    return vm->makeString(vm->createString(path.c_str(), (uint32)path.size()));
+}
+
+static Value zip_writer_get_error(Interpreter *vm, void *instance)
+{
+    const std::string &error = asZipWriter(instance)->error;
+    if (error.empty())
+    {
+        return vm->makeNil();
+    }
+    return vm->makeString(vm->createString(error.c_str(), (uint32)error.size()));
+}
+
+static Value zip_writer_get_count(Interpreter *vm, void *instance)
+{
+    return vm->makeInt(asZipWriter(instance)->entries);
+}
+
+static Value zip_writer_get_level(Interpreter *vm, void *instance)
+{
+    return vm->makeInt(asZipWriter(instance)->level);
+}
+
+static Value zip_writer_get_threads(Interpreter *vm, void *instance)
+{
+    return vm->makeInt((int)asZipWriter(instance)->workers.size());
+}
+
+static void registerZipWriterClass(Interpreter &vm)
+{
+    NativeClassDef *klass = vm.registerNativeClass("ZipWriter", zip_writer_ctor, zip_writer_dtor, -1, false);
+
+    vm.addNativeMethod(klass, "addFile", zip_writer_add_file);
+    vm.addNativeMethod(klass, "addBuffer", zip_writer_add_buffer);
+    vm.addNativeMethod(klass, "setLevel", zip_writer_set_level);
+    vm.addNativeMethod(klass, "setThreads", zip_writer_set_threads);
+    vm.addNativeMethod(klass, "flush", zip_writer_flush);
+    vm.addNativeMethod(klass, "finalize", zip_writer_finalize);
+
+    vm.addNativeProperty(klass, "path", zip_writer_get_path, nullptr);
+    vm.addNativeProperty(klass, "error", zip_writer_get_error, nullptr);
+    vm.addNativeProperty(klass, "count", zip_writer_get_count, nullptr);
+    vm.addNativeProperty(klass, "level", zip_writer_get_level, nullptr);
+    vm.addNativeProperty(klass, "threads", zip_writer_get_threads, nullptr);
+}
+
 void Interpreter::registerZip()
 {
     addModule("zip")
@@ -473,6 +1563,9 @@ void Interpreter::registerZip()
         .addFunction("read_buffer", native_zip_read_buffer, 2)
         .addFunction("extract", native_zip_extract, 2)
         .addFunction("create", native_zip_create, -1);
+
+    registerZipArchiveClass(*this);
+    registerZipWriterClass(*this);
 }
 
 #endif
@@ -233,6 +233,146 @@ void Compiler::predeclareGlobals()
   }
 }
 
+void Compiler::scanAppendTargets()
+{
+  // Pre-scan: nomes que crescem com `s = s + x` / `s += x` e que recebem uma
+  // string literal algures. E so um filtro barato: cada local com um destes
+  // nomes confirma no seu proprio alcance (appendTargetInScope) se e ela que
+  // cresce. Um falso positivo so custa a verificacao extra nas leituras.
+  std::set<std::string> appended;
+  std::set<std::string> stringy;
+
+  for (size_t i = 0; i + 2 < tokens.size(); i++)
+  {
+    if (tokens[i].type != TOKEN_IDENTIFIER)
+      continue;
+
+    const std::string &name = tokens[i].lexeme;
+    const Token &op = tokens[i + 1];
+    const Token &next = tokens[i + 2];
+    const bool literal = (next.type == TOKEN_STRING || next.type == TOKEN_FSTRING);
+
+    if (op.type == TOKEN_PLUS_EQUAL)
+    {
+      appended.insert(name);
+      if (literal)
+        stringy.insert(name);
+    }
+    else if (op.type == TOKEN_EQUAL)
+    {
+      if (literal)
+        stringy.insert(name);
+      else if (next.type == TOKEN_IDENTIFIER && next.lexeme == name &&
+               i + 3 < tokens.size() && tokens[i + 3].type == TOKEN_PLUS)
+      {
+        appended.insert(name);
+        if (i + 4 < tokens.size() &&
+            (tokens[i + 4].type == TOKEN_STRING || tokens[i + 4].type == TOKEN_FSTRING))
+          stringy.insert(name);
+      }
+    }
+  }
+
+  for (const std::string &name : appended)
+  {
+    if (stringy.count(name))
+      appendTargets_.insert(name);
+  }
+}
+
+// Chamado por addLocal com `current` logo a seguir ao nome da local. Percorre
+// os tokens ate ao fim do bloco onde a local vive a procura de `name += x` /
+// `name = name + x` e de uma string literal atribuida. Ignora corpos de
+// def/process/class (la dentro o nome e um upvalue ou outra variavel) e o
+// resto de um bloco onde outro `var name` esconde a local.
+bool Compiler::appendTargetInScope(const std::string &name)
+{
+  auto at = [this](size_t i) -> const Token &
+  {
+    static const Token eof(TOKEN_EOF, "", 0, 0);
+    if (i == 0)
+      return current;
+    size_t index = (size_t)cursor + i - 1;
+    return index < tokens.size() ? tokens[index] : eof;
+  };
+  auto literal = [](const Token &t)
+  {
+    return t.type == TOKEN_STRING || t.type == TOKEN_FSTRING;
+  };
+
+  bool appended = false;
+  bool stringy = at(0).type == TOKEN_EQUAL && literal(at(1)); // var s = "..."
+  int depth = 0;
+  int skipDepth = -1;   // corpo de uma funcao/classe aninhada
+  int shadowDepth = -1; // bloco onde `var name` esconde a local
+  bool bodyNext = false;
+
+  for (size_t i = 0;; i++)
+  {
+    const Token &t = at(i);
+    if (t.type == TOKEN_EOF)
+      break;
+
+    if (t.type == TOKEN_LBRACE)
+    {
+      depth++;
+      if (bodyNext && skipDepth < 0)
+        skipDepth = depth;
+      bodyNext = false;
+      continue;
+    }
+    if (t.type == TOKEN_RBRACE)
+    {
+      if (depth == skipDepth)
+        skipDepth = -1;
+      if (depth == shadowDepth)
+        shadowDepth = -1;
+      if (--depth < 0)
+        break;
+      continue;
+    }
+    if (skipDepth >= 0 || shadowDepth >= 0)
+      continue;
+
+    if (t.type == TOKEN_DEF || t.type == TOKEN_PROCESS || t.type == TOKEN_CLASS || t.type == TOKEN_STRUCT)
+    {
+      bodyNext = true;
+      continue;
+    }
+    if (t.type == TOKEN_VAR && at(i + 1).type == TOKEN_IDENTIFIER && at(i + 1).lexeme == name)
+    {
+      if (depth == 0)
+        break;
+      shadowDepth = depth;
+      continue;
+    }
+    if (t.type != TOKEN_IDENTIFIER || t.lexeme != name)
+      continue;
+
+    const Token &op = at(i + 1);
+    const Token &next = at(i + 2);
+    if (op.type == TOKEN_PLUS_EQUAL)
+    {
+      appended = true;
+      stringy = stringy || literal(next);
+    }
+    else if (op.type == TOKEN_EQUAL)
+    {
+      if (literal(next))
+        stringy = true;
+      else if (next.type == TOKEN_IDENTIFIER && next.lexeme == name && at(i + 3).type == TOKEN_PLUS)
+      {
+        appended = true;
+        stringy = stringy || literal(at(i + 4));
+      }
+    }
+
+    if (appended && stringy)
+      return true;
+  }
+  return false;
+}
+
 bool Compiler::enterSwitchContext()
 {
   if (switchDepth_ >= MAX_SWITCH_DEPTH)
@@ -289,7 +429,9 @@ ProcessDef *Compiler::compile(const std::string &source)
   stats.totalErrors = 0;
   stats.totalWarnings = 0;
   enclosingStack_.clear();
+  captures_.clear();
   declaredGlobals_.clear();
+  appendTargets_.clear();
   upvalueCount_ = 0;
   isProcess_ = true; // Top-level code IS a process
   switchDepth_ = 0;
@@ -345,6 +487,7 @@ ProcessDef *Compiler::compile(const std::string &source)
   }
 
   predeclareGlobals();
+  scanAppendTargets();
 
   function = vm_->addFunction("__main__", 0);
   if (!function)
@@ -413,14 +556,15 @@ ProcessDef *Compiler::compile(const std::string &source)
 void Compiler::injectStdlib()
 {
     Lexer *oldLexer            = this->lexer;
-    std::vector<Token> oldToks = this->tokens;
-    Token oldCurrent           = this->current;
-    Token oldPrevious          = this->previous;
+    std::vector<Token> oldToks = std::move(this->tokens);
+    Token oldCurrent           = std::move(this->current);
+    Token oldPrevious          = std::move(this->previous);
     int   oldCursor            = this->cursor;
 
     this->lexer  = new Lexer(STDLIB_SOURCE, STDLIB_SOURCE_LEN);
     this->tokens = lexer->scanAll();
     predeclareGlobals();
+    scanAppendTargets();
     this->cursor = 0;
     advance();
 
@@ -431,9 +575,9 @@ void Compiler::injectStdlib()
 
     delete this->lexer;
     this->lexer    = oldLexer;
-    this->tokens   = oldToks;
-    this->current  = oldCurrent;
-    this->previous = oldPrevious;
+    this->tokens   = std::move(oldToks);
+    this->current  = std::move(oldCurrent);
+    this->previous = std::move(oldPrevious);
     this->cursor   = oldCursor;
 }
 
@@ -459,7 +603,9 @@ ProcessDef *Compiler::compileExpression(const std::string &source)
   currentFunctionType = FunctionType::TYPE_SCRIPT;
   currentClass = nullptr;
   enclosingStack_.clear();
+  captures_.clear();
   declaredGlobals_.clear();
+  appendTargets_.clear();
   globalIndices_.clear();
   globalIndexToName_.clear();
 
@@ -579,47 +725,100 @@ int Compiler::resolveUpvalue(Token &name)
   if (enclosingStack_.empty())
     return -1;
 
-  // Procura em TODOS os níveis (de baixo para cima)
-  for (int level = enclosingStack_.size() - 1; level >= 0; level--)
+  return resolveUpvalueAt((int)enclosingStack_.size(), name.lexeme, identHash(name.lexeme));
+}
+
+// Função na profundidade `depth` (enclosingStack_.size() = a que está a
+// compilar; enclosingStack_[depth - 1] guarda os locals do pai dela).
+// Local do pai: isLocal=true. Mais acima: o pai captura-a primeiro e esta
+// função usa o upvalue dele (isLocal=false), como no clox.
+int Compiler::resolveUpvalueAt(int depth, const std::string &name, uint32 hash)
+{
+  if (depth == 0)
+    return -1;
+
+  std::vector<Local> &parent = enclosingStack_[depth - 1].locals;
+  for (int i = (int)parent.size() - 1; i >= 0; i--)
   {
-    // Procura nos locals desse nível
-    for (int i = enclosingStack_[level].locals.size() - 1; i >= 0; i--)
-    {
-      if (enclosingStack_[level].locals[i].name == name.lexeme)
-      {
-        // Marca como capturado
-        enclosingStack_[level].locals[i].isCaptured = true;
+    Local &local = parent[i];
+    if (!local.matches(name, hash))
+      continue;
 
-        // Se é do pai imediato: isLocal=true
-        // Se é de mais acima: isLocal=false
-        bool isLocal = (level == (int)enclosingStack_.size() - 1);
-        return addUpvalue(i, isLocal);
-      }
+    // Marca como capturado
+    local.isCaptured = true;
+    if (local.capture < 0)
+    {
+      local.capture = (int)captures_.size();
+      captures_.push_back(CaptureInfo{local.assigned, {}});
     }
+    return addUpvalue(depth, (uint8)i, true, local.capture);
   }
 
-  return -1;
+  int upvalue = resolveUpvalueAt(depth - 1, name, hash);
+  if (upvalue == -1)
+    return -1;
+
+  int capture = enclosingStack_[depth - 1].upvalues[upvalue].capture;
+  return addUpvalue(depth, (uint8)upvalue, false, capture);
 }
 
-int Compiler::addUpvalue(uint8 index, bool isLocal)
+int Compiler::addUpvalue(int depth, uint8 index, bool isLocal, int capture)
 {
-  for (int i = 0; i < upvalueCount_; i++)
+  bool current = depth == (int)enclosingStack_.size();
+  const UpvalueInfo *list = current ? upvalues_ : enclosingStack_[depth].upvalues.data();
+  int count = current ? upvalueCount_ : (int)enclosingStack_[depth].upvalues.size();
+
+  for (int i = 0; i < count; i++)
   {
-    if (upvalues_[i].index == index && upvalues_[i].isLocal == isLocal)
+    if (list[i].index == index && list[i].isLocal == isLocal)
     {
       return i;
     }
   }
-  if (upvalueCount_ >= MAX_LOCALS)
+  if (count >= MAX_LOCALS)
   {
     error("Too many closure variables in function");
     return 0;
   }
 
-  upvalues_[upvalueCount_].isLocal = isLocal;
-  upvalues_[upvalueCount_].index = index;
+  UpvalueInfo info;
+  info.index = index;
+  info.isLocal = isLocal;
+  info.capture = capture;
+  if (current)
+    upvalues_[upvalueCount_++] = info;
+  else
+    enclosingStack_[depth].upvalues.push_back(info);
 
-  return upvalueCount_++;
+  return count;
+}
+
+// OP_SET_LOCAL / OP_SET_UPVALUE: a variável deixa de poder ser copiada
+void Compiler::noteAssignment(uint8 setOp, int arg)
+{
+  if (setOp == OP_SET_LOCAL)
+  {
+    locals_[arg].assigned = true;
+    boxCapture(locals_[arg].capture);
+  }
+  else if (setOp == OP_SET_UPVALUE)
+  {
+    boxCapture(upvalues_[arg].capture);
+  }
+}
+
+void Compiler::boxCapture(int capture)
+{
+  if (capture < 0 || captures_[capture].boxed)
+    return;
+
+  CaptureInfo &info = captures_[capture];
+  info.boxed = true;
+  for (const std::pair<Code *, int> &site : info.sites)
+  {
+    site.first->code[site.second] &= (uint8)~UPVALUE_BY_VALUE;
+  }
+  info.sites.clear();
 }
 
 // ============================================
@@ -628,25 +827,22 @@ int Compiler::addUpvalue(uint8 index, bool isLocal)
 
 void Compiler::advance()
 {
-
-  previous = current;
+  // Nunca se volta atrás no vetor: os tokens são movidos, não copiados
+  previous = std::move(current);
   if (cursor >= (int)tokens.size())
   {
     current.type = TOKEN_EOF;
     return;
   }
 
-  current = tokens[cursor++];
+  current = std::move(tokens[cursor++]);
 }
 
-Token Compiler::peek(int offset)
+const Token &Compiler::peek(int offset)
 {
+  static const Token eof(TOKEN_EOF, "", 1, 0);
   if (tokens.empty())
   {
-    Token eof;
-    eof.type = TOKEN_EOF;
-    eof.lexeme = "";
-    eof.line = 1;
     return eof;
   }
 
@@ -1034,6 +1230,7 @@ void Compiler::parsePrecedence(Precedence precedence)
   }
 
   bool canAssign = (precedence <= PREC_ASSIGNMENT);
+  const int leftStart = currentChunk->count;
   (this->*prefixRule)(canAssign);
 
   // Verifica se houve erro
@@ -1053,6 +1250,8 @@ void Compiler::parsePrecedence(Precedence precedence)
       break;
     }
 
+    // O operando esquerdo de qualquer infix comeca onde o prefixo comecou
+    infixLeftStart_ = leftStart;
     (this->*infixRule)(canAssign);
 
     // Verifica se houve erro
@@ -377,10 +377,10 @@ void Compiler::fstringExpression(bool canAssign)
         // Compile the expression using a sub-lexer
         // Save current lexer/parser state
         Lexer *savedLexer = lexer;
-        std::vector<Token> savedTokens = tokens;
+        std::vector<Token> savedTokens = std::move(tokens);
         int savedCursor = cursor;
-        Token savedCurrent = current;
-        Token savedPrevious = previous;
+        Token savedCurrent = std::move(current);
+        Token savedPrevious = std::move(previous);
         int fstringLine = savedPrevious.line;
 
         // Create a sub-lexer for the expression
@@ -398,7 +398,7 @@ void Compiler::fstringExpression(bool canAssign)
         // Prime the parser with first token
         if (!tokens.empty())
         {
-            current = tokens[0];
+            current = std::move(tokens[0]);
             cursor = 1;
         }
 
@@ -411,10 +411,10 @@ void Compiler::fstringExpression(bool canAssign)
 
         // Restore lexer/parser state
         lexer = savedLexer;
-        tokens = savedTokens;
+        tokens = std::move(savedTokens);
         cursor = savedCursor;
-        current = savedCurrent;
-        previous = savedPrevious;
+        current = std::move(savedCurrent);
+        previous = std::move(savedPrevious);
 
         if (segmentCount > 0) emitByte(OP_ADD);
         segmentCount++;
@@ -531,6 +531,8 @@ void Compiler::binary(bool canAssign)
     }
 
     ParseRule *rule = getRule(operatorType);
+    const int leftStart = infixLeftStart_;
+    const int leftEnd = currentChunk->count;
 
     parsePrecedence((Precedence)(rule->prec + 1));
 
@@ -538,6 +540,9 @@ void Compiler::binary(bool canAssign)
     {
     case TOKEN_PLUS:
         emitByte(OP_ADD);
+        lastAddLeftStart_ = leftStart;
+        lastAddLeftEnd_ = leftEnd;
+        lastAddAt_ = currentChunk->count - 1;
         break;
     case TOKEN_MINUS:
         emitByte(OP_SUBTRACT);
@@ -568,6 +568,7 @@ uint16 Compiler::identifierConstant(Token &name)
 void Compiler::emitVarOp(uint8 op, int arg)
 {
     bool isGlobal = (op == OP_GET_GLOBAL || op == OP_SET_GLOBAL);
+    noteAssignment(op, arg);
     emitByte(op);
     if (isGlobal)
         emitShort((uint16)arg);
@@ -577,6 +578,12 @@ void Compiler::emitVarOp(uint8 op, int arg)
 
 void Compiler::handle_assignment(uint8 getOp, uint8 setOp, int arg, bool canAssign)
 {
+    // Locais que crescem com `s = s + x` (ver appendTargetInScope): o append
+    // le a local sem lhe tirar a posse, qualquer outra leitura tira
+    const bool appendTarget = (getOp == OP_GET_LOCAL && locals_[arg].appendTarget);
+    const uint8 appendGetOp = getOp;
+    if (appendTarget)
+        getOp = OP_GET_LOCAL_SHARED;
 
     if (match(TOKEN_PLUS_PLUS))
     {
@@ -600,14 +607,30 @@ void Compiler::handle_assignment(uint8 getOp, uint8 setOp, int arg, bool canAssi
     }
     else if (canAssign && match(TOKEN_EQUAL))
     {
+        const int rhsStart = currentChunk->count;
+        lastAddAt_ = -1;
         expression();
+        if (hadError)
+            return;
+
+        // s = s + x: a expressao inteira e um OP_ADD cujo operando esquerdo
+        // e so a leitura desta slot. Passa a OP_APPEND_LOCAL e a leitura deixa
+        // de partilhar a string (s + x + y, s * 2 + x, ... ficam como estao)
+        if (appendTarget && lastAddAt_ == currentChunk->count - 1 &&
+            lastAddLeftStart_ == rhsStart && lastAddLeftEnd_ == rhsStart + 2 &&
+            currentChunk->code[rhsStart] == OP_GET_LOCAL_SHARED &&
+            currentChunk->code[rhsStart + 1] == (uint8)arg)
+        {
+            currentChunk->code[rhsStart] = appendGetOp;
+            currentChunk->code[lastAddAt_] = OP_APPEND_LOCAL;
+        }
         emitVarOp(setOp, arg);
     }
     else if (canAssign && match(TOKEN_PLUS_EQUAL))
     {
-        emitVarOp(getOp, arg);
+        emitVarOp(appendGetOp, arg);
         expression();
-        emitByte(OP_ADD);
+        emitByte(appendTarget ? OP_APPEND_LOCAL : OP_ADD);
         emitVarOp(setOp, arg);
     }
     else if (canAssign && match(TOKEN_MINUS_EQUAL))
@@ -740,6 +763,7 @@ void Compiler::declareVariable()
     // Permite re-declarar a variável de descarte '_' múltiplas vezes no mesmo scope
     if (name.lexeme != "_")
     {
+        uint32 nameHash = identHash(name.lexeme);
         for (int i = localCount_ - 1; i >= 0; i--)
         {
             Local &local = locals_[i];
@@ -749,7 +773,7 @@ void Compiler::declareVariable()
                 break;
             }
 
-            if (local.name == name.lexeme)
+            if (local.matches(name.lexeme, nameHash))
             {
                 fail("Variable '%s' already declared in this scope", name.lexeme.c_str());
                 return;
@@ -775,10 +799,14 @@ void Compiler::addLocal(Token &name)
         return;
     }
 
-    locals_[localCount_].name = name.lexeme;
+    locals_[localCount_].setName(name.lexeme);
     locals_[localCount_].depth = -1;
     locals_[localCount_].usedInitLocal = false;
     locals_[localCount_].isCaptured = false;
+    locals_[localCount_].appendTarget =
+        appendTargets_.count(name.lexeme) > 0 && appendTargetInScope(name.lexeme);
+    locals_[localCount_].assigned = false;
+    locals_[localCount_].capture = -1;
 
     localCount_++;
 }
@@ -820,9 +848,10 @@ void Compiler::endScope()
 
 int Compiler::resolveLocal(Token &name)
 {
+    uint32 nameHash = identHash(name.lexeme);
     for (int i = localCount_ - 1; i >= 0; i--)
     {
-        if (locals_[i].name == name.lexeme)
+        if (locals_[i].matches(name.lexeme, nameHash))
         {
             if (locals_[i].depth == -1)
             {
@@ -1623,21 +1652,14 @@ void Compiler::funDeclaration()
     }
 
     // Compila função
-    compileFunction(func, false); // false = não é process
+    std::vector<UpvalueInfo> upvalues;
+    compileFunction(func, false, &upvalues); // false = não é process
 
     // Verifica se tem upvalues
     if (func->upvalueCount > 0)
     {
         // É uma CLOSURE (captura variáveis)
-        uint16 constant = makeConstant(vm_->makeFunction(func->index));
-        emitByte(OP_CLOSURE);
-        emitShort(constant);
-        // Emite info de cada upvalue (isLocal, index)
-        for (int i = 0; i < func->upvalueCount; i++)
-        {
-            emitByte(upvalues_[i].isLocal ? 1 : 0);
-            emitByte(upvalues_[i].index);
-        }
+        emitClosure(func, upvalues);
     }
     else
     {
@@ -1727,7 +1749,28 @@ void Compiler::processDeclaration()
     isProcess_ = savedIsProcess;
 }
 
-void Compiler::compileFunction(Function *func, bool isProcess)
+// OP_CLOSURE + [flags][index] por upvalue. Variaveis ainda sem atribuicoes
+// vao por valor; o sitio fica em captures_ para boxCapture() o desfazer.
+void Compiler::emitClosure(Function *func, const std::vector<UpvalueInfo> &upvalues)
+{
+    uint16 constant = makeConstant(vm_->makeFunction(func->index));
+    emitByte(OP_CLOSURE);
+    emitShort(constant);
+    for (const UpvalueInfo &upvalue : upvalues)
+    {
+        uint8 flags = upvalue.isLocal ? UPVALUE_LOCAL : 0;
+        CaptureInfo &capture = captures_[upvalue.capture];
+        if (!capture.boxed)
+        {
+            flags |= UPVALUE_BY_VALUE;
+            capture.sites.push_back(std::make_pair(currentChunk, currentChunk->count));
+        }
+        emitByte(flags);
+        emitByte(upvalue.index);
+    }
+}
+
+void Compiler::compileFunction(Function *func, bool isProcess, std::vector<UpvalueInfo> *upvalues)
 {
     // ========================================
     // GUARDA ESTADO
@@ -1743,21 +1786,22 @@ void Compiler::compileFunction(Function *func, bool isProcess)
     size_t savedStackSize = enclosingStack_.size();
 
     // ========================================
-    // PUSH na stack de enclosing (se há pai)
+    // PUSH na stack de enclosing (um nível por função, mesmo sem locals,
+    // para resolveUpvalueAt() subir a cadeia nível a nível)
     // ========================================
-    if (enclosingLocalCount > 0)
     {
         EnclosingContext ctx;
         ctx.function = enclosing;
 
-        // Copia locals atuais para o context
+        // Copia locals e upvalues atuais para o context
         ctx.locals.reserve(enclosingLocalCount);
         for (int i = 0; i < enclosingLocalCount; i++)
         {
             ctx.locals.push_back(this->locals_[i]);
         }
+        ctx.upvalues.assign(this->upvalues_, this->upvalues_ + savedUpvalueCount);
 
-        enclosingStack_.push_back(ctx);  
+        enclosingStack_.push_back(std::move(ctx));
     }
 
     // ========================================
@@ -1858,6 +1902,10 @@ void Compiler::compileFunction(Function *func, bool isProcess)
     // GUARDA UPVALUE COUNT
     // ========================================
     func->upvalueCount = this->upvalueCount_;
+    if (upvalues)
+    {
+        upvalues->assign(this->upvalues_, this->upvalues_ + this->upvalueCount_);
+    }
 
     // ========================================
     // RESTAURA ESTADO (POP da stack)
@@ -1869,7 +1917,8 @@ void Compiler::compileFunction(Function *func, bool isProcess)
     this->isProcess_ = wasInProcess;
     this->upvalueCount_ = savedUpvalueCount;
 
-    // Restore locals_ array from enclosingStack_ before popping
+    // Restore locals_ / upvalues_ from enclosingStack_ before popping
+    // (capturas da cadeia podem ter-lhes acrescentado isCaptured / upvalues)
     while (enclosingStack_.size() > savedStackSize)
     {
         EnclosingContext &ctx = enclosingStack_.back();
@@ -1878,6 +1927,11 @@ void Compiler::compileFunction(Function *func, bool isProcess)
         {
             this->locals_[i] = ctx.locals[i];
         }
+        for (size_t i = 0; i < ctx.upvalues.size(); i++)
+        {
+            this->upvalues_[i] = ctx.upvalues[i];
+        }
+        this->upvalueCount_ = (int)ctx.upvalues.size();
         enclosingStack_.pop_back();
     }
 }
@@ -2191,15 +2245,16 @@ void Compiler::includeStatement()
 
     // GUARDA estado
     Lexer *oldLexer = this->lexer;
-    std::vector<Token> oldTokens = this->tokens;
-    Token oldCurrent = this->current;
-    Token oldPrevious = this->previous;
+    std::vector<Token> oldTokens = std::move(this->tokens);
+    Token oldCurrent = std::move(this->current);
+    Token oldPrevious = std::move(this->previous);
     int oldCursor = this->cursor;
 
     // COMPILA inline
     this->lexer = new Lexer(source, sourceSize);
     this->tokens = lexer->scanAll();
     predeclareGlobals();
+    scanAppendTargets();
     this->cursor = 0;
     advance();
 
@@ -2211,9 +2266,9 @@ void Compiler::includeStatement()
     // RESTAURA
     delete this->lexer;
     this->lexer = oldLexer;
-    this->tokens = oldTokens;
-    this->current = oldCurrent;
-    this->previous = oldPrevious;
+    this->tokens = std::move(oldTokens);
+    this->current = std::move(oldCurrent);
+    this->previous = std::move(oldPrevious);
     this->cursor = oldCursor;
 
     // Remove do set
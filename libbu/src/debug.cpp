@@ -397,6 +397,28 @@ size_t Debug::disassembleInstruction(const Code &chunk, size_t offset)
   case OP_BREAKPOINT:
     return simpleInstruction("OP_BREAKPOINT", offset);
 
+    // ========== QUICKENED (95-101) ==========
+  case OP_ADD_INT:
+    return simpleInstruction("OP_ADD_INT", offset);
+  case OP_ADD_DOUBLE:
+    return simpleInstruction("OP_ADD_DOUBLE", offset);
+  case OP_SUBTRACT_INT:
+    return simpleInstruction("OP_SUBTRACT_INT", offset);
+  case OP_SUBTRACT_DOUBLE:
+    return simpleInstruction("OP_SUBTRACT_DOUBLE", offset);
+  case OP_LESS_INT:
+    return simpleInstruction("OP_LESS_INT", offset);
+  case OP_LESS_DOUBLE:
+    return simpleInstruction("OP_LESS_DOUBLE", offset);
+  case OP_GET_INDEX_ARRAY:
+    return simpleInstruction("OP_GET_INDEX_ARRAY", offset);
+
+    // ========== STRING APPEND (102-103) ==========
+  case OP_APPEND_LOCAL:
+    return simpleInstruction("OP_APPEND_LOCAL", offset);
+  case OP_GET_LOCAL_SHARED:
+    return byteInstruction("OP_GET_LOCAL_SHARED", chunk, offset);
+
   default:
     printf("Unknown opcode %u\n", (unsigned)instruction);
     return offset + 1;
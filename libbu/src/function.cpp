@@ -1,10 +1,13 @@
 #include "config.hpp"
 #include "interpreter.hpp"
 #include "pool.hpp"
+#include "jit.hpp"
 
 Function::~Function()
 {
-   
+    jitFreeCode(jit);
+    jit = nullptr;
+
     if (chunk)
     {
         chunk->clear();
@@ -23,6 +23,9 @@
  * - sweep(): Reclaims unmarked objects and resets marks for next cycle
  * - runGC(): Orchestrates the complete GC cycle with threshold management
  * - checkGC(): Triggers collection when allocation exceeds threshold
+ *
+ * Pacing counts object headers (totalAllocated), container payload allocated
+ * through GCPayloadAlloc since the last cycle, and StringPool growth.
  */
 #include "interpreter.hpp"
 
@@ -51,9 +54,10 @@ void Interpreter::markRoots()
         // Marca privates
         for (int j = 0; j < MAX_PRIVATES; j++)
         {
-            if (!proc->privates[j].isObject())
+            Value &v = proc->priv(j);
+            if (!v.isObject())
                 continue;
-            markValue(proc->privates[j]);
+            markValue(v);
         }
 
         ProcessExec *fiber = proc;
@@ -139,6 +143,8 @@ void Interpreter::sweep()
 
     GCObject **obj = &gcObjects;
     size_t freed = 0;
+    size_t live = 0;
+    size_t freedPayload = 0;
 
     while (*obj)
     {
@@ -147,6 +153,7 @@ void Interpreter::sweep()
         {
             // Unreachable — full free
             *obj = current->next;
+            freedPayload += payloadBytes(current);
             freeObject(current);
             freed++;
         }
@@ -154,10 +161,14 @@ void Interpreter::sweep()
         {
             // marked == 1: alive — reset for next cycle
             current->marked = 0;
+            live += payloadBytes(current);
             obj = &current->next;
         }
     }
 
+    livePayload = live;
+    gcLastFreed = freedPayload;
+
     //   Info("GC Sweep freed %zu objects", freed);
 }
 
@@ -263,6 +274,62 @@ void Interpreter::freeObject(GCObject *obj)
     }
 }
 
+// Bytes de elementos reservados por um objeto (fora do cabecalho)
+size_t Interpreter::payloadBytes(GCObject *obj) const
+{
+    switch (obj->type)
+    {
+    case GCObjectType::ARRAY:
+        return static_cast<ArrayInstance *>(obj)->values.capacity() * sizeof(Value);
+    case GCObjectType::MAP:
+    {
+        MapInstance *m = static_cast<MapInstance *>(obj);
+        return m->table.capacity * sizeof(*m->table.entries);
+    }
+    case GCObjectType::SET:
+    {
+        SetInstance *set = static_cast<SetInstance *>(obj);
+        return set->table.capacity * sizeof(*set->table.entries);
+    }
+    default:
+        // Structs/classes/closures guardam os elementos inline e os buffers
+        // ja contam os dados em totalAllocated
+        return 0;
+    }
+}
+
+// Bytes contados em totalAllocated para o objeto (cabecalho + inline)
+static size_t objectBytes(GCObject *obj)
+{
+    switch (obj->type)
+    {
+    case GCObjectType::STRUCT:
+        return sizeof(StructInstance) + static_cast<StructInstance *>(obj)->values.size() * sizeof(Value);
+    case GCObjectType::CLASS:
+        return sizeof(ClassInstance) + static_cast<ClassInstance *>(obj)->fields.size() * sizeof(Value);
+    case GCObjectType::ARRAY:
+        return sizeof(ArrayInstance);
+    case GCObjectType::MAP:
+        return sizeof(MapInstance);
+    case GCObjectType::SET:
+        return sizeof(SetInstance);
+    case GCObjectType::BUFFER:
+    {
+        BufferInstance *b = static_cast<BufferInstance *>(obj);
+        return sizeof(BufferInstance) + (size_t)b->count * b->elementSize;
+    }
+    case GCObjectType::NATIVE_CLASS:
+        return sizeof(NativeClassInstance);
+    case GCObjectType::NATIVE_STRUCT:
+        return sizeof(NativeStructInstance);
+    case GCObjectType::CLOSURE:
+        return sizeof(Closure) + static_cast<Closure *>(obj)->upvalues.size() * (sizeof(Value) + sizeof(Upvalue *));
+    case GCObjectType::UPVALUE:
+        return sizeof(Upvalue);
+    }
+    return 0;
+}
+
 void Interpreter::checkGC()
 {
     // OPTIMIZATION: Use likely/unlikely for better branch prediction
@@ -270,12 +337,50 @@ void Interpreter::checkGC()
     if (__builtin_expect(!enabledGC, 0))
         return;
 
-    if (__builtin_expect(totalAllocated > nextGC, 0))
+    // Payload alocado e strings criadas desde a ultima recolha
+    size_t pending = payloadAllocated - payloadMark;
+    size_t strings = stringPool.getBytesAllocated();
+    if (strings > stringMark)
+        pending += strings - stringMark;
+
+    if (__builtin_expect(totalAllocated + pending > nextGC, 0))
     {
         runGC();
     }
 }
 
+void Interpreter::getGCStats(GCStats &out)
+{
+    out = GCStats();
+
+    GCObject *lists[2] = {gcObjects, persistentObjects};
+    for (GCObject *list : lists)
+    {
+        for (GCObject *obj = list; obj; obj = obj->next)
+        {
+            GCKindStats &kind = out.kinds[(int)obj->type];
+            kind.count++;
+            kind.bytes += objectBytes(obj) + payloadBytes(obj);
+        }
+    }
+
+    out.stringBytes = stringPool.getBytesAllocated();
+    for (const GCKindStats &kind : out.kinds)
+        out.heapBytes += kind.bytes;
+    out.heapBytes += out.stringBytes;
+    out.nextGC = nextGC;
+    out.collections = gcCollections;
+    out.lastFreed = gcLastFreed;
+
+    PageAllocatorStats pages;
+    arena.GetStats(pages);
+    for (int i = 0; i <= (int)GCObjectType::UPVALUE; i++)
+        out.kinds[i].allocated = pages.kinds[i].allocations;
+    out.heapPages = pages.pages;
+    out.heapReserved = pages.reservedBytes;
+    out.heapReleased = pages.releasedBytes;
+}
+
 void Interpreter::blackenObject(GCObject *obj)
 {
     switch (obj->type)
@@ -355,7 +460,10 @@ void Interpreter::blackenObject(GCObject *obj)
         Closure *c = static_cast<Closure *>(obj);
         for (size_t i = 0; i < c->upvalues.size(); i++)
         {
-            markObject((GCObject *)c->upvalues[i]);
+            if (c->upvalues[i])
+                markObject((GCObject *)c->upvalues[i]);
+            else
+                markValue(c->captured()[i]);
         }
         break;
     }
@@ -408,21 +516,35 @@ void Interpreter::runGC()
         grayStack.reserve(256);
     }
 
+    size_t headersBefore = totalAllocated;
+
     markRoots();
 
     traceReferences();
 
     sweep();
 
-    nextGC = static_cast<size_t>(totalAllocated * GC_GROWTH_FACTOR);
-    if (nextGC < MIN_GC_THRESHOLD)
+    // Proxima recolha depois de o heap vivo (objetos + payload + strings)
+    // crescer GC_GROWTH_FACTOR vezes; a folga fica entre MIN e MAX
+    payloadMark = payloadAllocated;
+    stringMark = stringPool.getBytesAllocated();
+    size_t live = totalAllocated + livePayload + stringMark;
+    size_t headroom = static_cast<size_t>(live * (GC_GROWTH_FACTOR - 1.0));
+    if (headroom < MIN_GC_THRESHOLD)
     {
-        nextGC = MIN_GC_THRESHOLD;
+        headroom = MIN_GC_THRESHOLD;
     }
-    if (nextGC > MAX_GC_THRESHOLD)
+    if (headroom > MAX_GC_THRESHOLD)
     {
-        nextGC = MAX_GC_THRESHOLD;
+        headroom = MAX_GC_THRESHOLD;
     }
+    nextGC = totalAllocated + headroom;
+
+    // Paginas do arena sem objetos: as que cabem na folga ficam, o resto vai ao SO
+    arena.Sweep(headroom);
+
+    gcLastFreed += headersBefore - totalAllocated;
+    gcCollections++;
 
 #if defined(DEBUG_GC)
     size_t objectCount = totalArrays + totalClasses + totalStructs + totalMaps + totalSets + totalBuffers + totalNativeClasses + totalNativeStructs + totalClosures + totalUpvalues;
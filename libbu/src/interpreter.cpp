@@ -1,4 +1,5 @@
 #include "interpreter.hpp"
+#include "spatial_grid.hpp"
 #include "compiler.hpp"
 #include "debug.hpp"
 #include "platform.hpp"
@@ -21,6 +22,7 @@ Interpreter::Interpreter()
 
   setPrivateTable();
   staticNames.resize((int)StaticNames::TOTAL_COUNT);
+  payloadMark = payloadAllocated;
 
   // Common collection methods (Array, Map, Set)
   staticNames[(int)StaticNames::PUSH] = createString("push");
@@ -149,6 +151,10 @@ void Interpreter::freeFunctions()
 
 void Interpreter::freeRunningProcesses()
 {
+#ifdef BU_ENABLE_SPACE
+  if (spatialGrid_)
+    spatialGrid_->clear();
+#endif
   for (size_t j = 0; j < cleanProcesses.size(); j++)
   {
     if (hooks.onDestroy)
@@ -246,6 +252,13 @@ void Interpreter::reset()
 
   clearAllGCObjects();
 
+  // Nenhum global pode continuar a apontar para um objeto libertado
+  for (size_t i = 0; i < globalsArray.size(); i++)
+  {
+    if (globalsArray[i].isObject())
+      globalsArray[i] = makeNil();
+  }
+
   gcObjects = nullptr;
   persistentObjects = nullptr;
   totalAllocated = 0;
@@ -256,10 +269,16 @@ void Interpreter::reset()
   totalNativeClasses = 0;
   totalNativeStructs = 0;
   nextGC = 1024 * 4;
+  payloadMark = payloadAllocated;
+  stringMark = stringPool.getBytesAllocated();
+  livePayload = 0;
   gcInProgress = false;
 
   frameCount = 0;
 
+  if (hasScriptArgs_)
+    buildArgs();
+
   // 3. Limpa blueprints de processos (gerados pelo script anterior)
   // Nota: Mantivemos este loop aqui pois reset() pode não querer limpar
   // todas as Classes/Structs se forem partilhadas, mas os ProcessDefs do script sim.
@@ -286,6 +305,7 @@ void Interpreter::reset()
 
 Interpreter::~Interpreter()
 {
+  setProcessWorkers(0);
   //dumpToFile("main.dump");
   Info("VM shutdown");
   Info("Memory allocated : %s", formatBytes(totalAllocated));
@@ -302,6 +322,13 @@ Interpreter::~Interpreter()
 
   freeInstances();
   freeRunningProcesses();
+#ifdef BU_ENABLE_SPACE
+  delete spatialGrid_;
+  spatialGrid_ = nullptr;
+#endif
+#ifdef BU_ENABLE_SOCKETS
+  freeNetState();
+#endif
   freeFunctions();
   // globals.destroy();  // OPTIMIZATION: HashMap globals removed
   clearAllGCObjects();  // Must be called before freeBlueprints() so native destructors can access ClassDef/NativeClassDef
@@ -336,7 +363,7 @@ BufferInstance *Interpreter::createBuffer(int count, int typeRaw)
 {
   checkGC();
   size_t size = sizeof(BufferInstance);
-  void *mem = (BufferInstance *)arena.Allocate(size);
+  void *mem = (BufferInstance *)arena.Allocate(size, (uint8)GCObjectType::BUFFER);
 
   BufferInstance *instance = new (mem) BufferInstance(count, (BufferType)typeRaw);
   instance->marked = 0;
@@ -357,7 +384,7 @@ void Interpreter::freeBuffer(BufferInstance *b)
   size_t dataSize = b->count * b->elementSize;
 
   b->~BufferInstance();
-  arena.Free(b, size);
+  arena.Free(b, size, (uint8)GCObjectType::BUFFER);
 
   totalBuffers--;
 
@@ -430,7 +457,7 @@ void Interpreter::addNativeProperty(NativeClassDef *klass, const char *propName,
 Value Interpreter::createNativeStruct(int structId, int argc, Value *args)
 {
   NativeStructDef *def = nativeStructs[structId];
-  void *data = arena.Allocate(def->structSize);
+  void *data = arena.Allocate(def->structSize, (uint8)GCObjectType::NATIVE_STRUCT);
   std::memset(data, 0, def->structSize);
   if (def->constructor)
   {
@@ -639,13 +666,26 @@ int Interpreter::addGlobal(const char *name, Value value)
   return index;
 }
 
+// As strings ficam no pool (sobrevivem ao reset()); o array e um objeto do
+// GC, por isso reset() volta a cria-lo depois de clearAllGCObjects()
 void Interpreter::setArgs(int argc, char *argv[])
+{
+  scriptArgs_.clear();
+  for (int i = 0; i < argc; i++)
+  {
+    scriptArgs_.push(createString(argv[i]));
+  }
+  hasScriptArgs_ = true;
+  buildArgs();
+}
+
+void Interpreter::buildArgs()
 {
   Value arr = makeArray();
   ArrayInstance *a = arr.asArray();
-  for (int i = 0; i < argc; i++)
+  for (size_t i = 0; i < scriptArgs_.size(); i++)
   {
-    a->values.push(makeString(argv[i]));
+    a->values.push(makeString(scriptArgs_[i]));
   }
   addGlobal("ARGV", arr);
 }
@@ -1172,6 +1212,59 @@ String *Interpreter::createString(const char *str)
   return stringPool.create(str);
 }
 
+bool Interpreter::appendToLocal(Value *slot, Value &left, const Value &right, bool discarded)
+{
+  if (!left.isString())
+    return false;
+
+  String *piece;
+  if (right.isString())
+    piece = right.asString();
+  else if (right.isInt())
+    piece = stringPool.toString(right.asInt());
+  else if (right.isUInt())
+    piece = stringPool.toString(right.asUInt());
+  else if (right.isDouble())
+    piece = stringPool.toString(right.asDouble());
+  else if (right.isBool())
+    piece = stringPool.toString(right.asBool());
+  else if (right.isNil())
+    piece = createString("nil");
+  else if (right.isByte())
+    piece = stringPool.toString(right.asByte());
+  else
+    return false;
+
+  String *str = left.asString();
+
+  // So cresce no sitio se a local e a unica referencia: a string nasceu aqui,
+  // nao foi lida desde entao (OP_GET_LOCAL_SHARED), o resultado e descartado
+  // e nenhuma closure tem um upvalue aberto sobre esta slot.
+  if (discarded && str->isOwned() && slot->isString() && slot->asString() == str)
+  {
+    Upvalue *upvalue = openUpvalues;
+    while (upvalue != nullptr && upvalue->location > slot)
+      upvalue = upvalue->nextOpen;
+
+    if (upvalue == nullptr || upvalue->location != slot)
+    {
+      stringPool.append(str, piece);
+      return true;
+    }
+  }
+
+  // Copia: a string antiga pode ter sido lida (alias) e fica intacta
+  String *result = stringPool.concat(str, piece);
+  if (result->isTransient() && result != str && result != piece)
+  {
+    result->capacity_and_flag |= String::IS_HELD_FLAG;
+    if (discarded)
+      result->capacity_and_flag |= String::IS_OWNED_FLAG;
+  }
+  left = makeString(result);
+  return true;
+}
+
 bool Interpreter::containsClassDefenition(String *name)
 {
   return classesMap.exist(name);
@@ -1245,23 +1338,8 @@ Value Interpreter::createClassInstance(ClassDef *klass, int argCount, Value *arg
   }
 
   // Cria a instância
-  Value value = makeClassInstance();
+  Value value = makeClassInstance(klass);
   ClassInstance *instance = value.asClassInstance();
-  instance->klass = klass;
-  instance->fields.reserve(klass->fieldCount);
-
-  // Inicializa fields com valores default ou nil
-  for (int i = 0; i < klass->fieldCount; i++)
-  {
-    if (i < (int)klass->fieldDefaults.size() && !klass->fieldDefaults[i].isNil())
-    {
-      instance->fields.push(klass->fieldDefaults[i]);
-    }
-    else
-    {
-      instance->fields.push(makeNil());
-    }
-  }
 
   // Se herda de NativeClass, cria os dados nativos
   NativeClassDef *nativeDef = nullptr;
@@ -1284,7 +1362,7 @@ Value Interpreter::createClassInstance(ClassDef *klass, int argCount, Value *arg
     }
     else
     {
-      instance->nativeUserData = arena.Allocate(128);
+      instance->nativeUserData = arena.Allocate(128, (uint8)GCObjectType::CLASS);
       std::memset(instance->nativeUserData, 0, 128);
     }
   }
@@ -1360,22 +1438,8 @@ Value Interpreter::createClassInstanceRaw(ClassDef *klass)
     return makeNil();
   }
 
-  Value value = makeClassInstance();
+  Value value = makeClassInstance(klass);
   ClassInstance *instance = value.asClassInstance();
-  instance->klass = klass;
-  instance->fields.reserve(klass->fieldCount);
-
-  for (int i = 0; i < klass->fieldCount; i++)
-  {
-    if (i < (int)klass->fieldDefaults.size() && !klass->fieldDefaults[i].isNil())
-    {
-      instance->fields.push(klass->fieldDefaults[i]);
-    }
-    else
-    {
-      instance->fields.push(makeNil());
-    }
-  }
 
   // Se herda de NativeClass, cria os dados nativos
   NativeClassDef *nativeDef = nullptr;
@@ -1398,7 +1462,7 @@ Value Interpreter::createClassInstanceRaw(ClassDef *klass)
     }
     else
     {
-      instance->nativeUserData = arena.Allocate(128);
+      instance->nativeUserData = arena.Allocate(128, (uint8)GCObjectType::CLASS);
       std::memset(instance->nativeUserData, 0, 128);
     }
   }
@@ -1813,11 +1877,6 @@ Closure::Closure() : GCObject(GCObjectType::CLOSURE),
                      functionId(-1),
                      upvalueCount(0) {}
 
-Closure::~Closure()
-{
-
-  upvalues.destroy();
-}
 
 Upvalue::Upvalue(Value *loc) : GCObject(GCObjectType::UPVALUE)
 {
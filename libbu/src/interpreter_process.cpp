@@ -1,5 +1,9 @@
 #include "interpreter.hpp"
 #include "pool.hpp"
+#include "opcode.hpp"
+#include "code.hpp"
+#include "process_workers.hpp"
+#include "spatial_grid.hpp"
 
 #if defined(DEBUG_GC)
 #define GC_DEBUG_LOG(...) Info(__VA_ARGS__)
@@ -30,17 +34,35 @@ void ProcessDef::finalize()
     {
         fiber->ip = fiber->frames[0].func->chunk->code;
     }
+
+    // So a entry frame e nada na stack: spawnProcess nao precisa de clonar a fiber
+    freshStart = fiber->frameCount == 1 && fiber->stackTop == fiber->stack &&
+                 fiber->gosubTop == 0 && fiber->tryDepth == 0 &&
+                 fiber->state != ProcessState::DEAD;
 }
 void ProcessDef::release()
 {
 }
 
+#if BU_ENABLE_PRIVATE_COLUMNS
+Process::Process() : columns(PrivateColumns::instance().acquire())
+{
+}
+
+Process::~Process()
+{
+    PrivateColumns::instance().release(columns);
+}
+#endif
+
 void Process::reset()
 {
     this->id = 0;
     this->blueprint = -1;
     this->exitCode = 0;
     this->initialized = false;
+    this->parallelStep = false;
+    this->batchStepped = false;
     name = nullptr;
 
     state = ProcessState::DEAD; // Estado do PROCESSO (frame)
@@ -202,9 +224,18 @@ Process *Interpreter::spawnProcess(ProcessDef *blueprint)
     instance->resumeTime = 0;
     instance->initialized = false;
     instance->exitCode = 0;
-
+    instance->parallelStep = false;
+    instance->batchStepped = false;
+
+#if BU_ENABLE_PRIVATE_COLUMNS
+    for (int i = 0; i < PRIVATE_COLUMNS; i++)
+        instance->columns[i * PRIVATE_BLOCK] = blueprint->privates[i];
+    memcpy(instance->privates + PRIVATE_COLUMNS, blueprint->privates + PRIVATE_COLUMNS,
+           sizeof(Value) * (MAX_PRIVATES - PRIVATE_COLUMNS));
+#else
     // Clone privates — memcpy is faster than element-by-element loop (448 bytes)
     memcpy(instance->privates, blueprint->privates, sizeof(Value) * MAX_PRIVATES);
+#endif
 
     ProcessExec *srcFiber = blueprint;
     ProcessExec *dstFiber = instance;
@@ -216,7 +247,18 @@ Process *Interpreter::spawnProcess(ProcessDef *blueprint)
         return nullptr;
     }
 
-    if (srcFiber->state == ProcessState::DEAD)
+    if (blueprint->freshStart)
+    {
+        // Caso normal: so a entry frame, stack vazia (os args vem depois)
+        dstFiber->frameCount = 1;
+        dstFiber->frames[0] = srcFiber->frames[0];
+        dstFiber->frames[0].slots = dstFiber->stack;
+        dstFiber->ip = dstFiber->frames[0].ip;
+        dstFiber->stackTop = dstFiber->stack;
+        dstFiber->gosubTop = 0;
+        dstFiber->tryDepth = 0;
+    }
+    else if (srcFiber->state == ProcessState::DEAD)
     {
         dstFiber->state = ProcessState::DEAD;
         dstFiber->stackTop = dstFiber->stack;
@@ -274,6 +316,56 @@ Process *Interpreter::spawnProcess(ProcessDef *blueprint)
 
     return instance;
 }
+void Interpreter::bindProcessArgs(Process *instance, ProcessDef *blueprint, const Value *args, int argCount)
+{
+    int localSlot = 0;
+    int mapped = (int)blueprint->argsNames.size();
+
+    for (int i = 0; i < argCount; i++)
+    {
+        if (i < mapped && blueprint->argsNames[i] != 255)
+        {
+            // Arg mapeia para um private (x, y, etc.) - copia direto
+            instance->priv(blueprint->argsNames[i]) = args[i];
+        }
+        else
+        {
+            // Arg é um local normal
+            instance->stack[localSlot++] = args[i];
+        }
+    }
+
+    instance->stackTop = instance->stack + localSlot;
+}
+
+Process *Interpreter::spawnWithArgs(ProcessDef *blueprint, const Value *args, int argCount, Value father)
+{
+    Process *instance = spawnProcess(blueprint);
+    if (!instance)
+    {
+        return nullptr;
+    }
+
+    if (argCount > 0)
+    {
+        bindProcessArgs(instance, blueprint, args, argCount);
+    }
+
+    instance->privates[(int)PrivateIndex::ID] = makeInt(instance->id);
+    instance->privates[(int)PrivateIndex::FATHER] = father;
+
+    if (hooks.onCreate)
+    {
+        hooks.onCreate(this, instance);
+    }
+    return instance;
+}
+
+void Interpreter::reserveProcesses(size_t extra)
+{
+    aliveProcesses.reserve(aliveProcesses.size() + extra);
+}
+
 uint32 Interpreter::getTotalProcesses() const
 {
     return static_cast<uint32>(processes.size());
@@ -312,6 +404,224 @@ Process *Interpreter::findProcessById(uint32 id)
     return nullptr;
 }
 
+bool Interpreter::canSuspendCurrentProcess() const
+{
+    // O main process corre fora do scheduler (run()), e as chamadas C++ -> script
+    // esperam que o frame alvo retorne sem ceder.
+    return currentProcess != nullptr && currentProcess != mainProcess &&
+           currentProcess->state == ProcessState::RUNNING && !stopOnCallReturn_;
+}
+
+bool Interpreter::suspendCurrentProcess(float seconds)
+{
+    if (!canSuspendCurrentProcess())
+    {
+        return false;
+    }
+
+    currentProcess->state = ProcessState::SUSPENDED;
+    currentProcess->resumeTime = seconds < 0 ? FLT_MAX : currentTime + seconds;
+    nativeYield_ = true;
+    return true;
+}
+
+int Interpreter::nativeResultSlot(const Value *args)
+{
+    return (int)(args - currentExec()->stack) - 1;
+}
+
+bool Interpreter::wakeProcess(uint32 processId, int resultSlot, const Value &result)
+{
+    Process *proc = findProcessById(processId);
+    if (!proc || proc->state != ProcessState::SUSPENDED)
+    {
+        return false;
+    }
+
+    if (resultSlot >= 0 && proc->stack + resultSlot < proc->stackTop)
+    {
+        proc->stack[resultSlot] = result;
+    }
+    proc->resumeTime = 0;
+    return true;
+}
+
+float Interpreter::timeUntilNextWake() const
+{
+    float next = -1.0f;
+    for (size_t i = 0; i < aliveProcesses.size(); i++)
+    {
+        const Process *proc = aliveProcesses[i];
+        if (proc == currentProcess || proc == mainProcess)
+            continue;
+        if (proc->state == ProcessState::RUNNING || proc->state == ProcessState::DEAD)
+            return 0.0f;
+        if (proc->state == ProcessState::SUSPENDED && proc->resumeTime != FLT_MAX)
+        {
+            float wait = proc->resumeTime - currentTime;
+            if (wait <= 0.0f)
+                return 0.0f;
+            if (next < 0.0f || wait < next)
+                next = wait;
+        }
+    }
+    return next;
+}
+
+#if BU_ENABLE_PROCESS_WORKERS
+
+void Interpreter::setProcessWorkers(int threads)
+{
+    if (threads < 0)
+        threads = (int)std::thread::hardware_concurrency();
+
+    delete workers_;
+    workers_ = nullptr;
+    if (threads > 1)
+        workers_ = new ProcessWorkers(threads);
+}
+
+int Interpreter::getProcessWorkers() const
+{
+    return workers_ ? workers_->threads() : 1;
+}
+
+// Um blueprint pode correr numa worker thread se o corpo so usa instrucoes
+// que mexem na propria pilha/privates (e le globais). Tudo o resto (chamadas,
+// colecoes, strings, upvalues, try, ...) fica na thread principal. Os casos
+// raros dentro destas instrucoes (overloads, erros, concat) fazem handoff.
+bool Interpreter::isParallelSafe(ProcessDef *def)
+{
+    if (def->parallelSafe >= 0)
+        return def->parallelSafe == 1;
+
+    def->parallelSafe = 0;
+    Function *func = def->frames[0].func;
+    if (!func || !func->chunk)
+        return false;
+
+    const Code *chunk = func->chunk;
+    size_t offset = 0;
+    while (offset < chunk->count)
+    {
+        switch (chunk->code[offset])
+        {
+        case OP_NIL:
+        case OP_TRUE:
+        case OP_FALSE:
+        case OP_POP:
+        case OP_NOT:
+        case OP_DUP:
+        case OP_ADD:
+        case OP_SUBTRACT:
+        case OP_MULTIPLY:
+        case OP_DIVIDE:
+        case OP_NEGATE:
+        case OP_MODULO:
+        case OP_EQUAL:
+        case OP_NOT_EQUAL:
+        case OP_GREATER:
+        case OP_GREATER_EQUAL:
+        case OP_LESS:
+        case OP_LESS_EQUAL:
+        case OP_FRAME:
+        case OP_EXIT:
+        case OP_RETURN:
+        case OP_ADD_INT:
+        case OP_ADD_DOUBLE:
+        case OP_SUBTRACT_INT:
+        case OP_SUBTRACT_DOUBLE:
+        case OP_LESS_INT:
+        case OP_LESS_DOUBLE:
+            offset += 1;
+            break;
+        case OP_GET_LOCAL:
+        case OP_SET_LOCAL:
+        case OP_GET_PRIVATE:
+        case OP_SET_PRIVATE:
+            offset += 2;
+            break;
+        case OP_CONSTANT:
+        case OP_GET_GLOBAL:
+        case OP_JUMP:
+        case OP_JUMP_IF_FALSE:
+        case OP_LOOP:
+            offset += 3;
+            break;
+        default:
+            return false;
+        }
+    }
+
+    def->parallelSafe = 1;
+    return true;
+}
+
+void Interpreter::parallelStepTask(void *ctx, size_t index)
+{
+    Interpreter *vm = static_cast<Interpreter *>(ctx);
+    Process *proc = vm->parallelBatch[index];
+
+    proc->parallelStep = true;
+    ProcessResult result = vm->run_process(proc);
+    proc->parallelStep = false;
+
+    // Parou antes de uma instrucao que precisa da thread principal: continua
+    // RUNNING e o update() acaba o passo na sua vez
+    if (result.reason == ProcessResult::PROCESS_HANDOFF)
+        return;
+
+    proc->batchStepped = true;
+    if (proc->state == ProcessState::DEAD || result.reason != ProcessResult::PROCESS_FRAME)
+    {
+        proc->state = ProcessState::DEAD;
+        proc->initialized = false;
+        return;
+    }
+
+    proc->state = ProcessState::SUSPENDED;
+    proc->resumeTime = vm->currentTime + (vm->lastFrameTime * (result.framePercent - 100) / 100.0f);
+}
+
+// Corre antes do passo sequencial do update(): junta os processos prontos
+// cujo blueprint e seguro e reparte-os pelas workers. Enquanto correm a thread
+// principal esta aqui, por isso nada aloca nem chama o GC; o fim do lote e o
+// safe point. Os hooks (onStart/onUpdate) continuam no passo sequencial, pela
+// ordem de aliveProcesses.
+void Interpreter::runParallelBatch(Process *skip)
+{
+    parallelBatch.clear();
+    for (size_t i = 0; i < aliveProcesses.size(); i++)
+    {
+        Process *proc = aliveProcesses[i];
+        if (proc == skip || !proc->initialized)
+            continue;
+        if (proc->state == ProcessState::SUSPENDED)
+        {
+            if (currentTime < proc->resumeTime)
+                continue;
+        }
+        else if (proc->state != ProcessState::RUNNING)
+            continue;
+        if (proc->blueprint < 0 || (size_t)proc->blueprint >= processes.size() ||
+            !isParallelSafe(processes[proc->blueprint]))
+            continue;
+
+        proc->state = ProcessState::RUNNING;
+        parallelBatch.push(proc);
+    }
+
+    workers_->run(parallelBatch.size(), parallelStepTask, this);
+    parallelBatch.clear();
+}
+
+#else
+
+void Interpreter::setProcessWorkers(int) {}
+int Interpreter::getProcessWorkers() const { return 1; }
+
+#endif
+
 void Interpreter::update(float deltaTime)
 {
     // if(    asEnded)
@@ -323,6 +633,15 @@ void Interpreter::update(float deltaTime)
     lastFrameTime = deltaTime;
     frameCount++;
 
+#if BU_ENABLE_PROCESS_WORKERS
+    if (workers_ && !debugger_)
+        runParallelBatch(savedCurrentProcess);
+#endif
+
+    // ticks() dentro de um processo chama update() aninhado: cada nivel usa
+    // so a sua parte de updateBatch
+    const size_t batchStart = updateBatch.size();
+
     size_t i = 0;
     while (i < aliveProcesses.size())
     {
@@ -336,6 +655,22 @@ void Interpreter::update(float deltaTime)
             continue;
         }
 
+        // Already stepped by the parallel batch: only the hook is left
+        if (proc->batchStepped)
+        {
+            proc->batchStepped = false;
+#ifdef BU_ENABLE_SPACE
+            if (spatialGrid_)
+                spatialGrid_->refresh(proc);
+#endif
+            if (hooks.onUpdate)
+                hooks.onUpdate(this, proc, deltaTime);
+            if (hooks.onUpdateBatch)
+                updateBatch.push(proc);
+            i++;
+            continue;
+        }
+
         // Frozen? -> skip entirely
         if (proc->state == ProcessState::FROZEN)
         {
@@ -360,6 +695,10 @@ void Interpreter::update(float deltaTime)
         {
             // remove sem manter ordem
             //   Info(" Process (id=%u) is dead. Cleaning up. ",   proc->id);
+#ifdef BU_ENABLE_SPACE
+            if (spatialGrid_)
+                spatialGrid_->remove(proc);
+#endif
             aliveProcesses[i] = aliveProcesses.back();
             cleanProcesses.push(proc);
             aliveProcesses.pop();
@@ -374,12 +713,26 @@ void Interpreter::update(float deltaTime)
         }
 
         run_process_step(proc);
+#ifdef BU_ENABLE_SPACE
+        if (spatialGrid_)
+            spatialGrid_->refresh(proc);
+#endif
         if (hooks.onUpdate)
             hooks.onUpdate(this,proc, deltaTime);
+        if (hooks.onUpdateBatch)
+            updateBatch.push(proc);
 
         i++;
     }
 
+    // Antes da reciclagem: os processos que morreram neste passo ainda sao validos
+    if (hooks.onUpdateBatch && updateBatch.size() > batchStart)
+    {
+        hooks.onUpdateBatch(this, updateBatch.data() + batchStart,
+                            updateBatch.size() - batchStart, deltaTime);
+    }
+    updateBatch.resize(batchStart);
+
     ProcessPool &pool = ProcessPool::instance();
     for (size_t j = 0; j < cleanProcesses.size(); j++)
     {
@@ -410,6 +763,31 @@ void Interpreter::update(float deltaTime)
     currentProcess = savedCurrentProcess;
 }
 
+#ifdef BU_ENABLE_SPACE
+
+SpatialGrid *Interpreter::getSpatialGrid()
+{
+    if (!spatialGrid_)
+        setSpatialGrid(64.0f, 16.0f);
+    return spatialGrid_;
+}
+
+void Interpreter::setSpatialGrid(float cellSize, float radius)
+{
+    if (spatialGrid_)
+    {
+        spatialGrid_->clear();
+        delete spatialGrid_;
+    }
+    spatialGrid_ = new SpatialGrid(cellSize, radius);
+
+    // Daqui em diante o update() mantem a grelha; os ja vivos entram agora
+    for (size_t i = 0; i < aliveProcesses.size(); i++)
+        spatialGrid_->refresh(aliveProcesses[i]);
+}
+
+#endif
+
 void Interpreter::run_process_step(Process *proc)
 {
     if (proc->state == ProcessState::DEAD)
@@ -474,6 +852,19 @@ void Interpreter::run_process_step(Process *proc)
         return;
     }
 
+    if (result.reason == ProcessResult::PROCESS_WAIT)
+    {
+        // suspendCurrentProcess() ja definiu state/resumeTime
+        if (!proc->initialized)
+        {
+            proc->initialized = true;
+            if (hooks.onStart)
+                hooks.onStart(this, proc);
+        }
+
+        return;
+    }
+
     if (result.reason == ProcessResult::PROCESS_DONE)
     {
         proc->state = ProcessState::DEAD;
@@ -484,14 +875,66 @@ void Interpreter::run_process_step(Process *proc)
 
 void Interpreter::render()
 {
-    if (!hooks.onRender)
-        return;
-    for (size_t i = 0; i < aliveProcesses.size(); i++)
+    if (hooks.onRender)
     {
-        Process *proc = aliveProcesses[i];
-        if (proc->state != ProcessState::DEAD && proc->initialized)
+        for (size_t i = 0; i < aliveProcesses.size(); i++)
         {
-            hooks.onRender(this,proc);
+            Process *proc = aliveProcesses[i];
+            if (proc->state != ProcessState::DEAD && proc->initialized)
+            {
+                hooks.onRender(this,proc);
+            }
         }
     }
+
+    if (hooks.onRenderBatch)
+    {
+        renderBatch();
+    }
+}
+
+// Junta os privates de desenho num so passo para o host submeter tudo de uma vez
+void Interpreter::renderBatch()
+{
+    renderProcs.clear();
+    renderX.clear();
+    renderY.clear();
+    renderAngle.clear();
+    renderSize.clear();
+    renderGraph.clear();
+
+    size_t alive = aliveProcesses.size();
+    renderProcs.reserve(alive);
+    renderX.reserve(alive);
+    renderY.reserve(alive);
+    renderAngle.reserve(alive);
+    renderSize.reserve(alive);
+    renderGraph.reserve(alive);
+
+    for (size_t i = 0; i < alive; i++)
+    {
+        Process *proc = aliveProcesses[i];
+        if (proc->state == ProcessState::DEAD || !proc->initialized)
+            continue;
+
+        renderProcs.push(proc);
+        renderX.push((float)proc->priv((int)PrivateIndex::X).asNumber());
+        renderY.push((float)proc->priv((int)PrivateIndex::Y).asNumber());
+        renderAngle.push((float)proc->priv((int)PrivateIndex::ANGLE).asNumber());
+        renderSize.push((float)proc->priv((int)PrivateIndex::SIZE).asNumber());
+        renderGraph.push((int)proc->priv((int)PrivateIndex::GRAPH).asNumber());
+    }
+
+    if (renderProcs.size() == 0)
+        return;
+
+    ProcessRenderBatch batch;
+    batch.count = renderProcs.size();
+    batch.procs = renderProcs.data();
+    batch.x = renderX.data();
+    batch.y = renderY.data();
+    batch.angle = renderAngle.data();
+    batch.size = renderSize.data();
+    batch.graph = renderGraph.data();
+    hooks.onRenderBatch(this, batch);
 }
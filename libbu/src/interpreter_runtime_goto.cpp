@@ -156,7 +156,12 @@ inline  const char *getValueTypeName(const Value &v)
 ProcessResult Interpreter::run_process(Process *process)
 {
     ProcessExec *fiber = process;
+#if BU_ENABLE_PROCESS_WORKERS
+    if (!process->parallelStep) // worker threads never touch shared VM state
+        currentProcess = process;
+#else
     currentProcess = process;
+#endif
 
     CallFrame *frame;
     Value *stackStart;
@@ -206,6 +211,7 @@ ProcessResult Interpreter::run_process(Process *process)
 #define TRY_OPERATOR_OVERLOAD(staticNameIdx, opSymbol)                                           \
     do {                                                                                        \
         if (a.isClassInstance()) {                                                              \
+            WORKER_HANDOFF(2);                                                                  \
             ClassInstance *_inst = a.asClassInstance();                                          \
             Function *_method;                                                                  \
             if (_inst->getMethod(staticNames[(int)StaticNames::staticNameIdx], &_method)) {     \
@@ -369,6 +375,19 @@ ProcessResult Interpreter::run_process(Process *process)
 
         // Debug (94)
         &&op_breakpoint,
+
+        // Quickened variants (95-101)
+        &&op_add_int,
+        &&op_add_double,
+        &&op_subtract_int,
+        &&op_subtract_double,
+        &&op_less_int,
+        &&op_less_double,
+        &&op_get_index_array,
+
+        // String append on locals (102-103)
+        &&op_append_local,
+        &&op_get_local_shared,
     };
 
 #define SAFE_CALL_NATIVE(fiber, argCount, callFunc)                                    \
@@ -402,6 +421,14 @@ ProcessResult Interpreter::run_process(Process *process)
             /* Retornar nil se for void */                                             \
             *_dest = makeNil();                                                        \
             (fiber)->stackTop = _dest + 1;                                             \
+        }                                                                              \
+                                                                                       \
+        /* 6. A native suspendeu o processo (IO/timer): ceder apos a chamada */        \
+        if (UNLIKELY(nativeYield_))                                                    \
+        {                                                                              \
+            nativeYield_ = false;                                                      \
+            STORE_FRAME();                                                             \
+            return {ProcessResult::PROCESS_WAIT, 0};                                   \
         }                                                                              \
     } while (0)
 
@@ -411,6 +438,60 @@ ProcessResult Interpreter::run_process(Process *process)
                 goto *dispatch_table[READ_BYTE()]; \
     } while (0)
 
+#if BU_ENABLE_PROCESS_WORKERS
+// Parallel update (setProcessWorkers): on a worker thread the process may only
+// touch its own stack/privates. An instruction that needs more (allocation,
+// errors, overloads, upvalues) puts back the operands it popped, rewinds to
+// its own opcode and stops; update() resumes it on the main thread.
+#define ON_WORKER() UNLIKELY(process->parallelStep)
+#define WORKER_HANDOFF(_popped)                         \
+    do                                                  \
+    {                                                   \
+        if (ON_WORKER())                                \
+        {                                               \
+            fiber->stackTop += (_popped);               \
+            ip -= 1;                                    \
+            STORE_FRAME();                              \
+            return {ProcessResult::PROCESS_HANDOFF, 0}; \
+        }                                               \
+    } while (0)
+#else
+#define ON_WORKER() false
+#define WORKER_HANDOFF(_popped) ((void)0)
+#endif
+
+// Quickening: rewrite the zero-operand opcode just dispatched (ip[-1]).
+// The byte is only touched while it still holds `_from`, so an OP_BREAKPOINT
+// patched over the site by RuntimeDebugger is never clobbered.
+#define REWRITE_OPCODE(_from, _to)                    \
+    do                                                \
+    {                                                 \
+        if (ip[-1] == (uint8)(_from) && !ON_WORKER()) \
+            ip[-1] = (uint8)(_to);                    \
+    } while (0)
+
+#if BU_ENABLE_QUICKENING
+#define QUICKEN(_from, _to) REWRITE_OPCODE(_from, _to)
+#else
+#define QUICKEN(_from, _to) ((void)0)
+#endif
+
+#define DEQUICKEN(_from, _to) REWRITE_OPCODE(_from, _to)
+
+#if BU_ENABLE_JIT
+// Baseline JIT: count calls/back-edges and hand the current frame to native
+// code once hot. Native code returns the bytecode position to resume at.
+#define JIT_HOT_ENTRY()                                                                \
+    do                                                                                 \
+    {                                                                                  \
+        if (jitEnabled_ && !debugger_ &&                                               \
+            (func->jit || (!ON_WORKER() && ++func->hotCount >= BU_JIT_HOT_THRESHOLD && jitCompile(func)))) \
+            ip = jitRun(func, fiber, process, stackStart, ip);                         \
+    } while (0)
+#else
+#define JIT_HOT_ENTRY() ((void)0)
+#endif
+
 #define ENTER_CALL_FRAME_DISPATCH(_targetFunc, _closure, _argc, _overflowMsg) \
     do                                                                          \
     {                                                                           \
@@ -428,6 +509,7 @@ ProcessResult Interpreter::run_process(Process *process)
         stackStart = newFrame->slots;                                           \
         ip = newFrame->ip;                                                      \
         func = newFrame->func;                                                  \
+        JIT_HOT_ENTRY();                                                        \
         DISPATCH();                                                             \
     } while (0)
 
@@ -503,17 +585,42 @@ op_set_local:
     DISPATCH();
 }
 
+op_get_local_shared:
+{
+    const GetLocalShared read = decodeGetLocalShared(ip - 1);
+    ip += GET_LOCAL_SHARED_LENGTH - 1;
+    const Value &value = stackStart[read.slot];
+    if (read.share && value.isString() && value.asString()->isOwned())
+        value.asString()->share();
+
+    PUSH(value);
+    DISPATCH();
+}
+
+op_append_local:
+{
+    // O compilador emite sempre OP_SET_LOCAL <slot> a seguir; se o resultado
+    // for descartado (OP_POP) a string da local pode crescer no sitio
+    if (ip[0] == OP_SET_LOCAL &&
+        appendToLocal(&stackStart[ip[1]], fiber->stackTop[-2], fiber->stackTop[-1], ip[2] == OP_POP))
+    {
+        DROP();
+        DISPATCH();
+    }
+    goto op_add;
+}
+
 op_get_private:
 {
     uint8 index = READ_BYTE();
-    PUSH(process->privates[index]);
+    PUSH(process->priv(index));
     DISPATCH();
 }
 
 op_set_private:
 {
     uint8 index = READ_BYTE();
-    process->privates[index] = PEEK();
+    process->priv(index) = PEEK();
     DISPATCH();
 }
 
@@ -557,6 +664,7 @@ op_add:
     // ---------------------------------------------------------
     if (LIKELY(a.isInt() && b.isInt()))
     {
+        QUICKEN(OP_ADD, OP_ADD_INT);
         PUSH(makeInt(a.asInt() + b.asInt()));
         DISPATCH();
     }
@@ -564,10 +672,14 @@ op_add:
     // Fast path: double + double
     if (a.isDouble() && b.isDouble())
     {
+        QUICKEN(OP_ADD, OP_ADD_DOUBLE);
         PUSH(makeDouble(a.asDouble() + b.asDouble()));
         DISPATCH();
     }
 
+    if (!(a.isNumber() && b.isNumber()))
+        WORKER_HANDOFF(2);
+
     // ---------------------------------------------------------
     // 1. CONCATENAÇÃO (String à Esquerda)
     // Ex: "Pontos: " + 100
@@ -684,6 +796,7 @@ op_subtract:
     // Fast path: int - int (fib, loops)
     if (LIKELY(a.isInt() && b.isInt()))
     {
+        QUICKEN(OP_SUBTRACT, OP_SUBTRACT_INT);
         PUSH(makeInt(a.asInt() - b.asInt()));
         DISPATCH();
     }
@@ -691,6 +804,7 @@ op_subtract:
     // Fast path: double - double
     if (a.isDouble() && b.isDouble())
     {
+        QUICKEN(OP_SUBTRACT, OP_SUBTRACT_DOUBLE);
         PUSH(makeDouble(a.asDouble() - b.asDouble()));
         DISPATCH();
     }
@@ -724,6 +838,7 @@ op_subtract:
         DISPATCH();
     }
 
+    WORKER_HANDOFF(2);
     TRY_OPERATOR_OVERLOAD(OP_SUB_METHOD, "-");
     THROW_RUNTIME_ERROR("Cannot apply '-' to %s and %s", getValueTypeName(a), getValueTypeName(b));
 }
@@ -757,6 +872,7 @@ op_multiply:
         DISPATCH();
     }
 
+    WORKER_HANDOFF(2);
     TRY_OPERATOR_OVERLOAD(OP_MUL_METHOD, "*");
     THROW_RUNTIME_ERROR("Cannot apply '*' to %s and %s", getValueTypeName(a), getValueTypeName(b));
 }
@@ -770,6 +886,7 @@ op_divide:
 #define THROW_DIV_ZERO()                                             \
     do                                                               \
     {                                                                \
+        WORKER_HANDOFF(2);                                           \
         STORE_FRAME();                                               \
         Value error = makeString("Division by zero");                \
                                                                      \
@@ -1014,6 +1131,7 @@ op_divide:
     }
     
 
+    WORKER_HANDOFF(2);
     TRY_OPERATOR_OVERLOAD(OP_DIV_METHOD, "/");
     STORE_FRAME();
     runtimeError("Cannot apply '/' to %s and %s", getValueTypeName(a), getValueTypeName(b));
@@ -1035,6 +1153,7 @@ op_modulo:
         int ib = b.asInt();
         if (UNLIKELY(ib == 0))
         {
+            WORKER_HANDOFF(2);
             STORE_FRAME();
             Value error = makeString("Modulo by zero");
             if (throwException(error)) { LOAD_FRAME(); DISPATCH(); }
@@ -1052,6 +1171,7 @@ op_modulo:
 
     if (!a.isNumber() || !b.isNumber())
     {
+        WORKER_HANDOFF(2);
         TRY_OPERATOR_OVERLOAD(OP_MOD_METHOD, "%");
         STORE_FRAME();
         runtimeError("Cannot apply '%%' to %s and %s", getValueTypeName(a), getValueTypeName(b));
@@ -1063,6 +1183,7 @@ op_modulo:
 
     if (db == 0.0)
     {
+        WORKER_HANDOFF(2);
         STORE_FRAME();
         Value error = makeString("Modulo by zero");
         if (throwException(error)) { LOAD_FRAME(); DISPATCH(); }
@@ -1102,6 +1223,7 @@ op_negate:
     }
     else
     {
+        WORKER_HANDOFF(1);
         THROW_RUNTIME_ERROR("Operand 'NEGATE' must be a number");
     }
     DISPATCH();
@@ -1168,6 +1290,7 @@ op_greater:
     }
     else
     {
+        WORKER_HANDOFF(2);
         TRY_OPERATOR_OVERLOAD(OP_GT_METHOD, ">");
         THROW_RUNTIME_ERROR("Operands '>' must be numbers or strings");
     }
@@ -1193,6 +1316,7 @@ op_greater_equal:
     }
     else
     {
+        WORKER_HANDOFF(2);
         TRY_OPERATOR_OVERLOAD(OP_GTE_METHOD, ">=");
         THROW_RUNTIME_ERROR("Operands '>=' must be numbers or strings");
     }
@@ -1204,12 +1328,15 @@ op_less:
     BINARY_OP_PREP();
     if (LIKELY(a.isInt() && b.isInt()))
     {
+        QUICKEN(OP_LESS, OP_LESS_INT);
         PUSH(makeBool(a.asInt() < b.asInt()));
         DISPATCH();
     }
     double da, db;
     if (LIKELY(toNumberPair(a, b, da, db)))
     {
+        if (a.isDouble() && b.isDouble())
+            QUICKEN(OP_LESS, OP_LESS_DOUBLE);
         PUSH(makeBool(da < db));
     }
     else if (a.isString() && b.isString())
@@ -1218,6 +1345,7 @@ op_less:
     }
     else
     {
+        WORKER_HANDOFF(2);
         TRY_OPERATOR_OVERLOAD(OP_LT_METHOD, "<");
         THROW_RUNTIME_ERROR("Operands '<' must be numbers or strings");
     }
@@ -1243,6 +1371,7 @@ op_less_equal:
     }
     else
     {
+        WORKER_HANDOFF(2);
         TRY_OPERATOR_OVERLOAD(OP_LTE_METHOD, "<=");
         THROW_RUNTIME_ERROR("Operands '<=' must be numbers or strings");
     }
@@ -1380,6 +1509,7 @@ op_loop:
     uint16 offset = READ_SHORT();
 
     ip -= offset;
+    JIT_HOT_ENTRY();
 
     DISPATCH();
 }
@@ -1480,45 +1610,17 @@ op_call:
             return {ProcessResult::PROCESS_DONE, 0};
         }
 
-        // SPAWN - clona blueprint
-        Process *instance = spawnProcess(blueprint);
-
-        // Se tem argumentos, inicializa locals da fiber
-        if (argCount > 0)
+        // SPAWN - entry frame do blueprint + args direto da stack
+        Process *instance = spawnWithArgs(blueprint, fiber->stackTop - argCount, argCount,
+                                          makeProcessInstance(process));
+        if (!instance)
         {
-            ProcessExec *procFiber = instance;
-            int localSlot = 0;
-
-            for (int i = 0; i < argCount; i++)
-            {
-                Value arg = fiber->stackTop[-(argCount - i)];
-
-                if (i < (int)blueprint->argsNames.size() && blueprint->argsNames[i] != 255)
-                {
-                    // Arg mapeia para um private (x, y, etc.) - copia direto
-                    instance->privates[blueprint->argsNames[i]] = arg;
-                }
-                else
-                {
-                    // Arg é um local normal
-                    procFiber->stack[localSlot] = arg;
-                    localSlot++;
-                }
-            }
-
-            procFiber->stackTop = procFiber->stack + localSlot;
+            return {ProcessResult::PROCESS_DONE, 0};
         }
 
         // Remove callee + args da stack atual
         fiber->stackTop -= (argCount + 1);
 
-        instance->privates[(int)PrivateIndex::ID] = makeInt(instance->id);
-        instance->privates[(int)PrivateIndex::FATHER] = makeProcessInstance(process);
-
-        if (hooks.onCreate)
-        {
-            hooks.onCreate(this,instance);
-        }
         // Push process instance directly
         PUSH(makeProcessInstance(instance));
 
@@ -1541,19 +1643,13 @@ op_call:
             return {ProcessResult::PROCESS_DONE, 0};
         }
 
-        Value value = makeStructInstance();
+        Value value = makeStructInstance(def);
         StructInstance *instance = value.as.sInstance;
-        instance->def = def;
 
-        instance->values.reserve(def->argCount);
         Value *args = fiber->stackTop - argCount;
         for (int i = 0; i < argCount; i++)
         {
-            instance->values.push(args[i]);
-        }
-        for (int i = argCount; i < def->argCount; i++)
-        {
-            instance->values.push(makeNil());
+            instance->values[i] = args[i];
         }
         fiber->stackTop -= (argCount + 1);
         PUSH(value);
@@ -1569,23 +1665,8 @@ op_call:
         int classId = callee.asClassId();
         ClassDef *klass = classes[classId];
 
-        Value value = makeClassInstance();
+        Value value = makeClassInstance(klass);
         ClassInstance *instance = value.asClassInstance();
-        instance->klass = klass;
-        instance->fields.reserve(klass->fieldCount);
-
-        // Inicializa fields com valores default ou nil
-        for (int i = 0; i < klass->fieldCount; i++)
-        {
-            if (i < (int)klass->fieldDefaults.size() && !klass->fieldDefaults[i].isNil())
-            {
-                instance->fields.push(klass->fieldDefaults[i]);
-            }
-            else
-            {
-                instance->fields.push(makeNil());
-            }
-        }
 
         // Verifica se há NativeClass na cadeia de herança (direta ou indireta)
         NativeClassDef *nativeKlass = instance->getNativeSuperclass();
@@ -1600,7 +1681,7 @@ op_call:
             else
             {
                 // Sem constructor, aloca buffer genérico
-                instance->nativeUserData = arena.Allocate(128);
+                instance->nativeUserData = arena.Allocate(128, (uint8)GCObjectType::CLASS);
                 std::memset(instance->nativeUserData, 0, 128);
             }
         }
@@ -1676,7 +1757,7 @@ op_call:
         int structId = callee.asNativeStructId();
         NativeStructDef *def = nativeStructs[structId];
 
-        void *data = arena.Allocate(def->structSize);
+        void *data = arena.Allocate(def->structSize, (uint8)GCObjectType::NATIVE_STRUCT);
         std::memset(data, 0, def->structSize);
 
         if (def->constructor)
@@ -1778,6 +1859,7 @@ op_call:
 
 op_return:
 {
+    WORKER_HANDOFF(0); // upvalues / C++ call boundary are shared state
     Value result = POP();
 
     if (hasFatalError_)
@@ -2035,7 +2117,7 @@ op_get_property:
         if (privateIdx != -1)
         {
             DROP();
-            PUSH(proc->privates[privateIdx]);
+            PUSH(proc->priv(privateIdx));
         }
         else
         {
@@ -2246,7 +2328,7 @@ op_set_property:
                 runtimeError("Property '%s' is readonly", name);
                 return {ProcessResult::PROCESS_DONE, 0};
             }
-            proc->privates[privateIdx] = value;
+            proc->priv(privateIdx) = value;
             DROP();
             DROP();
             PUSH(value);
@@ -2869,10 +2951,8 @@ op_invoke:
                 ptr->values.reserve(strLen);
                 for (int i = 0; i < strLen; i++)
                 {
-                    // Cria string de 1 char
-                    char buf[2] = {strChars[i], '\0'};
-
-                    ptr->values.push(makeString(createString(buf, 1)));
+                    // Strings de 1 char vem da cache do pool
+                    ptr->values.push(makeString(stringPool.fromChar((unsigned char)strChars[i])));
                 }
             }
             else
@@ -3607,7 +3687,7 @@ op_invoke:
                 return {ProcessResult::PROCESS_DONE, 0};
             }
             Value val = PEEK();
-            set->table.insert(val);
+            set->table.insert(mapKey(val));
             ARGS_CLEANUP();
             PUSH(receiver);
             DISPATCH();
@@ -3772,6 +3852,13 @@ op_invoke:
             fiber->stackTop = dest + 1;
         }
 
+        if (UNLIKELY(nativeYield_))
+        {
+            nativeYield_ = false;
+            STORE_FRAME();
+            return {ProcessResult::PROCESS_WAIT, 0};
+        }
+
         DISPATCH();
     }
 
@@ -4794,7 +4881,7 @@ op_define_map:
         Value value = POP();
         Value key = POP();
 
-        inst->table.set(key, value);
+        inst->table.set(mapKey(key), value);
     }
 
     PUSH(map);
@@ -4810,7 +4897,7 @@ op_define_set:
     for (int i = 0; i < count; i++)
     {
         Value val = POP();
-        inst->table.insert(val);
+        inst->table.insert(mapKey(val));
     }
 
     PUSH(set);
@@ -4856,7 +4943,7 @@ op_set_index:
     case ValueType::MAP:
     {
         MapInstance *map = container.asMap();
-        map->table.set(index, value);
+        map->table.set(mapKey(index), value);
         PUSH(value);
         DISPATCH();
     }
@@ -4927,6 +5014,32 @@ op_set_index:
         DISPATCH();
     }
 
+    case ValueType::NATIVECLASSINSTANCE:
+    {
+        NativeClassInstance *inst = container.asNativeClassInstance();
+        if (!inst->klass->typedArray)
+        {
+            runtimeError("Cannot index assign this type");
+            return {ProcessResult::ERROR, 0};
+        }
+        if (!index.isNumber() || !value.isNumber())
+        {
+            runtimeError("Typed array index and value must be numbers");
+            return {ProcessResult::ERROR, 0};
+        }
+
+        TypedArrayData *ta = (TypedArrayData *)inst->userData;
+        int i = index.isInt() ? index.asInt() : (int)index.asNumber();
+        if (i < 0 || i >= ta->count)
+        {
+            runtimeError("Typed array index %d out of bounds (size=%d)", i, ta->count);
+            return {ProcessResult::ERROR, 0};
+        }
+        typedArrayStore(ta, i, value);
+        PUSH(value);
+        DISPATCH();
+    }
+
     case ValueType::STRING:
     {
         runtimeError("Strings are immutable");
@@ -4954,6 +5067,9 @@ op_get_index:
             return {ProcessResult::ERROR, 0};
         }
 
+        if (index.isInt())
+            QUICKEN(OP_GET_INDEX, OP_GET_INDEX_ARRAY);
+
         ArrayInstance *arr = container.asArray();
         int i = (int)index.asNumber();
         uint32 size = arr->values.size();
@@ -4973,6 +5089,31 @@ op_get_index:
         DISPATCH();
     }
 
+    case ValueType::NATIVECLASSINSTANCE:
+    {
+        NativeClassInstance *inst = container.asNativeClassInstance();
+        if (!inst->klass->typedArray)
+        {
+            runtimeError("Cannot index this type");
+            return {ProcessResult::ERROR, 0};
+        }
+        if (!index.isNumber())
+        {
+            runtimeError("Typed array index must be a number");
+            return {ProcessResult::ERROR, 0};
+        }
+
+        TypedArrayData *ta = (TypedArrayData *)inst->userData;
+        int i = index.isInt() ? index.asInt() : (int)index.asNumber();
+        if (i < 0 || i >= ta->count)
+        {
+            runtimeError("Typed array index %d out of bounds (size=%d)", i, ta->count);
+            return {ProcessResult::ERROR, 0};
+        }
+        PUSH(typedArrayLoad(ta, i));
+        DISPATCH();
+    }
+
     case ValueType::STRING:
     {
         if (!index.isInt())
@@ -5774,19 +5915,24 @@ op_closure:
     Value funcVal = READ_CONSTANT();
     int funcID = funcVal.asFunctionId();
     Function *function = functions[funcID];
-    Value closure = makeClosure();
+    Value closure = makeClosure(function->upvalueCount);
     Closure *closurePtr = closure.as.closure;
     closurePtr->functionId = funcID;
-    closurePtr->upvalueCount = function->upvalueCount;
 
-    closurePtr->upvalues.clear();
+    // Na stack antes de criar upvalues: createUpvalue() pode correr o GC
+    PUSH(closure);
 
     for (int i = 0; i < function->upvalueCount; i++)
     {
-        uint8 isLocal = READ_BYTE();
+        uint8 flags = READ_BYTE();
         uint8 index = READ_BYTE();
 
-        if (isLocal)
+        if (flags == (UPVALUE_LOCAL | UPVALUE_BY_VALUE))
+        {
+            // Nunca reatribuida: copia, sem Upvalue nem procura em openUpvalues
+            closurePtr->captured()[i] = stackStart[index];
+        }
+        else if (flags & UPVALUE_LOCAL)
         {
             Value *local = &stackStart[index];
 
@@ -5802,7 +5948,7 @@ op_closure:
 
             if (upvalue != nullptr && upvalue->location == local)
             {
-                closurePtr->upvalues.push(upvalue);
+                closurePtr->upvalues[i] = upvalue;
             }
             else
             {
@@ -5818,7 +5964,7 @@ op_closure:
                     prev->nextOpen = created;
                 }
 
-                closurePtr->upvalues.push(created);
+                closurePtr->upvalues[i] = created;
             }
         }
         else
@@ -5833,11 +5979,19 @@ op_closure:
                 runtimeError("Upvalue index %d out of bounds (count=%d)", index, frame->closure->upvalueCount);
                 return {ProcessResult::PROCESS_DONE, 0};
             }
-            closurePtr->upvalues.push(frame->closure->upvalues[index]);
+            Upvalue *shared = frame->closure->upvalues[index];
+            if ((flags & UPVALUE_BY_VALUE) && shared)
+            {
+                closurePtr->captured()[i] = *shared->location;
+            }
+            else
+            {
+                closurePtr->upvalues[i] = shared;
+                closurePtr->captured()[i] = frame->closure->captured()[index];
+            }
         }
     }
 
-    PUSH(closure);
     DISPATCH();
 }
 
@@ -5856,7 +6010,8 @@ op_get_upvalue:
         return {ProcessResult::PROCESS_DONE, 0};
     }
 
-    PUSH(*frame->closure->upvalues[slot]->location);
+    Upvalue *upvalue = frame->closure->upvalues[slot];
+    PUSH(upvalue ? *upvalue->location : frame->closure->captured()[slot]);
     DISPATCH();
 }
 
@@ -5875,7 +6030,12 @@ op_set_upvalue:
         return {ProcessResult::PROCESS_DONE, 0};
     }
 
-    *frame->closure->upvalues[slot]->location = PEEK();
+    // O compilador so emite SET para upvalues partilhados
+    Upvalue *upvalue = frame->closure->upvalues[slot];
+    if (upvalue)
+        *upvalue->location = PEEK();
+    else
+        frame->closure->captured()[slot] = PEEK();
     DISPATCH();
 }
 
@@ -6106,10 +6266,130 @@ op_breakpoint:
     DISPATCH();
 }
 
+// ============================================
+// QUICKENED OPCODES
+// Operands are only peeked until the guard passes; on a guard failure the
+// site is rewritten back to the generic opcode and the generic handler runs
+// with the stack untouched.
+// ============================================
+op_add_int:
+{
+    Value &a = fiber->stackTop[-2];
+    const Value &b = fiber->stackTop[-1];
+    if (LIKELY(a.isInt() && b.isInt()))
+    {
+        a.as.integer += b.as.integer;
+        DROP();
+        DISPATCH();
+    }
+    DEQUICKEN(OP_ADD_INT, OP_ADD);
+    goto op_add;
+}
+
+op_add_double:
+{
+    Value &a = fiber->stackTop[-2];
+    const Value &b = fiber->stackTop[-1];
+    if (LIKELY(a.isDouble() && b.isDouble()))
+    {
+        a.as.number += b.as.number;
+        DROP();
+        DISPATCH();
+    }
+    DEQUICKEN(OP_ADD_DOUBLE, OP_ADD);
+    goto op_add;
+}
+
+op_subtract_int:
+{
+    Value &a = fiber->stackTop[-2];
+    const Value &b = fiber->stackTop[-1];
+    if (LIKELY(a.isInt() && b.isInt()))
+    {
+        a.as.integer -= b.as.integer;
+        DROP();
+        DISPATCH();
+    }
+    DEQUICKEN(OP_SUBTRACT_INT, OP_SUBTRACT);
+    goto op_subtract;
+}
+
+op_subtract_double:
+{
+    Value &a = fiber->stackTop[-2];
+    const Value &b = fiber->stackTop[-1];
+    if (LIKELY(a.isDouble() && b.isDouble()))
+    {
+        a.as.number -= b.as.number;
+        DROP();
+        DISPATCH();
+    }
+    DEQUICKEN(OP_SUBTRACT_DOUBLE, OP_SUBTRACT);
+    goto op_subtract;
+}
+
+op_less_int:
+{
+    Value &a = fiber->stackTop[-2];
+    const Value &b = fiber->stackTop[-1];
+    if (LIKELY(a.isInt() && b.isInt()))
+    {
+        a = makeBool(a.as.integer < b.as.integer);
+        DROP();
+        DISPATCH();
+    }
+    DEQUICKEN(OP_LESS_INT, OP_LESS);
+    goto op_less;
+}
+
+op_less_double:
+{
+    Value &a = fiber->stackTop[-2];
+    const Value &b = fiber->stackTop[-1];
+    if (LIKELY(a.isDouble() && b.isDouble()))
+    {
+        a = makeBool(a.as.number < b.as.number);
+        DROP();
+        DISPATCH();
+    }
+    DEQUICKEN(OP_LESS_DOUBLE, OP_LESS);
+    goto op_less;
+}
+
+op_get_index_array:
+{
+    Value &container = fiber->stackTop[-2];
+    const Value &index = fiber->stackTop[-1];
+    if (LIKELY(container.isArray() && index.isInt()))
+    {
+        ArrayInstance *arr = container.asArray();
+        int i = index.as.integer;
+        uint32 size = arr->values.size();
+        if (i < 0)
+            i += size;
+        if (LIKELY(i >= 0 && (uint32)i < size))
+        {
+            container = arr->values[i];
+            DROP();
+            DISPATCH();
+        }
+        // Out of bounds: the generic handler reports the error
+        goto op_get_index;
+    }
+    DEQUICKEN(OP_GET_INDEX_ARRAY, OP_GET_INDEX);
+    goto op_get_index;
+}
+
 // Cleanup macros
 
 #undef READ_BYTE
 #undef READ_SHORT
+#undef REWRITE_OPCODE
+#undef QUICKEN
+#undef DEQUICKEN
+#undef JIT_HOT_ENTRY
+#undef WORKER_HANDOFF
+#undef ON_WORKER
 }
 
 #endif // USE_COMPUTED_GOTO
@@ -121,7 +121,12 @@ static const char* getValueTypeName(const Value &v)
 ProcessResult Interpreter::run_process(Process *process)
 {
     ProcessExec *fiber = process;
+#if BU_ENABLE_PROCESS_WORKERS
+    if (!process->parallelStep) // worker threads never touch shared VM state
+        currentProcess = process;
+#else
     currentProcess = process;
+#endif
 
     CallFrame *frame;
     Value *stackStart;
@@ -178,6 +183,7 @@ ProcessResult Interpreter::run_process(Process *process)
         STORE_FRAME();                                                          \
         PUSH_CALL_FRAME(_targetFunc, _closure, _argc, _overflowMsg);            \
         LOAD_FRAME();                                                           \
+        JIT_HOT_ENTRY();                                                        \
     } while (false)
 
 #define THROW_RUNTIME_ERROR(fmt, ...)                                \
@@ -203,6 +209,7 @@ ProcessResult Interpreter::run_process(Process *process)
 
 #define TRY_OPERATOR_OVERLOAD(staticNameIdx, opSymbol)                                           \
     if (a.isClassInstance()) {                                                                   \
+        WORKER_HANDOFF(2);                                                                       \
         ClassInstance *_inst = a.asClassInstance();                                               \
         Function *_method;                                                                       \
         if (_inst->getMethod(staticNames[(int)StaticNames::staticNameIdx], &_method)) {          \
@@ -218,6 +225,68 @@ ProcessResult Interpreter::run_process(Process *process)
     }
 
 #define READ_CONSTANT() (func->chunk->constants[READ_SHORT()])
+
+#if BU_ENABLE_PROCESS_WORKERS
+// Parallel update (setProcessWorkers): on a worker thread the process may only
+// touch its own stack/privates. An instruction that needs more (allocation,
+// errors, overloads, upvalues) puts back the operands it popped, rewinds to
+// its own opcode and stops; update() resumes it on the main thread.
+#define ON_WORKER() UNLIKELY(process->parallelStep)
+#define WORKER_HANDOFF(_popped)                         \
+    do                                                  \
+    {                                                   \
+        if (ON_WORKER())                                \
+        {                                               \
+            fiber->stackTop += (_popped);               \
+            ip -= 1;                                    \
+            STORE_FRAME();                              \
+            return {ProcessResult::PROCESS_HANDOFF, 0}; \
+        }                                               \
+    } while (0)
+#else
+#define ON_WORKER() false
+#define WORKER_HANDOFF(_popped) ((void)0)
+#endif
+
+// Quickening: rewrite the zero-operand opcode just dispatched (ip[-1]).
+// The byte is only touched while it still holds `_from`, so an OP_BREAKPOINT
+// patched over the site by RuntimeDebugger is never clobbered.
+#define REWRITE_OPCODE(_from, _to)                    \
+    do                                                \
+    {                                                 \
+        if (ip[-1] == (uint8)(_from) && !ON_WORKER()) \
+            ip[-1] = (uint8)(_to);                    \
+    } while (0)
+
+#if BU_ENABLE_QUICKENING
+#define QUICKEN(_from, _to) REWRITE_OPCODE(_from, _to)
+#else
+#define QUICKEN(_from, _to) ((void)0)
+#endif
+
+// Guard failed: restore the generic opcode and run its handler
+#define DEQUICKEN(_from, _to)                  \
+    do                                         \
+    {                                          \
+        REWRITE_OPCODE(_from, _to);            \
+        instruction = (_to);                   \
+        goto redispatch_instruction;           \
+    } while (0)
+
+#if BU_ENABLE_JIT
+// Baseline JIT: count calls/back-edges and hand the current frame to native
+// code once hot. Native code returns the bytecode position to resume at.
+#define JIT_HOT_ENTRY()                                                                \
+    do                                                                                 \
+    {                                                                                  \
+        if (jitEnabled_ && !debugger_ &&                                               \
+            (func->jit || (!ON_WORKER() && ++func->hotCount >= BU_JIT_HOT_THRESHOLD && jitCompile(func)))) \
+            ip = jitRun(func, fiber, process, stackStart, ip);                         \
+    } while (0)
+#else
+#define JIT_HOT_ENTRY() ((void)0)
+#endif
+
     LOAD_FRAME();
 
     // printf("[DEBUG] Starting run_process: ip=%p, func=%s, offset=%ld\n",
@@ -254,6 +323,14 @@ ProcessResult Interpreter::run_process(Process *process)
             /* Retornar nil se for void */                                             \
             *_dest = makeNil();                                                        \
             (fiber)->stackTop = _dest + 1;                                             \
+        }                                                                              \
+                                                                                       \
+        /* 6. A native suspendeu o processo (IO/timer): ceder apos a chamada */        \
+        if (UNLIKELY(nativeYield_))                                                    \
+        {                                                                              \
+            nativeYield_ = false;                                                      \
+            STORE_FRAME();                                                             \
+            return {ProcessResult::PROCESS_WAIT, 0};                                   \
         }                                                                              \
     } while (0)
 
@@ -366,17 +443,43 @@ ProcessResult Interpreter::run_process(Process *process)
             break;
         }
 
+        case OP_GET_LOCAL_SHARED:
+        {
+            const GetLocalShared read = decodeGetLocalShared(ip - 1);
+            ip += GET_LOCAL_SHARED_LENGTH - 1;
+            const Value &value = stackStart[read.slot];
+            if (read.share && value.isString() && value.asString()->isOwned())
+                value.asString()->share();
+
+            PUSH(value);
+            break;
+        }
+
+        case OP_APPEND_LOCAL:
+        {
+            // O compilador emite sempre OP_SET_LOCAL <slot> a seguir; se o resultado
+            // for descartado (OP_POP) a string da local pode crescer no sitio
+            if (ip[0] == OP_SET_LOCAL &&
+                appendToLocal(&stackStart[ip[1]], fiber->stackTop[-2], fiber->stackTop[-1], ip[2] == OP_POP))
+            {
+                DROP();
+                break;
+            }
+            instruction = OP_ADD;
+            goto redispatch_instruction;
+        }
+
         case OP_GET_PRIVATE:
         {
             uint8 index = READ_BYTE();
-            PUSH(process->privates[index]);
+            PUSH(process->priv(index));
             break;
         }
 
         case OP_SET_PRIVATE:
         {
             uint8 index = READ_BYTE();
-            process->privates[index] = PEEK();
+            process->priv(index) = PEEK();
             break;
         }
 
@@ -419,6 +522,7 @@ ProcessResult Interpreter::run_process(Process *process)
             // ---------------------------------------------------------
             if (LIKELY(a.isInt() && b.isInt()))
             {
+                QUICKEN(OP_ADD, OP_ADD_INT);
                 PUSH(makeInt(a.asInt() + b.asInt()));
                 break;
             }
@@ -426,10 +530,14 @@ ProcessResult Interpreter::run_process(Process *process)
             // Fast path: double + double
             if (a.isDouble() && b.isDouble())
             {
+                QUICKEN(OP_ADD, OP_ADD_DOUBLE);
                 PUSH(makeDouble(a.asDouble() + b.asDouble()));
                 break;
             }
 
+            if (!(a.isNumber() && b.isNumber()))
+                WORKER_HANDOFF(2);
+
             // ---------------------------------------------------------
             // 1. CONCATENAÇÃO (String à Esquerda)
             // Ex: "Pontos: " + 100
@@ -548,6 +656,7 @@ ProcessResult Interpreter::run_process(Process *process)
             // Fast path: int - int (fib, loops)
             if (LIKELY(a.isInt() && b.isInt()))
             {
+                QUICKEN(OP_SUBTRACT, OP_SUBTRACT_INT);
                 PUSH(makeInt(a.asInt() - b.asInt()));
                 break;
             }
@@ -555,6 +664,7 @@ ProcessResult Interpreter::run_process(Process *process)
             // Fast path: double - double
             if (a.isDouble() && b.isDouble())
             {
+                QUICKEN(OP_SUBTRACT, OP_SUBTRACT_DOUBLE);
                 PUSH(makeDouble(a.asDouble() - b.asDouble()));
                 break;
             }
@@ -586,6 +696,7 @@ ProcessResult Interpreter::run_process(Process *process)
             }
             
 
+            WORKER_HANDOFF(2);
             TRY_OPERATOR_OVERLOAD(OP_SUB_METHOD, "-");
             THROW_RUNTIME_ERROR("Cannot apply '-' to %s and %s", getValueTypeName(a), getValueTypeName(b));
             break;
@@ -620,6 +731,7 @@ ProcessResult Interpreter::run_process(Process *process)
                 break;
             }
 
+            WORKER_HANDOFF(2);
             TRY_OPERATOR_OVERLOAD(OP_MUL_METHOD, "*");
             THROW_RUNTIME_ERROR("Cannot apply '*' to %s and %s", getValueTypeName(a), getValueTypeName(b));
             break;
@@ -636,6 +748,7 @@ ProcessResult Interpreter::run_process(Process *process)
 #define THROW_DIV_ZERO()                                             \
     do                                                               \
     {                                                                \
+        WORKER_HANDOFF(2);                                           \
         STORE_FRAME();                                               \
         Value error = makeString("Division by zero");                \
         if (throwException(error))                                   \
@@ -711,6 +824,7 @@ ProcessResult Interpreter::run_process(Process *process)
             }   
             
 
+            WORKER_HANDOFF(2);
             TRY_OPERATOR_OVERLOAD(OP_DIV_METHOD, "/");
             THROW_RUNTIME_ERROR("Cannot apply '/' to %s and %s", getValueTypeName(a), getValueTypeName(b));
 
@@ -733,6 +847,7 @@ ProcessResult Interpreter::run_process(Process *process)
                 int ib = b.asInt();
                 if (UNLIKELY(ib == 0))
                 {
+                    WORKER_HANDOFF(2);
                     STORE_FRAME();
                     Value error = makeString("Modulo by zero");
                     if (throwException(error)) { LOAD_FRAME(); break; }
@@ -750,6 +865,7 @@ ProcessResult Interpreter::run_process(Process *process)
 
             if (!a.isNumber() || !b.isNumber())
             {
+                WORKER_HANDOFF(2);
                 TRY_OPERATOR_OVERLOAD(OP_MOD_METHOD, "%");
                 THROW_RUNTIME_ERROR("Cannot apply '%%' to %s and %s", getValueTypeName(a), getValueTypeName(b));
             }
@@ -759,6 +875,7 @@ ProcessResult Interpreter::run_process(Process *process)
                 double db = b.asDouble();
                 if (db == 0.0)
                 {
+                    WORKER_HANDOFF(2);
                     STORE_FRAME();
                     Value error = makeString("Modulo by zero");
                     if (throwException(error)) { LOAD_FRAME(); break; }
@@ -788,6 +905,7 @@ ProcessResult Interpreter::run_process(Process *process)
                 PUSH(makeFloat(-a.asFloat()));
             else
             {
+                WORKER_HANDOFF(1);
                 THROW_RUNTIME_ERROR("Operand 'NEGATE' must be a number");
             }
             break;
@@ -852,6 +970,7 @@ ProcessResult Interpreter::run_process(Process *process)
             }
             else
             {
+                WORKER_HANDOFF(2);
                 TRY_OPERATOR_OVERLOAD(OP_GT_METHOD, ">");
                 THROW_RUNTIME_ERROR("Operands '>' must be numbers or strings");
             }
@@ -877,6 +996,7 @@ ProcessResult Interpreter::run_process(Process *process)
             }
             else
             {
+                WORKER_HANDOFF(2);
                 TRY_OPERATOR_OVERLOAD(OP_GTE_METHOD, ">=");
                 THROW_RUNTIME_ERROR("Operands '>=' must be numbers or strings");
             }
@@ -888,12 +1008,15 @@ ProcessResult Interpreter::run_process(Process *process)
             BINARY_OP_PREP();
             if (LIKELY(a.isInt() && b.isInt()))
             {
+                QUICKEN(OP_LESS, OP_LESS_INT);
                 PUSH(makeBool(a.asInt() < b.asInt()));
                 break;
             }
             double da, db;
             if (LIKELY(toNumberPair(a, b, da, db)))
             {
+                if (a.isDouble() && b.isDouble())
+                    QUICKEN(OP_LESS, OP_LESS_DOUBLE);
                 PUSH(makeBool(da < db));
             }
             else if (a.isString() && b.isString())
@@ -902,6 +1025,7 @@ ProcessResult Interpreter::run_process(Process *process)
             }
             else
             {
+                WORKER_HANDOFF(2);
                 TRY_OPERATOR_OVERLOAD(OP_LT_METHOD, "<");
                 THROW_RUNTIME_ERROR("Operands '<' must be numbers or strings");
             }
@@ -927,6 +1051,7 @@ ProcessResult Interpreter::run_process(Process *process)
             }
             else
             {
+                WORKER_HANDOFF(2);
                 TRY_OPERATOR_OVERLOAD(OP_LTE_METHOD, "<=");
                 THROW_RUNTIME_ERROR("Operands '<=' must be numbers or strings");
             }
@@ -1064,6 +1189,7 @@ ProcessResult Interpreter::run_process(Process *process)
 
             uint16 offset = READ_SHORT();
             ip -= offset;
+            JIT_HOT_ENTRY();
 
             break;
         }
@@ -1149,52 +1275,17 @@ ProcessResult Interpreter::run_process(Process *process)
                     return {ProcessResult::PROCESS_DONE, 0};
                 }
 
-                // SPAWN - clona blueprint
-                Process *instance = spawnProcess(blueprint);
-
-                // Se tem argumentos, inicializa locals da fiber
-                if (argCount > 0)
+                // SPAWN - entry frame do blueprint + args direto da stack
+                Process *instance = spawnWithArgs(blueprint, fiber->stackTop - argCount, argCount,
+                                                  makeProcessInstance(process));
+                if (!instance)
                 {
-                    ProcessExec *procFiber = instance;
-                    int localSlot = 0;
-
-                    for (int i = 0; i < argCount; i++)
-                    {
-                        Value arg = fiber->stackTop[-(argCount - i)];
-
-                        if (i < (int)blueprint->argsNames.size() && blueprint->argsNames[i] != 255)
-                        {
-                            // Arg mapeia para um private (x, y, etc.) - copia direto
-                            instance->privates[blueprint->argsNames[i]] = arg;
-                        }
-                        else
-                        {
-                            // Arg é um local normal
-                            procFiber->stack[localSlot] = arg;
-                            localSlot++;
-                        }
-                    }
-
-                    procFiber->stackTop = procFiber->stack + localSlot;
+                    return {ProcessResult::PROCESS_DONE, 0};
                 }
 
                 // Remove callee + args da stack atual
                 fiber->stackTop -= (argCount + 1);
 
-                // if (process->id == 0)
-                // {
-                // }
-
-              // Info("Spawned process %d from blueprint '%d'", instance->id, process->id);
-
-                instance->privates[(int)PrivateIndex::ID] = makeInt(instance->id);
-                instance->privates[(int)PrivateIndex::FATHER] = makeProcessInstance(process);
-
-                 if (hooks.onCreate)
-                 {
-                     hooks.onCreate(this,instance);
-                 }
-
                 // Push process instance directly
                 PUSH(makeProcessInstance(instance));
             }
@@ -1210,20 +1301,13 @@ ProcessResult Interpreter::run_process(Process *process)
                     return {ProcessResult::PROCESS_DONE, 0};
                 }
 
-                Value value = makeStructInstance();
+                Value value = makeStructInstance(def);
                 StructInstance *instance = value.as.sInstance;
-                instance->marked = 0;
-                instance->def = def;
 
-                instance->values.reserve(def->argCount);
                 Value *args = fiber->stackTop - argCount;
                 for (int i = 0; i < argCount; i++)
                 {
-                    instance->values.push(args[i]);
-                }
-                for (int i = argCount; i < def->argCount; i++)
-                {
-                    instance->values.push(makeNil());
+                    instance->values[i] = args[i];
                 }
                 fiber->stackTop -= (argCount + 1);
                 PUSH(value);
@@ -1234,23 +1318,8 @@ ProcessResult Interpreter::run_process(Process *process)
                 int classId = callee.asClassId();
                 ClassDef *klass = classes[classId];
 
-                Value value = makeClassInstance();
+                Value value = makeClassInstance(klass);
                 ClassInstance *instance = value.asClassInstance();
-                instance->klass = klass;
-                instance->fields.reserve(klass->fieldCount);
-
-                // Inicializa fields com valores default ou nil
-                for (int i = 0; i < klass->fieldCount; i++)
-                {
-                    if (i < (int)klass->fieldDefaults.size() && !klass->fieldDefaults[i].isNil())
-                    {
-                        instance->fields.push(klass->fieldDefaults[i]);
-                    }
-                    else
-                    {
-                        instance->fields.push(makeNil());
-                    }
-                }
 
                 // Verifica se há NativeClass na cadeia de herança (direta ou indireta)
                 NativeClassDef *nativeKlass = instance->getNativeSuperclass();
@@ -1265,7 +1334,7 @@ ProcessResult Interpreter::run_process(Process *process)
                     else
                     {
                         // Sem constructor, aloca buffer genérico
-                        instance->nativeUserData = arena.Allocate(128);
+                        instance->nativeUserData = arena.Allocate(128, (uint8)GCObjectType::CLASS);
                         std::memset(instance->nativeUserData, 0, 128);
                     }
                 }
@@ -1329,7 +1398,7 @@ ProcessResult Interpreter::run_process(Process *process)
                 int structId = callee.asNativeStructId();
                 NativeStructDef *def = nativeStructs[structId];
 
-                void *data = arena.Allocate(def->structSize);
+                void *data = arena.Allocate(def->structSize, (uint8)GCObjectType::NATIVE_STRUCT);
                 std::memset(data, 0, def->structSize);
                 if (def->constructor)
                 {
@@ -1431,11 +1500,13 @@ ProcessResult Interpreter::run_process(Process *process)
             }
 
             LOAD_FRAME();
+            JIT_HOT_ENTRY();
             break;
         }
 
         case OP_RETURN:
         {
+            WORKER_HANDOFF(0); // upvalues / C++ call boundary are shared state
 
             Value result = POP();
 
@@ -1816,7 +1887,7 @@ ProcessResult Interpreter::run_process(Process *process)
                 if (privateIdx != -1)
                 {
                     DROP();
-                    PUSH(proc->privates[privateIdx]);
+                    PUSH(proc->priv(privateIdx));
                 }
                 else
                 {
@@ -2029,7 +2100,7 @@ ProcessResult Interpreter::run_process(Process *process)
                         runtimeError("Property '%s' is readonly", name);
                         return {ProcessResult::PROCESS_DONE, 0};
                     }
-                    proc->privates[privateIdx] = value;
+                    proc->priv(privateIdx) = value;
                     DROP();
                     DROP();
                     PUSH(value);
@@ -2650,10 +2721,8 @@ ProcessResult Interpreter::run_process(Process *process)
                         ptr->values.reserve(strLen);
                         for (int i = 0; i < strLen; i++)
                         {
-                            // Cria string de 1 char
-                            char buf[2] = {strChars[i], '\0'};
-
-                            ptr->values.push(makeString(createString(buf, 1)));
+                            // Strings de 1 char vem da cache do pool
+                            ptr->values.push(makeString(stringPool.fromChar((unsigned char)strChars[i])));
                         }
                     }
                     else
@@ -3387,7 +3456,7 @@ ProcessResult Interpreter::run_process(Process *process)
                         return {ProcessResult::PROCESS_DONE, 0};
                     }
                     Value val = PEEK();
-                    set->table.insert(val);
+                    set->table.insert(mapKey(val));
                     ARGS_CLEANUP();
                     PUSH(receiver);
                     break;
@@ -3547,6 +3616,13 @@ ProcessResult Interpreter::run_process(Process *process)
                     fiber->stackTop = dest + 1;
                 }
 
+                if (UNLIKELY(nativeYield_))
+                {
+                    nativeYield_ = false;
+                    STORE_FRAME();
+                    return {ProcessResult::PROCESS_WAIT, 0};
+                }
+
                 break;
             }
 
@@ -4573,7 +4649,7 @@ ProcessResult Interpreter::run_process(Process *process)
                 Value value = POP();
                 Value key = POP();
 
-                inst->table.set(key, value);
+                inst->table.set(mapKey(key), value);
             }
 
             PUSH(map);
@@ -4589,7 +4665,7 @@ ProcessResult Interpreter::run_process(Process *process)
             for (int i = 0; i < count; i++)
             {
                 Value val = POP();
-                inst->table.insert(val);
+                inst->table.insert(mapKey(val));
             }
 
             PUSH(set);
@@ -4635,7 +4711,7 @@ ProcessResult Interpreter::run_process(Process *process)
             case ValueType::MAP:
             {
                 MapInstance *map = container.asMap();
-                map->table.set(index, value);
+                map->table.set(mapKey(index), value);
                 PUSH(value);
                 break;
             }
@@ -4694,6 +4770,32 @@ ProcessResult Interpreter::run_process(Process *process)
                 break;
             }
 
+            case ValueType::NATIVECLASSINSTANCE:
+            {
+                NativeClassInstance *inst = container.asNativeClassInstance();
+                if (!inst->klass->typedArray)
+                {
+                    runtimeError("Cannot index assign this type");
+                    return {ProcessResult::ERROR, 0};
+                }
+                if (!index.isNumber() || !value.isNumber())
+                {
+                    runtimeError("Typed array index and value must be numbers");
+                    return {ProcessResult::ERROR, 0};
+                }
+
+                TypedArrayData *ta = (TypedArrayData *)inst->userData;
+                int i = index.isInt() ? index.asInt() : (int)index.asNumber();
+                if (i < 0 || i >= ta->count)
+                {
+                    runtimeError("Typed array index %d out of bounds (size=%d)", i, ta->count);
+                    return {ProcessResult::ERROR, 0};
+                }
+                typedArrayStore(ta, i, value);
+                PUSH(value);
+                break;
+            }
+
             case ValueType::STRING:
             {
                 runtimeError("Strings are immutable");
@@ -4723,6 +4825,9 @@ ProcessResult Interpreter::run_process(Process *process)
                     return {ProcessResult::ERROR, 0};
                 }
 
+                if (index.isInt())
+                    QUICKEN(OP_GET_INDEX, OP_GET_INDEX_ARRAY);
+
                 ArrayInstance *arr = container.asArray();
                 int i = (int)index.asNumber();
                 uint32 size = arr->values.size();
@@ -4742,6 +4847,31 @@ ProcessResult Interpreter::run_process(Process *process)
                 break;
             }
 
+            case ValueType::NATIVECLASSINSTANCE:
+            {
+                NativeClassInstance *inst = container.asNativeClassInstance();
+                if (!inst->klass->typedArray)
+                {
+                    runtimeError("Cannot index this type");
+                    return {ProcessResult::ERROR, 0};
+                }
+                if (!index.isNumber())
+                {
+                    runtimeError("Typed array index must be a number");
+                    return {ProcessResult::ERROR, 0};
+                }
+
+                TypedArrayData *ta = (TypedArrayData *)inst->userData;
+                int i = index.isInt() ? index.asInt() : (int)index.asNumber();
+                if (i < 0 || i >= ta->count)
+                {
+                    runtimeError("Typed array index %d out of bounds (size=%d)", i, ta->count);
+                    return {ProcessResult::ERROR, 0};
+                }
+                PUSH(typedArrayLoad(ta, i));
+                break;
+            }
+
             case ValueType::STRING:
             {
                 if (!index.isInt())
@@ -5514,19 +5644,24 @@ ProcessResult Interpreter::run_process(Process *process)
             Value funcVal = READ_CONSTANT();
             int funcID = funcVal.asFunctionId();
             Function *function = functions[funcID];
-            Value closure = makeClosure();
+            Value closure = makeClosure(function->upvalueCount);
             Closure *closurePtr = closure.as.closure;
             closurePtr->functionId = funcID;
-            closurePtr->upvalueCount = function->upvalueCount;
 
-            closurePtr->upvalues.clear();
+            // Na stack antes de criar upvalues: createUpvalue() pode correr o GC
+            PUSH(closure);
 
             for (int i = 0; i < function->upvalueCount; i++)
             {
-                uint8 isLocal = READ_BYTE();
+                uint8 flags = READ_BYTE();
                 uint8 index = READ_BYTE();
 
-                if (isLocal)
+                if (flags == (UPVALUE_LOCAL | UPVALUE_BY_VALUE))
+                {
+                    // Nunca reatribuida: copia, sem Upvalue nem procura em openUpvalues
+                    closurePtr->captured()[i] = stackStart[index];
+                }
+                else if (flags & UPVALUE_LOCAL)
                 {
                     Value *local = &stackStart[index];
 
@@ -5542,7 +5677,7 @@ ProcessResult Interpreter::run_process(Process *process)
 
                     if (upvalue != nullptr && upvalue->location == local)
                     {
-                        closurePtr->upvalues.push(upvalue);
+                        closurePtr->upvalues[i] = upvalue;
                     }
                     else
                     {
@@ -5558,7 +5693,7 @@ ProcessResult Interpreter::run_process(Process *process)
                             prev->nextOpen = created;
                         }
 
-                        closurePtr->upvalues.push(created);
+                        closurePtr->upvalues[i] = created;
                     }
                 }
                 else
@@ -5573,11 +5708,18 @@ ProcessResult Interpreter::run_process(Process *process)
                         runtimeError("Upvalue capture index %d out of range (max %d)", index, frame->closure->upvalueCount);
                         return {ProcessResult::PROCESS_DONE, 0};
                     }
-                    closurePtr->upvalues.push(frame->closure->upvalues[index]);
+                    Upvalue *shared = frame->closure->upvalues[index];
+                    if ((flags & UPVALUE_BY_VALUE) && shared)
+                    {
+                        closurePtr->captured()[i] = *shared->location;
+                    }
+                    else
+                    {
+                        closurePtr->upvalues[i] = shared;
+                        closurePtr->captured()[i] = frame->closure->captured()[index];
+                    }
                 }
             }
-
-            PUSH(closure);
             break;
         }
 
@@ -5597,7 +5739,8 @@ ProcessResult Interpreter::run_process(Process *process)
                 return {ProcessResult::PROCESS_DONE, 0};
             }
 
-            PUSH(*frame->closure->upvalues[slot]->location);
+            Upvalue *upvalue = frame->closure->upvalues[slot];
+            PUSH(upvalue ? *upvalue->location : frame->closure->captured()[slot]);
             break;
         }
 
@@ -5617,7 +5760,12 @@ ProcessResult Interpreter::run_process(Process *process)
                 return {ProcessResult::PROCESS_DONE, 0};
             }
 
-            *frame->closure->upvalues[slot]->location = PEEK();
+            // O compilador so emite SET para upvalues partilhados
+            Upvalue *upvalue = frame->closure->upvalues[slot];
+            if (upvalue)
+                *upvalue->location = PEEK();
+            else
+                frame->closure->captured()[slot] = PEEK();
             break;
         }
 
@@ -5733,6 +5881,114 @@ ProcessResult Interpreter::run_process(Process *process)
             break;
         }
 
+        // ============================================
+        // QUICKENED OPCODES
+        // Operands are only peeked until the guard passes; on a guard
+        // failure the site is rewritten back to the generic opcode and the
+        // generic handler runs with the stack untouched.
+        // ============================================
+        case OP_ADD_INT:
+        {
+            Value &a = fiber->stackTop[-2];
+            const Value &b = fiber->stackTop[-1];
+            if (LIKELY(a.isInt() && b.isInt()))
+            {
+                a.as.integer += b.as.integer;
+                DROP();
+                break;
+            }
+            DEQUICKEN(OP_ADD_INT, OP_ADD);
+        }
+
+        case OP_ADD_DOUBLE:
+        {
+            Value &a = fiber->stackTop[-2];
+            const Value &b = fiber->stackTop[-1];
+            if (LIKELY(a.isDouble() && b.isDouble()))
+            {
+                a.as.number += b.as.number;
+                DROP();
+                break;
+            }
+            DEQUICKEN(OP_ADD_DOUBLE, OP_ADD);
+        }
+
+        case OP_SUBTRACT_INT:
+        {
+            Value &a = fiber->stackTop[-2];
+            const Value &b = fiber->stackTop[-1];
+            if (LIKELY(a.isInt() && b.isInt()))
+            {
+                a.as.integer -= b.as.integer;
+                DROP();
+                break;
+            }
+            DEQUICKEN(OP_SUBTRACT_INT, OP_SUBTRACT);
+        }
+
+        case OP_SUBTRACT_DOUBLE:
+        {
+            Value &a = fiber->stackTop[-2];
+            const Value &b = fiber->stackTop[-1];
+            if (LIKELY(a.isDouble() && b.isDouble()))
+            {
+                a.as.number -= b.as.number;
+                DROP();
+                break;
+            }
+            DEQUICKEN(OP_SUBTRACT_DOUBLE, OP_SUBTRACT);
+        }
+
+        case OP_LESS_INT:
+        {
+            Value &a = fiber->stackTop[-2];
+            const Value &b = fiber->stackTop[-1];
+            if (LIKELY(a.isInt() && b.isInt()))
+            {
+                a = makeBool(a.as.integer < b.as.integer);
+                DROP();
+                break;
+            }
+            DEQUICKEN(OP_LESS_INT, OP_LESS);
+        }
+
+        case OP_LESS_DOUBLE:
+        {
+            Value &a = fiber->stackTop[-2];
+            const Value &b = fiber->stackTop[-1];
+            if (LIKELY(a.isDouble() && b.isDouble()))
+            {
+                a = makeBool(a.as.number < b.as.number);
+                DROP();
+                break;
+            }
+            DEQUICKEN(OP_LESS_DOUBLE, OP_LESS);
+        }
+
+        case OP_GET_INDEX_ARRAY:
+        {
+            Value &container = fiber->stackTop[-2];
+            const Value &index = fiber->stackTop[-1];
+            if (LIKELY(container.isArray() && index.isInt()))
+            {
+                ArrayInstance *arr = container.asArray();
+                int i = index.as.integer;
+                uint32 size = arr->values.size();
+                if (i < 0)
+                    i += size;
+                if (LIKELY(i >= 0 && (uint32)i < size))
+                {
+                    container = arr->values[i];
+                    DROP();
+                    break;
+                }
+                // Out of bounds: the generic handler reports the error
+                instruction = OP_GET_INDEX;
+                goto redispatch_instruction;
+            }
+            DEQUICKEN(OP_GET_INDEX_ARRAY, OP_GET_INDEX);
+        }
+
         default:
         {
             if (debugMode_)
@@ -5747,6 +6003,12 @@ ProcessResult Interpreter::run_process(Process *process)
 
 #undef READ_BYTE
 #undef READ_SHORT
+#undef REWRITE_OPCODE
+#undef QUICKEN
+#undef DEQUICKEN
+#undef JIT_HOT_ENTRY
+#undef WORKER_HANDOFF
+#undef ON_WORKER
 }
 
 #endif // !USE_COMPUTED_GOTO
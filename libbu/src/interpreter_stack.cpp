@@ -662,26 +662,7 @@ Process *Interpreter::callProcess(ProcessDef *proc, int argCount)
     // Se tem argumentos, inicializa
     if (argCount > 0)
     {
-        ProcessExec *procFiber = instance;
-        int localSlot = 0;
-
-        for (int i = 0; i < argCount; i++)
-        {
-            Value arg = currentExec()->stackTop[-argCount + i];
-
-            if (i < (int)proc->argsNames.size() && proc->argsNames[i] != 255)
-            {
-                // Arg mapeia para um private (x, y, etc.) - copia direto
-                instance->privates[proc->argsNames[i]] = arg;
-            }
-            else
-            {
-                // Arg é um local normal
-                procFiber->stack[localSlot] = arg;
-                localSlot++;
-            }
-        }
-        procFiber->stackTop = procFiber->stack + localSlot;
+        bindProcessArgs(instance, proc, currentExec()->stackTop - argCount, argCount);
 
         // Remove args da stack atual
         currentExec()->stackTop -= argCount;
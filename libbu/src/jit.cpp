@@ -0,0 +1,887 @@
+#include "jit.hpp"
+#include "interpreter.hpp"
+#include "opcode.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#if BU_ENABLE_JIT
+#include <sys/mman.h>
+#endif
+
+// ============================================
+// Baseline JIT
+//
+// Layout of the generated code (rbx = JitState* everywhere):
+//
+//   entry:    push rbx ; mov rbx, rdi ; jmp rsi      (rsi = block to start at)
+//   block[i]: one per bytecode instruction
+//             - stack moves (GET/SET_LOCAL, CONSTANT, ...) are inlined
+//             - everything else calls a helper `int h(JitState*, uint32)`
+//               which returns 0 to continue, non-zero to bail out
+//             - unsupported opcodes just exit with pc = their offset
+//   bails:    mov dword [rbx+pc], offset ; jmp exit
+//   exit:     pop rbx ; ret
+//
+// Helpers only take the fast paths that can't allocate or throw, and check
+// types before touching the stack, so a bail leaves the VM exactly as it was
+// before the instruction and the interpreter simply re-executes it.
+// ============================================
+
+void jitFreeCode(JitCode *code)
+{
+    if (!code)
+        return;
+#if BU_ENABLE_JIT
+    if (code->mem)
+        munmap(code->mem, code->size);
+#endif
+    delete[] code->entries;
+    delete code;
+}
+
+#if BU_ENABLE_JIT
+
+static_assert(sizeof(Value) == 16, "JIT stack moves assume 16-byte Values");
+
+namespace
+{
+
+    // ========== VALUE HELPERS ==========
+
+    FORCE_INLINE void setInt(Value &v, int i)
+    {
+        v.type = ValueType::INT;
+        v.as.integer = i;
+    }
+
+    FORCE_INLINE void setDouble(Value &v, double d)
+    {
+        v.type = ValueType::DOUBLE;
+        v.as.number = d;
+    }
+
+    FORCE_INLINE void setBool(Value &v, bool b)
+    {
+        v.type = ValueType::BOOL;
+        v.as.boolean = b;
+    }
+
+    FORCE_INLINE double numberOf(const Value &v)
+    {
+        return v.isInt() ? (double)v.asInt() : v.asDouble();
+    }
+
+    // ========== RUNTIME HELPERS ==========
+    // Mirror the interpreter fast paths exactly; return 1 to bail.
+
+    int jitNil(JitState *s, uint32)
+    {
+        Value &dst = *s->stackTop++;
+        dst.type = ValueType::NIL;
+        return 0;
+    }
+
+    int jitTrue(JitState *s, uint32)
+    {
+        setBool(*s->stackTop++, true);
+        return 0;
+    }
+
+    int jitFalse(JitState *s, uint32)
+    {
+        setBool(*s->stackTop++, false);
+        return 0;
+    }
+
+    int jitAdd(JitState *s, uint32)
+    {
+        Value &a = s->stackTop[-2];
+        const Value &b = s->stackTop[-1];
+        if (a.isInt() && b.isInt())
+            setInt(a, a.asInt() + b.asInt());
+        else if (a.isDouble() && b.isDouble())
+            setDouble(a, a.asDouble() + b.asDouble());
+        else
+            return 1;
+        s->stackTop--;
+        return 0;
+    }
+
+    int jitSubtract(JitState *s, uint32)
+    {
+        Value &a = s->stackTop[-2];
+        const Value &b = s->stackTop[-1];
+        if (a.isInt() && b.isInt())
+            setInt(a, a.asInt() - b.asInt());
+        else if (a.isDouble() && b.isDouble())
+            setDouble(a, a.asDouble() - b.asDouble());
+        else
+            return 1;
+        s->stackTop--;
+        return 0;
+    }
+
+    int jitMultiply(JitState *s, uint32)
+    {
+        Value &a = s->stackTop[-2];
+        const Value &b = s->stackTop[-1];
+        if (a.isInt() && b.isInt())
+            setInt(a, a.asInt() * b.asInt());
+        else if (a.isDouble() && b.isDouble())
+            setDouble(a, a.asDouble() * b.asDouble());
+        else
+            return 1;
+        s->stackTop--;
+        return 0;
+    }
+
+    int jitDivide(JitState *s, uint32)
+    {
+        Value &a = s->stackTop[-2];
+        const Value &b = s->stackTop[-1];
+        if (a.isInt() && b.isInt())
+        {
+            int ia = a.asInt();
+            int ib = b.asInt();
+            if (ib == 0 || (ia == INT32_MIN && ib == -1))
+                return 1;
+            if (ia % ib == 0)
+                setInt(a, ia / ib);
+            else
+                setDouble(a, (double)ia / ib);
+        }
+        else if (a.isDouble() && b.isDouble())
+        {
+            double db = b.asDouble();
+            if (db == 0.0)
+                return 1;
+            setDouble(a, a.asDouble() / db);
+        }
+        else
+            return 1;
+        s->stackTop--;
+        return 0;
+    }
+
+    int jitModulo(JitState *s, uint32)
+    {
+        Value &a = s->stackTop[-2];
+        const Value &b = s->stackTop[-1];
+        if (!a.isInt() || !b.isInt())
+            return 1;
+        int ia = a.asInt();
+        int ib = b.asInt();
+        if (ib == 0)
+            return 1;
+        setInt(a, (ia == INT32_MIN && ib == -1) ? 0 : ia % ib);
+        s->stackTop--;
+        return 0;
+    }
+
+    int jitNegate(JitState *s, uint32)
+    {
+        Value &a = s->stackTop[-1];
+        if (a.isInt())
+            setInt(a, -a.asInt());
+        else if (a.isDouble())
+            setDouble(a, -a.asDouble());
+        else
+            return 1;
+        return 0;
+    }
+
+    int jitNot(JitState *s, uint32)
+    {
+        Value &a = s->stackTop[-1];
+        setBool(a, !isTruthy(a));
+        return 0;
+    }
+
+#define JIT_INT_BINARY(_name, _expr)                      \
+    int _name(JitState *s, uint32)                        \
+    {                                                     \
+        Value &a = s->stackTop[-2];                       \
+        const Value &b = s->stackTop[-1];                 \
+        if (!a.isInt() || !b.isInt())                     \
+            return 1;                                     \
+        int ia = a.asInt();                               \
+        int ib = b.asInt();                               \
+        _expr;                                            \
+        s->stackTop--;                                    \
+        return 0;                                         \
+    }
+
+    JIT_INT_BINARY(jitEqual, setBool(a, ia == ib))
+    JIT_INT_BINARY(jitNotEqual, setBool(a, ia != ib))
+    JIT_INT_BINARY(jitBitAnd, setInt(a, ia & ib))
+    JIT_INT_BINARY(jitBitOr, setInt(a, ia | ib))
+    JIT_INT_BINARY(jitBitXor, setInt(a, ia ^ ib))
+    JIT_INT_BINARY(jitShiftLeft, setInt(a, ia << (ib & 31)))
+    JIT_INT_BINARY(jitShiftRight, setInt(a, ia >> (ib & 31)))
+
+#undef JIT_INT_BINARY
+
+#define JIT_COMPARE(_name, _op)                                    \
+    int _name(JitState *s, uint32)                                 \
+    {                                                              \
+        Value &a = s->stackTop[-2];                                \
+        const Value &b = s->stackTop[-1];                          \
+        if (a.isInt() && b.isInt())                                \
+            setBool(a, a.asInt() _op b.asInt());                   \
+        else if (a.isDouble() && b.isDouble())                     \
+            setBool(a, a.asDouble() _op b.asDouble());             \
+        else                                                       \
+            return 1;                                              \
+        s->stackTop--;                                             \
+        return 0;                                                  \
+    }
+
+    JIT_COMPARE(jitGreater, >)
+    JIT_COMPARE(jitGreaterEqual, >=)
+    JIT_COMPARE(jitLess, <)
+    JIT_COMPARE(jitLessEqual, <=)
+
+#undef JIT_COMPARE
+
+    int jitBitNot(JitState *s, uint32)
+    {
+        Value &a = s->stackTop[-1];
+        if (!a.isInt())
+            return 1;
+        setInt(a, ~a.asInt());
+        return 0;
+    }
+
+    // Returns 1 when the jump must be taken (top is falsey); never pops.
+    int jitJumpIfFalse(JitState *s, uint32)
+    {
+        return isTruthy(s->stackTop[-1]) ? 0 : 1;
+    }
+
+    // Typed array (Float32Array, ...) behind a NativeClassInstance, or null
+    FORCE_INLINE TypedArrayData *typedArrayOf(const Value &v)
+    {
+        if (!v.isNativeClassInstance())
+            return nullptr;
+        NativeClassInstance *inst = v.asNativeClassInstance();
+        return inst->klass->typedArray ? (TypedArrayData *)inst->userData : nullptr;
+    }
+
+    int jitGetIndex(JitState *s, uint32)
+    {
+        Value &container = s->stackTop[-2];
+        const Value &index = s->stackTop[-1];
+        if (!index.isInt())
+            return 1;
+        int i = index.asInt();
+        if (container.isArray())
+        {
+            ArrayInstance *arr = container.asArray();
+            uint32 size = (uint32)arr->values.size();
+            if (i < 0)
+                i += size;
+            if (i < 0 || (uint32)i >= size)
+                return 1;
+            container = arr->values[i];
+        }
+        else if (TypedArrayData *ta = typedArrayOf(container))
+        {
+            if ((uint32)i >= (uint32)ta->count)
+                return 1;
+            container = typedArrayLoad(ta, i);
+        }
+        else
+            return 1;
+        s->stackTop--;
+        return 0;
+    }
+
+    // [container, index, value] -> [value]
+    int jitSetIndex(JitState *s, uint32)
+    {
+        const Value &container = s->stackTop[-3];
+        const Value &index = s->stackTop[-2];
+        const Value &value = s->stackTop[-1];
+        if (!index.isInt())
+            return 1;
+        int i = index.asInt();
+        if (container.isArray())
+        {
+            ArrayInstance *arr = container.asArray();
+            uint32 size = (uint32)arr->values.size();
+            if (i < 0)
+                i += size;
+            if (i < 0 || (uint32)i >= size)
+                return 1;
+            arr->values[i] = value;
+        }
+        else if (TypedArrayData *ta = typedArrayOf(container))
+        {
+            if ((uint32)i >= (uint32)ta->count || !value.isNumber())
+                return 1;
+            typedArrayStore(ta, i, value);
+        }
+        else
+            return 1;
+        s->stackTop[-3] = value;
+        s->stackTop -= 2;
+        return 0;
+    }
+
+    int jitGetLocalShared(JitState *s, uint32 slot)
+    {
+        const Value &value = s->slots[slot];
+        if (value.isString() && value.asString()->isOwned())
+            value.asString()->share();
+        *s->stackTop++ = value;
+        return 0;
+    }
+
+    int jitCopy2(JitState *s, uint32)
+    {
+        s->stackTop[0] = s->stackTop[-2];
+        s->stackTop[1] = s->stackTop[-1];
+        s->stackTop += 2;
+        return 0;
+    }
+
+    int jitSin(JitState *s, uint32)
+    {
+        Value &v = s->stackTop[-1];
+        if (!v.isInt() && !v.isDouble())
+            return 1;
+        setDouble(v, std::sin(numberOf(v)));
+        return 0;
+    }
+
+    int jitCos(JitState *s, uint32)
+    {
+        Value &v = s->stackTop[-1];
+        if (!v.isInt() && !v.isDouble())
+            return 1;
+        setDouble(v, std::cos(numberOf(v)));
+        return 0;
+    }
+
+    int jitSqrt(JitState *s, uint32)
+    {
+        Value &v = s->stackTop[-1];
+        if (!v.isInt() && !v.isDouble())
+            return 1;
+        double d = numberOf(v);
+        if (d < 0)
+            return 1;
+        setDouble(v, std::sqrt(d));
+        return 0;
+    }
+
+    int jitAbs(JitState *s, uint32)
+    {
+        Value &v = s->stackTop[-1];
+        if (v.isInt())
+            setInt(v, std::abs(v.asInt()));
+        else if (v.isDouble())
+            setDouble(v, std::abs(v.asDouble()));
+        else
+            return 1;
+        return 0;
+    }
+
+    int jitFloor(JitState *s, uint32)
+    {
+        Value &v = s->stackTop[-1];
+        if (v.isInt())
+            return 0;
+        if (!v.isDouble())
+            return 1;
+        setInt(v, (int)std::floor(v.asDouble()));
+        return 0;
+    }
+
+    typedef int (*JitHelper)(JitState *, uint32);
+
+    JitHelper helperFor(uint8 op)
+    {
+        switch (op)
+        {
+        case OP_NIL: return jitNil;
+        case OP_TRUE: return jitTrue;
+        case OP_FALSE: return jitFalse;
+        case OP_ADD:
+        case OP_ADD_INT:
+        case OP_ADD_DOUBLE:
+        case OP_APPEND_LOCAL: return jitAdd;
+        case OP_SUBTRACT:
+        case OP_SUBTRACT_INT:
+        case OP_SUBTRACT_DOUBLE: return jitSubtract;
+        case OP_MULTIPLY: return jitMultiply;
+        case OP_DIVIDE: return jitDivide;
+        case OP_MODULO: return jitModulo;
+        case OP_NEGATE: return jitNegate;
+        case OP_NOT: return jitNot;
+        case OP_BITWISE_AND: return jitBitAnd;
+        case OP_BITWISE_OR: return jitBitOr;
+        case OP_BITWISE_XOR: return jitBitXor;
+        case OP_BITWISE_NOT: return jitBitNot;
+        case OP_SHIFT_LEFT: return jitShiftLeft;
+        case OP_SHIFT_RIGHT: return jitShiftRight;
+        case OP_EQUAL: return jitEqual;
+        case OP_NOT_EQUAL: return jitNotEqual;
+        case OP_GREATER: return jitGreater;
+        case OP_GREATER_EQUAL: return jitGreaterEqual;
+        case OP_LESS:
+        case OP_LESS_INT:
+        case OP_LESS_DOUBLE: return jitLess;
+        case OP_LESS_EQUAL: return jitLessEqual;
+        case OP_GET_INDEX:
+        case OP_GET_INDEX_ARRAY: return jitGetIndex;
+        case OP_SET_INDEX: return jitSetIndex;
+        case OP_COPY2: return jitCopy2;
+        case OP_SIN: return jitSin;
+        case OP_COS: return jitCos;
+        case OP_SQRT: return jitSqrt;
+        case OP_ABS: return jitAbs;
+        case OP_FLOOR: return jitFloor;
+        default: return nullptr;
+        }
+    }
+
+    // Instruction length in bytes (0 = unknown opcode). Must match the
+    // operand reads in interpreter_runtime_*.cpp.
+    uint32 instructionLength(const Code *chunk, uint32 offset, const Vector<Function *> &functions)
+    {
+        switch (chunk->code[offset])
+        {
+        case OP_GET_LOCAL_SHARED:
+            return GET_LOCAL_SHARED_LENGTH;
+        case OP_GET_LOCAL:
+        case OP_SET_LOCAL:
+        case OP_GET_PRIVATE:
+        case OP_SET_PRIVATE:
+        case OP_CALL:
+        case OP_RETURN_N:
+        case OP_GET_UPVALUE:
+        case OP_SET_UPVALUE:
+        case OP_ARRAY_PUSH:
+        case OP_PRINT:
+        case OP_DISCARD:
+            return 2;
+        case OP_CONSTANT:
+        case OP_GET_GLOBAL:
+        case OP_SET_GLOBAL:
+        case OP_DEFINE_GLOBAL:
+        case OP_JUMP:
+        case OP_JUMP_IF_FALSE:
+        case OP_LOOP:
+        case OP_GOSUB:
+        case OP_DEFINE_ARRAY:
+        case OP_DEFINE_MAP:
+        case OP_DEFINE_SET:
+        case OP_GET_PROPERTY:
+        case OP_SET_PROPERTY:
+            return 3;
+        case OP_INVOKE:
+            return 4;
+        case OP_SUPER_INVOKE:
+        case OP_TRY:
+            return 5;
+        case OP_CLOSURE:
+        {
+            if (offset + 3 > chunk->count)
+                return 0;
+            uint16 idx = (uint16)((chunk->code[offset + 1] << 8) | chunk->code[offset + 2]);
+            if (idx >= chunk->constants.size())
+                return 0;
+            const Value &fv = chunk->constants[idx];
+            if (!fv.isFunction() || (size_t)fv.asFunctionId() >= functions.size() ||
+                !functions[fv.asFunctionId()])
+                return 0;
+            return 3 + 2 * (uint32)functions[fv.asFunctionId()]->upvalueCount;
+        }
+        case OP_BREAKPOINT:
+            return 0; // Original opcode lives in the debugger, not in the chunk
+        default:
+            return chunk->code[offset] <= OP_APPEND_LOCAL ? 1 : 0;
+        }
+    }
+
+    // ========== x86-64 EMITTER ==========
+
+    class Emitter
+    {
+    public:
+        std::vector<uint8> buf;
+
+        uint32 pos() const { return (uint32)buf.size(); }
+
+        void u8(uint8 b) { buf.push_back(b); }
+
+        void u32(uint32 v)
+        {
+            for (int i = 0; i < 4; i++)
+                u8((uint8)(v >> (i * 8)));
+        }
+
+        void u64(uint64_t v)
+        {
+            for (int i = 0; i < 8; i++)
+                u8((uint8)(v >> (i * 8)));
+        }
+
+        void patch32(uint32 at, int32 v)
+        {
+            for (int i = 0; i < 4; i++)
+                buf[at + i] = (uint8)((uint32)v >> (i * 8));
+        }
+
+        // mov rax|rcx, [rbx + disp8]
+        void loadRax(uint8 disp) { u8(0x48); u8(0x8B); u8(0x43); u8(disp); }
+        void loadRcx(uint8 disp) { u8(0x48); u8(0x8B); u8(0x4B); u8(disp); }
+
+        // add/sub qword [rbx + disp8], imm8
+        void addMem(uint8 disp, int8 imm) { u8(0x48); u8(0x83); u8(0x43); u8(disp); u8((uint8)imm); }
+        void subMem(uint8 disp, int8 imm) { u8(0x48); u8(0x83); u8(0x6B); u8(disp); u8((uint8)imm); }
+
+        // movups xmm0, [rax + disp32] / movups [rax + disp32], xmm0
+        void loadXmmRax(uint32 disp) { u8(0x0F); u8(0x10); u8(0x80); u32(disp); }
+        void storeXmmRax(uint32 disp) { u8(0x0F); u8(0x11); u8(0x80); u32(disp); }
+
+        // movups xmm0, [rcx - 16] / movups [rcx], xmm0
+        void loadXmmTop() { u8(0x0F); u8(0x10); u8(0x41); u8(0xF0); }
+        void storeXmmRcx() { u8(0x0F); u8(0x11); u8(0x01); }
+
+        // mov dword [rbx + disp8], imm32
+        void storeImm32(uint8 disp, uint32 v) { u8(0xC7); u8(0x43); u8(disp); u32(v); }
+
+        // mov rdi, rbx ; mov esi, imm32 ; mov rax, imm64 ; call rax
+        void callHelper(JitHelper fn, uint32 operand)
+        {
+            u8(0x48); u8(0x89); u8(0xDF);
+            u8(0xBE); u32(operand);
+            u8(0x48); u8(0xB8); u64((uint64_t)(uintptr_t)fn);
+            u8(0xFF); u8(0xD0);
+        }
+
+        // test eax, eax ; jnz rel32 — returns the patch position
+        uint32 jnzOnEax()
+        {
+            u8(0x85); u8(0xC0);
+            u8(0x0F); u8(0x85);
+            uint32 at = pos();
+            u32(0);
+            return at;
+        }
+
+        // jmp rel32 — returns the patch position
+        uint32 jmp()
+        {
+            u8(0xE9);
+            uint32 at = pos();
+            u32(0);
+            return at;
+        }
+    };
+
+    struct Fixup
+    {
+        uint32 at;     // posicao do rel32
+        uint32 target; // offset de bytecode (jumps) ou pc do bail
+    };
+
+    const uint8 OFF_TOP = (uint8)offsetof(JitState, stackTop);
+    const uint8 OFF_SLOTS = (uint8)offsetof(JitState, slots);
+    const uint8 OFF_GLOBALS = (uint8)offsetof(JitState, globals);
+    const uint8 OFF_PRIVATES = (uint8)offsetof(JitState, privates);
+    const uint8 OFF_COLUMNS = (uint8)offsetof(JitState, columns);
+    const uint8 OFF_CONSTANTS = (uint8)offsetof(JitState, constants);
+    const uint8 OFF_PC = (uint8)offsetof(JitState, pc);
+
+} // namespace
+
+bool Interpreter::jitCompile(Function *func)
+{
+    if (func->jit)
+        return true;
+    if (func->jitFailed || !func->chunk || func->chunk->count == 0)
+        return false;
+
+    const Code *chunk = func->chunk;
+    const uint32 count = (uint32)chunk->count;
+
+    // Pass 1: instruction boundaries
+    std::vector<uint32> starts;
+    std::vector<uint8> isStart(count, 0);
+    for (uint32 off = 0; off < count;)
+    {
+        uint32 len = instructionLength(chunk, off, functions);
+        if (len == 0 || off + len > count)
+        {
+            func->jitFailed = true;
+            func->hotCount = 0;
+            return false;
+        }
+        isStart[off] = 1;
+        starts.push_back(off);
+        off += len;
+    }
+
+    Emitter e;
+    std::vector<int32> label(count, -1);   // bloco nativo de cada instrucao
+    std::vector<uint8> enterable(count, 0); // instrucoes suportadas
+    std::vector<Fixup> jumps;
+    std::vector<Fixup> bails;
+    std::vector<uint32> exits;             // jmp rel32 -> epilogo
+    bool supportedAny = false;
+
+    // Prologue: push rbx ; mov rbx, rdi ; jmp rsi
+    e.u8(0x53);
+    e.u8(0x48); e.u8(0x89); e.u8(0xFB);
+    e.u8(0xFF); e.u8(0xE6);
+
+    auto exitAt = [&](uint32 pc)
+    {
+        e.storeImm32(OFF_PC, pc);
+        exits.push_back(e.jmp());
+    };
+
+    auto stackGet = [&](uint8 base, uint32 index)
+    {
+        e.loadRax(base);
+        e.loadRcx(OFF_TOP);
+        e.loadXmmRax(index * (uint32)sizeof(Value));
+        e.storeXmmRcx();
+        e.addMem(OFF_TOP, (int8)sizeof(Value));
+    };
+
+    auto stackSet = [&](uint8 base, uint32 index)
+    {
+        e.loadRcx(OFF_TOP);
+        e.loadXmmTop();
+        e.loadRax(base);
+        e.storeXmmRax(index * (uint32)sizeof(Value));
+    };
+
+    for (size_t n = 0; n < starts.size(); n++)
+    {
+        const uint32 off = starts[n];
+        const uint8 *ip = chunk->code + off;
+        const uint8 op = ip[0];
+        const uint32 next = off + instructionLength(chunk, off, functions);
+        label[off] = (int32)e.pos();
+        bool supported = true;
+
+        switch (op)
+        {
+        case OP_CONSTANT:
+            stackGet(OFF_CONSTANTS, (uint32)((ip[1] << 8) | ip[2]));
+            break;
+        case OP_GET_LOCAL:
+            stackGet(OFF_SLOTS, ip[1]);
+            break;
+        case OP_SET_LOCAL:
+            stackSet(OFF_SLOTS, ip[1]);
+            break;
+        case OP_GET_LOCAL_SHARED:
+        {
+            // o decode le o opcode seguinte: tem de existir dentro do chunk
+            assert(next == off + GET_LOCAL_SHARED_LENGTH && next < chunk->count);
+            const GetLocalShared read = decodeGetLocalShared(ip);
+            if (read.share)
+                e.callHelper(jitGetLocalShared, read.slot);
+            else
+                stackGet(OFF_SLOTS, read.slot);
+            break;
+        }
+        case OP_GET_GLOBAL:
+            stackGet(OFF_GLOBALS, (uint32)((ip[1] << 8) | ip[2]));
+            break;
+        case OP_SET_GLOBAL:
+            stackSet(OFF_GLOBALS, (uint32)((ip[1] << 8) | ip[2]));
+            break;
+        case OP_GET_PRIVATE:
+#if BU_ENABLE_PRIVATE_COLUMNS
+            if (ip[1] < PRIVATE_COLUMNS)
+            {
+                stackGet(OFF_COLUMNS, ip[1] * PRIVATE_BLOCK);
+                break;
+            }
+#endif
+            stackGet(OFF_PRIVATES, ip[1]);
+            break;
+        case OP_SET_PRIVATE:
+#if BU_ENABLE_PRIVATE_COLUMNS
+            if (ip[1] < PRIVATE_COLUMNS)
+            {
+                stackSet(OFF_COLUMNS, ip[1] * PRIVATE_BLOCK);
+                break;
+            }
+#endif
+            stackSet(OFF_PRIVATES, ip[1]);
+            break;
+        case OP_POP:
+            e.subMem(OFF_TOP, (int8)sizeof(Value));
+            break;
+        case OP_DUP:
+            e.loadRcx(OFF_TOP);
+            e.loadXmmTop();
+            e.storeXmmRcx();
+            e.addMem(OFF_TOP, (int8)sizeof(Value));
+            break;
+        case OP_JUMP:
+        {
+            uint32 target = next + (uint32)((ip[1] << 8) | ip[2]);
+            jumps.push_back({e.jmp(), target});
+            break;
+        }
+        case OP_LOOP:
+        {
+            uint32 offset = (uint32)((ip[1] << 8) | ip[2]);
+            if (offset > next)
+            {
+                func->jitFailed = true;
+                func->hotCount = 0;
+                return false;
+            }
+            jumps.push_back({e.jmp(), next - offset});
+            break;
+        }
+        case OP_JUMP_IF_FALSE:
+        {
+            uint32 target = next + (uint32)((ip[1] << 8) | ip[2]);
+            e.callHelper(jitJumpIfFalse, 0);
+            jumps.push_back({e.jnzOnEax(), target});
+            break;
+        }
+        default:
+        {
+            JitHelper fn = helperFor(op);
+            if (fn)
+            {
+                e.callHelper(fn, 0);
+                bails.push_back({e.jnzOnEax(), off});
+            }
+            else
+            {
+                supported = false;
+                exitAt(off);
+            }
+            break;
+        }
+        }
+
+        if (supported)
+        {
+            enterable[off] = 1;
+            supportedAny = true;
+            // Falling off the end of the chunk would resume at a bogus pc
+            if (next >= count && op != OP_JUMP && op != OP_LOOP)
+                exitAt(next);
+        }
+    }
+
+    if (!supportedAny)
+    {
+        func->jitFailed = true;
+        func->hotCount = 0;
+        return false;
+    }
+
+    // Bail stubs
+    for (const Fixup &b : bails)
+    {
+        e.patch32(b.at, (int32)(e.pos() - (b.at + 4)));
+        exitAt(b.target);
+    }
+
+    // Epilogue: pop rbx ; ret
+    const uint32 epilogue = e.pos();
+    e.u8(0x5B);
+    e.u8(0xC3);
+
+    for (uint32 at : exits)
+        e.patch32(at, (int32)(epilogue - (at + 4)));
+
+    for (const Fixup &j : jumps)
+    {
+        if (j.target >= count || !isStart[j.target])
+        {
+            func->jitFailed = true;
+            func->hotCount = 0;
+            return false;
+        }
+        e.patch32(j.at, (int32)((uint32)label[j.target] - (j.at + 4)));
+    }
+
+    size_t size = e.buf.size();
+    void *mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED)
+    {
+        func->jitFailed = true;
+        func->hotCount = 0;
+        return false;
+    }
+    std::memcpy(mem, e.buf.data(), size);
+    if (mprotect(mem, size, PROT_READ | PROT_EXEC) != 0)
+    {
+        munmap(mem, size);
+        func->jitFailed = true;
+        func->hotCount = 0;
+        return false;
+    }
+
+    JitCode *code = new JitCode();
+    code->mem = (uint8 *)mem;
+    code->size = size;
+    code->codeSize = count;
+    code->entries = new int32[count];
+    for (uint32 i = 0; i < count; i++)
+        code->entries[i] = enterable[i] ? label[i] : -1;
+
+    func->jit = code;
+    return true;
+}
+
+uint8 *Interpreter::jitRun(Function *func, ProcessExec *fiber, Process *process, Value *slots, uint8 *ip)
+{
+    JitCode *code = func->jit;
+    uint8 *base = func->chunk->code;
+    const uint8 *target = code->entryAt((uint32)(ip - base));
+    if (!target)
+        return ip;
+
+    JitState state;
+    state.stackTop = fiber->stackTop;
+    state.slots = slots;
+    state.globals = globalsArray.data();
+    state.privates = process->privates;
+#if BU_ENABLE_PRIVATE_COLUMNS
+    state.columns = process->columns;
+#else
+    state.columns = nullptr;
+#endif
+    state.constants = func->chunk->constants.data;
+    state.pc = 0;
+
+    ((JitEntryFn)code->mem)(&state, target);
+
+    fiber->stackTop = state.stackTop;
+    return base + state.pc;
+}
+
+#else
+
+bool Interpreter::jitCompile(Function *func)
+{
+    func->jitFailed = true;
+    return false;
+}
+
+uint8 *Interpreter::jitRun(Function *, ProcessExec *, Process *, Value *, uint8 *ip)
+{
+    return ip;
+}
+
+#endif
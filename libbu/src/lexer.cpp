@@ -3,6 +3,109 @@
 #include "utf8_utils.h"
 #include <cctype>
 #include <cstdio>
+#include <cstring>
+
+// ============================================
+// KEYWORDS - Perfect hash construído em compile time
+// hash = (c[0] | c[1] << 8 | c[n-1] << 16 | n << 24) * KEYWORD_HASH_MUL,
+// top KEYWORD_TABLE_BITS bits. O static_assert falha se uma keyword nova
+// colidir: basta escolher outro multiplicador ímpar.
+// ============================================
+
+namespace
+{
+struct Keyword
+{
+    const char *text;
+    TokenType type;
+};
+
+constexpr Keyword kKeywords[] = {
+    {"var", TOKEN_VAR}, {"def", TOKEN_DEF}, {"if", TOKEN_IF}, {"elif", TOKEN_ELIF},
+    {"else", TOKEN_ELSE}, {"while", TOKEN_WHILE}, {"for", TOKEN_FOR}, {"foreach", TOKEN_FOREACH},
+    {"in", TOKEN_IN}, {"return", TOKEN_RETURN}, {"break", TOKEN_BREAK}, {"continue", TOKEN_CONTINUE},
+    {"do", TOKEN_DO}, {"loop", TOKEN_LOOP}, {"switch", TOKEN_SWITCH}, {"case", TOKEN_CASE},
+    {"default", TOKEN_DEFAULT}, {"true", TOKEN_TRUE}, {"false", TOKEN_FALSE}, {"nil", TOKEN_NIL},
+    {"print", TOKEN_PRINT}, {"process", TOKEN_PROCESS}, {"type", TOKEN_TYPE}, {"frame", TOKEN_FRAME},
+    {"len", TOKEN_LEN}, {"free", TOKEN_FREE}, {"proc", TOKEN_PROC}, {"get_id", TOKEN_GET_ID},
+    {"exit", TOKEN_EXIT}, {"label", TOKEN_LABEL}, {"goto", TOKEN_GOTO}, {"gosub", TOKEN_GOSUB},
+    {"struct", TOKEN_STRUCT}, {"enum", TOKEN_ENUM}, {"class", TOKEN_CLASS}, {"self", TOKEN_SELF},
+    {"super", TOKEN_SUPER}, {"include", TOKEN_INCLUDE}, {"import", TOKEN_IMPORT}, {"using", TOKEN_USING},
+    {"require", TOKEN_REQUIRE}, {"try", TOKEN_TRY}, {"catch", TOKEN_CATCH}, {"finally", TOKEN_FINALLY},
+    {"throw", TOKEN_THROW}, {"sin", TOKEN_SIN}, {"cos", TOKEN_COS}, {"asin", TOKEN_ASIN},
+    {"acos", TOKEN_ACOS}, {"atan", TOKEN_ATAN}, {"atan2", TOKEN_ATAN2}, {"sqrt", TOKEN_SQRT},
+    {"pow", TOKEN_POW}, {"log", TOKEN_LOG}, {"abs", TOKEN_ABS}, {"floor", TOKEN_FLOOR},
+    {"ceil", TOKEN_CEIL}, {"deg", TOKEN_DEG}, {"rad", TOKEN_RAD}, {"tan", TOKEN_TAN},
+    {"exp", TOKEN_EXP}, {"clock", TOKEN_CLOCK},
+};
+
+constexpr int KEYWORD_COUNT = (int)(sizeof(kKeywords) / sizeof(kKeywords[0]));
+constexpr int KEYWORD_TABLE_BITS = 8;
+constexpr uint32_t KEYWORD_HASH_MUL = 0x1eee7281u;
+
+constexpr size_t keywordLength(const char *text)
+{
+    size_t n = 0;
+    while (text[n])
+        n++;
+    return n;
+}
+
+constexpr uint32_t keywordHash(const char *text, size_t len)
+{
+    return ((uint32_t)(uint8_t)text[0] |
+            ((uint32_t)(uint8_t)(len > 1 ? text[1] : 0) << 8) |
+            ((uint32_t)(uint8_t)text[len - 1] << 16) |
+            ((uint32_t)len << 24)) *
+               KEYWORD_HASH_MUL >>
+           (32 - KEYWORD_TABLE_BITS);
+}
+
+struct KeywordTable
+{
+    int8_t slot[1 << KEYWORD_TABLE_BITS];
+    uint8_t length[KEYWORD_COUNT];
+    size_t minLength;
+    size_t maxLength;
+    int collisions;
+};
+
+constexpr KeywordTable buildKeywordTable()
+{
+    KeywordTable table{};
+    table.minLength = 255;
+    for (int i = 0; i < (1 << KEYWORD_TABLE_BITS); i++)
+        table.slot[i] = -1;
+    for (int k = 0; k < KEYWORD_COUNT; k++)
+    {
+        size_t len = keywordLength(kKeywords[k].text);
+        uint32_t h = keywordHash(kKeywords[k].text, len);
+        if (table.slot[h] >= 0)
+            table.collisions++;
+        table.slot[h] = (int8_t)k;
+        table.length[k] = (uint8_t)len;
+        if (len < table.minLength)
+            table.minLength = len;
+        if (len > table.maxLength)
+            table.maxLength = len;
+    }
+    return table;
+}
+
+constexpr KeywordTable kKeywordTable = buildKeywordTable();
+static_assert(kKeywordTable.collisions == 0, "keyword perfect hash collision: change KEYWORD_HASH_MUL");
+
+TokenType lookupKeyword(const char *text, size_t len)
+{
+    if (len < kKeywordTable.minLength || len > kKeywordTable.maxLength)
+        return TOKEN_IDENTIFIER;
+    int k = kKeywordTable.slot[keywordHash(text, len)];
+    if (k < 0 || kKeywordTable.length[k] != len || std::memcmp(kKeywords[k].text, text, len) != 0)
+        return TOKEN_IDENTIFIER;
+    return kKeywords[k].type;
+}
+} // namespace
+
 
 Lexer::Lexer(const std::string &src)
     : source(src),
@@ -16,7 +119,6 @@ Lexer::Lexer(const std::string &src)
       pendingErrorLine(0),
       pendingErrorColumn(0)
 {
-    initKeywords();
 }
 
 Lexer::Lexer(const char *src, size_t len)
@@ -28,7 +130,6 @@ Lexer::Lexer(const char *src, size_t len)
       pendingErrorLine(0),
       pendingErrorColumn(0)
 {
-    initKeywords();
 }
 
 void Lexer::setPendingError(const std::string &message)
@@ -42,84 +143,6 @@ void Lexer::setPendingError(const std::string &message)
     }
 }
 
-void Lexer::initKeywords()
-{
-    keywords = {
-        {"var", TOKEN_VAR},
-        {"def", TOKEN_DEF},
-        {"if", TOKEN_IF},
-        {"elif", TOKEN_ELIF},
-        {"else", TOKEN_ELSE},
-        {"while", TOKEN_WHILE},
-        {"for", TOKEN_FOR},
-        {"foreach", TOKEN_FOREACH},
-        {"in", TOKEN_IN},
-        {"return", TOKEN_RETURN},
-        {"break", TOKEN_BREAK},
-        {"continue", TOKEN_CONTINUE},
-        {"do", TOKEN_DO},
-        {"loop", TOKEN_LOOP},
-        {"switch", TOKEN_SWITCH},
-        {"case", TOKEN_CASE},
-        {"default", TOKEN_DEFAULT},
-        {"true", TOKEN_TRUE},
-        {"false", TOKEN_FALSE},
-        {"nil", TOKEN_NIL},
-        {"print", TOKEN_PRINT},
-        {"process", TOKEN_PROCESS},
-        {"type", TOKEN_TYPE},
-        {"frame", TOKEN_FRAME},
-        {"len", TOKEN_LEN},
-        {"free", TOKEN_FREE},
-        {"proc", TOKEN_PROC},
-        {"get_id", TOKEN_GET_ID},
-        {"exit", TOKEN_EXIT},
-        {"label", TOKEN_LABEL},
-        {"goto", TOKEN_GOTO},
-        {"gosub", TOKEN_GOSUB},
-        {"struct", TOKEN_STRUCT},
-        {"enum", TOKEN_ENUM},
-        {"class", TOKEN_CLASS},
-        {"self", TOKEN_SELF},
-        {"super", TOKEN_SUPER},
-        {"include", TOKEN_INCLUDE},
-        {"import", TOKEN_IMPORT},
-        {"using", TOKEN_USING},
-        {"require", TOKEN_REQUIRE},
-        {"try", TOKEN_TRY},
-        {"catch", TOKEN_CATCH},
-        {"finally", TOKEN_FINALLY},
-        {"throw", TOKEN_THROW},
-
-        {"sin", TOKEN_SIN},
-        {"cos", TOKEN_COS},
-        {"asin", TOKEN_ASIN},
-        {"acos", TOKEN_ACOS},
-        {"atan", TOKEN_ATAN},
-        {"atan2", TOKEN_ATAN2},
-        {"sqrt", TOKEN_SQRT},
-        {"pow", TOKEN_POW},
-        {"log", TOKEN_LOG},
-        {"abs", TOKEN_ABS},
-        {"floor", TOKEN_FLOOR},
-        {"ceil", TOKEN_CEIL},
-        {"deg", TOKEN_DEG},
-        {"rad", TOKEN_RAD},
-        {"tan", TOKEN_TAN},
-        {"exp", TOKEN_EXP},
-
- 
-        {"clock", TOKEN_CLOCK},
-
-
-        
-
-
-        
-
-    };
-}
-
 void Lexer::reset()
 {
     start = 0;
@@ -262,9 +285,15 @@ void Lexer::skipWhitespace()
     }
 }
 
-Token Lexer::makeToken(TokenType type, const std::string &lexeme)
+Token Lexer::makeToken(TokenType type, std::string lexeme)
+{
+    return Token(type, std::move(lexeme), line, tokenColumn);
+}
+
+// Lexema = fatia [start, current) da source
+Token Lexer::makeSourceToken(TokenType type)
 {
-    return Token(type, lexeme, line, tokenColumn);
+    return Token(type, std::string(source.data() + start, current - start), line, tokenColumn);
 }
 
 Token Lexer::errorToken(const std::string &message)
@@ -274,7 +303,7 @@ Token Lexer::errorToken(const std::string &message)
 
 bool Lexer::isKeyword(const std::string &name)
 {
-    return keywords.find(name) != keywords.end();
+    return lookupKeyword(name.data(), name.size()) != TOKEN_IDENTIFIER;
 }
 
 Token Lexer::number()
@@ -289,8 +318,7 @@ Token Lexer::number()
             advance();
         }
 
-        std::string numStr = source.substr(start, current - start);
-        return makeToken(TOKEN_INT, numStr);
+        return makeSourceToken(TOKEN_INT);
     }
 
     // Normal int/float
@@ -310,8 +338,7 @@ Token Lexer::number()
         }
     }
 
-    std::string numStr = source.substr(start, current - start);
-    return makeToken(type, numStr);
+    return makeSourceToken(type);
 }
  
 
@@ -330,24 +357,17 @@ Token Lexer::identifier()
         }
     }
 
-    std::string text = source.substr(start, current - start);
+    const char *text = source.data() + start;
+    size_t length = current - start;
 
     // Check for f-string: f"..."
-    if (text == "f" && peek() == '"')
+    if (length == 1 && text[0] == 'f' && peek() == '"')
     {
         advance(); // consume the opening "
         return fstring();
     }
 
-    auto it = keywords.find(text);
-    if (it != keywords.end())
-    {
-        return makeToken(it->second, text);
-    }
-
- 
-
-    return makeToken(TOKEN_IDENTIFIER, text);
+    return makeSourceToken(lookupKeyword(text, length));
 }
 
 
@@ -543,7 +563,7 @@ Token Lexer::string()
     }
 
     advance(); // fecha "
-    return makeToken(TOKEN_STRING, value);
+    return makeToken(TOKEN_STRING, std::move(value));
 }
 
 Token Lexer::verbatimString()
@@ -572,7 +592,7 @@ Token Lexer::verbatimString()
                 continue;
             }
             // Fim da string verbatim
-            return makeToken(TOKEN_STRING, value);
+            return makeToken(TOKEN_STRING, std::move(value));
         }
 
         // Adiciona caractere literal (incluindo quebras de linha)
@@ -718,7 +738,7 @@ Token Lexer::fstring()
     }
 
     advance(); // consume closing "
-    return makeToken(TOKEN_FSTRING, value);
+    return makeToken(TOKEN_FSTRING, std::move(value));
 }
 // ============================================
 // MAIN API: scanToken()
@@ -900,15 +920,15 @@ Token Lexer::nextToken()
 std::vector<Token> Lexer::scanAll()
 {
     std::vector<Token> tokens;
-    tokens.reserve(256); // Pre-allocate for performance
+    tokens.reserve(256 + source.length() / 6); // ~1 token por 6 bytes em código típico
 
-    Token token;
+    TokenType type;
     do
     {
-        token = nextToken();
-        tokens.push_back(token);
+        tokens.push_back(nextToken());
+        type = tokens.back().type;
 
-    } while (token.type != TOKEN_EOF && !hasPendingError);
+    } while (type != TOKEN_EOF && !hasPendingError);
 
     return tokens;
 }
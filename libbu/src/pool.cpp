@@ -43,10 +43,11 @@ void StringPool::deallocString(String *s)
         return;
 
     //    Info("Dealloc string %p", s);
-    bytesAllocated -= sizeof(String) + s->length() + 1;
+    size_t bytes = s->capacity() ? s->capacity() : s->length() + 1;
+    bytesAllocated -= sizeof(String) + bytes;
 
     if (s->isLong() && s->ptr)
-        allocator.Free(s->ptr, s->length() + 1);
+        allocator.Free(s->ptr, bytes);
 
     s->~String();
     allocator.Free(s, sizeof(String));
@@ -72,6 +73,12 @@ void StringPool::clear()
     dummyString->~String();
     allocator.Free(dummyString, sizeof(String));
 
+    if (scratch)
+        allocator.Free(scratch, scratchSize);
+    scratch = nullptr;
+    scratchSize = 0;
+    std::memset(charStrings, 0, sizeof(charStrings));
+
    // allocator.Stats();
     allocator.Clear();
 
@@ -80,12 +87,18 @@ void StringPool::clear()
 }
 
 String *StringPool::create(const char *str, uint32 len)
+{
+    return create(str, len, hashString(str, len));
+}
+
+String *StringPool::create(const char *str, uint32 len, size_t hash)
 {
     // Cache hit?
 
     int index = 0;
+    StringKey key = {str, len, hash};
 
-    if (pool.get(str, &index))
+    if (pool.get(key, &index))
     {
         String *s = map[index];
         return s;
@@ -109,13 +122,14 @@ String *StringPool::create(const char *str, uint32 len)
         s->ptr[len] = '\0';
     }
 
-    s->hash = hashString(s->chars(), len);
+    s->hash = hash;
     bytesAllocated += sizeof(String) + len;
     s->index = map.size();
 
     // Info("Create string %s hash %d len %d", s->chars(), s->hash, s->length());
     map.push(s);
-    pool.set(s->chars(), map.size() - 1);
+    StringKey stored = {s->chars(), len, hash};
+    pool.set(stored, map.size() - 1);
 
     // Store in pool
 
@@ -126,6 +140,15 @@ String *StringPool::create(const char *str)
 {
     return create(str, std::strlen(str));
 }
+
+// Transients (concat) passam a interned: a copia guardada no pool nao pode
+// ser libertada nem crescer no sitio por concat()/append()
+String *StringPool::intern(String *s)
+{
+    if (!s->isTransient())
+        return s;
+    return create(s->chars(), (uint32)s->length(), s->hash);
+}
 // ========================================
 // CONCAT - OTIMIZADO
 // ========================================
@@ -162,18 +185,147 @@ String *StringPool::concat(String *a, String *b)
         s->ptr[totalLen] = '\0';
     }
 
-    s->hash = hashString(s->chars(), totalLen);
+    s->hash = hashStringContinue(a->hash, b->chars(), lenB);
     s->index = String::TRANSIENT_INDEX;
     bytesAllocated += sizeof(String) + totalLen;
 
     // Free the left operand if it was transient (s = s + "x" pattern)
-    // Data already copied via memcpy above, so safe to free now
-    if (a->isTransient())
+    // Data already copied via memcpy above, so safe to free now.
+    // Strings held by a local (append targets) may still be referenced.
+    if (a->isTransient() && !a->isHeld())
         freeTransient(a);
 
     return s;
 }
 
+// ========================================
+// APPEND - s = s + x numa local (OP_APPEND_LOCAL)
+// ========================================
+
+// dst tem de ser um transient isOwned(): ninguem mais o ve, por isso cresce
+// no sitio com capacidade que duplica (custo amortizado O(len(src))).
+void StringPool::append(String *dst, String *src)
+{
+    size_t lenA = dst->length();
+    size_t lenB = src->length();
+    if (lenB == 0)
+        return;
+
+    size_t totalLen = lenA + lenB;
+    const char *from = src->chars();
+    dst->hash = hashStringContinue(dst->hash, from, lenB);
+
+    if (!dst->isLong())
+    {
+        if (totalLen <= String::SMALL_THRESHOLD)
+        {
+            std::memcpy(dst->data + lenA, from, lenB);
+            dst->data[totalLen] = '\0';
+            dst->length_and_flag = totalLen;
+            bytesAllocated += lenB;
+            return;
+        }
+
+        size_t capacity = totalLen * 2 + 1;
+        char *buffer = (char *)allocator.Allocate(capacity);
+        std::memcpy(buffer, dst->data, lenA);
+        std::memcpy(buffer + lenA, from, lenB);
+        buffer[totalLen] = '\0';
+        dst->ptr = buffer;
+        dst->length_and_flag = totalLen | String::IS_LONG_FLAG;
+        dst->capacity_and_flag = (uint32)capacity | String::IS_OWNED_FLAG | String::IS_HELD_FLAG;
+        bytesAllocated += capacity - lenA;
+        return;
+    }
+
+    size_t capacity = dst->capacity() ? dst->capacity() : lenA + 1;
+    if (totalLen + 1 > capacity)
+    {
+        size_t grown = capacity * 2;
+        if (grown < totalLen + 1)
+            grown = totalLen + 1;
+
+        char *buffer = (char *)allocator.Allocate(grown);
+        std::memcpy(buffer, dst->ptr, lenA);
+        std::memcpy(buffer + lenA, from, lenB);
+        allocator.Free(dst->ptr, capacity);
+        dst->ptr = buffer;
+        dst->capacity_and_flag = (uint32)grown | String::IS_OWNED_FLAG | String::IS_HELD_FLAG;
+        bytesAllocated += grown - capacity;
+    }
+    else
+    {
+        std::memcpy(dst->ptr + lenA, from, lenB);
+    }
+
+    dst->ptr[totalLen] = '\0';
+    dst->length_and_flag = totalLen | String::IS_LONG_FLAG;
+}
+
+// ========================================
+// SLICE / CHAR - sem copia temporaria
+// ========================================
+
+// Interna len bytes de src a partir de start diretamente do buffer do pai:
+// create() aceita spans sem '\0', por isso nao ha copia intermedia. Fica
+// interned de proposito: o GC nao recolhe strings, um objeto novo por
+// chamada (copia ou view) crescia sem limite num loop.
+String *StringPool::slice(String *src, uint32 start, uint32 len)
+{
+    if (len == 0)
+        return create("", 0);
+    if (start == 0 && len == src->length())
+        return src;
+    if (len == 1)
+        return fromChar((unsigned char)src->chars()[start]);
+    return create(src->chars() + start, len);
+}
+
+// Strings de 1 byte ficam em cache: indexar/iterar texto nao faz hash
+String *StringPool::fromChar(unsigned char c)
+{
+    String *s = charStrings[c];
+    if (!s)
+    {
+        char buf[1] = {(char)c};
+        s = create(buf, 1);
+        charStrings[c] = s;
+    }
+    return s;
+}
+
+// Buffer de trabalho reutilizado (heap): substitui alloca, que rebentava a
+// stack em strings grandes. So vale ate a proxima chamada.
+char *StringPool::scratchBuffer(size_t len)
+{
+    if (len + 1 > scratchSize)
+    {
+        size_t size = scratchSize ? scratchSize : 256;
+        while (size < len + 1)
+            size *= 2;
+        if (scratch)
+            allocator.Free(scratch, scratchSize);
+        scratch = (char *)allocator.Allocate(size);
+        scratchSize = size;
+    }
+    return scratch;
+}
+
+// Interna os primeiros len bytes do buffer de trabalho. Se um upper/replace
+// pontual o fez crescer alem de SCRATCH_KEEP, e devolvido logo: o pool nao
+// fica com megabytes reservados para as strings pequenas seguintes.
+String *StringPool::createFromScratch(size_t len)
+{
+    String *s = create(scratch, (uint32)len);
+    if (scratchSize > SCRATCH_KEEP)
+    {
+        allocator.Free(scratch, scratchSize);
+        scratch = nullptr;
+        scratchSize = 0;
+    }
+    return s;
+}
+
 // ========================================
 // UPPER/LOWER - OTIMIZADO
 // ========================================
@@ -184,18 +336,23 @@ String *StringPool::upper(String *src)
         return create("", 0);
 
     size_t len = src->length();
+    const char *str = src->chars();
 
-    //  ALLOCA buffer temporário
-    char *temp = (char *)alloca(len + 1);
+    // Nada para mudar: devolve a propria string (sem hash nem lookup)
+    size_t first = 0;
+    while (first < len && (char)toupper((unsigned char)str[first]) == str[first])
+        first++;
+    if (first == len)
+        return src;
 
-    const char *str = src->chars();
-    for (size_t i = 0; i < len; i++)
+    char *temp = scratchBuffer(len);
+    std::memcpy(temp, str, first);
+    for (size_t i = first; i < len; i++)
     {
         temp[i] = (char)toupper((unsigned char)str[i]);
     }
-    temp[len] = '\0';
 
-    return create(temp, len);
+    return createFromScratch(len);
 }
 
 String *StringPool::lower(String *src)
@@ -204,17 +361,22 @@ String *StringPool::lower(String *src)
         return create("", 0);
 
     size_t len = src->length();
+    const char *str = src->chars();
 
-    char *temp = (char *)alloca(len + 1);
+    size_t first = 0;
+    while (first < len && (char)tolower((unsigned char)str[first]) == str[first])
+        first++;
+    if (first == len)
+        return src;
 
-    const char *str = src->chars();
-    for (size_t i = 0; i < len; i++)
+    char *temp = scratchBuffer(len);
+    std::memcpy(temp, str, first);
+    for (size_t i = first; i < len; i++)
     {
         temp[i] = (char)tolower((unsigned char)str[i]);
     }
-    temp[len] = '\0';
 
-    return create(temp, len);
+    return createFromScratch(len);
 }
 
 // ========================================
@@ -235,15 +397,7 @@ String *StringPool::substring(String *src, uint32 start, uint32 end)
     if (start > end)
         start = end;
 
-    size_t newLen = end - start;
-    if (newLen == 0)
-        return create("", 0);
-
-    char *temp = (char *)alloca(newLen + 1);
-    std::memcpy(temp, src->chars() + start, newLen);
-    temp[newLen] = '\0';
-
-    return create(temp, newLen);
+    return slice(src, start, end - start);
 }
 
 // ========================================
@@ -278,8 +432,7 @@ String *StringPool::replace(String *src, const char *oldStr, const char *newStr)
     // Calcula tamanho final
     size_t finalLen = len - (count * oldLen) + (count * newLen);
 
-    //  ALLOCA buffer temporário
-    char *temp = (char *)alloca(finalLen + 1);
+    char *temp = scratchBuffer(finalLen);
 
     // Copia com substituições
     const char *current = str;
@@ -300,9 +453,8 @@ String *StringPool::replace(String *src, const char *oldStr, const char *newStr)
     // Copia resto
     size_t remainLen = len - (current - str);
     std::memcpy(temp + destIdx, current, remainLen);
-    temp[finalLen] = '\0';
 
-    return create(temp, finalLen);
+    return createFromScratch(finalLen);
 }
 
 // ========================================
@@ -323,8 +475,7 @@ String *StringPool::at(String *str, int index)
     if (index < 0 || index >= len)
         return create("", 0);
 
-    char buf[2] = {str->chars()[index], '\0'};
-    return create(buf, 1);
+    return fromChar((unsigned char)str->chars()[index]);
 }
 
 // ========================================
@@ -348,7 +499,7 @@ bool StringPool::startsWith(String *str, String *prefix)
     if (prefix->length() > str->length())
         return false;
 
-    return strncmp(str->chars(), prefix->chars(), prefix->length()) == 0;
+    return memcmp(str->chars(), prefix->chars(), prefix->length()) == 0;
 }
 
 bool StringPool::endsWith(String *str, String *suffix)
@@ -362,8 +513,8 @@ bool StringPool::endsWith(String *str, String *suffix)
     if (suffixLen > strLen)
         return false;
 
-    return strcmp(str->chars() + (strLen - suffixLen),
-                  suffix->chars()) == 0;
+    return memcmp(str->chars() + (strLen - suffixLen),
+                  suffix->chars(), suffixLen) == 0;
 }
 
 // ========================================
@@ -375,10 +526,11 @@ String *StringPool::trim(String *str)
     if (!str)
         return create("", 0);
 
-    const char *start = str->chars();
-    const char *end = start + str->length() - 1;
+    const char *base = str->chars();
+    const char *start = base;
+    const char *end = base + str->length() - 1;
 
-    while (*start && isspace((unsigned char)*start))
+    while (start <= end && isspace((unsigned char)*start))
         start++;
 
     while (end > start && isspace((unsigned char)*end))
@@ -388,13 +540,7 @@ String *StringPool::trim(String *str)
         return create("", 0);
 
     size_t len = end - start + 1;
-
-    //  create() já lida com substring não null-terminated
-    char *temp = (char *)alloca(len + 1);
-    std::memcpy(temp, start, len);
-    temp[len] = '\0';
-
-    return create(temp, len);
+    return slice(str, (uint32)(start - base), (uint32)len);
 }
 
 // ========================================
@@ -453,34 +599,15 @@ String *StringPool::repeat(String *str, int count)
     size_t len = str->length();
     size_t totalLen = len * count;
 
-    //  ALLOCA se não for muito grande
-    char *temp;
-    bool useAlloca = (totalLen < 4096); // Stack limit
-
-    if (useAlloca)
-    {
-        temp = (char *)alloca(totalLen + 1);
-    }
-    else
-    {
-        temp = (char *)allocator.Allocate(totalLen + 1);
-    }
+    char *temp = scratchBuffer(totalLen);
 
     // Repete
     for (int i = 0; i < count; i++)
     {
         std::memcpy(temp + (i * len), str->chars(), len);
     }
-    temp[totalLen] = '\0';
-
-    String *result = create(temp, totalLen);
-
-    if (!useAlloca)
-    {
-        allocator.Free(temp, totalLen + 1);
-    }
 
-    return result;
+    return createFromScratch(totalLen);
 }
 
 // ========================================
@@ -491,15 +618,14 @@ String *StringPool::capitalize(String *str)
     if (!str || str->length() == 0) return create("", 0);
     
     int len = str->length();
-    char *temp = (char *)alloca(len + 1);
+    char *temp = scratchBuffer(len);
     const char *src = str->chars();
     
     temp[0] = (char)toupper((unsigned char)src[0]);
     for (int i = 1; i < len; i++)
         temp[i] = (char)tolower((unsigned char)src[i]);
-    temp[len] = '\0';
     
-    return create(temp, len);
+    return createFromScratch(len);
 }
 
 // ========================================
@@ -510,7 +636,7 @@ String *StringPool::title(String *str)
     if (!str || str->length() == 0) return create("", 0);
     
     int len = str->length();
-    char *temp = (char *)alloca(len + 1);
+    char *temp = scratchBuffer(len);
     const char *src = str->chars();
     
     bool newWord = true;
@@ -531,9 +657,8 @@ String *StringPool::title(String *str)
             temp[i] = (char)tolower((unsigned char)src[i]);
         }
     }
-    temp[len] = '\0';
     
-    return create(temp, len);
+    return createFromScratch(len);
 }
 
 // ========================================
@@ -551,7 +676,7 @@ String *StringPool::lstrip(String *str)
         start++;
     
     if (start == 0) return str;
-    return create(s + start, len - start);
+    return slice(str, start, len - start);
 }
 
 // ========================================
@@ -568,12 +693,7 @@ String *StringPool::rstrip(String *str)
         end--;
     
     if (end == (int)str->length()) return str;
-    if (end == 0) return create("", 0);
-
-    char *temp = (char *)alloca(end + 1);
-    std::memcpy(temp, s, end);
-    temp[end] = '\0';
-    return create(temp, end);
+    return slice(str, 0, end);
 }
 
 // ========================================
@@ -868,6 +988,41 @@ void ProcessPool::clear()
     pool.clear();
 }
 
+#if BU_ENABLE_PRIVATE_COLUMNS
+
+PrivateColumns &PrivateColumns::instance()
+{
+    // Nunca destruido: Process apagados tarde (destrutores estaticos) ainda devolvem o slot
+    static PrivateColumns *columns = new PrivateColumns();
+    return *columns;
+}
+
+Value *PrivateColumns::acquire()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (freeSlots.size() > 0)
+    {
+        Value *slot = freeSlots.back();
+        freeSlots.pop();
+        return slot;
+    }
+
+    if (nextInBlock == PRIVATE_BLOCK)
+    {
+        blocks.push(new Block());
+        nextInBlock = 0;
+    }
+    return &blocks.back()->cols[0][nextInBlock++];
+}
+
+void PrivateColumns::release(Value *slot)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    freeSlots.push(slot);
+}
+
+#endif
+
 void ProcessPool::shrink()
 {
     if (pool.size() <= MIN_POOL_SIZE)
@@ -0,0 +1,107 @@
+#include "process_workers.hpp"
+
+#if BU_ENABLE_PROCESS_WORKERS
+
+ProcessWorkers::ProcessWorkers(int threads)
+    : threadCount(threads < 1 ? 1 : threads)
+{
+    slices = new Slice[threadCount];
+
+    // A thread 0 e quem chama run()
+    for (int i = 1; i < threadCount; i++)
+        pool.emplace_back(&ProcessWorkers::workerLoop, this, i);
+}
+
+ProcessWorkers::~ProcessWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread &t : pool)
+        t.join();
+    delete[] slices;
+}
+
+void ProcessWorkers::run(size_t count, WorkerTask fn, void *ctx)
+{
+    if (count == 0)
+        return;
+
+    // Pouco trabalho: acordar as threads custa mais do que fazer tudo aqui
+    if (threadCount == 1 || count <= CHUNK)
+    {
+        for (size_t i = 0; i < count; i++)
+            fn(ctx, i);
+        return;
+    }
+
+    size_t per = (count + threadCount - 1) / threadCount;
+    for (int t = 0; t < threadCount; t++)
+    {
+        size_t begin = (size_t)t * per;
+        if (begin > count)
+            begin = count;
+        size_t end = begin + per;
+        if (end > count)
+            end = count;
+        slices[t].end = end;
+        slices[t].next.store(begin, std::memory_order_relaxed);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        task = fn;
+        taskCtx = ctx;
+        busy = threadCount - 1;
+        round++;
+    }
+    wake.notify_all();
+
+    drain(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return busy == 0; });
+}
+
+void ProcessWorkers::workerLoop(int self)
+{
+    uint64_t seen = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || round != seen; });
+            if (stopping)
+                return;
+            seen = round;
+        }
+
+        drain(self);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busy == 0)
+            done.notify_one();
+    }
+}
+
+void ProcessWorkers::drain(int self)
+{
+    // Primeiro a propria fatia, depois as dos outros, por ordem
+    for (int k = 0; k < threadCount; k++)
+    {
+        Slice &slice = slices[(self + k) % threadCount];
+        for (;;)
+        {
+            size_t begin = slice.next.fetch_add(CHUNK, std::memory_order_relaxed);
+            if (begin >= slice.end)
+                break;
+            size_t end = begin + CHUNK < slice.end ? begin + CHUNK : slice.end;
+            for (size_t i = begin; i < end; i++)
+                task(taskCtx, i);
+        }
+    }
+}
+
+#endif
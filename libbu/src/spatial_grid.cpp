@@ -0,0 +1,317 @@
+#include "spatial_grid.hpp"
+#include "interpreter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#ifdef BU_ENABLE_SPACE
+
+SpatialGrid::SpatialGrid(float cellSize, float radius)
+    : cell(cellSize), invCell(1.0f / cellSize), radiusAt100(radius)
+{
+}
+
+float SpatialGrid::radiusOf(Process *proc, float radiusAt100)
+{
+    return std::fabs((float)proc->priv((int)PrivateIndex::SIZE).asNumber()) * radiusAt100 / 100.0f;
+}
+
+int32_t SpatialGrid::cellOf(float v) const
+{
+    float c = std::floor(v * invCell);
+    // Coordenadas absurdas (nan, inf) ficam todas nas celulas dos extremos
+    if (!(c > -1e9f))
+        return -1000000000;
+    if (c > 1e9f)
+        return 1000000000;
+    return (int32_t)c;
+}
+
+SpatialGrid::Cell *SpatialGrid::find(int32_t cx, int32_t cy)
+{
+    auto it = cells.find(key(cx, cy));
+    return it == cells.end() ? nullptr : &it->second;
+}
+
+void SpatialGrid::remove(Process *proc)
+{
+    if (proc->gridSlot < 0)
+        return;
+
+    auto it = cells.find(proc->gridCell);
+    if (it != cells.end())
+    {
+        // Troca com o ultimo da celula: O(1)
+        Cell &c = it->second;
+        Process *last = c.back();
+        c[proc->gridSlot] = last;
+        last->gridSlot = proc->gridSlot;
+        c.pop_back();
+
+        // Celula vazia sai do mapa: cells.size() conta so celulas ocupadas
+        if (c.empty())
+        {
+            int32_t cx = (int32_t)(it->first >> 32);
+            int32_t cy = (int32_t)(uint32_t)it->first;
+            cells.erase(it);
+            if (cx == minCx || cx == maxCx || cy == minCy || cy == maxCy)
+                boundsDirty = true;
+        }
+    }
+    proc->gridSlot = -1;
+}
+
+// Caixa das celulas ocupadas, recalculada quando uma celula da borda esvazia
+void SpatialGrid::updateBounds()
+{
+    boundsDirty = false;
+    minCx = minCy = 0;
+    maxCx = maxCy = -1;
+    bool first = true;
+    for (auto &entry : cells)
+    {
+        int32_t cx = (int32_t)(entry.first >> 32);
+        int32_t cy = (int32_t)(uint32_t)entry.first;
+        if (first)
+        {
+            minCx = maxCx = cx;
+            minCy = maxCy = cy;
+            first = false;
+            continue;
+        }
+        if (cx < minCx) minCx = cx;
+        if (cx > maxCx) maxCx = cx;
+        if (cy < minCy) minCy = cy;
+        if (cy > maxCy) maxCy = cy;
+    }
+}
+
+void SpatialGrid::refresh(Process *proc)
+{
+    if (proc->state == ProcessState::DEAD || !proc->initialized)
+    {
+        remove(proc);
+        return;
+    }
+
+    int32_t cx = cellOf((float)proc->priv((int)PrivateIndex::X).asNumber());
+    int32_t cy = cellOf((float)proc->priv((int)PrivateIndex::Y).asNumber());
+    int64_t k = key(cx, cy);
+
+    float r = radiusOf(proc, radiusAt100);
+    if (r > maxRadius)
+        maxRadius = r;
+
+    if (proc->gridSlot >= 0)
+    {
+        if (proc->gridCell == k)
+            return;
+        remove(proc);
+    }
+
+    if (boundsDirty)
+        updateBounds();
+    if (minCx > maxCx)
+    {
+        minCx = maxCx = cx;
+        minCy = maxCy = cy;
+    }
+    else
+    {
+        if (cx < minCx) minCx = cx;
+        if (cx > maxCx) maxCx = cx;
+        if (cy < minCy) minCy = cy;
+        if (cy > maxCy) maxCy = cy;
+    }
+
+    Cell &c = cells[k];
+    proc->gridCell = k;
+    proc->gridSlot = (int32_t)c.size();
+    c.push_back(proc);
+}
+
+void SpatialGrid::clear()
+{
+    for (auto &entry : cells)
+    {
+        for (Process *proc : entry.second)
+            proc->gridSlot = -1;
+    }
+    cells.clear();
+    maxRadius = 0.0f;
+    minCx = minCy = 0;
+    maxCx = maxCy = -1;
+    boundsDirty = false;
+}
+
+template <class Fn>
+void SpatialGrid::visit(float x0, float y0, float x1, float y1, Fn &&fn)
+{
+    if (boundsDirty)
+        updateBounds();
+
+    int32_t cx0 = cellOf(x0), cx1 = cellOf(x1);
+    int32_t cy0 = cellOf(y0), cy1 = cellOf(y1);
+    if (cx0 < minCx) cx0 = minCx;
+    if (cx1 > maxCx) cx1 = maxCx;
+    if (cy0 < minCy) cy0 = minCy;
+    if (cy1 > maxCy) cy1 = maxCy;
+
+    if (cx0 > cx1 || cy0 > cy1)
+        return;
+
+    // Caixa com mais celulas do que as ocupadas: percorre so as ocupadas
+    if ((int64_t)(cx1 - cx0 + 1) * (cy1 - cy0 + 1) > (int64_t)cells.size())
+    {
+        for (auto &entry : cells)
+        {
+            int32_t cx = (int32_t)(entry.first >> 32);
+            int32_t cy = (int32_t)(uint32_t)entry.first;
+            if (cx < cx0 || cx > cx1 || cy < cy0 || cy > cy1)
+                continue;
+            for (Process *proc : entry.second)
+            {
+                if (!fn(proc))
+                    return;
+            }
+        }
+        return;
+    }
+
+    for (int32_t cy = cy0; cy <= cy1; cy++)
+    {
+        for (int32_t cx = cx0; cx <= cx1; cx++)
+        {
+            Cell *c = find(cx, cy);
+            if (!c)
+                continue;
+            for (Process *proc : *c)
+            {
+                if (!fn(proc))
+                    return;
+            }
+        }
+    }
+}
+
+static inline bool candidate(Process *proc, int blueprint, Process *self)
+{
+    return proc != self && proc->state != ProcessState::DEAD &&
+           (blueprint < 0 || proc->blueprint == blueprint);
+}
+
+Process *SpatialGrid::collide(Process *self, int blueprint)
+{
+    float x = (float)self->priv((int)PrivateIndex::X).asNumber();
+    float y = (float)self->priv((int)PrivateIndex::Y).asNumber();
+    float r = radiusOf(self, radiusAt100);
+    float reach = r + maxRadius;
+
+    Process *hit = nullptr;
+    visit(x - reach, y - reach, x + reach, y + reach, [&](Process *proc)
+    {
+        if (!candidate(proc, blueprint, self))
+            return true;
+        float dx = (float)proc->priv((int)PrivateIndex::X).asNumber() - x;
+        float dy = (float)proc->priv((int)PrivateIndex::Y).asNumber() - y;
+        float rr = r + radiusOf(proc, radiusAt100);
+        if (dx * dx + dy * dy <= rr * rr)
+        {
+            hit = proc;
+            return false;
+        }
+        return true;
+    });
+    return hit;
+}
+
+const std::vector<Process *> &SpatialGrid::within(float x, float y, float r, int blueprint, Process *self)
+{
+    found.clear();
+    float reach = r + maxRadius;
+    visit(x - reach, y - reach, x + reach, y + reach, [&](Process *proc)
+    {
+        if (!candidate(proc, blueprint, self))
+            return true;
+        float dx = (float)proc->priv((int)PrivateIndex::X).asNumber() - x;
+        float dy = (float)proc->priv((int)PrivateIndex::Y).asNumber() - y;
+        float rr = r + radiusOf(proc, radiusAt100);
+        if (dx * dx + dy * dy <= rr * rr)
+            found.push_back(proc);
+        return true;
+    });
+    return found;
+}
+
+Process *SpatialGrid::nearest(float x, float y, int blueprint, Process *self, float maxDist)
+{
+    if (boundsDirty)
+        updateBounds();
+    if (minCx > maxCx)
+        return nullptr;
+
+    int32_t cx = cellOf(x), cy = cellOf(y);
+    // Aneis de celulas a volta de (cx, cy) ate cobrir a grelha toda
+    int32_t span = 0;
+    span = std::max(span, std::abs(cx - minCx));
+    span = std::max(span, std::abs(cx - maxCx));
+    span = std::max(span, std::abs(cy - minCy));
+    span = std::max(span, std::abs(cy - maxCy));
+
+    Process *best = nullptr;
+    float bestD2 = maxDist >= 0.0f ? maxDist * maxDist : INFINITY;
+
+    auto consider = [&](Process *proc)
+    {
+        if (!candidate(proc, blueprint, self))
+            return;
+        float dx = (float)proc->priv((int)PrivateIndex::X).asNumber() - x;
+        float dy = (float)proc->priv((int)PrivateIndex::Y).asNumber() - y;
+        float d2 = dx * dx + dy * dy;
+        if (d2 <= bestD2)
+        {
+            bestD2 = d2;
+            best = proc;
+        }
+    };
+
+    // Grelha esparsa (poucos processos muito espalhados): mais barato ver tudo
+    size_t probes = 0;
+    for (int32_t ring = 0; ring <= span; ring++)
+    {
+        if (probes > cells.size())
+        {
+            for (auto &entry : cells)
+            {
+                for (Process *proc : entry.second)
+                    consider(proc);
+            }
+            return best;
+        }
+
+        // Tudo o que falta esta a pelo menos (ring - 1) celulas de distancia
+        float gap = (ring - 1) * cell;
+        if (gap > 0.0f && gap * gap > bestD2)
+            break;
+
+        for (int32_t iy = cy - ring; iy <= cy + ring; iy++)
+        {
+            bool edgeRow = (iy == cy - ring || iy == cy + ring);
+            for (int32_t ix = cx - ring; ix <= cx + ring; ix += edgeRow ? 1 : 2 * ring)
+            {
+                probes++;
+                Cell *c = find(ix, iy);
+                if (c)
+                {
+                    for (Process *proc : *c)
+                        consider(proc);
+                }
+                if (ring == 0)
+                    break;
+            }
+        }
+    }
+    return best;
+}
+
+#endif
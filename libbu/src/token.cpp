@@ -9,8 +9,8 @@ Token::Token()
     column = 0;
 }
 
-Token::Token(TokenType t, const std::string &lex, int l, int c)
-    : type(t), lexeme(lex), line(l), column(c) {}
+Token::Token(TokenType t, std::string lex, int l, int c)
+    : type(t), lexeme(std::move(lex)), line(l), column(c) {}
 
 std::string Token::toString() const
 {
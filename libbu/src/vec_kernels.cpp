@@ -0,0 +1,191 @@
+#define BU_VEC_KERNEL_IMPL
+#include "vec_kernels.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define BU_VEC_HAS_SSE2 1
+#endif
+
+// ============================================
+// Scalar
+// ============================================
+
+static void scalarF32ToF64(double *d, const float *s, size_t n)
+{
+  for (size_t i = 0; i < n; i++)
+    d[i] = (double)s[i];
+}
+
+static void scalarF64ToF32(float *d, const double *s, size_t n)
+{
+  for (size_t i = 0; i < n; i++)
+    d[i] = (float)s[i];
+}
+
+static const VecKernels kScalarKernels =
+    BU_VEC_KERNEL_TABLE("scalar", ScalarLane<float>, ScalarLane<double>, scalarF32ToF64, scalarF64ToF32);
+
+const VecKernels *vecKernelsScalar()
+{
+  return &kScalarKernels;
+}
+
+// ============================================
+// SSE2 (baseline em x86-64)
+// ============================================
+
+#ifdef BU_VEC_HAS_SSE2
+
+namespace
+{
+  struct Sse2F32
+  {
+    typedef float T;
+    typedef __m128 V;
+    typedef __m128d D;
+    enum
+    {
+      W = 4
+    };
+    static inline V load(const T *p) { return _mm_loadu_ps(p); }
+    static inline void store(T *p, V v) { _mm_storeu_ps(p, v); }
+    static inline V set1(T x) { return _mm_set1_ps(x); }
+    static inline V add(V x, V y) { return _mm_add_ps(x, y); }
+    static inline V sub(V x, V y) { return _mm_sub_ps(x, y); }
+    static inline V mul(V x, V y) { return _mm_mul_ps(x, y); }
+    static inline V div(V x, V y) { return _mm_div_ps(x, y); }
+    static inline V fma(V x, V y, V z) { return _mm_add_ps(_mm_mul_ps(x, y), z); }
+    static inline V min(V x, V y) { return _mm_min_ps(x, y); }
+    static inline V max(V x, V y) { return _mm_max_ps(x, y); }
+    static inline T hmin(V x)
+    {
+      x = _mm_min_ps(x, _mm_movehl_ps(x, x));
+      x = _mm_min_ss(x, _mm_shuffle_ps(x, x, 1));
+      return _mm_cvtss_f32(x);
+    }
+    static inline T hmax(V x)
+    {
+      x = _mm_max_ps(x, _mm_movehl_ps(x, x));
+      x = _mm_max_ss(x, _mm_shuffle_ps(x, x, 1));
+      return _mm_cvtss_f32(x);
+    }
+    static inline D zeroD() { return _mm_setzero_pd(); }
+    static inline D addD(D acc, V x)
+    {
+      acc = _mm_add_pd(acc, _mm_cvtps_pd(x));
+      return _mm_add_pd(acc, _mm_cvtps_pd(_mm_movehl_ps(x, x)));
+    }
+    static inline D fmaD(D acc, V x, V y)
+    {
+      acc = _mm_add_pd(acc, _mm_mul_pd(_mm_cvtps_pd(x), _mm_cvtps_pd(y)));
+      return _mm_add_pd(acc, _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(x, x)),
+                                        _mm_cvtps_pd(_mm_movehl_ps(y, y))));
+    }
+    static inline double hsumD(D acc)
+    {
+      return _mm_cvtsd_f64(_mm_add_sd(acc, _mm_unpackhi_pd(acc, acc)));
+    }
+  };
+
+  struct Sse2F64
+  {
+    typedef double T;
+    typedef __m128d V;
+    typedef __m128d D;
+    enum
+    {
+      W = 2
+    };
+    static inline V load(const T *p) { return _mm_loadu_pd(p); }
+    static inline void store(T *p, V v) { _mm_storeu_pd(p, v); }
+    static inline V set1(T x) { return _mm_set1_pd(x); }
+    static inline V add(V x, V y) { return _mm_add_pd(x, y); }
+    static inline V sub(V x, V y) { return _mm_sub_pd(x, y); }
+    static inline V mul(V x, V y) { return _mm_mul_pd(x, y); }
+    static inline V div(V x, V y) { return _mm_div_pd(x, y); }
+    static inline V fma(V x, V y, V z) { return _mm_add_pd(_mm_mul_pd(x, y), z); }
+    static inline V min(V x, V y) { return _mm_min_pd(x, y); }
+    static inline V max(V x, V y) { return _mm_max_pd(x, y); }
+    static inline T hmin(V x) { return _mm_cvtsd_f64(_mm_min_sd(x, _mm_unpackhi_pd(x, x))); }
+    static inline T hmax(V x) { return _mm_cvtsd_f64(_mm_max_sd(x, _mm_unpackhi_pd(x, x))); }
+    static inline D zeroD() { return _mm_setzero_pd(); }
+    static inline D addD(D acc, V x) { return _mm_add_pd(acc, x); }
+    static inline D fmaD(D acc, V x, V y) { return _mm_add_pd(acc, _mm_mul_pd(x, y)); }
+    static inline double hsumD(D acc)
+    {
+      return _mm_cvtsd_f64(_mm_add_sd(acc, _mm_unpackhi_pd(acc, acc)));
+    }
+  };
+} // namespace
+
+static void sse2F32ToF64(double *d, const float *s, size_t n)
+{
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    __m128 x = _mm_loadu_ps(s + i);
+    _mm_storeu_pd(d + i, _mm_cvtps_pd(x));
+    _mm_storeu_pd(d + i + 2, _mm_cvtps_pd(_mm_movehl_ps(x, x)));
+  }
+  for (; i < n; i++)
+    d[i] = (double)s[i];
+}
+
+static void sse2F64ToF32(float *d, const double *s, size_t n)
+{
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    __m128 lo = _mm_cvtpd_ps(_mm_loadu_pd(s + i));
+    __m128 hi = _mm_cvtpd_ps(_mm_loadu_pd(s + i + 2));
+    _mm_storeu_ps(d + i, _mm_movelh_ps(lo, hi));
+  }
+  for (; i < n; i++)
+    d[i] = (float)s[i];
+}
+
+static const VecKernels kSse2Kernels =
+    BU_VEC_KERNEL_TABLE("sse2", Sse2F32, Sse2F64, sse2F32ToF64, sse2F64ToF32);
+
+const VecKernels *vecKernelsSse2()
+{
+  return &kSse2Kernels;
+}
+
+#else
+
+const VecKernels *vecKernelsSse2()
+{
+  return nullptr;
+}
+
+#endif
+
+// ============================================
+// Runtime dispatch
+// ============================================
+
+static bool vecCpuHasAvx2()
+{
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+  return false;
+#endif
+}
+
+const VecKernels *vecKernelsBest()
+{
+  static const VecKernels *best = nullptr;
+  if (!best)
+  {
+    if (vecCpuHasAvx2() && vecKernelsAvx2())
+      best = vecKernelsAvx2();
+    else if (vecKernelsSse2())
+      best = vecKernelsSse2();
+    else
+      best = vecKernelsScalar();
+  }
+  return best;
+}
@@ -0,0 +1,313 @@
+#pragma once
+
+// ============================================
+// Bulk numeric kernels for Buffers / typed arrays (module `vec`)
+//
+// Uma tabela de function pointers por ISA (scalar, sse2, avx2); a melhor
+// suportada pela CPU e escolhida em runtime por vecKernelsBest().
+// vec_kernels_avx2.cpp e compilado com -mavx2 -mfma, por isso este header
+// e esse ficheiro nao podem puxar headers da STL nem inline functions com
+// linkage externa: uma copia AVX2 escolhida pelo linker partia CPUs antigas.
+// Tudo o que e template fica em namespace anonimo.
+// ============================================
+
+#include <stddef.h>
+
+enum class VecOp
+{
+  ADD,
+  SUB,
+  MUL,
+  DIV
+};
+
+struct VecKernels
+{
+  const char *name;
+
+  // d = a op b; b aponta para um unico valor quando bScalar
+  void (*binaryF32)(VecOp op, float *d, const float *a, const float *b, bool bScalar, size_t n);
+  void (*binaryF64)(VecOp op, double *d, const double *a, const double *b, bool bScalar, size_t n);
+
+  // d = a * b + c; b e c podem ser escalares
+  void (*fmaF32)(float *d, const float *a, const float *b, bool bScalar, const float *c, bool cScalar, size_t n);
+  void (*fmaF64)(double *d, const double *a, const double *b, bool bScalar, const double *c, bool cScalar, size_t n);
+
+  void (*clampF32)(float *d, const float *a, float lo, float hi, size_t n);
+  void (*clampF64)(double *d, const double *a, double lo, double hi, size_t n);
+
+  // Reducoes acumulam em double (float32 incluido)
+  double (*sumF32)(const float *a, size_t n);
+  double (*sumF64)(const double *a, size_t n);
+  double (*dotF32)(const float *a, const float *b, size_t n);
+  double (*dotF64)(const double *a, const double *b, size_t n);
+
+  // n > 0
+  void (*minMaxF32)(const float *a, size_t n, float *outMin, float *outMax);
+  void (*minMaxF64)(const double *a, size_t n, double *outMin, double *outMax);
+
+  void (*f32ToF64)(double *d, const float *s, size_t n);
+  void (*f64ToF32)(float *d, const double *s, size_t n);
+};
+
+const VecKernels *vecKernelsScalar();
+const VecKernels *vecKernelsSse2(); // nullptr fora de x86
+// So pode ser chamada depois de confirmar AVX2+FMA na CPU (ver vecKernelsBest)
+const VecKernels *vecKernelsAvx2(); // nullptr se nao foi compilado com AVX2
+const VecKernels *vecKernelsBest();
+
+#ifdef BU_VEC_KERNEL_IMPL
+
+// ============================================
+// Generic loops over an ISA "lane" type S:
+//   S::T scalar type, S::V vector, S::W lanes,
+//   load/store/set1/add/sub/mul/div/fma/min/max,
+//   hmin/hmax (horizontal), and for the double accumulators
+//   S::D, zeroD, addD(D, V), fmaD(D, V, V), hsumD(D)
+// ============================================
+namespace
+{
+  template <class S>
+  struct VecAdd
+  {
+    static inline typename S::V vec(typename S::V x, typename S::V y) { return S::add(x, y); }
+    static inline typename S::T one(typename S::T x, typename S::T y) { return x + y; }
+  };
+
+  template <class S>
+  struct VecSub
+  {
+    static inline typename S::V vec(typename S::V x, typename S::V y) { return S::sub(x, y); }
+    static inline typename S::T one(typename S::T x, typename S::T y) { return x - y; }
+  };
+
+  template <class S>
+  struct VecMul
+  {
+    static inline typename S::V vec(typename S::V x, typename S::V y) { return S::mul(x, y); }
+    static inline typename S::T one(typename S::T x, typename S::T y) { return x * y; }
+  };
+
+  template <class S>
+  struct VecDiv
+  {
+    static inline typename S::V vec(typename S::V x, typename S::V y) { return S::div(x, y); }
+    static inline typename S::T one(typename S::T x, typename S::T y) { return x / y; }
+  };
+
+  template <class S, class Op>
+  void vecBinaryLoop(typename S::T *d, const typename S::T *a, const typename S::T *b, bool bScalar, size_t n)
+  {
+    typedef typename S::T T;
+    typedef typename S::V V;
+    size_t i = 0;
+    if (bScalar)
+    {
+      const T k = *b;
+      const V vk = S::set1(k);
+      for (; i + S::W <= n; i += S::W)
+        S::store(d + i, Op::vec(S::load(a + i), vk));
+      for (; i < n; i++)
+        d[i] = Op::one(a[i], k);
+    }
+    else
+    {
+      for (; i + S::W <= n; i += S::W)
+        S::store(d + i, Op::vec(S::load(a + i), S::load(b + i)));
+      for (; i < n; i++)
+        d[i] = Op::one(a[i], b[i]);
+    }
+  }
+
+  template <class S>
+  void vecBinary(VecOp op, typename S::T *d, const typename S::T *a, const typename S::T *b, bool bScalar, size_t n)
+  {
+    switch (op)
+    {
+    case VecOp::ADD:
+      vecBinaryLoop<S, VecAdd<S>>(d, a, b, bScalar, n);
+      break;
+    case VecOp::SUB:
+      vecBinaryLoop<S, VecSub<S>>(d, a, b, bScalar, n);
+      break;
+    case VecOp::MUL:
+      vecBinaryLoop<S, VecMul<S>>(d, a, b, bScalar, n);
+      break;
+    case VecOp::DIV:
+      vecBinaryLoop<S, VecDiv<S>>(d, a, b, bScalar, n);
+      break;
+    }
+  }
+
+  template <class S, bool BS, bool CS>
+  void vecFmaLoop(typename S::T *d, const typename S::T *a, const typename S::T *b, const typename S::T *c, size_t n)
+  {
+    typedef typename S::V V;
+    const V vb = S::set1(*b);
+    const V vc = S::set1(*c);
+    size_t i = 0;
+    for (; i + S::W <= n; i += S::W)
+    {
+      V y = BS ? vb : S::load(b + i);
+      V z = CS ? vc : S::load(c + i);
+      S::store(d + i, S::fma(S::load(a + i), y, z));
+    }
+    for (; i < n; i++)
+      d[i] = a[i] * (BS ? *b : b[i]) + (CS ? *c : c[i]);
+  }
+
+  template <class S>
+  void vecFma(typename S::T *d, const typename S::T *a, const typename S::T *b, bool bScalar,
+              const typename S::T *c, bool cScalar, size_t n)
+  {
+    if (n == 0)
+      return;
+    if (bScalar)
+    {
+      if (cScalar)
+        vecFmaLoop<S, true, true>(d, a, b, c, n);
+      else
+        vecFmaLoop<S, true, false>(d, a, b, c, n);
+    }
+    else
+    {
+      if (cScalar)
+        vecFmaLoop<S, false, true>(d, a, b, c, n);
+      else
+        vecFmaLoop<S, false, false>(d, a, b, c, n);
+    }
+  }
+
+  template <class S>
+  void vecClamp(typename S::T *d, const typename S::T *a, typename S::T lo, typename S::T hi, size_t n)
+  {
+    typedef typename S::T T;
+    typedef typename S::V V;
+    const V vlo = S::set1(lo);
+    const V vhi = S::set1(hi);
+    size_t i = 0;
+    for (; i + S::W <= n; i += S::W)
+      S::store(d + i, S::max(vlo, S::min(vhi, S::load(a + i))));
+    for (; i < n; i++)
+    {
+      T x = a[i];
+      x = x < hi ? x : hi;
+      d[i] = x > lo ? x : lo;
+    }
+  }
+
+  template <class S>
+  double vecSum(const typename S::T *a, size_t n)
+  {
+    typedef typename S::D D;
+    // Dois acumuladores escondem a latencia do add
+    D acc0 = S::zeroD();
+    D acc1 = S::zeroD();
+    size_t i = 0;
+    for (; i + 2 * S::W <= n; i += 2 * S::W)
+    {
+      acc0 = S::addD(acc0, S::load(a + i));
+      acc1 = S::addD(acc1, S::load(a + i + S::W));
+    }
+    for (; i + S::W <= n; i += S::W)
+      acc0 = S::addD(acc0, S::load(a + i));
+    double s = S::hsumD(acc0) + S::hsumD(acc1);
+    for (; i < n; i++)
+      s += (double)a[i];
+    return s;
+  }
+
+  template <class S>
+  double vecDot(const typename S::T *a, const typename S::T *b, size_t n)
+  {
+    typedef typename S::D D;
+    D acc0 = S::zeroD();
+    D acc1 = S::zeroD();
+    size_t i = 0;
+    for (; i + 2 * S::W <= n; i += 2 * S::W)
+    {
+      acc0 = S::fmaD(acc0, S::load(a + i), S::load(b + i));
+      acc1 = S::fmaD(acc1, S::load(a + i + S::W), S::load(b + i + S::W));
+    }
+    for (; i + S::W <= n; i += S::W)
+      acc0 = S::fmaD(acc0, S::load(a + i), S::load(b + i));
+    double s = S::hsumD(acc0) + S::hsumD(acc1);
+    for (; i < n; i++)
+      s += (double)a[i] * (double)b[i];
+    return s;
+  }
+
+  template <class S>
+  void vecMinMax(const typename S::T *a, size_t n, typename S::T *outMin, typename S::T *outMax)
+  {
+    typedef typename S::T T;
+    typedef typename S::V V;
+    T mn = a[0];
+    T mx = a[0];
+    size_t i = 0;
+    if (n >= S::W)
+    {
+      V vmn = S::load(a);
+      V vmx = vmn;
+      for (i = S::W; i + S::W <= n; i += S::W)
+      {
+        V x = S::load(a + i);
+        vmn = S::min(vmn, x);
+        vmx = S::max(vmx, x);
+      }
+      mn = S::hmin(vmn);
+      mx = S::hmax(vmx);
+    }
+    for (; i < n; i++)
+    {
+      mn = a[i] < mn ? a[i] : mn;
+      mx = a[i] > mx ? a[i] : mx;
+    }
+    *outMin = mn;
+    *outMax = mx;
+  }
+
+  // Lanes escalares: tambem servem de referencia para as outras ISAs
+  template <class TT>
+  struct ScalarLane
+  {
+    typedef TT T;
+    typedef TT V;
+    typedef double D;
+    enum
+    {
+      W = 1
+    };
+    static inline V load(const T *p) { return *p; }
+    static inline void store(T *p, V v) { *p = v; }
+    static inline V set1(T x) { return x; }
+    static inline V add(V x, V y) { return x + y; }
+    static inline V sub(V x, V y) { return x - y; }
+    static inline V mul(V x, V y) { return x * y; }
+    static inline V div(V x, V y) { return x / y; }
+    static inline V fma(V x, V y, V z) { return x * y + z; }
+    static inline V min(V x, V y) { return x < y ? x : y; }
+    static inline V max(V x, V y) { return x > y ? x : y; }
+    static inline T hmin(V x) { return x; }
+    static inline T hmax(V x) { return x; }
+    static inline D zeroD() { return 0.0; }
+    static inline D addD(D acc, V x) { return acc + (double)x; }
+    static inline D fmaD(D acc, V x, V y) { return acc + (double)x * (double)y; }
+    static inline double hsumD(D acc) { return acc; }
+  };
+} // namespace
+
+// Tabela constante (sem codigo de inicializacao a correr antes do teste de CPU)
+#define BU_VEC_KERNEL_TABLE(_name, _S32, _S64, _widen, _narrow)   \
+  {                                                               \
+    _name,                                                        \
+        vecBinary<_S32>, vecBinary<_S64>,                         \
+        vecFma<_S32>, vecFma<_S64>,                               \
+        vecClamp<_S32>, vecClamp<_S64>,                           \
+        vecSum<_S32>, vecSum<_S64>,                               \
+        vecDot<_S32>, vecDot<_S64>,                               \
+        vecMinMax<_S32>, vecMinMax<_S64>,                         \
+        _widen, _narrow                                           \
+  }
+
+#endif // BU_VEC_KERNEL_IMPL
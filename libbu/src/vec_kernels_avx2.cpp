@@ -0,0 +1,147 @@
+// AVX2 + FMA kernels. Compilado com -mavx2 -mfma (libbu/CMakeLists.txt);
+// so entra em uso depois de vecKernelsBest() confirmar a CPU.
+// Nao incluir aqui nada alem de vec_kernels.hpp e intrinsics.
+
+#define BU_VEC_KERNEL_IMPL
+#include "vec_kernels.hpp"
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+
+namespace
+{
+  struct Avx2F32
+  {
+    typedef float T;
+    typedef __m256 V;
+    typedef __m256d D;
+    enum
+    {
+      W = 8
+    };
+    static inline V load(const T *p) { return _mm256_loadu_ps(p); }
+    static inline void store(T *p, V v) { _mm256_storeu_ps(p, v); }
+    static inline V set1(T x) { return _mm256_set1_ps(x); }
+    static inline V add(V x, V y) { return _mm256_add_ps(x, y); }
+    static inline V sub(V x, V y) { return _mm256_sub_ps(x, y); }
+    static inline V mul(V x, V y) { return _mm256_mul_ps(x, y); }
+    static inline V div(V x, V y) { return _mm256_div_ps(x, y); }
+    static inline V fma(V x, V y, V z) { return _mm256_fmadd_ps(x, y, z); }
+    static inline V min(V x, V y) { return _mm256_min_ps(x, y); }
+    static inline V max(V x, V y) { return _mm256_max_ps(x, y); }
+    static inline T hmin(V x)
+    {
+      __m128 m = _mm_min_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+      m = _mm_min_ps(m, _mm_movehl_ps(m, m));
+      m = _mm_min_ss(m, _mm_shuffle_ps(m, m, 1));
+      return _mm_cvtss_f32(m);
+    }
+    static inline T hmax(V x)
+    {
+      __m128 m = _mm_max_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+      m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+      m = _mm_max_ss(m, _mm_shuffle_ps(m, m, 1));
+      return _mm_cvtss_f32(m);
+    }
+    static inline D zeroD() { return _mm256_setzero_pd(); }
+    static inline D addD(D acc, V x)
+    {
+      acc = _mm256_add_pd(acc, _mm256_cvtps_pd(_mm256_castps256_ps128(x)));
+      return _mm256_add_pd(acc, _mm256_cvtps_pd(_mm256_extractf128_ps(x, 1)));
+    }
+    static inline D fmaD(D acc, V x, V y)
+    {
+      acc = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(x)),
+                            _mm256_cvtps_pd(_mm256_castps256_ps128(y)), acc);
+      return _mm256_fmadd_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(x, 1)),
+                             _mm256_cvtps_pd(_mm256_extractf128_ps(y, 1)), acc);
+    }
+    static inline double hsumD(D acc)
+    {
+      __m128d s = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+      return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+    }
+  };
+
+  struct Avx2F64
+  {
+    typedef double T;
+    typedef __m256d V;
+    typedef __m256d D;
+    enum
+    {
+      W = 4
+    };
+    static inline V load(const T *p) { return _mm256_loadu_pd(p); }
+    static inline void store(T *p, V v) { _mm256_storeu_pd(p, v); }
+    static inline V set1(T x) { return _mm256_set1_pd(x); }
+    static inline V add(V x, V y) { return _mm256_add_pd(x, y); }
+    static inline V sub(V x, V y) { return _mm256_sub_pd(x, y); }
+    static inline V mul(V x, V y) { return _mm256_mul_pd(x, y); }
+    static inline V div(V x, V y) { return _mm256_div_pd(x, y); }
+    static inline V fma(V x, V y, V z) { return _mm256_fmadd_pd(x, y, z); }
+    static inline V min(V x, V y) { return _mm256_min_pd(x, y); }
+    static inline V max(V x, V y) { return _mm256_max_pd(x, y); }
+    static inline T hmin(V x)
+    {
+      __m128d m = _mm_min_pd(_mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1));
+      return _mm_cvtsd_f64(_mm_min_sd(m, _mm_unpackhi_pd(m, m)));
+    }
+    static inline T hmax(V x)
+    {
+      __m128d m = _mm_max_pd(_mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1));
+      return _mm_cvtsd_f64(_mm_max_sd(m, _mm_unpackhi_pd(m, m)));
+    }
+    static inline D zeroD() { return _mm256_setzero_pd(); }
+    static inline D addD(D acc, V x) { return _mm256_add_pd(acc, x); }
+    static inline D fmaD(D acc, V x, V y) { return _mm256_fmadd_pd(x, y, acc); }
+    static inline double hsumD(D acc)
+    {
+      __m128d s = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+      return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+    }
+  };
+} // namespace
+
+static void avx2F32ToF64(double *d, const float *s, size_t n)
+{
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    __m256 x = _mm256_loadu_ps(s + i);
+    _mm256_storeu_pd(d + i, _mm256_cvtps_pd(_mm256_castps256_ps128(x)));
+    _mm256_storeu_pd(d + i + 4, _mm256_cvtps_pd(_mm256_extractf128_ps(x, 1)));
+  }
+  for (; i < n; i++)
+    d[i] = (double)s[i];
+}
+
+static void avx2F64ToF32(float *d, const double *s, size_t n)
+{
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    __m128 lo = _mm256_cvtpd_ps(_mm256_loadu_pd(s + i));
+    __m128 hi = _mm256_cvtpd_ps(_mm256_loadu_pd(s + i + 4));
+    _mm256_storeu_ps(d + i, _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1));
+  }
+  for (; i < n; i++)
+    d[i] = (float)s[i];
+}
+
+static const VecKernels kAvx2Kernels =
+    BU_VEC_KERNEL_TABLE("avx2", Avx2F32, Avx2F64, avx2F32ToF64, avx2F64ToF32);
+
+const VecKernels *vecKernelsAvx2()
+{
+  return &kAvx2Kernels;
+}
+
+#else
+
+const VecKernels *vecKernelsAvx2()
+{
+  return nullptr;
+}
+
+#endif
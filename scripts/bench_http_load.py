@@ -0,0 +1,48 @@
+#!/usr/bin/env python3
+# Load generator for bench_http.bu: keep-alive connections sending pipelined
+# batches of GET requests; the server side counts the responses.
+# Usage: python3 bench_http_load.py <port> <seconds> [connections] [pipeline]
+import multiprocessing
+import socket
+import sys
+import time
+
+
+def worker(port, seconds, pipeline, out):
+    s = socket.create_connection(("127.0.0.1", port))
+    s.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+    batch = b"GET /plaintext HTTP/1.1\r\nHost: bench\r\n\r\n" * pipeline
+    done = 0
+    end = time.time() + seconds
+    buf = b""
+    while time.time() < end:
+        s.sendall(batch)
+        got = 0
+        while got < pipeline:
+            chunk = s.recv(1 << 20)
+            if not chunk:
+                out.put(done)
+                return
+            buf += chunk
+            n = buf.count(b"HTTP/1.1 200")
+            if n:
+                got += n
+                buf = buf[buf.rfind(b"HTTP/1.1 200") + 12:]
+        done += got
+    s.close()
+    out.put(done)
+
+
+if __name__ == "__main__":
+    port = int(sys.argv[1])
+    seconds = float(sys.argv[2])
+    conns = int(sys.argv[3]) if len(sys.argv) > 3 else 4
+    pipeline = int(sys.argv[4]) if len(sys.argv) > 4 else 16
+    out = multiprocessing.Queue()
+    procs = [multiprocessing.Process(target=worker, args=(port, seconds, pipeline, out)) for _ in range(conns)]
+    for p in procs:
+        p.start()
+    for _ in procs:
+        out.get()
+    for p in procs:
+        p.join()
@@ -0,0 +1,144 @@
+#!/usr/bin/env python3
+# Client side of test_docs_http.bu: exercises the HttpServer module and
+# writes "ok" (or the failures, one per line) to the result file.
+# Usage: python3 http_client_standin.py <port> <result_file>
+import http.client
+import socket
+import sys
+import time
+
+port = int(sys.argv[1])
+result_path = sys.argv[2]
+failures = []
+
+
+def check(cond, msg):
+    if not cond:
+        failures.append(msg)
+
+
+def raw(data, expect_responses, timeout=5):
+    # Sends raw bytes and reads until expect_responses complete responses
+    s = socket.create_connection(("127.0.0.1", port), timeout=timeout)
+    s.sendall(data)
+    buf = b""
+    responses = []
+    while len(responses) < expect_responses:
+        while b"\r\n\r\n" not in buf:
+            chunk = s.recv(65536)
+            if not chunk:
+                s.close()
+                return responses, True
+            buf += chunk
+        head, buf = buf.split(b"\r\n\r\n", 1)
+        length = 0
+        for line in head.split(b"\r\n")[1:]:
+            k, v = line.split(b":", 1)
+            if k.strip().lower() == b"content-length":
+                length = int(v)
+        while len(buf) < length:
+            chunk = s.recv(65536)
+            if not chunk:
+                break
+            buf += chunk
+        responses.append((head, buf[:length]))
+        buf = buf[length:]
+    s.settimeout(0.5)
+    closed = False
+    try:
+        closed = s.recv(1) == b""
+    except socket.timeout:
+        pass
+    s.close()
+    return responses, closed
+
+
+def run():
+    # Keep-alive: many requests, one connection
+    conn = http.client.HTTPConnection("127.0.0.1", port, timeout=5)
+    for i in range(50):
+        conn.request("GET", "/hello?n=%d" % i)
+        r = conn.getresponse()
+        body = r.read()
+        check(r.status == 200 and body == b"hello", "keep-alive GET %d" % i)
+    conn.request("GET", "/stats")
+    accepted_after_keepalive = int(conn.getresponse().read())
+
+    # POST with Content-Length, headers in and out
+    conn.request("POST", "/echo", body=b"x=1&y=2", headers={"X-Test": "abc"})
+    r = conn.getresponse()
+    check(r.read() == b"x=1&y=2", "POST echo body")
+    check(r.getheader("X-Method") == "POST", "response header")
+    check(r.getheader("X-Test") == "abc", "request header seen by script")
+
+    # Buffer body
+    conn.request("GET", "/buffer")
+    r = conn.getresponse()
+    check(r.read() == b"bytes", "Buffer body")
+    check(r.getheader("Content-Type") == "application/octet-stream", "custom content type")
+
+    # Large body: partial writes go through the output queue
+    conn.request("GET", "/big")
+    r = conn.getresponse()
+    body = r.read()
+    check(len(body) == 4 * 1024 * 1024 and body[:4] == b"0123", "large response")
+
+    conn.request("GET", "/missing")
+    r = conn.getresponse()
+    check(r.status == 404 and r.reason == "Not Found", "404 status text")
+    r.read()
+    conn.request("GET", "/stats")
+    check(int(conn.getresponse().read()) == accepted_after_keepalive, "single connection for all requests")
+    conn.close()
+
+    # Chunked request body, split across writes
+    s = socket.create_connection(("127.0.0.1", port), timeout=5)
+    s.sendall(b"POST /echo HTTP/1.1\r\nHost: x\r\nTransfer-Encoding: chunked\r\n\r\n5;ext=1\r\nhel")
+    time.sleep(0.05)
+    s.sendall(b"lo\r\n6\r\n world\r\n0\r\nX-Trailer: y\r\n\r\n")
+    data = b""
+    while b"hello world" not in data:
+        chunk = s.recv(4096)
+        if not chunk:
+            break
+        data += chunk
+    check(b"hello world" in data, "chunked request body")
+    s.close()
+
+    # Pipelining: the slow response must still come first
+    pipelined = (b"GET /slow HTTP/1.1\r\nHost: x\r\n\r\n"
+                 b"GET /hello HTTP/1.1\r\nHost: x\r\n\r\n"
+                 b"GET /hello HTTP/1.1\r\nHost: x\r\nConnection: close\r\n\r\n")
+    responses, closed = raw(pipelined, 3)
+    check(len(responses) == 3, "pipelined response count")
+    if len(responses) == 3:
+        check(responses[0][1] == b"slow" and responses[1][1] == b"hello", "pipelined order")
+        check(b"Connection: close" in responses[2][0], "close echoed")
+    check(closed, "server closes after Connection: close")
+
+    # HTTP/1.0 closes by default
+    responses, closed = raw(b"GET /hello HTTP/1.0\r\n\r\n", 1)
+    check(len(responses) == 1 and responses[0][1] == b"hello", "HTTP/1.0 request")
+    check(closed, "HTTP/1.0 closes")
+
+    # Malformed request and body limit are answered by the server itself
+    responses, closed = raw(b"NONSENSE\r\n\r\n", 1)
+    check(len(responses) == 1 and b" 400 " in responses[0][0], "400 on bad request line")
+    responses, closed = raw(b"POST /echo HTTP/1.1\r\nContent-Length: 999999999\r\n\r\n", 1)
+    check(len(responses) == 1 and b" 413 " in responses[0][0], "413 on oversized body")
+
+
+try:
+    run()
+except Exception as e:  # report instead of hanging the server
+    failures.append("exception: %r" % (e,))
+
+with open(result_path, "w") as f:
+    f.write("ok\n" if not failures else "\n".join(failures) + "\n")
+
+try:
+    c = http.client.HTTPConnection("127.0.0.1", port, timeout=5)
+    c.request("GET", "/quit")
+    c.getresponse().read()
+except Exception:
+    pass
@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+# Local HTTP/1.1 stand-in server for test_docs_socket.bu
+# Usage: python3 http_standin.py <port>
+import sys
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+connections = set()
+dropped = set()
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+
+    def log_message(self, fmt, *args):
+        pass
+
+    def send_body(self, body, extra=None):
+        self.send_response(200)
+        self.send_header("Content-Type", "text/plain")
+        self.send_header("Content-Length", str(len(body)))
+        for k, v in (extra or {}).items():
+            self.send_header(k, v)
+        self.end_headers()
+        self.wfile.write(body)
+
+    def send_chunked(self, parts):
+        self.send_response(200)
+        self.send_header("Content-Type", "text/plain")
+        self.send_header("Transfer-Encoding", "chunked")
+        self.end_headers()
+        for part in parts:
+            self.wfile.write(b"%x;ext=1\r\n%s\r\n" % (len(part), part))
+        self.wfile.write(b"0\r\nX-Trailer: done\r\n\r\n")
+
+    def do_GET(self):
+        connections.add(self.client_address)
+        if self.path == "/hello":
+            self.send_body(b"hello")
+        elif self.path.startswith("/query"):
+            self.send_body(self.path.encode())
+        elif self.path == "/chunked":
+            self.send_chunked([b"alpha-", b"beta-", b"gamma"])
+        elif self.path == "/big":
+            self.send_chunked([(b"%05d\n" % i) * 100 for i in range(200)])
+        elif self.path == "/close":
+            self.send_response(200)
+            self.send_header("Connection", "close")
+            self.end_headers()
+            self.wfile.write(b"until-close")
+            self.close_connection = True
+        elif self.path == "/empty":
+            self.send_response(204)
+            self.end_headers()
+        elif self.path == "/count":
+            self.send_body(str(len(connections)).encode())
+        elif self.path == "/interim":
+            self.wfile.write(b"HTTP/1.1 100 Continue\r\n\r\n")
+            self.wfile.write(b"HTTP/1.1 103 Early Hints\r\nLink: </a.css>\r\n\r\n")
+            self.send_body(b"final")
+        elif self.path == "/drop-once" and self.path not in dropped:
+            # Idle connection closed by the server as the request arrives
+            dropped.add(self.path)
+            self.close_connection = True
+        else:
+            self.send_body(b"missing", None)
+
+    def do_POST(self):
+        connections.add(self.client_address)
+        length = int(self.headers.get("Content-Length", "0"))
+        data = self.rfile.read(length)
+        self.send_body(data, {"X-Content-Type": self.headers.get("Content-Type", "")})
+
+
+if __name__ == "__main__":
+    port = int(sys.argv[1]) if len(sys.argv) > 1 else 18080
+    ThreadingHTTPServer(("127.0.0.1", port), Handler).serve_forever()
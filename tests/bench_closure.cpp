@@ -0,0 +1,134 @@
+// ============================================
+// Closure creation micro-benchmark
+// Each case creates N closures (a nested def, mostly one per function call as
+// callbacks do) and calls each one once; the time is taken in-script with
+// time.current().
+// "copied" captures are never assigned (UPVALUE_BY_VALUE: the value lives in
+// the closure), "shared" ones are written by the closure (one Upvalue per
+// captured variable, found through openUpvalues). Also prints the heap bytes
+// each retained closure costs (Closure + Upvalue objects, from getGCStats).
+// Usage: bulang_bench_closure [closures=1000000]
+// ============================================
+
+#include "interpreter.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+struct BenchCase
+{
+    const char *name;
+    const char *global; // seconds, written by the script
+};
+
+static const BenchCase kCases[] = {
+    {"factory x1", "tFactory1"},
+    {"factory x3", "tFactory3"},
+    {"counter", "tCounter"},
+    {"loop body", "tLoop"},
+    {"grandparent", "tChain"},
+    {"map callback", "tMap"},
+};
+
+static double globalNumber(Interpreter &vm, const char *name)
+{
+    Value v;
+    if (!vm.tryGetGlobal(name, &v) || !v.isNumber())
+        return -1.0;
+    return v.asNumber();
+}
+
+static size_t closureBytes(Interpreter &vm)
+{
+    GCStats stats;
+    vm.getGCStats(stats);
+    return stats.kinds[(int)GCObjectType::CLOSURE].bytes + stats.kinds[(int)GCObjectType::UPVALUE].bytes;
+}
+
+int main(int argc, char *argv[])
+{
+    int closures = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    if (closures < 100)
+        closures = 1000000;
+
+    std::string script = "import time;\n"
+                         "var n = " + std::to_string(closures) + ";\n" +
+                         // Uma closure por chamada, com variaveis novas: k, a, b, c copiadas
+                         "def adder(k) { def f(x) { return x + k; } return f; }\n"
+                         "def summer(a, b, c) { def f() { return a + b + c; } return f; }\n"
+                         // c escrita pela closure: Upvalue partilhado, fechado no return
+                         "def counter() { var c = 0; def f() { c += 1; return c; } return f; }\n"
+                         "def factory1(n) { var t0 = time.current(); var s = 0;\n"
+                         "    for (var i = 0; i < n; i++) { s += adder(3)(1); }\n"
+                         "    var t = time.current() - t0; if (s != 4 * n) { return -1; } return t; }\n"
+                         "def factory3(n) { var t0 = time.current(); var s = 0;\n"
+                         "    for (var i = 0; i < n; i++) { s += summer(1, 2, 3)(); }\n"
+                         "    var t = time.current() - t0; if (s != 6 * n) { return -1; } return t; }\n"
+                         "def counters(n) { var t0 = time.current(); var s = 0;\n"
+                         "    for (var i = 0; i < n; i++) { s += counter()(); }\n"
+                         "    var t = time.current() - t0; if (s != n) { return -1; } return t; }\n"
+                         // def no corpo do loop sobre uma local da funcao (ja aberta)
+                         "def loopBody(n) { var t0 = time.current(); var k = 3; var s = 0;\n"
+                         "    for (var i = 0; i < n; i++) { def f(x) { return x + k; } s += f(1); }\n"
+                         "    var t = time.current() - t0; if (s != 4 * n) { return -1; } return t; }\n"
+                         // inner le k do avo: middle tambem passa a ser closure
+                         "def chain(n) { var t0 = time.current(); var k = 2; var s = 0;\n"
+                         "    for (var i = 0; i < n; i++) {\n"
+                         "        def middle() { def inner() { return k; } return inner; }\n"
+                         "        s += middle()(); }\n"
+                         "    var t = time.current() - t0; if (s != 2 * n) { return -1; } return t; }\n"
+                         // Padrao map/filter da stdlib: uma closure por chamada
+                         "def mapped(n) { var t0 = time.current(); var items = [1, 2]; var s = 0;\n"
+                         "    for (var i = 0; i < n; i++) { var d = i; def add(x) { return x + d; } s += sum(map(items, add)); }\n"
+                         "    var t = time.current() - t0; if (s <= 0) { return -1; } return t; }\n"
+                         "var tFactory1 = factory1(n);\n"
+                         "var tFactory3 = factory3(n);\n"
+                         "var tCounter = counters(n);\n"
+                         "var tLoop = loopBody(n);\n"
+                         "var tChain = chain(n);\n"
+                         "var tMap = mapped(n);\n";
+
+    Interpreter vm;
+    vm.registerAll();
+    if (!vm.run(script.c_str()))
+    {
+        std::fprintf(stderr, "script failed:\n%s\n", script.c_str());
+        return 1;
+    }
+
+    std::printf("closures: %d, sizeof(Closure): %zu, sizeof(Upvalue): %zu\n", closures, sizeof(Closure),
+                sizeof(Upvalue));
+    std::printf("%-14s %12s %14s\n", "case", "total ms", "ns/closure");
+    bool ok = true;
+    for (const BenchCase &bc : kCases)
+    {
+        double t = globalNumber(vm, bc.global);
+        if (t < 0)
+        {
+            std::printf("%-14s %12s %14s\n", bc.name, "failed", "-");
+            ok = false;
+            continue;
+        }
+        std::printf("%-14s %12.3f %14.1f\n", bc.name, t * 1000.0, t * 1e9 / closures);
+    }
+
+    // Bytes por closure viva: 10000 guardadas num array, cada caso numa VM nova
+    const char *retained[][2] = {
+        {"copied", "def retain(n) { var keep = [];\n"
+                   "    for (var i = 0; i < n; i++) { var k = i; def f() { return k; } keep.push(f); } return keep; }\n"
+                   "var kept = retain(10000);\n"},
+        {"shared", "def retain(n) { var keep = [];\n"
+                   "    for (var i = 0; i < n; i++) { var k = 0; def f() { k += 1; } keep.push(f); } return keep; }\n"
+                   "var kept = retain(10000);\n"},
+    };
+    for (auto &r : retained)
+    {
+        Interpreter keep;
+        keep.registerAll();
+        if (!keep.run(r[1]))
+            return 1;
+        keep.runGC();
+        std::printf("bytes/closure (%s): %.1f\n", r[0], closureBytes(keep) / 10000.0);
+    }
+    return ok ? 0 : 1;
+}
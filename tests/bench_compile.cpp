@@ -0,0 +1,110 @@
+// ============================================
+// Compile-throughput benchmark
+// Generates a multi-MB script (functions with many locals, loops, nested
+// scopes, closures, classes, strings, f-strings) and times lexing+compiling
+// it on a fresh VM. Nothing is executed.
+// Usage: bulang_bench_compile [megabytes=4] [runs=5]
+// ============================================
+
+#include "interpreter.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+static void emitFunction(std::string &out, int n)
+{
+    char buf[2048];
+    std::snprintf(buf, sizeof(buf),
+                  "def compute_%d(alpha, beta, gamma)\n"
+                  "{\n"
+                  "    var total = 0;\n"
+                  "    var scale = alpha * 2 + beta;\n"
+                  "    var title = \"function number %d\";\n"
+                  "    for (var index = 0; index < gamma; index++) {\n"
+                  "        var offset = index %% 7;\n"
+                  "        if (offset == 0 && scale > 10) {\n"
+                  "            total = total + scale * offset - beta;\n"
+                  "        } elif (offset == 3) {\n"
+                  "            total += alpha / (offset + 1);\n"
+                  "        } else {\n"
+                  "            var temporary = [offset, scale, total];\n"
+                  "            total = total + len(temporary) + temporary[1];\n"
+                  "        }\n"
+                  "    }\n"
+                  "    var counter = 0;\n"
+                  "    def bump() { counter = counter + scale; return counter; }\n"
+                  "    while (counter < 100) { bump(); }\n"
+                  "    var summary = {\"total\": total, \"title\": title, \"counter\": counter};\n"
+                  "    return f\"{title}: {total} / {summary}\";\n"
+                  "}\n\n",
+                  n, n);
+    out += buf;
+}
+
+static void emitClass(std::string &out, int n)
+{
+    char buf[1024];
+    std::snprintf(buf, sizeof(buf),
+                  "class Shape_%d\n"
+                  "{\n"
+                  "    var width;\n"
+                  "    var height;\n"
+                  "    def init(w, h) { self.width = w; self.height = h; }\n"
+                  "    def area() { return self.width * self.height; }\n"
+                  "    def grow(amount) { self.width += amount; self.height += amount; return self; }\n"
+                  "}\n\n",
+                  n);
+    out += buf;
+}
+
+int main(int argc, char *argv[])
+{
+    double megabytes = argc > 1 ? std::atof(argv[1]) : 4.0;
+    int runs = argc > 2 ? std::atoi(argv[2]) : 5;
+    if (megabytes <= 0)
+        megabytes = 4.0;
+    if (runs < 1)
+        runs = 1;
+
+    std::string source;
+    size_t target = (size_t)(megabytes * 1024 * 1024);
+    source.reserve(target + 4096);
+    int functions = 0;
+    while (source.size() < target)
+    {
+        emitFunction(source, functions);
+        if (functions % 16 == 0)
+            emitClass(source, functions);
+        functions++;
+    }
+
+    std::printf("source: %.2f MB, %d functions\n", source.size() / (1024.0 * 1024.0), functions);
+
+    std::vector<double> times;
+    for (int r = 0; r < runs; r++)
+    {
+        Interpreter vm;
+        vm.registerAll();
+
+        auto t0 = std::chrono::steady_clock::now();
+        bool ok = vm.compile(source.c_str(), false);
+        auto t1 = std::chrono::steady_clock::now();
+        if (!ok)
+        {
+            std::fprintf(stderr, "compile failed\n");
+            return 1;
+        }
+        times.push_back(std::chrono::duration<double>(t1 - t0).count());
+    }
+
+    std::sort(times.begin(), times.end());
+    double best = times.front();
+    double median = times[times.size() / 2];
+    double mb = source.size() / (1024.0 * 1024.0);
+    std::printf("compile: best %.1f ms, median %.1f ms, %.1f MB/s\n",
+                best * 1000.0, median * 1000.0, mb / best);
+    return 0;
+}
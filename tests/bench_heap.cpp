@@ -0,0 +1,100 @@
+// ============================================
+// GC object heap micro-benchmark
+// "churn" creates N short-lived arrays/maps/structs (dead right away, as in a
+// game loop) and times them in-script with time.current(). "spike" keeps N of
+// them alive, drops them and collects: prints the object heap reserved
+// (GCStats::heapReserved) and the process RSS at each point, to see memory go
+// down after the spike.
+// Usage: bulang_bench_heap [objects=2000000]
+// ============================================
+
+#include "interpreter.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+static double globalNumber(Interpreter &vm, const char *name)
+{
+    Value v;
+    if (!vm.tryGetGlobal(name, &v) || !v.isNumber())
+        return -1.0;
+    return v.asNumber();
+}
+
+// Resident set em MB (so Linux; -1 nos outros)
+static double residentMB()
+{
+#if defined(__linux__)
+    FILE *f = std::fopen("/proc/self/statm", "r");
+    if (!f)
+        return -1.0;
+    long pages = 0, resident = 0;
+    int read = std::fscanf(f, "%ld %ld", &pages, &resident);
+    std::fclose(f);
+    if (read != 2)
+        return -1.0;
+    return resident * (double)sysconf(_SC_PAGESIZE) / (1024.0 * 1024.0);
+#else
+    return -1.0;
+#endif
+}
+
+static void printHeap(Interpreter &vm, const char *when)
+{
+    GCStats stats;
+    vm.getGCStats(stats);
+    std::printf("%-10s reserved %8.1f MB  released %8.1f MB  rss %8.1f MB\n", when,
+                stats.heapReserved / (1024.0 * 1024.0), stats.heapReleased / (1024.0 * 1024.0), residentMB());
+}
+
+int main(int argc, char *argv[])
+{
+    int objects = argc > 1 ? std::atoi(argv[1]) : 2000000;
+    if (objects < 1000)
+        objects = 2000000;
+
+    std::string script = "import time;\n"
+                         "var n = " + std::to_string(objects) + ";\n" +
+                         "struct P { x, y }\n"
+                         "def churn(n) { var t0 = time.current(); var s = 0;\n"
+                         "    for (var i = 0; i < n; i++) { var a = [i]; var m = {}; var p = P(i, 1); s += a.length() + p.y; }\n"
+                         "    var t = time.current() - t0; if (s != 2 * n) { return -1; } return t; }\n"
+                         "var tChurn = churn(n);\n";
+
+    Interpreter vm;
+    vm.registerAll();
+    if (!vm.run(script.c_str()))
+    {
+        std::fprintf(stderr, "script failed:\n%s\n", script.c_str());
+        return 1;
+    }
+
+    double t = globalNumber(vm, "tChurn");
+    if (t < 0)
+    {
+        std::fprintf(stderr, "churn failed\n");
+        return 1;
+    }
+    std::printf("objects: %d\n", objects);
+    std::printf("churn      %10.3f ms  %8.1f ns/iteration (array + map + struct)\n", t * 1000.0, t * 1e9 / objects);
+
+    // Pico: objetos vivos ate ao fim de spike(), depois uma recolha
+    Interpreter spike;
+    spike.registerAll();
+    std::string keep = "struct P { x, y }\n"
+                       "var kept = [];\n"
+                       "def fill(n) { for (var i = 0; i < n; i++) { kept.push([i]); kept.push(P(i, i)); } }\n"
+                       "fill(" + std::to_string(objects / 4) + ");\n";
+    if (!spike.run(keep.c_str()))
+        return 1;
+    printHeap(spike, "peak");
+    if (!spike.run("kept = nil;\n"))
+        return 1;
+    spike.runGC();
+    printHeap(spike, "collected");
+    return 0;
+}
@@ -0,0 +1,241 @@
+// ============================================
+// Process scheduler micro-benchmark (headless, no raylib)
+// Each workload spawns its processes from a script and then drives
+// Interpreter::update() from C++ for a fixed number of frames, timing only
+// the update loop. Prints ns per process-step (one resume of one process),
+// spawns/kills per second where the workload churns, bytes per process
+// (sizeof(Process) + its PrivateColumns slot + GC heap growth while spawning)
+// and the cost of one render() through VMHooks::onRenderBatch. `workers` > 1
+// turns on the parallel update() (Interpreter::setProcessWorkers).
+// Usage: bulang_bench_scheduler [processes=10000] [frames=300] [workers=0]
+// ============================================
+
+#include "interpreter.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+struct BenchCase
+{
+    const char *name;
+    const char *script; // define the processes and spawn n of them (n = global)
+};
+
+static const BenchCase kCases[] = {
+    // Ball de visualTest/test_stress_fps.bu, sem desenho
+    {"balls",
+     "process Ball(sx, sy, svx, svy) {\n"
+     "    x = sx; y = sy;\n"
+     "    var vx = svx; var vy = svy;\n"
+     "    loop {\n"
+     "        x += vx; y += vy;\n"
+     "        if (x < 0 || x > 800) { vx = -vx; }\n"
+     "        if (y < 0 || y > 600) { vy = -vy; }\n"
+     "        frame;\n"
+     "    }\n"
+     "}\n"
+     "for (var i = 0; i < n; i++) { Ball(i % 800, i % 600, 1 + i % 3, 2 - i % 5); }\n"},
+
+    // Cada Spark vive 1..8 frames e deixa um substituto ao morrer
+    {"spawn/kill",
+     "var spawned = 0;\n"
+     "process Spark(life) {\n"
+     "    var t = 0;\n"
+     "    loop {\n"
+     "        t += 1;\n"
+     "        if (t > life) { spawned += 1; Spark(life); exit; }\n"
+     "        frame;\n"
+     "    }\n"
+     "}\n"
+     "for (var i = 0; i < n; i++) { Spark(1 + i % 8); }\n"},
+
+    // Como spawn/kill, mas as mortes de cada frame sao repostas num so spawn_many
+    {"spawn_many",
+     "var spawned = 0;\n"
+     "var dead = 0;\n"
+     "process Spark(life) {\n"
+     "    var t = 0;\n"
+     "    loop {\n"
+     "        t += 1;\n"
+     "        if (t > life) { dead += 1; exit; }\n"
+     "        frame;\n"
+     "    }\n"
+     "}\n"
+     "process Refill() {\n"
+     "    loop {\n"
+     "        if (dead > 0) {\n"
+     "            var args = [];\n"
+     "            for (var i = 0; i < dead; i++) { args.push([1 + i % 8]); }\n"
+     "            spawn_many(Spark, dead, args);\n"
+     "            spawned += dead; dead = 0;\n"
+     "        }\n"
+     "        frame;\n"
+     "    }\n"
+     "}\n"
+     "var first = [];\n"
+     "for (var i = 0; i < n; i++) { first.push([1 + i % 8]); }\n"
+     "spawn_many(Spark, n, first);\n"
+     "Refill();\n"},
+
+    // Mistura de frame(25) / frame / frame(400) (acorda a cada 4 frames)
+    {"frame(N) mix",
+     "process Sleeper(pct) {\n"
+     "    var t = 0;\n"
+     "    loop { t += 1; frame(pct); }\n"
+     "}\n"
+     "var pcts = [25, 100, 400, 400];\n"
+     "for (var i = 0; i < n; i++) { Sleeper(pcts[i % 4]); }\n"},
+
+    // Bolas com colisao pela grelha do modulo space (antes: O(n^2) em script)
+    {"space.collide",
+     "import space;\n"
+     "var hits = 0;\n"
+     "space.setup(32, 8);\n"
+     "process Mote(sx, sy, svx, svy) {\n"
+     "    x = sx; y = sy;\n"
+     "    var vx = svx; var vy = svy;\n"
+     "    loop {\n"
+     "        x += vx; y += vy;\n"
+     "        if (x < 0 || x > 2000) { vx = -vx; }\n"
+     "        if (y < 0 || y > 2000) { vy = -vy; }\n"
+     "        if (space.collide(type Mote) != nil) { hits += 1; }\n"
+     "        frame;\n"
+     "    }\n"
+     "}\n"
+     "for (var i = 0; i < n; i++) { Mote((i * 37) % 2000, (i * 91) % 2000, 1 + i % 3, 2 - i % 5); }\n"},
+
+    // Sem signal() nesta arvore: as buscas equivalentes sao get_id / proc
+    {"get_id/proc",
+     "var hits = 0;\n"
+     "process Target() { loop { frame; } }\n"
+     "process Seeker(tid) {\n"
+     "    loop {\n"
+     "        var p = proc(tid);\n"
+     "        if (p != nil && get_id(type Target) >= 0) { hits += 1; }\n"
+     "        frame;\n"
+     "    }\n"
+     "}\n"
+     "var targets = [];\n"
+     "for (var i = 0; i < 64; i++) { targets.push(Target().id); }\n"
+     "for (var i = 0; i < n; i++) { Seeker(targets[i % 64]); }\n"},
+};
+
+static size_t gSteps = 0;
+static size_t gDestroyed = 0;
+static size_t gDrawn = 0;
+static double gSum = 0.0;
+
+static void countSteps(Interpreter *, Process *const *, size_t count, float) { gSteps += count; }
+static void drawBatch(Interpreter *, const ProcessRenderBatch &batch)
+{
+    // Um host submeteria aqui os sprites; soma so para o loop nao desaparecer
+    for (size_t i = 0; i < batch.count; i++)
+        gSum += batch.x[i] + batch.y[i] + batch.angle[i] + batch.size[i] + batch.graph[i];
+    gDrawn += batch.count;
+}
+static void countDestroy(Interpreter *, Process *, int) { gDestroyed++; }
+
+static size_t heapBytes(Interpreter &vm)
+{
+    GCStats stats;
+    vm.getGCStats(stats);
+    return stats.heapBytes;
+}
+
+static double globalNumber(Interpreter &vm, const char *name)
+{
+    Value v;
+    if (!vm.tryGetGlobal(name, &v) || !v.isNumber())
+        return -1.0;
+    return v.asNumber();
+}
+
+int main(int argc, char *argv[])
+{
+    int processes = argc > 1 ? std::atoi(argv[1]) : 10000;
+    int frames = argc > 2 ? std::atoi(argv[2]) : 300;
+    int workers = argc > 3 ? std::atoi(argv[3]) : 0;
+    if (processes < 1)
+        processes = 10000;
+    if (frames < 1)
+        frames = 300;
+
+    std::printf("processes: %d, frames: %d, workers: %d, sizeof(Process): %zu bytes\n",
+                processes, frames, workers, sizeof(Process));
+    std::printf("%-14s %12s %12s %12s %14s %12s %12s\n", "case", "steps", "ns/step", "ms/frame", "spawns/s",
+                "bytes/proc", "ms/render");
+
+    for (const BenchCase &bc : kCases)
+    {
+        Interpreter vm;
+        vm.registerAll();
+        vm.setProcessWorkers(workers);
+
+        VMHooks hooks;
+        hooks.onUpdateBatch = countSteps;
+        hooks.onRenderBatch = drawBatch;
+        hooks.onDestroy = countDestroy;
+        vm.setHooks(hooks);
+
+        size_t heapBefore = heapBytes(vm);
+        std::string script = "var n = " + std::to_string(processes) + ";\n" + bc.script;
+        if (!vm.run(script.c_str()))
+        {
+            std::fprintf(stderr, "script failed:\n%s\n", script.c_str());
+            return 1;
+        }
+        size_t alive = vm.getAliveProcesses().size();
+        size_t heapGrowth = heapBytes(vm) - heapBefore;
+        double bytesPerProc = sizeof(Process) + (alive ? (double)heapGrowth / alive : 0.0);
+#if BU_ENABLE_PRIVATE_COLUMNS
+        bytesPerProc += PRIVATE_COLUMNS * sizeof(Value);
+#endif
+
+        // Primeiro update fora da medicao (processos ainda nao iniciados)
+        vm.update(0.016f);
+        double spawnedBefore = globalNumber(vm, "spawned");
+
+        gSteps = 0;
+        gDestroyed = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (int f = 0; f < frames; f++)
+            vm.update(0.016f);
+        auto t1 = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(t1 - t0).count();
+
+        gDrawn = 0;
+        auto r0 = std::chrono::steady_clock::now();
+        for (int f = 0; f < frames; f++)
+            vm.render();
+        auto r1 = std::chrono::steady_clock::now();
+        double renderSeconds = std::chrono::duration<double>(r1 - r0).count();
+
+        double spawned = globalNumber(vm, "spawned");
+        std::printf("%-14s %12zu %12.1f %12.3f", bc.name, gSteps,
+                    gSteps ? seconds * 1e9 / gSteps : 0.0, seconds * 1000.0 / frames);
+        if (spawned >= 0)
+            std::printf(" %14.0f", (spawned - spawnedBefore) / seconds);
+        else
+            std::printf(" %14s", "-");
+        std::printf(" %12.0f %12.3f\n", bytesPerProc, renderSeconds * 1000.0 / frames);
+
+        if (spawned >= 0 && gDestroyed == 0)
+        {
+            std::fprintf(stderr, "%s: no process was destroyed\n", bc.name);
+            return 1;
+        }
+        if (gDrawn == 0)
+        {
+            std::fprintf(stderr, "%s: render batch was empty\n", bc.name);
+            return 1;
+        }
+        if (globalNumber(vm, "hits") == 0)
+        {
+            std::fprintf(stderr, "%s: lookups found nothing\n", bc.name);
+            return 1;
+        }
+        vm.killAliveProcess();
+    }
+    return 0;
+}
@@ -0,0 +1,89 @@
+// ============================================
+// String building micro-benchmark
+// Appends a one-byte piece N times to a local with s = s + x and s += x
+// (grown in place), with StringBuilder, and to a global (copies every time,
+// run with N / 50 as the reference), and prints ns per append.
+// Usage: bulang_bench_string [appends=1000000]
+// ============================================
+
+#include "interpreter.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+static double timedGlobal(Interpreter &vm, const char *name)
+{
+    Value v;
+    if (!vm.tryGetGlobal(name, &v) || !v.isNumber())
+        return -1.0;
+    return v.asNumber();
+}
+
+int main(int argc, char *argv[])
+{
+    int appends = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    if (appends < 100)
+        appends = 1000000;
+    int globalAppends = appends / 50;
+
+    char setup[256];
+    std::snprintf(setup, sizeof(setup),
+                  "import time;\n"
+                  "var n = %d;\n"
+                  "var ng = %d;\n",
+                  appends, globalAppends);
+
+    // Tudo num so script: o tempo e medido la dentro com time.current()
+    std::string script = std::string(setup) +
+                         "def localConcat(n) { var t0 = time.current(); var s = \"\"; "
+                         "for (var i = 0; i < n; i++) { s = s + \"x\"; } "
+                         "var t = time.current() - t0; if (len(s) != n) { return -1; } return t; }\n"
+                         "def localAppend(n) { var t0 = time.current(); var s = \"\"; var piece = \"x\"; "
+                         "for (var i = 0; i < n; i++) { s += piece; } "
+                         "var t = time.current() - t0; if (len(s) != n) { return -1; } return t; }\n"
+                         "def builder(n) { var t0 = time.current(); var sb = StringBuilder(); "
+                         "for (var i = 0; i < n; i++) { sb.append(\"x\"); } var s = sb.toString(); "
+                         "var t = time.current() - t0; if (len(s) != n) { return -1; } return t; }\n"
+                         "var gs = \"\";\n"
+                         "def globalConcat(n) { var t0 = time.current(); "
+                         "for (var i = 0; i < n; i++) { gs = gs + \"x\"; } "
+                         "var t = time.current() - t0; if (len(gs) != n) { return -1; } return t; }\n"
+                         "var tLocalConcat = localConcat(n);\n"
+                         "var tLocalAppend = localAppend(n);\n"
+                         "var tBuilder = builder(n);\n"
+                         "var tGlobal = globalConcat(ng);\n";
+
+    Interpreter vm;
+    vm.registerAll();
+    if (!vm.run(script.c_str()))
+    {
+        std::fprintf(stderr, "script failed:\n%s\n", script.c_str());
+        return 1;
+    }
+
+    struct Row
+    {
+        const char *name;
+        const char *global;
+        int count;
+    };
+    const Row rows[] = {
+        {"local s = s + x", "tLocalConcat", appends},
+        {"local s += x", "tLocalAppend", appends},
+        {"StringBuilder", "tBuilder", appends},
+        {"global s = s + x", "tGlobal", globalAppends},
+    };
+
+    std::printf("%-18s %10s %12s %12s\n", "case", "appends", "total ms", "ns/append");
+    for (const Row &row : rows)
+    {
+        double t = timedGlobal(vm, row.global);
+        if (t < 0)
+        {
+            std::printf("%-18s %10d %12s %12s\n", row.name, row.count, "failed", "-");
+            continue;
+        }
+        std::printf("%-18s %10d %12.3f %12.1f\n", row.name, row.count, t * 1000.0, t * 1e9 / row.count);
+    }
+    return 0;
+}
@@ -0,0 +1,116 @@
+// ============================================
+// vec module micro-benchmark
+// Each case runs the same operation as a bytecode loop over typed arrays
+// (a[i] indexing, JIT on) and as one vec.* call per kernel set (scalar,
+// sse2, best available), on the same data, and prints ms per pass.
+// Usage: bulang_bench_vec [elements=1048576] [passes=10]
+// ============================================
+
+#include "interpreter.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+struct BenchCase
+{
+    const char *name;
+    const char *loop; // body of def kernel(d, a, b, c, dd, da, n)
+    const char *call; // the same operation as one vec.* call
+};
+
+static const BenchCase kCases[] = {
+    {"add f32", "for (var i = 0; i < n; i++) { d[i] = a[i] + b[i]; }", "vec.add(d, a, b);"},
+    {"scale f64", "for (var i = 0; i < n; i++) { dd[i] = da[i] * 1.5; }", "vec.mul(dd, da, 1.5);"},
+    {"fma f32", "for (var i = 0; i < n; i++) { d[i] = a[i] * b[i] + c[i]; }", "vec.fma(d, a, b, c);"},
+    {"sum f64", "var s = 0.0; for (var i = 0; i < n; i++) { s = s + da[i]; }", "vec.sum(da);"},
+    {"dot f32", "var s = 0.0; for (var i = 0; i < n; i++) { s = s + a[i] * b[i]; }", "vec.dot(a, b);"},
+    {"max f64", "var m = da[0]; for (var i = 1; i < n; i++) { if (da[i] > m) { m = da[i]; } }", "vec.max(da);"},
+    {"clamp f32",
+     "for (var i = 0; i < n; i++) { var x = a[i]; if (x < 10) { x = 10; } if (x > 20) { x = 20; } d[i] = x; }",
+     "vec.clamp(d, a, 10, 20);"},
+    {"f32 -> f64", "for (var i = 0; i < n; i++) { dd[i] = a[i]; }", "vec.convert(dd, a);"},
+    {"fill f64", "for (var i = 0; i < n; i++) { dd[i] = 2.5; }", "vec.fill(dd, 2.5);"},
+    {"copy f64", "for (var i = 0; i < n; i++) { dd[i] = da[i]; }", "vec.copy(dd, 0, da, 0, n);"},
+};
+
+static double timedGlobal(Interpreter &vm, const char *name)
+{
+    Value v;
+    if (!vm.tryGetGlobal(name, &v) || !v.isNumber())
+        return -1.0;
+    return v.asNumber();
+}
+
+int main(int argc, char *argv[])
+{
+    int elements = argc > 1 ? std::atoi(argv[1]) : 1 << 20;
+    int passes = argc > 2 ? std::atoi(argv[2]) : 10;
+    if (elements < 16)
+        elements = 1 << 20;
+    if (passes < 1)
+        passes = 1;
+
+    char setup[1024];
+    std::snprintf(setup, sizeof(setup),
+                  "import vec;\n"
+                  "import time;\n"
+                  "var n = %d;\n"
+                  "var passes = %d;\n"
+                  "def ramp(arr, k) { for (var i = 0; i < n; i++) { arr.add((i %% 97) * k); } return arr; }\n"
+                  "var a = ramp(Float32Array(n), 0.25);\n"
+                  "var b = ramp(Float32Array(n), 0.5);\n"
+                  "var c = ramp(Float32Array(n), 1);\n"
+                  "var d = ramp(Float32Array(n), 0);\n"
+                  "var da = ramp(Float64Array(n), 0.125);\n"
+                  "var dd = ramp(Float64Array(n), 0);\n",
+                  elements, passes);
+
+    std::printf("elements: %d, passes: %d (ms per pass)\n", elements, passes);
+    {
+        Interpreter vm;
+        vm.registerAll();
+        Value best;
+        if (vm.run("import vec;\nvar isaName = vec.isa();\n") && vm.tryGetGlobal("isaName", &best) && best.isString())
+            std::printf("best kernels: %s\n", best.asStringChars());
+    }
+    std::printf("%-12s %10s %10s %10s %10s %9s\n", "case", "bytecode", "scalar", "sse2", "best", "speedup");
+
+    for (const BenchCase &bc : kCases)
+    {
+        Interpreter vm;
+        vm.registerAll();
+
+        // Tudo num so script: o tempo e medido la dentro com time.current()
+        std::string script = std::string(setup) +
+                             "def kernel(d, a, b, c, dd, da, n) { " + bc.loop + " }\n"
+                             "def timeLoop() { var t0 = time.current(); "
+                             "for (var r = 0; r < passes; r++) { kernel(d, a, b, c, dd, da, n); } "
+                             "var t = time.current() - t0; return t / passes; }\n"
+                             "def timeVec(isa) { if (vec.isa(isa) == nil) { return -1; } var t0 = time.current(); "
+                             "for (var r = 0; r < passes; r++) { " + bc.call + " } "
+                             "var t = time.current() - t0; return t / passes; }\n"
+                             "var tLoop = timeLoop();\n"
+                             "var tScalar = timeVec(\"scalar\");\n"
+                             "var tSse2 = timeVec(\"sse2\");\n"
+                             "var tBest = timeVec(\"best\");\n";
+        if (!vm.run(script.c_str()))
+        {
+            std::fprintf(stderr, "script failed:\n%s\n", script.c_str());
+            return 1;
+        }
+
+        double loopTime = timedGlobal(vm, "tLoop");
+        double vecTime[3] = {timedGlobal(vm, "tScalar"), timedGlobal(vm, "tSse2"), timedGlobal(vm, "tBest")};
+
+        std::printf("%-12s %10.3f", bc.name, loopTime * 1000.0);
+        for (int k = 0; k < 3; k++)
+        {
+            if (vecTime[k] < 0)
+                std::printf(" %10s", "-");
+            else
+                std::printf(" %10.3f", vecTime[k] * 1000.0);
+        }
+        std::printf(" %8.0fx\n", vecTime[2] > 0 ? loopTime / vecTime[2] : 0.0);
+    }
+    return 0;
+}
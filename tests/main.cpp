@@ -1,7 +1,7 @@
 // ============================================
 // Minimal BuLang test runner
 // Only depends on libbu — no SDL, OpenGL, or plugins.
-// Usage: bulang_test <script.bu> [--dump]
+// Usage: bulang_test <script.bu> [--dump] [--workers N]
 // Exit code 0 = success, 1 = error
 // ============================================
 
@@ -87,6 +87,7 @@ int main(int argc, char *argv[])
 {
     const char *scriptFile = nullptr;
     bool dump = false;
+    int workers = 0;
 
     for (int i = 1; i < argc; ++i)
     {
@@ -94,6 +95,10 @@ int main(int argc, char *argv[])
         {
             dump = true;
         }
+        else if (std::strcmp(argv[i], "--workers") == 0 && i + 1 < argc)
+        {
+            workers = std::atoi(argv[++i]);
+        }
         else if (!scriptFile)
         {
             scriptFile = argv[i];
@@ -102,7 +107,7 @@ int main(int argc, char *argv[])
 
     if (!scriptFile)
     {
-        std::fprintf(stderr, "Usage: bulang_test <script.bu> [--dump]\n");
+        std::fprintf(stderr, "Usage: bulang_test <script.bu> [--dump] [--workers N]\n");
         return 1;
     }
 
@@ -117,6 +122,7 @@ int main(int argc, char *argv[])
     // Set up VM
     Interpreter vm;
     vm.registerAll();
+    vm.setProcessWorkers(workers);
 
     // Configure file loader with search paths relative to the script
     SimpleLoaderCtx loaderCtx;
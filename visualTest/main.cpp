@@ -184,14 +184,14 @@ static int native_is_key_down(Interpreter *vm, int argc, Value *args)
 
 static void onRender(Interpreter *vm, Process *proc)
 {
-    float x = (float)proc->privates[(int)PrivateIndex::X].asNumber();
-    float y = (float)proc->privates[(int)PrivateIndex::Y].asNumber();
-    int size = (int)proc->privates[(int)PrivateIndex::SIZE].asNumber();
-    int graph = (int)proc->privates[(int)PrivateIndex::GRAPH].asNumber();
-    int r = (int)proc->privates[(int)PrivateIndex::iRED].asNumber();
-    int g = (int)proc->privates[(int)PrivateIndex::iGREEN].asNumber();
-    int b = (int)proc->privates[(int)PrivateIndex::iBLUE].asNumber();
-    int a = (int)proc->privates[(int)PrivateIndex::iALPHA].asNumber();
+    float x = (float)proc->priv((int)PrivateIndex::X).asNumber();
+    float y = (float)proc->priv((int)PrivateIndex::Y).asNumber();
+    int size = (int)proc->priv((int)PrivateIndex::SIZE).asNumber();
+    int graph = (int)proc->priv((int)PrivateIndex::GRAPH).asNumber();
+    int r = (int)proc->priv((int)PrivateIndex::iRED).asNumber();
+    int g = (int)proc->priv((int)PrivateIndex::iGREEN).asNumber();
+    int b = (int)proc->priv((int)PrivateIndex::iBLUE).asNumber();
+    int a = (int)proc->priv((int)PrivateIndex::iALPHA).asNumber();
 
     float radius = size * 0.15f;
     if (radius < 2) radius = 2;